@@ -23,6 +23,7 @@ public class InworldAIClient : ModuleRules
             new string[]
             {
                 "Core",
+                "NetCore",
             });
 
         PrivateDependencyModuleNames.AddRange(
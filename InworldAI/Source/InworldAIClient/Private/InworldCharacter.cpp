@@ -75,6 +75,28 @@ void UInworldCharacter::HandlePacket(const FInworldWrappedPacket& WrappedPacket)
 	}
 }
 
+int32 UInworldCharacter::GetSubscribedPacketTypes() const
+{
+	int32 Mask = 0;
+	auto AddIfBound = [&Mask](EInworldPacketType Type, const auto& Delegate, const auto& DelegateNative)
+	{
+		if (Delegate.IsBound() || DelegateNative.IsBound())
+		{
+			Mask |= Inworld::PacketTypeBit(Type);
+		}
+	};
+	AddIfBound(EInworldPacketType::Text, OnInworldTextEventDelegate, OnInworldTextEventDelegateNative);
+	AddIfBound(EInworldPacketType::VAD, OnInworldVADEventDelegate, OnInworldVADEventDelegateNative);
+	AddIfBound(EInworldPacketType::AudioData, OnInworldAudioEventDelegate, OnInworldAudioEventDelegateNative);
+	AddIfBound(EInworldPacketType::A2FHeader, OnInworldA2FHeaderEventDelegate, OnInworldA2FHeaderEventDelegateNative);
+	AddIfBound(EInworldPacketType::A2FContent, OnInworldA2FContentEventDelegate, OnInworldA2FContentEventDelegateNative);
+	AddIfBound(EInworldPacketType::Silence, OnInworldSilenceEventDelegate, OnInworldSilenceEventDelegateNative);
+	AddIfBound(EInworldPacketType::Control, OnInworldControlEventDelegate, OnInworldControlEventDelegateNative);
+	AddIfBound(EInworldPacketType::Emotion, OnInworldEmotionEventDelegate, OnInworldEmotionEventDelegateNative);
+	AddIfBound(EInworldPacketType::Custom, OnInworldCustomEventDelegate, OnInworldCustomEventDelegateNative);
+	return Mask;
+}
+
 void UInworldCharacter::SetSession(UInworldSession* InSession)
 {
 	if (Session == InSession)
@@ -9,6 +9,7 @@
 #include "InworldAIClientModule.h"
 #include "InworldAIClientSettings.h"
 #include "InworldMacros.h"
+#include "InworldPacketLog.h"
 #include "CoreMinimal.h"
 #include "GenericPlatform/GenericPlatformMisc.h"
 
@@ -206,6 +207,14 @@ UInworldClient::UInworldClient()
 			{
 				return;
 			}
+			InworldPacketTypeResolver TypeResolver;
+			Packet->Accept(TypeResolver);
+			const EInworldPacketType Type = TypeResolver.GetType();
+			if (!IsPacketTypeSubscribed(Type))
+			{
+				DroppedPacketCounts[static_cast<int32>(Type)].Increment();
+				return;
+			}
 			AsyncTask(ENamedThreads::GameThread, [this, Packet]()
 				{
 					if (bIsBeingDestroyed)
@@ -217,6 +226,10 @@ UInworldClient::UInworldClient()
 					TSharedPtr<FInworldPacket> ReceivedPacket = PacketTranslator.GetPacket();
 					if (ReceivedPacket.IsValid())
 					{
+						if (FInworldPacketLog::IsEnabled())
+						{
+							FInworldPacketLog::Get().Record(*ReceivedPacket);
+						}
 						OnPacketReceivedDelegateNative.Broadcast(ReceivedPacket);
 						OnPacketReceivedDelegate.Broadcast(ReceivedPacket);
 					}
@@ -682,6 +695,34 @@ void UInworldClient::GetConnectionError(FString& OutErrorMessage, int32& OutErro
 #endif
 }
 
+void UInworldClient::SetPacketSubscriptionMask(int32 Mask)
+{
+	PacketSubscriptionMask.store((Mask & Inworld::AllPacketTypes) | Inworld::RequiredPacketTypes, std::memory_order_relaxed);
+}
+
+int32 UInworldClient::GetDroppedPacketCount(EInworldPacketType Type) const
+{
+	if (Type >= EInworldPacketType::Count)
+	{
+		return 0;
+	}
+	return DroppedPacketCounts[static_cast<int32>(Type)].GetValue();
+}
+
+void UInworldClient::ResetDroppedPacketCounts()
+{
+	for (FThreadSafeCounter& DroppedPacketCount : DroppedPacketCounts)
+	{
+		DroppedPacketCount.Reset();
+	}
+}
+
+bool UInworldClient::IsPacketTypeSubscribed(EInworldPacketType Type) const
+{
+	// packets the translator doesn't know about are never dropped
+	return Type >= EInworldPacketType::Count || (PacketSubscriptionMask.load(std::memory_order_relaxed) & Inworld::PacketTypeBit(Type)) != 0;
+}
+
 FInworldWrappedPacket UInworldClient::SendTextMessage(const FString& AgentId, const FString& Text)
 {
 	NO_CLIENT_RETURN({})
@@ -0,0 +1,240 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#include "InworldPacketEventBus.h"
+
+namespace Inworld
+{
+	static const FString* GetPacketAgentId(const FInworldRouting& Routing)
+	{
+		if (Routing.Source.Type == EInworldActorType::AGENT)
+		{
+			return &Routing.Source.Name;
+		}
+		if (Routing.Target.Type == EInworldActorType::AGENT)
+		{
+			return &Routing.Target.Name;
+		}
+		return nullptr;
+	}
+}
+
+FDelegateHandle FInworldPacketEventBus::Subscribe(EInworldPacketType Type, FListener Listener, const FInworldPacketFilter& Filter)
+{
+	if (!ensureMsgf(Type < EInworldPacketType::Count, TEXT("FInworldPacketEventBus::Subscribe: invalid packet type")) || !Listener)
+	{
+		return FDelegateHandle();
+	}
+
+	const FDelegateHandle Handle(FDelegateHandle::GenerateNewHandle);
+	const FListenerKey Key{ Type, Filter };
+	HandleToKey.Add(Handle, Key);
+
+	if (DispatchDepth > 0)
+	{
+		PendingAdds.Emplace(Key, FListenerEntry{ Handle, MoveTemp(Listener) });
+	}
+	else
+	{
+		AddListener(Key, FListenerEntry{ Handle, MoveTemp(Listener) });
+	}
+	return Handle;
+}
+
+void FInworldPacketEventBus::Unsubscribe(FDelegateHandle Handle)
+{
+	FListenerKey Key;
+	if (!HandleToKey.RemoveAndCopyValue(Handle, Key))
+	{
+		return;
+	}
+
+	const int32 NumPendingAdds = PendingAdds.RemoveAll([Handle](const TPair<FListenerKey, FListenerEntry>& PendingAdd) { return PendingAdd.Value.Handle == Handle; });
+	if (NumPendingAdds > 0)
+	{
+		return;
+	}
+
+	if (DispatchDepth > 0)
+	{
+		PendingRemoves.Emplace(Key, Handle);
+	}
+	else
+	{
+		RemoveListener(Key, Handle);
+	}
+}
+
+void FInworldPacketEventBus::UnsubscribeAll()
+{
+	TArray<FDelegateHandle> Handles;
+	HandleToKey.GenerateKeyArray(Handles);
+	for (const FDelegateHandle& Handle : Handles)
+	{
+		Unsubscribe(Handle);
+	}
+}
+
+void FInworldPacketEventBus::Dispatch(const FInworldPacket& Packet)
+{
+	const EInworldPacketType Type = Packet.GetPacketType();
+	if (Type >= EInworldPacketType::Count)
+	{
+		return;
+	}
+
+	const FTypeListeners& TypeListeners = Listeners[static_cast<int32>(Type)];
+	if (TypeListeners.Num == 0)
+	{
+		return;
+	}
+
+	++DispatchDepth;
+
+	Invoke(TypeListeners.Any, Packet);
+
+	if (TypeListeners.ByAgent.Num() > 0)
+	{
+		if (const FString* AgentId = Inworld::GetPacketAgentId(Packet.Routing))
+		{
+			if (const TArray<FListenerEntry>* AgentListeners = TypeListeners.ByAgent.Find(*AgentId))
+			{
+				Invoke(*AgentListeners, Packet);
+			}
+		}
+	}
+
+	if (TypeListeners.ByConversation.Num() > 0 && !Packet.Routing.ConversationId.IsEmpty())
+	{
+		if (const TArray<FListenerEntry>* ConversationListeners = TypeListeners.ByConversation.Find(Packet.Routing.ConversationId))
+		{
+			Invoke(*ConversationListeners, Packet);
+		}
+	}
+
+	if (--DispatchDepth == 0)
+	{
+		FlushPending();
+	}
+}
+
+int32 FInworldPacketEventBus::GetSubscribedPacketTypes() const
+{
+	int32 Mask = 0;
+	for (int32 Index = 0; Index < static_cast<int32>(EInworldPacketType::Count); ++Index)
+	{
+		if (Listeners[Index].Num > 0)
+		{
+			Mask |= Inworld::PacketTypeBit(static_cast<EInworldPacketType>(Index));
+		}
+	}
+	return Mask;
+}
+
+int32 FInworldPacketEventBus::GetNumListeners(EInworldPacketType Type) const
+{
+	return Type < EInworldPacketType::Count ? Listeners[static_cast<int32>(Type)].Num : 0;
+}
+
+TArray<FInworldPacketEventBus::FListenerEntry>& FInworldPacketEventBus::FindOrAddListeners(const FListenerKey& Key)
+{
+	FTypeListeners& TypeListeners = Listeners[static_cast<int32>(Key.Type)];
+	if (!Key.Filter.AgentId.IsEmpty())
+	{
+		return TypeListeners.ByAgent.FindOrAdd(Key.Filter.AgentId);
+	}
+	if (!Key.Filter.ConversationId.IsEmpty())
+	{
+		return TypeListeners.ByConversation.FindOrAdd(Key.Filter.ConversationId);
+	}
+	return TypeListeners.Any;
+}
+
+TArray<FInworldPacketEventBus::FListenerEntry>* FInworldPacketEventBus::FindListeners(const FListenerKey& Key)
+{
+	FTypeListeners& TypeListeners = Listeners[static_cast<int32>(Key.Type)];
+	if (!Key.Filter.AgentId.IsEmpty())
+	{
+		return TypeListeners.ByAgent.Find(Key.Filter.AgentId);
+	}
+	if (!Key.Filter.ConversationId.IsEmpty())
+	{
+		return TypeListeners.ByConversation.Find(Key.Filter.ConversationId);
+	}
+	return &TypeListeners.Any;
+}
+
+void FInworldPacketEventBus::AddListener(const FListenerKey& Key, FListenerEntry&& Entry)
+{
+	FindOrAddListeners(Key).Add(MoveTemp(Entry));
+
+	if (++Listeners[static_cast<int32>(Key.Type)].Num == 1)
+	{
+		OnSubscriptionsChangedDelegate.Broadcast();
+	}
+}
+
+void FInworldPacketEventBus::RemoveListener(const FListenerKey& Key, FDelegateHandle Handle)
+{
+	TArray<FListenerEntry>* KeyListeners = FindListeners(Key);
+	if (KeyListeners == nullptr)
+	{
+		return;
+	}
+
+	const int32 NumRemoved = KeyListeners->RemoveAll([Handle](const FListenerEntry& Entry) { return Entry.Handle == Handle; });
+	if (NumRemoved == 0)
+	{
+		return;
+	}
+
+	FTypeListeners& TypeListeners = Listeners[static_cast<int32>(Key.Type)];
+	if (KeyListeners->Num() == 0)
+	{
+		if (!Key.Filter.AgentId.IsEmpty())
+		{
+			TypeListeners.ByAgent.Remove(Key.Filter.AgentId);
+		}
+		else if (!Key.Filter.ConversationId.IsEmpty())
+		{
+			TypeListeners.ByConversation.Remove(Key.Filter.ConversationId);
+		}
+	}
+
+	TypeListeners.Num -= NumRemoved;
+	if (TypeListeners.Num == 0)
+	{
+		OnSubscriptionsChangedDelegate.Broadcast();
+	}
+}
+
+void FInworldPacketEventBus::Invoke(const TArray<FListenerEntry>& KeyListeners, const FInworldPacket& Packet) const
+{
+	for (const FListenerEntry& Entry : KeyListeners)
+	{
+		if (PendingRemoves.Num() > 0 && PendingRemoves.ContainsByPredicate([&Entry](const TPair<FListenerKey, FDelegateHandle>& PendingRemove) { return PendingRemove.Value == Entry.Handle; }))
+		{
+			continue;
+		}
+		Entry.Listener(Packet);
+	}
+}
+
+void FInworldPacketEventBus::FlushPending()
+{
+	TArray<TPair<FListenerKey, FDelegateHandle>> Removes = MoveTemp(PendingRemoves);
+	TArray<TPair<FListenerKey, FListenerEntry>> Adds = MoveTemp(PendingAdds);
+
+	for (const TPair<FListenerKey, FDelegateHandle>& Remove : Removes)
+	{
+		RemoveListener(Remove.Key, Remove.Value);
+	}
+	for (TPair<FListenerKey, FListenerEntry>& Add : Adds)
+	{
+		AddListener(Add.Key, MoveTemp(Add.Value));
+	}
+}
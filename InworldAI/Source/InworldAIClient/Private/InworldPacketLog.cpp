@@ -0,0 +1,250 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#include "InworldPacketLog.h"
+#include "InworldPackets.h"
+
+#include "CoreGlobals.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/OutputDevice.h"
+#include "UObject/Class.h"
+
+static TAutoConsoleVariable<bool> CVarLogAllPackets(
+TEXT("Inworld.Debug.LogAllPackets"), false,
+TEXT("Enable/Disable recording all packets going from server, dump them with Inworld.Debug.DumpPacketLog")
+);
+
+static FAutoConsoleCommandWithOutputDevice DumpPacketLogCommand(
+	TEXT("Inworld.Debug.DumpPacketLog"),
+	TEXT("Log the packets recorded while Inworld.Debug.LogAllPackets is enabled"),
+	FConsoleCommandWithOutputDeviceDelegate::CreateLambda([](FOutputDevice& Ar) { FInworldPacketLog::Get().Dump(Ar); })
+);
+
+namespace Inworld
+{
+	template<int32 Length>
+	static void CopyTruncated(ANSICHAR(&Dest)[Length], const FString& Src)
+	{
+		const int32 Num = FMath::Min(Src.Len(), Length - 1);
+		const TCHAR* Chars = *Src;
+		for (int32 i = 0; i < Num; ++i)
+		{
+			Dest[i] = Chars[i] < 128 ? static_cast<ANSICHAR>(Chars[i]) : '?';
+		}
+		Dest[Num] = '\0';
+	}
+
+	static void FillRecord(FInworldPacketLogRecord& Record, uint64 Sequence, const FInworldPacket& Packet)
+	{
+		Record.Sequence = Sequence;
+		Record.Time = FPlatformTime::Seconds() - GStartTime;
+		Record.Type = Packet.GetPacketType();
+		Record.SourceType = Packet.Routing.Source.Type;
+		Record.TargetType = Packet.Routing.Target.Type;
+		Record.Value0 = 0;
+		Record.Value1 = 0;
+		CopyTruncated(Record.SourceName, Packet.Routing.Source.Name);
+		CopyTruncated(Record.TargetName, Packet.Routing.Target.Name);
+		CopyTruncated(Record.ConversationId, Packet.Routing.ConversationId);
+		CopyTruncated(Record.InteractionId, Packet.PacketId.InteractionId);
+		CopyTruncated(Record.UtteranceId, Packet.PacketId.UtteranceId);
+		Record.Label[0] = '\0';
+
+		switch (Record.Type)
+		{
+		case EInworldPacketType::Text:
+		{
+			const FInworldTextEvent& Event = static_cast<const FInworldTextEvent&>(Packet);
+			Record.Value0 = Event.Text.Len();
+			Record.Value1 = Event.Final;
+			CopyTruncated(Record.Label, Event.Text);
+			break;
+		}
+		case EInworldPacketType::VAD:
+			Record.Value0 = static_cast<const FInworldVADEvent&>(Packet).VoiceDetected;
+			break;
+		case EInworldPacketType::Data:
+			Record.Value0 = static_cast<const FInworldDataEvent&>(Packet).Chunk.Num();
+			break;
+		case EInworldPacketType::AudioData:
+		{
+			const FInworldAudioDataEvent& Event = static_cast<const FInworldAudioDataEvent&>(Packet);
+			Record.Value0 = Event.Chunk.Num();
+			Record.Value1 = Event.VisemeInfos.Num();
+			break;
+		}
+		case EInworldPacketType::A2FHeader:
+		{
+			const FInworldA2FHeaderEvent& Event = static_cast<const FInworldA2FHeaderEvent&>(Packet);
+			Record.Value0 = Event.BlendShapes.Num();
+			Record.Value1 = Event.SamplesPerSecond;
+			break;
+		}
+		case EInworldPacketType::A2FContent:
+		{
+			const FInworldA2FContentEvent& Event = static_cast<const FInworldA2FContentEvent&>(Packet);
+			Record.Value0 = Event.AudioInfo.Audio.Num();
+			Record.Value1 = Event.BlendShapeWeights.Values.Num();
+			break;
+		}
+		case EInworldPacketType::Silence:
+			Record.Value0 = FMath::RoundToInt(static_cast<const FInworldSilenceEvent&>(Packet).Duration * 1000.f);
+			break;
+		case EInworldPacketType::Control:
+			Record.Value0 = static_cast<int32>(static_cast<const FInworldControlEvent&>(Packet).Action);
+			break;
+		case EInworldPacketType::ConversationUpdate:
+		{
+			const FInworldConversationUpdateEvent& Event = static_cast<const FInworldConversationUpdateEvent&>(Packet);
+			Record.Value0 = static_cast<int32>(Event.EventType);
+			Record.Value1 = Event.Agents.Num();
+			break;
+		}
+		case EInworldPacketType::CurrentSceneStatus:
+		{
+			const FInworldCurrentSceneStatusEvent& Event = static_cast<const FInworldCurrentSceneStatusEvent&>(Packet);
+			Record.Value0 = Event.AgentInfos.Num();
+			CopyTruncated(Record.Label, Event.SceneName);
+			break;
+		}
+		case EInworldPacketType::Emotion:
+		{
+			const FInworldEmotionEvent& Event = static_cast<const FInworldEmotionEvent&>(Packet);
+			Record.Value0 = static_cast<int32>(Event.Behavior);
+			Record.Value1 = static_cast<int32>(Event.Strength);
+			break;
+		}
+		case EInworldPacketType::Custom:
+		{
+			const FInworldCustomEvent& Event = static_cast<const FInworldCustomEvent&>(Packet);
+			Record.Value0 = Event.Params.RepMap.Num();
+			CopyTruncated(Record.Label, Event.Name);
+			break;
+		}
+		case EInworldPacketType::Relation:
+		{
+			const FInworldRelationEvent& Event = static_cast<const FInworldRelationEvent&>(Packet);
+			Record.Value0 = Event.Trust;
+			Record.Value1 = Event.Respect;
+			break;
+		}
+		default:
+			break;
+		}
+	}
+}
+
+FString FInworldPacketLogRecord::ToString() const
+{
+	return FString::Printf(TEXT("#%llu %.3f %s %s:%s -> %s:%s Conversation: %s Interaction: %s Utterance: %s Values: %d %d '%s'"),
+		Sequence, Time, *UEnum::GetValueAsString(Type),
+		*UEnum::GetValueAsString(SourceType), ANSI_TO_TCHAR(SourceName),
+		*UEnum::GetValueAsString(TargetType), ANSI_TO_TCHAR(TargetName),
+		ANSI_TO_TCHAR(ConversationId), ANSI_TO_TCHAR(InteractionId), ANSI_TO_TCHAR(UtteranceId),
+		Value0, Value1, ANSI_TO_TCHAR(Label));
+}
+
+FInworldPacketLog& FInworldPacketLog::Get()
+{
+	// never destroyed, the log is still readable from the system error handler during shutdown
+	static FInworldPacketLog* PacketLog = new FInworldPacketLog();
+	return *PacketLog;
+}
+
+bool FInworldPacketLog::IsEnabled()
+{
+	return CVarLogAllPackets.GetValueOnAnyThread();
+}
+
+FInworldPacketLog::FInworldPacketLog()
+{
+	FCoreDelegates::OnHandleSystemError.AddRaw(this, &FInworldPacketLog::OnHandleSystemError);
+}
+
+void FInworldPacketLog::Record(const FInworldPacket& Packet)
+{
+	FSlot* LogSlots = GetOrAllocateSlots();
+	const uint64 Sequence = NextSequence.fetch_add(1, std::memory_order_relaxed);
+	FSlot& Slot = LogSlots[Sequence % Capacity];
+
+	Slot.Stamp.store(0, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	Inworld::FillRecord(Slot.Record, Sequence, Packet);
+	Slot.Stamp.store(Sequence + 1, std::memory_order_release);
+}
+
+void FInworldPacketLog::GetRecords(TArray<FInworldPacketLogRecord>& OutRecords) const
+{
+	OutRecords.Reset();
+
+	const FSlot* LogSlots = Slots.load(std::memory_order_acquire);
+	if (LogSlots == nullptr)
+	{
+		return;
+	}
+
+	const uint64 End = NextSequence.load(std::memory_order_acquire);
+	const uint64 Begin = End > Capacity ? End - Capacity : 0;
+	OutRecords.Reserve(static_cast<int32>(End - Begin));
+	for (uint64 Sequence = Begin; Sequence < End; ++Sequence)
+	{
+		const FSlot& Slot = LogSlots[Sequence % Capacity];
+		const uint64 Stamp = Slot.Stamp.load(std::memory_order_acquire);
+		if (Stamp != Sequence + 1)
+		{
+			continue;
+		}
+
+		FInworldPacketLogRecord Record = Slot.Record;
+		std::atomic_thread_fence(std::memory_order_acquire);
+		// skip records overwritten while copied
+		if (Slot.Stamp.load(std::memory_order_relaxed) == Stamp)
+		{
+			OutRecords.Add(Record);
+		}
+	}
+}
+
+void FInworldPacketLog::Dump(FOutputDevice& Ar) const
+{
+	TArray<FInworldPacketLogRecord> Records;
+	GetRecords(Records);
+
+	Ar.Logf(TEXT("Inworld packet log: %d of %llu packets"), Records.Num(), NextSequence.load(std::memory_order_relaxed));
+	for (const FInworldPacketLogRecord& Record : Records)
+	{
+		Ar.Log(Record.ToString());
+	}
+}
+
+FInworldPacketLog::FSlot* FInworldPacketLog::GetOrAllocateSlots()
+{
+	FSlot* LogSlots = Slots.load(std::memory_order_acquire);
+	if (LogSlots == nullptr)
+	{
+		// allocated once on first record, then reused for the lifetime of the process
+		FSlot* NewSlots = new FSlot[Capacity];
+		if (Slots.compare_exchange_strong(LogSlots, NewSlots, std::memory_order_acq_rel))
+		{
+			LogSlots = NewSlots;
+		}
+		else
+		{
+			delete[] NewSlots;
+		}
+	}
+	return LogSlots;
+}
+
+void FInworldPacketLog::OnHandleSystemError()
+{
+	if (Slots.load(std::memory_order_acquire) != nullptr)
+	{
+		Dump(*GLog);
+	}
+}
@@ -55,4 +55,31 @@ protected:
 	}
 };
 
+// resolves the packet type without translating, used to drop unsubscribed packets on the receiving thread
+class InworldPacketTypeResolver : public Inworld::PacketVisitor
+{
+public:
+	virtual ~InworldPacketTypeResolver() = default;
+
+	virtual void Visit(const Inworld::TextEvent& Event) override { Type = EInworldPacketType::Text; }
+	virtual void Visit(const Inworld::VADEvent& Event) override { Type = EInworldPacketType::VAD; }
+	virtual void Visit(const Inworld::DataEvent& Event) override { Type = EInworldPacketType::Data; }
+	virtual void Visit(const Inworld::AudioDataEvent& Event) override { Type = EInworldPacketType::AudioData; }
+	virtual void Visit(const Inworld::A2FHeaderEvent& Event) override { Type = EInworldPacketType::A2FHeader; }
+	virtual void Visit(const Inworld::A2FContentEvent& Event) override { Type = EInworldPacketType::A2FContent; }
+	virtual void Visit(const Inworld::SilenceEvent& Event) override { Type = EInworldPacketType::Silence; }
+	virtual void Visit(const Inworld::ControlEvent& Event) override { Type = EInworldPacketType::Control; }
+	virtual void Visit(const Inworld::ControlEventConversationUpdate& Event) override { Type = EInworldPacketType::ConversationUpdate; }
+	virtual void Visit(const Inworld::ControlEventCurrentSceneStatus& Event) override { Type = EInworldPacketType::CurrentSceneStatus; }
+	virtual void Visit(const Inworld::EmotionEvent& Event) override { Type = EInworldPacketType::Emotion; }
+	virtual void Visit(const Inworld::CustomEvent& Event) override { Type = EInworldPacketType::Custom; }
+	virtual void Visit(const Inworld::RelationEvent& Event) override { Type = EInworldPacketType::Relation; }
+
+	// Count if the packet is of a type the translator doesn't know
+	EInworldPacketType GetType() const { return Type; }
+
+private:
+	EInworldPacketType Type = EInworldPacketType::Count;
+};
+
 #endif
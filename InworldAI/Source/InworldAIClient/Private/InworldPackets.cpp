@@ -6,6 +6,10 @@
  */
 
 #include "InworldPackets.h"
+#include "InworldReplicatedKeys.h"
+#include "InworldAIClientModule.h"
+
+#include "Engine/PackageMapClient.h"
 
 #include <string>
 
@@ -15,11 +19,16 @@ void AppendToDebugString(FString& DbgStr, const FString& Str)
 	DbgStr.Append(TEXT(". "));
 }
 
-void FInworldAudioDataEvent::ConvertToReplicatableEvents(const FInworldAudioDataEvent& Event, TArray<FInworldAudioDataEvent>& RepEvents)
+static constexpr uint32 ReplicatedDataMaxSize = 32 * 1024;
+
+static TArray<uint8> GetReplicatedDataChunk(const TArray<uint8>& Data, uint32 Index)
 {
-	constexpr uint32 DataMaxSize = 32 * 1024;
+	return TArray<uint8>(Data.GetData() + (ReplicatedDataMaxSize * Index), FMath::Min(ReplicatedDataMaxSize, (Data.Num() - (ReplicatedDataMaxSize * Index))));
+}
 
-	const uint32 NumArrays = Event.Chunk.Num() / DataMaxSize + 1;
+void FInworldAudioDataEvent::ConvertToReplicatableEvents(const FInworldAudioDataEvent& Event, TArray<FInworldAudioDataEvent>& RepEvents)
+{
+	const uint32 NumArrays = Event.Chunk.Num() / ReplicatedDataMaxSize + 1;
 	RepEvents.SetNum(NumArrays);
 
 	for (uint32 i = 0; i < NumArrays; ++i)
@@ -28,7 +37,7 @@ void FInworldAudioDataEvent::ConvertToReplicatableEvents(const FInworldAudioData
 		RepEvent.PacketId = Event.PacketId;
 		RepEvent.Routing = Event.Routing;
 		RepEvent.bFinal = false;
-		RepEvent.Chunk = TArray<uint8>(Event.Chunk.GetData() + (DataMaxSize * i), FMath::Min(DataMaxSize, (Event.Chunk.Num() - (DataMaxSize * i))));
+		RepEvent.Chunk = GetReplicatedDataChunk(Event.Chunk, i);
 	}
 
 	auto& FinalEvent = RepEvents.Last();
@@ -36,6 +45,24 @@ void FInworldAudioDataEvent::ConvertToReplicatableEvents(const FInworldAudioData
 	FinalEvent.VisemeInfos = Event.VisemeInfos;
 }
 
+void FInworldA2FContentEvent::ConvertToReplicatableEvents(const FInworldA2FContentEvent& Event, TArray<FInworldA2FContentEvent>& RepEvents)
+{
+	const uint32 NumArrays = Event.AudioInfo.Audio.Num() / ReplicatedDataMaxSize + 1;
+	RepEvents.SetNum(NumArrays);
+
+	for (uint32 i = 0; i < NumArrays; ++i)
+	{
+		FInworldA2FContentEvent& RepEvent = RepEvents[i];
+		RepEvent.PacketId = Event.PacketId;
+		RepEvent.Routing = Event.Routing;
+		RepEvent.AudioInfo.TimeCode = Event.AudioInfo.TimeCode;
+		RepEvent.AudioInfo.Audio = GetReplicatedDataChunk(Event.AudioInfo.Audio, i);
+	}
+
+	// the frame's weights complete it, they travel with the last chunk
+	RepEvents.Last().BlendShapeWeights = Event.BlendShapeWeights;
+}
+
 template<typename T>
 void SerializeValue(FMemoryArchive& Ar, T& Val)
 {
@@ -87,12 +114,438 @@ static void SerializeString(FMemoryArchive& Ar, FString& Str)
 
 	if (Ar.IsLoading())
 	{
-		Str = FString(Size, TEXT("0"));
+		Str.Empty();
+		if (Size <= 0)
+		{
+			return;
+		}
+		Str.GetCharArray().SetNumZeroed(Size + 1);
 	}
 
 	Ar.Serialize((void*)Str.GetCharArray().GetData(), sizeof(TCHAR) * Size);
 }
 
+namespace Inworld
+{
+	// precedes compact packets, legacy packets start with the length of the packet UID
+	static constexpr uint16 CompactPacketMagic = 0x49A5;
+
+	enum ECompactPacketFlags : uint8
+	{
+		InternedNames = 1 << 0,
+	};
+}
+
+namespace Inworld
+{
+	enum class EReplicatedValueKind : uint8
+	{
+		String,
+		Integer,
+		Float,
+		True,
+		False,
+	};
+
+	// values are packed only when they convert back to the exact same string
+	static EReplicatedValueKind GetReplicatedValueKind(const FString& Value, int32& OutInteger, float& OutFloat)
+	{
+		if (Value.Equals(TEXT("true"), ESearchCase::CaseSensitive))
+		{
+			return EReplicatedValueKind::True;
+		}
+		if (Value.Equals(TEXT("false"), ESearchCase::CaseSensitive))
+		{
+			return EReplicatedValueKind::False;
+		}
+		if (Value.IsEmpty() || !Value.IsNumeric())
+		{
+			return EReplicatedValueKind::String;
+		}
+
+		const int64 Integer = FCString::Atoi64(*Value);
+		if (Integer >= MIN_int32 && Integer <= MAX_int32 && FString::FromInt(static_cast<int32>(Integer)).Equals(Value, ESearchCase::CaseSensitive))
+		{
+			OutInteger = static_cast<int32>(Integer);
+			return EReplicatedValueKind::Integer;
+		}
+
+		const float Float = FCString::Atof(*Value);
+		if (FString::SanitizeFloat(Float).Equals(Value, ESearchCase::CaseSensitive))
+		{
+			OutFloat = Float;
+			return EReplicatedValueKind::Float;
+		}
+		return EReplicatedValueKind::String;
+	}
+
+	static void SerializeReplicatedValue(FArchive& Ar, FString& Value)
+	{
+		int32 Integer = 0;
+		float Float = 0.f;
+		uint8 Kind = static_cast<uint8>(Ar.IsLoading() ? EReplicatedValueKind::String : GetReplicatedValueKind(Value, Integer, Float));
+		Ar << Kind;
+
+		switch (static_cast<EReplicatedValueKind>(Kind))
+		{
+		case EReplicatedValueKind::String:
+			SerializeReplicatedString(Ar, Value, FInworldReplicatedMapStruct::MaxValueBytes);
+			break;
+		case EReplicatedValueKind::Integer:
+		{
+			uint32 ZigZag = (static_cast<uint32>(Integer) << 1) ^ static_cast<uint32>(Integer >> 31);
+			Ar.SerializeIntPacked(ZigZag);
+			if (Ar.IsLoading())
+			{
+				Value = FString::FromInt(static_cast<int32>((ZigZag >> 1) ^ (0u - (ZigZag & 1))));
+			}
+			break;
+		}
+		case EReplicatedValueKind::Float:
+			Ar << Float;
+			if (Ar.IsLoading())
+			{
+				Value = FString::SanitizeFloat(Float);
+			}
+			break;
+		case EReplicatedValueKind::True:
+			Value = TEXT("true");
+			break;
+		case EReplicatedValueKind::False:
+			Value = TEXT("false");
+			break;
+		default:
+			Ar.SetError();
+			break;
+		}
+	}
+}
+
+bool FInworldReplicatedMapStruct::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	UPackageMapClient* PackageMapClient = Cast<UPackageMapClient>(Map);
+	UNetConnection* Connection = PackageMapClient ? PackageMapClient->GetConnection() : nullptr;
+	FInworldReplicatedKeyDictionary* Keys = Inworld::FindOrAddReplicatedKeys(Connection);
+
+	bOutSuccess = NetSerializeWithKeys(Ar, Keys);
+
+	if (Ar.IsLoading() && Keys && Keys->HasPendingAcknowledgement())
+	{
+		Inworld::OnReplicatedKeysReceived().Broadcast(Connection);
+	}
+	return true;
+}
+
+bool FInworldReplicatedMapStruct::NetSerializeWithKeys(FArchive& Ar, FInworldReplicatedKeyDictionary* Keys)
+{
+	if (Ar.IsLoading())
+	{
+		RepMap.Reset();
+
+		uint32 Num = 0;
+		Ar.SerializeIntPacked(Num);
+		if (Ar.IsError() || Num > static_cast<uint32>(MaxNum))
+		{
+			Ar.SetError();
+			return false;
+		}
+
+		for (uint32 i = 0; i < Num; ++i)
+		{
+			FString Key, Value;
+			FInworldReplicatedKeyDictionary::SerializeKey(Ar, Key, Keys);
+			Inworld::SerializeReplicatedValue(Ar, Value);
+			if (Ar.IsError())
+			{
+				RepMap.Reset();
+				return false;
+			}
+			RepMap.Add(MoveTemp(Key), MoveTemp(Value));
+		}
+		return true;
+	}
+
+	// the reader rejects larger maps, the params past the limit are dropped
+	uint32 Num = FMath::Min(RepMap.Num(), MaxNum);
+	if (RepMap.Num() > MaxNum)
+	{
+		UE_LOG(LogInworldAIClient, Warning, TEXT("Replicated map of %d params truncated to %d params"), RepMap.Num(), MaxNum);
+	}
+	Ar.SerializeIntPacked(Num);
+	uint32 NumWritten = 0;
+	for (auto It = RepMap.CreateIterator(); It && NumWritten < Num; ++It, ++NumWritten)
+	{
+		FInworldReplicatedKeyDictionary::SerializeKey(Ar, It->Key, Keys);
+		Inworld::SerializeReplicatedValue(Ar, It->Value);
+	}
+	return !Ar.IsError();
+}
+
+int64 FInworldPacketArchive::GetRemaining() const
+{
+	const int64 TotalSize = Inner.TotalSize();
+	return TotalSize < 0 ? MAX_int64 : TotalSize - Inner.Tell();
+}
+
+void FInworldPacketArchive::SerializeRaw(void* Data, int64 Num)
+{
+	if (IsLoading() && (IsError() || Num > GetRemaining()))
+	{
+		SetError();
+		FMemory::Memzero(Data, Num);
+		return;
+	}
+	Inner.ByteOrderSerialize(Data, Num);
+}
+
+void FInworldPacketArchive::SerializeVarUInt(uint64& Value)
+{
+	if (IsLoading())
+	{
+		Value = 0;
+		for (int32 Shift = 0; Shift < 64; Shift += 7)
+		{
+			uint8 Byte = 0;
+			SerializeRaw(&Byte, 1);
+			Value |= static_cast<uint64>(Byte & 0x7F) << Shift;
+			if ((Byte & 0x80) == 0)
+			{
+				return;
+			}
+		}
+		SetError();
+		return;
+	}
+
+	uint64 Remaining = Value;
+	do
+	{
+		uint8 Byte = Remaining & 0x7F;
+		Remaining >>= 7;
+		if (Remaining != 0)
+		{
+			Byte |= 0x80;
+		}
+		SerializeRaw(&Byte, 1);
+	} while (Remaining != 0);
+}
+
+void FInworldPacketArchive::SerializeVarInt(int32& Value)
+{
+	// zigzag, small negative values stay small
+	uint64 Encoded = (static_cast<uint32>(Value) << 1) ^ static_cast<uint32>(Value >> 31);
+	SerializeVarUInt(Encoded);
+	const uint32 Decoded = static_cast<uint32>(Encoded);
+	Value = static_cast<int32>((Decoded >> 1) ^ (~(Decoded & 1) + 1));
+}
+
+void FInworldPacketArchive::SerializeByte(uint8& Value)
+{
+	SerializeRaw(&Value, sizeof(Value));
+}
+
+void FInworldPacketArchive::SerializeBool(bool& Value)
+{
+	uint8 Byte = Value ? 1 : 0;
+	SerializeByte(Byte);
+	Value = Byte != 0;
+}
+
+void FInworldPacketArchive::SerializeFloat(float& Value)
+{
+	SerializeRaw(&Value, sizeof(Value));
+}
+
+void FInworldPacketArchive::SerializeDouble(double& Value)
+{
+	SerializeRaw(&Value, sizeof(Value));
+}
+
+void FInworldPacketArchive::SerializeCount(int32& Count, int32 MinElementSize)
+{
+	uint64 Value = FMath::Max(Count, 0);
+	SerializeVarUInt(Value);
+	if (IsLoading())
+	{
+		if (IsError() || Value > static_cast<uint64>(MAX_int32) || static_cast<int64>(Value) * MinElementSize > GetRemaining())
+		{
+			SetError();
+			Value = 0;
+		}
+		Count = static_cast<int32>(Value);
+	}
+}
+
+void FInworldPacketArchive::SerializeBytes(TArray<uint8>& Bytes)
+{
+	int32 Num = Bytes.Num();
+	SerializeCount(Num);
+	if (IsLoading())
+	{
+		Bytes.SetNumUninitialized(Num);
+	}
+	if (Num > 0)
+	{
+		SerializeRaw(Bytes.GetData(), Num);
+	}
+}
+
+void FInworldPacketArchive::SerializeString(FString& Str)
+{
+	if (IsLoading())
+	{
+		int32 Len = 0;
+		SerializeCount(Len);
+		if (Len == 0)
+		{
+			Str.Empty();
+			return;
+		}
+		TArray<ANSICHAR> Utf8;
+		Utf8.SetNumUninitialized(Len);
+		SerializeRaw(Utf8.GetData(), Len);
+		const FUTF8ToTCHAR Converted(Utf8.GetData(), Len);
+		Str = FString(Converted.Length(), Converted.Get());
+		return;
+	}
+
+	const FTCHARToUTF8 Utf8(*Str);
+	int32 Len = Utf8.Length();
+	SerializeCount(Len);
+	if (Len > 0)
+	{
+		SerializeRaw((void*)Utf8.Get(), Len);
+	}
+}
+
+void FInworldPacketArchive::SerializeName(FString& Str)
+{
+	if (NameTable == nullptr)
+	{
+		SerializeString(Str);
+		return;
+	}
+
+	// 0 is followed by a new name, otherwise the index of a name already in the table plus one
+	if (IsLoading())
+	{
+		uint64 Reference = 0;
+		SerializeVarUInt(Reference);
+		if (Reference == 0)
+		{
+			SerializeString(Str);
+			if (!IsError())
+			{
+				NameTable->NameToIndex.Add(Str, NameTable->Names.Add(Str));
+			}
+		}
+		else if (Reference <= static_cast<uint64>(NameTable->Names.Num()))
+		{
+			Str = NameTable->Names[Reference - 1];
+		}
+		else
+		{
+			SetError();
+			Str.Empty();
+		}
+		return;
+	}
+
+	if (const int32* Index = NameTable->NameToIndex.Find(Str))
+	{
+		uint64 Reference = *Index + 1;
+		SerializeVarUInt(Reference);
+		return;
+	}
+	uint64 Reference = 0;
+	SerializeVarUInt(Reference);
+	SerializeString(Str);
+	NameTable->NameToIndex.Add(Str, NameTable->Names.Add(Str));
+}
+
+TSharedPtr<FInworldPacket> Inworld::MakePacket(EInworldPacketType Type)
+{
+	switch (Type)
+	{
+	case EInworldPacketType::Text: return MakeShared<FInworldTextEvent>();
+	case EInworldPacketType::VAD: return MakeShared<FInworldVADEvent>();
+	case EInworldPacketType::Data: return MakeShared<FInworldDataEvent>();
+	case EInworldPacketType::AudioData: return MakeShared<FInworldAudioDataEvent>();
+	case EInworldPacketType::A2FHeader: return MakeShared<FInworldA2FHeaderEvent>();
+	case EInworldPacketType::A2FContent: return MakeShared<FInworldA2FContentEvent>();
+	case EInworldPacketType::Silence: return MakeShared<FInworldSilenceEvent>();
+	case EInworldPacketType::Control: return MakeShared<FInworldControlEvent>();
+	case EInworldPacketType::ConversationUpdate: return MakeShared<FInworldConversationUpdateEvent>();
+	case EInworldPacketType::CurrentSceneStatus: return MakeShared<FInworldCurrentSceneStatusEvent>();
+	case EInworldPacketType::Emotion: return MakeShared<FInworldEmotionEvent>();
+	case EInworldPacketType::Custom: return MakeShared<FInworldCustomEvent>();
+	case EInworldPacketType::Relation: return MakeShared<FInworldRelationEvent>();
+	default: return nullptr;
+	}
+}
+
+void Inworld::WritePacket(FMemoryArchive& Ar, FInworldPacket& Packet, FInworldPacketNameTable* NameTable)
+{
+	check(!Ar.IsLoading());
+
+	uint16 Magic = CompactPacketMagic;
+	uint8 Version = FInworldPacketArchive::CurrentVersion;
+	uint8 Flags = NameTable ? InternedNames : 0;
+	uint8 Type = static_cast<uint8>(Packet.GetPacketType());
+	Ar << Magic;
+	Ar << Version;
+	Ar << Flags;
+	Ar << Type;
+
+	FInworldPacketArchive PacketAr(Ar, Version, NameTable);
+	Packet.SerializeCompact(PacketAr);
+}
+
+TSharedPtr<FInworldPacket> Inworld::ReadPacket(FMemoryArchive& Ar, FInworldPacketNameTable* NameTable, EInworldPacketType LegacyType)
+{
+	check(Ar.IsLoading());
+
+	constexpr int64 HeaderSize = sizeof(uint16) + 3 * sizeof(uint8);
+	const int64 Start = Ar.Tell();
+	uint16 Magic = 0;
+	if (Ar.TotalSize() - Start >= HeaderSize)
+	{
+		Ar << Magic;
+	}
+
+	if (Magic != CompactPacketMagic)
+	{
+		Ar.Seek(Start);
+		TSharedPtr<FInworldPacket> Packet = MakePacket(LegacyType);
+		if (Packet.IsValid())
+		{
+			Packet->Serialize(Ar);
+		}
+		return Packet;
+	}
+
+	uint8 Version = 0, Flags = 0, Type = 0;
+	Ar << Version;
+	Ar << Flags;
+	Ar << Type;
+
+	const bool bInternedNames = (Flags & InternedNames) != 0;
+	if (Version == 0 || Version > FInworldPacketArchive::CurrentVersion || (bInternedNames && NameTable == nullptr))
+	{
+		return nullptr;
+	}
+
+	TSharedPtr<FInworldPacket> Packet = MakePacket(static_cast<EInworldPacketType>(Type));
+	if (!Packet.IsValid())
+	{
+		return nullptr;
+	}
+
+	FInworldPacketArchive PacketAr(Ar, Version, bInternedNames ? NameTable : nullptr);
+	Packet->SerializeCompact(PacketAr);
+	return PacketAr.IsError() ? nullptr : Packet;
+}
+
 void FInworldActor::Serialize(FMemoryArchive& Ar)
 {
 	uint8 T = static_cast<uint8>(Type);
@@ -102,6 +555,12 @@ void FInworldActor::Serialize(FMemoryArchive& Ar)
 	SerializeString(Ar, Name);
 }
 
+void FInworldActor::SerializeCompact(FInworldPacketArchive& Ar)
+{
+	Ar.SerializeEnum(Type);
+	Ar.SerializeName(Name);
+}
+
 void FInworldActor::AppendDebugString(FString& Str) const
 {
 	switch (Type)
@@ -130,6 +589,13 @@ void FInworldRouting::Serialize(FMemoryArchive& Ar)
 	Target.Serialize(Ar);
 }
 
+void FInworldRouting::SerializeCompact(FInworldPacketArchive& Ar)
+{
+	Source.SerializeCompact(Ar);
+	Target.SerializeCompact(Ar);
+	Ar.SerializeName(ConversationId);
+}
+
 void FInworldRouting::AppendDebugString(FString& Str) const
 {
 	AppendToDebugString(Str, TEXT("Source"));
@@ -146,6 +612,13 @@ void FInworldPacketId::Serialize(FMemoryArchive& Ar)
 	SerializeString(Ar, InteractionId);
 }
 
+void FInworldPacketId::SerializeCompact(FInworldPacketArchive& Ar)
+{
+	Ar.SerializeString(UID);
+	Ar.SerializeName(UtteranceId);
+	Ar.SerializeName(InteractionId);
+}
+
 void FInworldPacketId::AppendDebugString(FString& Str) const
 {
 	AppendToDebugString(Str, UID);
@@ -159,6 +632,12 @@ void FInworldPacket::Serialize(FMemoryArchive& Ar)
 	Routing.Serialize(Ar);
 }
 
+void FInworldPacket::SerializeCompact(FInworldPacketArchive& Ar)
+{
+	PacketId.SerializeCompact(Ar);
+	Routing.SerializeCompact(Ar);
+}
+
 FString FInworldPacket::ToDebugString() const
 {
 	FString Str;
@@ -168,6 +647,14 @@ FString FInworldPacket::ToDebugString() const
 	return Str;
 }
 
+void FInworldTextEvent::SerializeCompact(FInworldPacketArchive& Ar)
+{
+	FInworldPacket::SerializeCompact(Ar);
+
+	Ar.SerializeString(Text);
+	Ar.SerializeBool(Final);
+}
+
 void FInworldTextEvent::AppendDebugString(FString& Str) const
 {
 	AppendToDebugString(Str, TEXT("Text"));
@@ -175,6 +662,13 @@ void FInworldTextEvent::AppendDebugString(FString& Str) const
 	AppendToDebugString(Str, Final ? TEXT("Final") : TEXT("Not final"));
 }
 
+void FInworldVADEvent::SerializeCompact(FInworldPacketArchive& Ar)
+{
+	FInworldPacket::SerializeCompact(Ar);
+
+	Ar.SerializeBool(VoiceDetected);
+}
+
 void FInworldVADEvent::AppendDebugString(FString& Str) const
 {
 	AppendToDebugString(Str, TEXT("Voice Activity"));
@@ -188,6 +682,13 @@ void FInworldDataEvent::Serialize(FMemoryArchive& Ar)
 	SerializeChunk(Ar, Chunk);
 }
 
+void FInworldDataEvent::SerializeCompact(FInworldPacketArchive& Ar)
+{
+	FInworldPacket::SerializeCompact(Ar);
+
+	Ar.SerializeBytes(Chunk);
+}
+
 void FInworldDataEvent::AppendDebugString(FString& Str) const
 {
 	AppendToDebugString(Str, TEXT("Data"));
@@ -202,6 +703,20 @@ void FInworldAudioDataEvent::Serialize(FMemoryArchive& Ar)
 	SerializeValue<bool>(Ar, bFinal);
 }
 
+void FInworldAudioDataEvent::SerializeCompact(FInworldPacketArchive& Ar)
+{
+	FInworldDataEvent::SerializeCompact(Ar);
+
+	int32 Num = VisemeInfos.Num();
+	Ar.SerializeCount(Num);
+	VisemeInfos.SetNum(Num);
+	for (FInworldVisemeInfo& VisemeInfo : VisemeInfos)
+	{
+		VisemeInfo.SerializeCompact(Ar);
+	}
+	Ar.SerializeBool(bFinal);
+}
+
 void FInworldAudioDataEvent::AppendDebugString(FString& Str) const
 {
 	FInworldDataEvent::AppendDebugString(Str);
@@ -217,12 +732,106 @@ void FInworldVisemeInfo::Serialize(FMemoryArchive& Ar)
 	SerializeValue<float>(Ar, Timestamp);
 }
 
+void FInworldVisemeInfo::SerializeCompact(FInworldPacketArchive& Ar)
+{
+	Ar.SerializeName(Code);
+	Ar.SerializeFloat(Timestamp);
+}
+
+void FInworldA2FHeaderEvent::Serialize(FMemoryArchive& Ar)
+{
+	FInworldPacket::Serialize(Ar);
+
+	SerializeValue<int32>(Ar, ChannelCount);
+	SerializeValue<int32>(Ar, SamplesPerSecond);
+	SerializeValue<int32>(Ar, BitsPerSample);
+
+	int32 Size = BlendShapes.Num();
+	SerializeValue<int32>(Ar, Size);
+
+	BlendShapes.SetNum(Size);
+
+	for (FName& BlendShape : BlendShapes)
+	{
+		FString BlendShapeStr = BlendShape.ToString();
+		SerializeString(Ar, BlendShapeStr);
+		BlendShape = FName(*BlendShapeStr);
+	}
+}
+
+void FInworldA2FHeaderEvent::SerializeCompact(FInworldPacketArchive& Ar)
+{
+	FInworldPacket::SerializeCompact(Ar);
+
+	Ar.SerializeVarInt(ChannelCount);
+	Ar.SerializeVarInt(SamplesPerSecond);
+	Ar.SerializeVarInt(BitsPerSample);
+
+	int32 Num = BlendShapes.Num();
+	Ar.SerializeCount(Num);
+	BlendShapes.SetNum(Num);
+	for (FName& BlendShape : BlendShapes)
+	{
+		FString BlendShapeStr = BlendShape.ToString();
+		Ar.SerializeName(BlendShapeStr);
+		if (BlendShapeStr.Len() >= NAME_SIZE)
+		{
+			Ar.SetError();
+			BlendShapeStr.Empty();
+		}
+		BlendShape = FName(*BlendShapeStr);
+	}
+}
+
 void FInworldA2FHeaderEvent::AppendDebugString(FString& Str) const
 {
+	AppendToDebugString(Str, TEXT("A2FHeader"));
+	AppendToDebugString(Str, FString::FromInt(ChannelCount));
+	AppendToDebugString(Str, FString::FromInt(SamplesPerSecond));
+	AppendToDebugString(Str, FString::FromInt(BitsPerSample));
+	AppendToDebugString(Str, FString::FromInt(BlendShapes.Num()));
+}
+
+void FInworldA2FContentEvent::Serialize(FMemoryArchive& Ar)
+{
+	FInworldPacket::Serialize(Ar);
+
+	SerializeValue<double>(Ar, AudioInfo.TimeCode);
+	SerializeChunk(Ar, AudioInfo.Audio);
+
+	SerializeValue<double>(Ar, BlendShapeWeights.TimeCode);
+	SerializeArray<float>(Ar, BlendShapeWeights.Values);
+}
+
+void FInworldA2FContentEvent::SerializeCompact(FInworldPacketArchive& Ar)
+{
+	FInworldPacket::SerializeCompact(Ar);
+
+	Ar.SerializeDouble(AudioInfo.TimeCode);
+	Ar.SerializeBytes(AudioInfo.Audio);
+
+	Ar.SerializeDouble(BlendShapeWeights.TimeCode);
+	int32 Num = BlendShapeWeights.Values.Num();
+	Ar.SerializeCount(Num, sizeof(float));
+	BlendShapeWeights.Values.SetNum(Num);
+	for (float& Value : BlendShapeWeights.Values)
+	{
+		Ar.SerializeFloat(Value);
+	}
 }
 
 void FInworldA2FContentEvent::AppendDebugString(FString& Str) const
 {
+	AppendToDebugString(Str, TEXT("A2FContent"));
+	AppendToDebugString(Str, FString::FromInt(AudioInfo.Audio.Num()));
+	AppendToDebugString(Str, FString::FromInt(BlendShapeWeights.Values.Num()));
+}
+
+void FInworldSilenceEvent::SerializeCompact(FInworldPacketArchive& Ar)
+{
+	FInworldPacket::SerializeCompact(Ar);
+
+	Ar.SerializeFloat(Duration);
 }
 
 void FInworldSilenceEvent::AppendDebugString(FString& Str) const
@@ -231,6 +840,14 @@ void FInworldSilenceEvent::AppendDebugString(FString& Str) const
 	AppendToDebugString(Str, FString::SanitizeFloat(Duration));
 }
 
+void FInworldControlEvent::SerializeCompact(FInworldPacketArchive& Ar)
+{
+	FInworldPacket::SerializeCompact(Ar);
+
+	Ar.SerializeEnum(Action);
+	Ar.SerializeString(Description);
+}
+
 void FInworldControlEvent::AppendDebugString(FString& Str) const
 {
 	AppendToDebugString(Str, TEXT("Control"));
@@ -238,6 +855,21 @@ void FInworldControlEvent::AppendDebugString(FString& Str) const
 	AppendToDebugString(Str, Description);
 }
 
+void FInworldConversationUpdateEvent::SerializeCompact(FInworldPacketArchive& Ar)
+{
+	FInworldControlEvent::SerializeCompact(Ar);
+
+	int32 Num = Agents.Num();
+	Ar.SerializeCount(Num);
+	Agents.SetNum(Num);
+	for (FString& Agent : Agents)
+	{
+		Ar.SerializeName(Agent);
+	}
+	Ar.SerializeEnum(EventType);
+	Ar.SerializeBool(bIncludePlayer);
+}
+
 void FInworldConversationUpdateEvent::AppendDebugString(FString& Str) const
 {
 	AppendToDebugString(Str, TEXT("ConversationUpdate"));
@@ -249,6 +881,25 @@ void FInworldConversationUpdateEvent::AppendDebugString(FString& Str) const
 	}
 }
 
+void FInworldCurrentSceneStatusEvent::SerializeCompact(FInworldPacketArchive& Ar)
+{
+	FInworldControlEvent::SerializeCompact(Ar);
+
+	Ar.SerializeString(SceneName);
+	Ar.SerializeString(SceneDescription);
+	Ar.SerializeString(SceneDisplayName);
+
+	int32 Num = AgentInfos.Num();
+	Ar.SerializeCount(Num);
+	AgentInfos.SetNum(Num);
+	for (FInworldAgentInfo& AgentInfo : AgentInfos)
+	{
+		Ar.SerializeName(AgentInfo.BrainName);
+		Ar.SerializeName(AgentInfo.AgentId);
+		Ar.SerializeString(AgentInfo.GivenName);
+	}
+}
+
 void FInworldCurrentSceneStatusEvent::AppendDebugString(FString& Str) const
 {
 	AppendToDebugString(Str, TEXT("CurrentSceneStatus"));
@@ -261,6 +912,14 @@ void FInworldCurrentSceneStatusEvent::AppendDebugString(FString& Str) const
 	}
 }
 
+void FInworldEmotionEvent::SerializeCompact(FInworldPacketArchive& Ar)
+{
+	FInworldPacket::SerializeCompact(Ar);
+
+	Ar.SerializeEnum(Behavior);
+	Ar.SerializeEnum(Strength);
+}
+
 void FInworldEmotionEvent::AppendDebugString(FString& Str) const
 {
 	AppendToDebugString(Str, TEXT("Emotion"));
@@ -268,6 +927,35 @@ void FInworldEmotionEvent::AppendDebugString(FString& Str) const
 	AppendToDebugString(Str, FString::FromInt(static_cast<int32>(Strength)));
 }
 
+void FInworldCustomEvent::SerializeCompact(FInworldPacketArchive& Ar)
+{
+	FInworldPacket::SerializeCompact(Ar);
+
+	Ar.SerializeString(Name);
+
+	TArray<FString> Keys, Values;
+	Params.RepMap.GenerateKeyArray(Keys);
+	Params.RepMap.GenerateValueArray(Values);
+	int32 Num = Keys.Num();
+	Ar.SerializeCount(Num, 2);
+	Keys.SetNum(Num);
+	Values.SetNum(Num);
+	for (int32 i = 0; i < Num; ++i)
+	{
+		Ar.SerializeName(Keys[i]);
+		Ar.SerializeString(Values[i]);
+	}
+
+	if (Ar.IsLoading())
+	{
+		Params.RepMap.Reset();
+		for (int32 i = 0; i < Num; ++i)
+		{
+			Params.RepMap.Add(Keys[i], Values[i]);
+		}
+	}
+}
+
 void FInworldCustomEvent::AppendDebugString(FString& Str) const
 {
 	AppendToDebugString(Str, TEXT("Custom"));
@@ -282,6 +970,17 @@ void FInworldCustomEvent::AppendDebugString(FString& Str) const
 	}
 }
 
+void FInworldRelationEvent::SerializeCompact(FInworldPacketArchive& Ar)
+{
+	FInworldPacket::SerializeCompact(Ar);
+
+	Ar.SerializeVarInt(Attraction);
+	Ar.SerializeVarInt(Familiar);
+	Ar.SerializeVarInt(Flirtatious);
+	Ar.SerializeVarInt(Respect);
+	Ar.SerializeVarInt(Trust);
+}
+
 void FInworldRelationEvent::AppendDebugString(FString& Str) const
 {
 	AppendToDebugString(Str, TEXT("Relation"));
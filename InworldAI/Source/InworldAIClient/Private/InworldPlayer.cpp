@@ -9,6 +9,7 @@
 #include "InworldPlayer.h"
 #include "InworldCharacter.h"
 #include "InworldSession.h"
+#include "InworldSessionGroup.h"
 #include "InworldMacros.h"
 
 #include "InworldAIClientModule.h"
@@ -66,6 +67,22 @@ bool UInworldPlayer::CallRemoteFunction(UFunction* Function, void* Parms, FOutPa
 	return false;
 }
 
+void UInworldPlayer::Tick(float DeltaTime)
+{
+	CommitConversationUpdate();
+}
+
+UWorld* UInworldPlayer::GetTickableGameObjectWorld() const
+{
+	AActor* Owner = GetTypedOuter<AActor>();
+	return Owner ? Owner->GetWorld() : nullptr;
+}
+
+TStatId UInworldPlayer::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UInworldPlayer, STATGROUP_Tickables);
+}
+
 void UInworldPlayer::HandlePacket(const FInworldWrappedPacket& WrappedPacket)
 {
 	auto& Packet = WrappedPacket.Packet;
@@ -75,6 +92,12 @@ void UInworldPlayer::HandlePacket(const FInworldWrappedPacket& WrappedPacket)
 	}
 }
 
+int32 UInworldPlayer::GetSubscribedPacketTypes() const
+{
+	// voice detection is replicated to clients, so it is kept even without local listeners
+	return Inworld::PacketTypeBit(EInworldPacketType::VAD) | Inworld::PacketTypeBit(EInworldPacketType::ConversationUpdate);
+}
+
 void UInworldPlayer::SetSession(UInworldSession* InSession)
 {
 	if (Session == InSession)
@@ -84,6 +107,13 @@ void UInworldPlayer::SetSession(UInworldSession* InSession)
 
 	if (Session.IsValid())
 	{
+		// the conversation lives on the previous connection
+		if (!ConversationId.IsEmpty())
+		{
+			SendAudioSessionStopToConversation();
+			ConversationId = {};
+			ConversationCharacters.Empty();
+		}
 		Session->UnregisterPlayer(this);
 	}
 
@@ -163,19 +193,36 @@ void UInworldPlayer::SetConversationParticipation(bool bParticipate)
 		bConversationParticipant = bParticipate;
 		if (!ConversationId.IsEmpty())
 		{
-			UpdateConversation();
+			RequestConversationUpdate();
 		}
 	}
 }
 
+static bool IsSessionGroupShard(const UInworldSession* Session)
+{
+	return Session && Session->GetOuter() && Session->GetOuter()->IsA<UInworldSessionGroup>();
+}
+
 void UInworldPlayer::AddTargetCharacter(UInworldCharacter* TargetCharacter)
 {
 	if (TargetCharacter && TargetCharacter->IsPossessed() && TargetCharacter->GetTargetPlayer() == nullptr)
 	{
+		// a conversation can't span the shards of a session group, an idle player follows the character to its shard
+		UInworldSession* TargetSession = TargetCharacter->GetSession();
+		if (TargetSession != Session.Get() && IsSessionGroupShard(TargetSession) && IsSessionGroupShard(Session.Get()) && TargetSession->GetOuter() == Session->GetOuter())
+		{
+			if (TargetCharacters.Get().Num() != 0)
+			{
+				UE_LOG(LogInworldAIClient, Warning, TEXT("UInworldPlayer::AddTargetCharacter skipped: %s is in another shard than the current targets."), *TargetCharacter->GetAgentInfo().GivenName);
+				return;
+			}
+			SetSession(TargetCharacter->GetSession());
+		}
+
 		TargetCharacter->SetTargetPlayer(this);
-		TargetCharacters.AddUnique(TargetCharacter);
+		TargetCharacters.Add(TargetCharacter);
 
-		UpdateConversation();
+		RequestConversationUpdate();
 
 		OnTargetCharacterAddedDelegateNative.Broadcast(TargetCharacter);
 		OnTargetCharacterAddedDelegate.Broadcast(TargetCharacter);
@@ -190,9 +237,9 @@ void UInworldPlayer::RemoveTargetCharacter(UInworldCharacter* TargetCharacter)
 	if (TargetCharacter && TargetCharacter->GetTargetPlayer() == this)
 	{
 		TargetCharacter->ClearTargetPlayer();
-		TargetCharacters.RemoveSingle(TargetCharacter);
+		TargetCharacters.Remove(TargetCharacter);
 
-		UpdateConversation();
+		RequestConversationUpdate();
 
 		OnTargetCharacterRemovedDelegateNative.Broadcast(TargetCharacter);
 		OnTargetCharacterRemovedDelegate.Broadcast(TargetCharacter);
@@ -205,7 +252,7 @@ void UInworldPlayer::RemoveTargetCharacter(UInworldCharacter* TargetCharacter)
 void UInworldPlayer::ClearAllTargetCharacters()
 {
 	TArray<UInworldCharacter*> CharactersToRemove = {};
-	for (UInworldCharacter* TargetCharacter : TargetCharacters)
+	for (UInworldCharacter* TargetCharacter : TargetCharacters.Get())
 	{
 		if (TargetCharacter->GetTargetPlayer() == this)
 		{
@@ -217,10 +264,10 @@ void UInworldPlayer::ClearAllTargetCharacters()
 		for (UInworldCharacter* CharacterToRemove : CharactersToRemove)
 		{
 			CharacterToRemove->ClearTargetPlayer();
-			TargetCharacters.RemoveSingle(CharacterToRemove);
+			TargetCharacters.Remove(CharacterToRemove);
 		}
 
-		UpdateConversation();
+		RequestConversationUpdate();
 
 		for (UInworldCharacter* CharacterToRemove : CharactersToRemove)
 		{
@@ -242,10 +289,64 @@ void UInworldPlayer::OnRep_VoiceDetected(bool bOldValue)
 	}
 }
 
+void UInworldPlayer::CommitConversationUpdate()
+{
+	if (!bConversationUpdatePending)
+	{
+		return;
+	}
+	bConversationUpdatePending = false;
+
+	// changes made during the frame could cancel each other out, don't restart the audio session for nothing
+	if (!ConversationId.IsEmpty() && !HasConversationChanged())
+	{
+		return;
+	}
+
+	UpdateConversation();
+}
+
+void UInworldPlayer::RequestConversationUpdate()
+{
+	bConversationUpdatePending = true;
+}
+
+bool UInworldPlayer::HasConversationChanged() const
+{
+	if (bConversationCharactersParticipant != bConversationParticipant)
+	{
+		return true;
+	}
+
+	const TArray<UInworldCharacter*>& Characters = TargetCharacters.Get();
+	if (ConversationCharacters.Num() != Characters.Num())
+	{
+		return true;
+	}
+
+	for (UInworldCharacter* Character : Characters)
+	{
+		if (!ConversationCharacters.Contains(Character))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
 void UInworldPlayer::UpdateConversation()
 {
 	NO_SESSION_RETURN(void())
 
+	bConversationUpdatePending = false;
+	ConversationCharacters.Reset(TargetCharacters.Get().Num());
+	for (UInworldCharacter* Character : TargetCharacters.Get())
+	{
+		ConversationCharacters.Add(Character);
+	}
+	bConversationCharactersParticipant = bConversationParticipant;
+
 	FString NextConversationId = Session->UpdateConversation(this);
 	const bool bHadAudioSession = bHasAudioSession;
 	if (bHasAudioSession)
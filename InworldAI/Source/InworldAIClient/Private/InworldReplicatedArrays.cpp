@@ -0,0 +1,126 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#include "InworldReplicatedArrays.h"
+#include "InworldCharacter.h"
+#include "InworldPlayer.h"
+
+namespace Inworld
+{
+	template<typename TItem, typename TObject>
+	bool AddReplicatedItem(FFastArraySerializer& Array, TArray<TItem>& Items, TArray<TObject*>& Objects, TObject* Object, TObject* TItem::*Member)
+	{
+		if (Object == nullptr || Objects.Contains(Object))
+		{
+			return false;
+		}
+
+		TItem& Item = Items.AddDefaulted_GetRef();
+		Item.*Member = Object;
+		Array.MarkItemDirty(Item);
+		Objects.Add(Object);
+		return true;
+	}
+
+	template<typename TItem, typename TObject>
+	bool RemoveReplicatedItem(FFastArraySerializer& Array, TArray<TItem>& Items, TArray<TObject*>& Objects, TObject* Object, TObject* TItem::*Member)
+	{
+		const int32 Idx = Items.IndexOfByPredicate([Object, Member](const TItem& Item) { return Item.*Member == Object; });
+		if (Idx == INDEX_NONE)
+		{
+			return false;
+		}
+
+		Items.RemoveAt(Idx);
+		Array.MarkArrayDirty();
+		Objects.RemoveSingle(Object);
+		return true;
+	}
+
+	template<typename TItem, typename TObject>
+	void AddResolvedItems(const TArray<TItem>& Items, TArray<TObject*>& Objects, TObject* TItem::*Member, const TArrayView<int32>& Indices)
+	{
+		// objects may be null until the subobject is resolved on the client, in that case they arrive as a change later
+		for (const int32 Idx : Indices)
+		{
+			if (TObject* Object = Items[Idx].*Member)
+			{
+				Objects.AddUnique(Object);
+			}
+		}
+	}
+}
+
+bool FInworldCharacterArray::Add(UInworldCharacter* Character)
+{
+	return Inworld::AddReplicatedItem(*this, Items, Characters, Character, &FInworldCharacterArrayItem::Character);
+}
+
+bool FInworldCharacterArray::Remove(UInworldCharacter* Character)
+{
+	return Inworld::RemoveReplicatedItem(*this, Items, Characters, Character, &FInworldCharacterArrayItem::Character);
+}
+
+void FInworldCharacterArray::Empty()
+{
+	Items.Empty();
+	Characters.Empty();
+	MarkArrayDirty();
+}
+
+void FInworldCharacterArray::PreReplicatedRemove(const TArrayView<int32>& RemovedIndices, int32 FinalSize)
+{
+	for (const int32 Idx : RemovedIndices)
+	{
+		Characters.RemoveSingle(Items[Idx].Character);
+	}
+}
+
+void FInworldCharacterArray::PostReplicatedAdd(const TArrayView<int32>& AddedIndices, int32 FinalSize)
+{
+	Inworld::AddResolvedItems(Items, Characters, &FInworldCharacterArrayItem::Character, AddedIndices);
+}
+
+void FInworldCharacterArray::PostReplicatedChange(const TArrayView<int32>& ChangedIndices, int32 FinalSize)
+{
+	Inworld::AddResolvedItems(Items, Characters, &FInworldCharacterArrayItem::Character, ChangedIndices);
+}
+
+bool FInworldPlayerArray::Add(UInworldPlayer* Player)
+{
+	return Inworld::AddReplicatedItem(*this, Items, Players, Player, &FInworldPlayerArrayItem::Player);
+}
+
+bool FInworldPlayerArray::Remove(UInworldPlayer* Player)
+{
+	return Inworld::RemoveReplicatedItem(*this, Items, Players, Player, &FInworldPlayerArrayItem::Player);
+}
+
+void FInworldPlayerArray::Empty()
+{
+	Items.Empty();
+	Players.Empty();
+	MarkArrayDirty();
+}
+
+void FInworldPlayerArray::PreReplicatedRemove(const TArrayView<int32>& RemovedIndices, int32 FinalSize)
+{
+	for (const int32 Idx : RemovedIndices)
+	{
+		Players.RemoveSingle(Items[Idx].Player);
+	}
+}
+
+void FInworldPlayerArray::PostReplicatedAdd(const TArrayView<int32>& AddedIndices, int32 FinalSize)
+{
+	Inworld::AddResolvedItems(Items, Players, &FInworldPlayerArrayItem::Player, AddedIndices);
+}
+
+void FInworldPlayerArray::PostReplicatedChange(const TArrayView<int32>& ChangedIndices, int32 FinalSize)
+{
+	Inworld::AddResolvedItems(Items, Players, &FInworldPlayerArrayItem::Player, ChangedIndices);
+}
@@ -0,0 +1,234 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#include "InworldReplicatedKeys.h"
+#include "InworldAIClientModule.h"
+
+#include "Engine/NetConnection.h"
+
+namespace Inworld
+{
+	using FReplicatedKeysByConnection = TMap<TWeakObjectPtr<UNetConnection>, TUniquePtr<FInworldReplicatedKeyDictionary>>;
+
+	static FReplicatedKeysByConnection& GetReplicatedKeysByConnection()
+	{
+		static FReplicatedKeysByConnection ReplicatedKeysByConnection;
+		return ReplicatedKeysByConnection;
+	}
+}
+
+void FInworldReplicatedKeyDictionary::SerializeKey(FArchive& Ar, FString& Key, FInworldReplicatedKeyDictionary* Keys)
+{
+	if (!Ar.IsLoading())
+	{
+		const int32 Index = Keys ? Keys->FindOrAddSentKey(Key) : INDEX_NONE;
+		if (Index == INDEX_NONE)
+		{
+			uint32 Tag = static_cast<uint32>(EKeyKind::Inline);
+			Ar.SerializeIntPacked(Tag);
+			Inworld::SerializeReplicatedString(Ar, Key, MaxKeyBytes);
+		}
+		else if (Keys->AcknowledgedKeyMask[Index])
+		{
+			uint32 Tag = (static_cast<uint32>(Index) << 2) | static_cast<uint32>(EKeyKind::Reference);
+			Ar.SerializeIntPacked(Tag);
+		}
+		else
+		{
+			uint32 Tag = (static_cast<uint32>(Index) << 2) | static_cast<uint32>(EKeyKind::Define);
+			Ar.SerializeIntPacked(Tag);
+			Inworld::SerializeReplicatedString(Ar, Key, MaxKeyBytes);
+		}
+		return;
+	}
+
+	uint32 Tag = 0;
+	Ar.SerializeIntPacked(Tag);
+	if (Ar.IsError())
+	{
+		return;
+	}
+
+	const EKeyKind Kind = static_cast<EKeyKind>(Tag & 3);
+	const uint32 Index = Tag >> 2;
+	switch (Kind)
+	{
+	case EKeyKind::Inline:
+		Inworld::SerializeReplicatedString(Ar, Key, MaxKeyBytes);
+		break;
+	case EKeyKind::Define:
+		if (Keys == nullptr || Index >= static_cast<uint32>(MaxKeys))
+		{
+			Ar.SetError();
+			break;
+		}
+		Inworld::SerializeReplicatedString(Ar, Key, MaxKeyBytes);
+		if (!Ar.IsError())
+		{
+			Keys->AddReceivedKey(static_cast<int32>(Index), Key);
+		}
+		break;
+	case EKeyKind::Reference:
+	{
+		const FString* ReceivedKey = Keys && Index < static_cast<uint32>(MaxKeys) ? Keys->FindReceivedKey(static_cast<int32>(Index)) : nullptr;
+		if (ReceivedKey == nullptr)
+		{
+			Ar.SetError();
+			break;
+		}
+		Key = *ReceivedKey;
+		break;
+	}
+	default:
+		Ar.SetError();
+		break;
+	}
+}
+
+void FInworldReplicatedKeyDictionary::Acknowledge(TArrayView<const int32> Indices)
+{
+	for (const int32 Index : Indices)
+	{
+		if (Index >= 0 && Index < AcknowledgedKeyMask.Num() && !AcknowledgedKeyMask[Index])
+		{
+			AcknowledgedKeyMask[Index] = true;
+			++NumAcknowledged;
+		}
+	}
+}
+
+bool FInworldReplicatedKeyDictionary::ConsumeAcknowledgement(TArray<int32>& OutIndices)
+{
+	if (!HasPendingAcknowledgement())
+	{
+		return false;
+	}
+
+	OutIndices = MoveTemp(PendingAcknowledgements);
+	PendingAcknowledgements.Reset();
+	return true;
+}
+
+int32 FInworldReplicatedKeyDictionary::FindOrAddSentKey(const FString& Key)
+{
+	if (const int32* Index = SentKeyToIndex.Find(Key))
+	{
+		return *Index;
+	}
+	if (SentKeyToIndex.Num() >= MaxKeys)
+	{
+		return INDEX_NONE;
+	}
+	AcknowledgedKeyMask.Add(false);
+	return SentKeyToIndex.Add(Key, SentKeyToIndex.Num());
+}
+
+void FInworldReplicatedKeyDictionary::AddReceivedKey(int32 Index, const FString& Key)
+{
+	if (Index >= ReceivedKeys.Num())
+	{
+		ReceivedKeys.SetNum(Index + 1);
+		ReceivedKeyMask.Add(false, Index + 1 - ReceivedKeyMask.Num());
+	}
+	ReceivedKeys[Index] = Key;
+
+	// a key is defined again until its acknowledgement arrives, acknowledge it once
+	if (!ReceivedKeyMask[Index])
+	{
+		ReceivedKeyMask[Index] = true;
+		PendingAcknowledgements.Add(Index);
+	}
+}
+
+const FString* FInworldReplicatedKeyDictionary::FindReceivedKey(int32 Index) const
+{
+	return Index < ReceivedKeyMask.Num() && ReceivedKeyMask[Index] ? &ReceivedKeys[Index] : nullptr;
+}
+
+FInworldReplicatedKeyDictionary* Inworld::FindOrAddReplicatedKeys(UNetConnection* Connection)
+{
+	if (Connection == nullptr)
+	{
+		return nullptr;
+	}
+
+	FReplicatedKeysByConnection& ReplicatedKeysByConnection = GetReplicatedKeysByConnection();
+	if (TUniquePtr<FInworldReplicatedKeyDictionary>* Keys = ReplicatedKeysByConnection.Find(Connection))
+	{
+		return Keys->Get();
+	}
+
+	for (auto It = ReplicatedKeysByConnection.CreateIterator(); It; ++It)
+	{
+		if (!It->Key.IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+	return ReplicatedKeysByConnection.Add(Connection, MakeUnique<FInworldReplicatedKeyDictionary>()).Get();
+}
+
+FInworldReplicatedKeyDictionary* Inworld::FindReplicatedKeys(UNetConnection* Connection)
+{
+	TUniquePtr<FInworldReplicatedKeyDictionary>* Keys = Connection ? GetReplicatedKeysByConnection().Find(Connection) : nullptr;
+	return Keys ? Keys->Get() : nullptr;
+}
+
+FOnInworldReplicatedKeysReceived& Inworld::OnReplicatedKeysReceived()
+{
+	static FOnInworldReplicatedKeysReceived OnReplicatedKeysReceivedDelegate;
+	return OnReplicatedKeysReceivedDelegate;
+}
+
+void Inworld::SerializeReplicatedString(FArchive& Ar, FString& Str, int32 MaxBytes)
+{
+	if (Ar.IsLoading())
+	{
+		uint32 Length = 0;
+		Ar.SerializeIntPacked(Length);
+		if (Ar.IsError() || Length > static_cast<uint32>(MaxBytes))
+		{
+			Ar.SetError();
+			Str.Empty();
+			return;
+		}
+		if (Length == 0)
+		{
+			Str.Empty();
+			return;
+		}
+
+		TArray<ANSICHAR> Bytes;
+		Bytes.SetNumUninitialized(Length);
+		Ar.Serialize(Bytes.GetData(), Length);
+		if (Ar.IsError())
+		{
+			Str.Empty();
+			return;
+		}
+
+		const FUTF8ToTCHAR Converted(Bytes.GetData(), Length);
+		Str = FString(Converted.Length(), Converted.Get());
+	}
+	else
+	{
+		const FTCHARToUTF8 Converted(*Str);
+		uint32 Length = Converted.Length();
+		if (Length > static_cast<uint32>(MaxBytes))
+		{
+			// the reader rejects longer strings, cut before the character straddling the limit
+			Length = MaxBytes;
+			while (Length > 0 && (static_cast<uint8>(Converted.Get()[Length]) & 0xC0) == 0x80)
+			{
+				--Length;
+			}
+			UE_LOG(LogInworldAIClient, Warning, TEXT("Replicated string of %d bytes truncated to %u bytes: %s..."), Converted.Length(), Length, *Str.Left(32));
+		}
+		Ar.SerializeIntPacked(Length);
+		Ar.Serialize(const_cast<ANSICHAR*>(Converted.Get()), Length);
+	}
+}
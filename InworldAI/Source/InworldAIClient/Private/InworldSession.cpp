@@ -25,7 +25,8 @@
 #define EMPTY_ARG_RETURN(Arg, Return) INWORLD_WARN_AND_RETURN_EMPTY(LogInworldAIClient, UInworldSession, Arg, Return)
 #define NO_CLIENT_RETURN(Return) EMPTY_ARG_RETURN(Client, Return)
 #define INVALID_CHARACTER_RETURN(Return) EMPTY_ARG_RETURN(Character, Return) EMPTY_ARG_RETURN(Character->GetAgentInfo().AgentId, Return)
-#define INVALID_PLAYER_RETURN(Return) EMPTY_ARG_RETURN(Player, Return) EMPTY_ARG_RETURN(Player->GetConversationId(), Return)
+// target changes of the frame are committed first, so the conversation has its current participants
+#define INVALID_PLAYER_RETURN(Return) EMPTY_ARG_RETURN(Player, Return) Player->CommitConversationUpdate(); EMPTY_ARG_RETURN(Player->GetConversationId(), Return)
 
 FString ToShortBrainName(const FString& BrainName)
 {
@@ -94,9 +95,21 @@ bool UInworldSession::CallRemoteFunction(UFunction* Function, void* Parms, FOutP
 	return false;
 }
 
+UWorld* UInworldSession::GetTickableGameObjectWorld() const
+{
+	AActor* Owner = GetTypedOuter<AActor>();
+	return Owner ? Owner->GetWorld() : nullptr;
+}
+
+TStatId UInworldSession::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UInworldSession, STATGROUP_Tickables);
+}
+
 void UInworldSession::Init()
 {
 	Client = NewObject<UInworldClient>(this);
+	OnPacketEventBusSubscriptionsChangedHandle = PacketEventBus.OnSubscriptionsChanged().AddUObject(this, &UInworldSession::UpdatePacketSubscriptions);
 	OnClientPacketReceivedHandle = Client->OnPacketReceived().AddUObject(this, &UInworldSession::HandlePacket);
 	OnClientPacketReceivedHandle = Client->OnPrePause().AddLambda(
 		[this]()
@@ -116,6 +129,11 @@ void UInworldSession::Init()
 		[this](EInworldConnectionState InworldConnectionState) -> void
 		{
 			ConnectionState = InworldConnectionState;
+			// requests of a lost connection are never answered
+			if (ConnectionState == EInworldConnectionState::Disconnected || ConnectionState == EInworldConnectionState::Failed)
+			{
+				ForgetRequestedCharacterLoads();
+			}
 			OnRep_ConnectionState();
 		}
 	);
@@ -130,7 +148,7 @@ void UInworldSession::Init()
 
 void UInworldSession::Destroy()
 {
-	TArray<UInworldCharacter*> RegisteredCharactersCopy = RegisteredCharacters;
+	TArray<UInworldCharacter*> RegisteredCharactersCopy = RegisteredCharacters.Get();
 	for (UInworldCharacter* RegisteredCharacter : RegisteredCharactersCopy)
 	{
 		if (RegisteredCharacter == nullptr || RegisteredCharacter->IsReadyForFinishDestroy())
@@ -139,6 +157,7 @@ void UInworldSession::Destroy()
 		}
 		UnregisterCharacter(RegisteredCharacter);
 	}
+	PacketEventBus.OnSubscriptionsChanged().Remove(OnPacketEventBusSubscriptionsChangedHandle);
 	if (IsValid(Client))
 	{
 		Client->OnPacketReceived().Remove(OnClientPacketReceivedHandle);
@@ -186,17 +205,14 @@ void UInworldSession::HandlePacket(const FInworldWrappedPacket& WrappedPacket)
 		}
 		else if (Source.Type == EInworldActorType::PLAYER)
 		{
-			if (TArray<FString>* AgentIds = ConversationIdToAgentIds.Find(ConversationId))
+			if (const FConversationFanOut* FanOut = ConversationFanOuts.Find(ConversationId))
 			{
-				for (const FString& AgentId : *AgentIds)
+				for (const TWeakObjectPtr<UInworldCharacter>& WeakCharacter : FanOut->Characters)
 				{
-					if (AgentId == Target.Name)
-					{
-						continue;
-					}
-					if (UInworldCharacter** TargetCharacter = AgentIdToCharacter.Find(AgentId))
+					UInworldCharacter* TargetCharacter = WeakCharacter.Get();
+					if (TargetCharacter && TargetCharacter->GetAgentInfo().AgentId != Target.Name)
 					{
-						(*TargetCharacter)->HandlePacket(WrappedPacket);
+						TargetCharacter->HandlePacket(WrappedPacket);
 					}
 				}
 			}
@@ -206,6 +222,8 @@ void UInworldSession::HandlePacket(const FInworldWrappedPacket& WrappedPacket)
 		{
 			(*ConversationPlayer)->HandlePacket(WrappedPacket);
 		}
+
+		PacketEventBus.Dispatch(*Packet);
 	}
 }
 
@@ -232,12 +250,15 @@ void UInworldSession::RegisterCharacter(UInworldCharacter* Character)
 			auto AgentInfo = BrainNameToAgentInfo[BrainName];
 			AgentIdToCharacter.Add(AgentInfo.AgentId, Character);
 			Character->Possess(AgentInfo);
+			RebuildConversationFanOuts();
 		}
-		else
+		else if (bAutoLoadCharacters)
 		{
-			Client->LoadCharacter(ToLongBrainName(BrainName, Workspace));
+			QueueCharacterLoad(ToLongBrainName(BrainName, Workspace));
 		}
 	}
+
+	UpdatePacketSubscriptions();
 }
 
 void UInworldSession::UnregisterCharacter(UInworldCharacter* Character)
@@ -253,11 +274,19 @@ void UInworldSession::UnregisterCharacter(UInworldCharacter* Character)
 		return;
 	}
 
+	const FString LongBrainName = ToLongBrainName(BrainName, Workspace);
+	PendingLoadBrainNames.Remove(LongBrainName);
+	RequestedBrainNames.Remove(LongBrainName);
+
+	// unloaded below, possessed again only after a new load
+	BrainNameToAgentInfo.Remove(BrainName);
 	AgentIdToCharacter.Remove(Character->GetAgentInfo().AgentId);
 	BrainNameToCharacter.Remove(BrainName);
 	RegisteredCharacters.Remove(Character);
-	Client->UnloadCharacter(ToLongBrainName(BrainName, Workspace));
+	Client->UnloadCharacter(LongBrainName);
 	Character->Unpossess();
+	RebuildConversationFanOuts();
+	UpdatePacketSubscriptions();
 }
 
 void UInworldSession::RegisterPlayer(UInworldPlayer* Player)
@@ -265,6 +294,7 @@ void UInworldSession::RegisterPlayer(UInworldPlayer* Player)
 	EMPTY_ARG_RETURN(Player, void())
 
 	RegisteredPlayers.Add(Player);
+	UpdatePacketSubscriptions();
 }
 
 void UInworldSession::UnregisterPlayer(UInworldPlayer* Player)
@@ -272,27 +302,38 @@ void UInworldSession::UnregisterPlayer(UInworldPlayer* Player)
 	EMPTY_ARG_RETURN(Player, void())
 
 	RegisteredPlayers.Remove(Player);
+	for (auto It = ConversationIdToPlayer.CreateIterator(); It; ++It)
+	{
+		if (It->Value == Player)
+		{
+			It.RemoveCurrent();
+		}
+	}
+	UpdatePacketSubscriptions();
 }
 
 void UInworldSession::StartSessionFromScene(const FInworldScene& Scene, const FInworldPlayerProfile& PlayerProfile, const FInworldCapabilitySet& CapabilitySet, const TMap<FString, FString>& Metadata, const FString& WorkspaceOverride, const FInworldAuth& AuthOverride)
 {
 	NO_CLIENT_RETURN(void())
 
-	Client->StartSessionFromScene(Scene, PlayerProfile, CapabilitySet, Metadata, WorkspaceOverride, AuthOverride);
+	UpdatePacketSubscriptions();
+	Client->StartSessionFromScene(Scene, PlayerProfile, TrimCapabilities(CapabilitySet), Metadata, WorkspaceOverride, AuthOverride);
 }
 
 void UInworldSession::StartSessionFromSave(const FInworldSave& Save, const FInworldPlayerProfile& PlayerProfile, const FInworldCapabilitySet& CapabilitySet, const TMap<FString, FString>& Metadata, const FString& WorkspaceOverride, const FInworldAuth& AuthOverride)
 {
 	NO_CLIENT_RETURN(void())
 
-	Client->StartSessionFromSave(Save, PlayerProfile, CapabilitySet, Metadata, WorkspaceOverride, AuthOverride);
+	UpdatePacketSubscriptions();
+	Client->StartSessionFromSave(Save, PlayerProfile, TrimCapabilities(CapabilitySet), Metadata, WorkspaceOverride, AuthOverride);
 }
 
 void UInworldSession::StartSessionFromToken(const FInworldToken& Token, const FInworldPlayerProfile& PlayerProfile, const FInworldCapabilitySet& CapabilitySet, const TMap<FString, FString>& Metadata, const FString& WorkspaceOverride, const FInworldAuth& AuthOverride)
 {
 	NO_CLIENT_RETURN(void())
 
-	Client->StartSessionFromToken(Token, PlayerProfile, CapabilitySet, Metadata, WorkspaceOverride, AuthOverride);
+	UpdatePacketSubscriptions();
+	Client->StartSessionFromToken(Token, PlayerProfile, TrimCapabilities(CapabilitySet), Metadata, WorkspaceOverride, AuthOverride);
 }
 
 void UInworldSession::StopSession()
@@ -348,7 +389,79 @@ void UInworldSession::LoadCapabilities(const FInworldCapabilitySet& CapabilitySe
 {
 	NO_CLIENT_RETURN(void())
 
-	Client->LoadCapabilities(CapabilitySet);
+	Client->LoadCapabilities(TrimCapabilities(CapabilitySet));
+}
+
+void UInworldSession::UpdatePacketSubscriptions()
+{
+	// replicated sessions have no client, packets are received on the server
+	if (!IsValid(Client))
+	{
+		return;
+	}
+
+	// listeners bound to the client directly can't be told apart, deliver everything to them
+	if (!bAutoPacketSubscription || Client->OnPacketReceivedDelegate.IsBound())
+	{
+		Client->SetPacketSubscriptionMask(Inworld::AllPacketTypes);
+		return;
+	}
+
+	int32 Mask = AdditionalPacketSubscriptions | PacketEventBus.GetSubscribedPacketTypes();
+	for (const UInworldCharacter* Character : RegisteredCharacters.Get())
+	{
+		if (Character)
+		{
+			Mask |= Character->GetSubscribedPacketTypes();
+		}
+	}
+	for (const UInworldPlayer* Player : RegisteredPlayers.Get())
+	{
+		if (Player)
+		{
+			Mask |= Player->GetSubscribedPacketTypes();
+		}
+	}
+	Client->SetPacketSubscriptionMask(Mask);
+}
+
+int32 UInworldSession::GetDroppedPacketCount(EInworldPacketType Type) const
+{
+	NO_CLIENT_RETURN(0)
+
+	return Client->GetDroppedPacketCount(Type);
+}
+
+FInworldCapabilitySet UInworldSession::TrimCapabilities(const FInworldCapabilitySet& CapabilitySet) const
+{
+	if (!bTrimCapabilities)
+	{
+		return CapabilitySet;
+	}
+
+	const int32 Mask = Client->GetPacketSubscriptionMask();
+	auto IsSubscribed = [Mask](EInworldPacketType Type) { return (Mask & Inworld::PacketTypeBit(Type)) != 0; };
+
+	FInworldCapabilitySet Trimmed = CapabilitySet;
+	if (!IsSubscribed(EInworldPacketType::AudioData))
+	{
+		// phonemes are only sent within audio packets
+		Trimmed.Audio = false;
+		Trimmed.PhonemeInfo = false;
+	}
+	if (!IsSubscribed(EInworldPacketType::Emotion))
+	{
+		Trimmed.Emotions = false;
+	}
+	if (!IsSubscribed(EInworldPacketType::Relation))
+	{
+		Trimmed.Relations = false;
+	}
+	if (!IsSubscribed(EInworldPacketType::A2FHeader) && !IsSubscribed(EInworldPacketType::A2FContent))
+	{
+		Trimmed.Audio2Face = false;
+	}
+	return Trimmed;
 }
 
 void UInworldSession::SaveSession(FOnInworldSessionSavedCallback Callback)
@@ -372,8 +485,8 @@ void UInworldSession::LoadCharacters(const TArray<UInworldCharacter*>& Character
 	EMPTY_ARG_RETURN(Characters, void())
 
 	TArray<FString> Names;
-	Algo::Transform(Characters, Names, [](const UInworldCharacter* C) { return C->GetAgentInfo().BrainName; });
-	Client->LoadCharacters(Names);
+	Algo::Transform(Characters, Names, [this](const UInworldCharacter* C) { return ToLongBrainName(C->GetAgentInfo().BrainName, Workspace); });
+	RequestCharacterLoads(Names);
 }
 
 void UInworldSession::UnloadCharacters(const TArray<UInworldCharacter*>& Characters)
@@ -382,8 +495,20 @@ void UInworldSession::UnloadCharacters(const TArray<UInworldCharacter*>& Charact
 	EMPTY_ARG_RETURN(Characters, void())
 	
 	TArray<FString> Names;
-	Algo::Transform(Characters, Names, [](const UInworldCharacter* C) { return C->GetAgentInfo().BrainName; });
+	Algo::Transform(Characters, Names, [this](const UInworldCharacter* C) { return ToLongBrainName(C->GetAgentInfo().BrainName, Workspace); });
 	Client->UnloadCharacters(Names);
+
+	// forget the agents so the characters are possessed again on the next load
+	for (UInworldCharacter* Character : Characters)
+	{
+		const FString LongBrainName = ToLongBrainName(Character->GetAgentInfo().BrainName, Workspace);
+		PendingLoadBrainNames.Remove(LongBrainName);
+		RequestedBrainNames.Remove(LongBrainName);
+		BrainNameToAgentInfo.Remove(ToShortBrainName(Character->GetAgentInfo().BrainName));
+		AgentIdToCharacter.Remove(Character->GetAgentInfo().AgentId);
+		Character->Unpossess();
+	}
+	RebuildConversationFanOuts();
 }
 
 FString UInworldSession::UpdateConversation(UInworldPlayer* Player)
@@ -545,7 +670,7 @@ void UInworldSession::CancelResponse(UInworldCharacter* Character, const FString
 
 void UInworldSession::ResetConversations()
 {
-	for(auto RegisteredPlayer : RegisteredPlayers)
+	for(auto RegisteredPlayer : RegisteredPlayers.Get())
 	{
 		RegisteredPlayer->ClearAllTargetCharacters();
 	}
@@ -565,10 +690,34 @@ void UInworldSession::GetConnectionError(FString& OutErrorMessage, int32& OutErr
 
 void UInworldSession::PossessAgents(const TArray<FInworldAgentInfo>& AgentInfos)
 {
+	UpdatePacketSubscriptions();
+
+	// answers the oldest load request, characters it didn't load failed or were rejected
+	TSet<FString> RejectedBrainNames;
+	if (bIsLoaded && InFlightLoadBrainNames.Num() > 0)
+	{
+		RejectedBrainNames.Append(InFlightLoadBrainNames[0]);
+		InFlightLoadBrainNames.RemoveAt(0);
+	}
+
+	// the scene loads all its characters, only the relevant ones are kept at start
+	TArray<FString> IrrelevantBrainNames;
 	for (const auto& AgentInfo : AgentInfos)
 	{
 		const FString& BrainName = ToShortBrainName(AgentInfo.BrainName);
+		if (!bIsLoaded && CharacterRelevance.IsBound() && BrainName != FString("__DUMMY__"))
+		{
+			UInworldCharacter* const* Character = BrainNameToCharacter.Find(BrainName);
+			if (Character == nullptr || !CharacterRelevance.Execute(*Character))
+			{
+				IrrelevantBrainNames.Add(ToLongBrainName(BrainName, Workspace));
+				continue;
+			}
+		}
+
 		BrainNameToAgentInfo.Add(BrainName, AgentInfo);
+		RequestedBrainNames.Remove(ToLongBrainName(BrainName, Workspace));
+		RejectedBrainNames.Remove(ToLongBrainName(BrainName, Workspace));
 		if (BrainNameToCharacter.Contains(BrainName))
 		{
 			UInworldCharacter* Character = BrainNameToCharacter[BrainName];
@@ -583,20 +732,34 @@ void UInworldSession::PossessAgents(const TArray<FInworldAgentInfo>& AgentInfos)
 			UE_LOG(LogInworldAIClient, Warning, TEXT("No character found for BrainName: %s"), *BrainName);
 		}
 	}
+	RebuildConversationFanOuts();
 
-	TArray<FString> BrainNames;
-	for (UInworldCharacter* Character : RegisteredCharacters)
+	if (IrrelevantBrainNames.Num() > 0)
 	{
-		const FString BrainName = ToShortBrainName(Character->GetAgentInfo().BrainName);
-		if (!BrainNameToAgentInfo.Contains(BrainName))
+		UE_LOG(LogInworldAIClient, Verbose, TEXT("Unloading %d irrelevant scene character(s)"), IrrelevantBrainNames.Num());
+		Client->UnloadCharacters(IrrelevantBrainNames);
+	}
+
+	for (const FString& RejectedBrainName : RejectedBrainNames)
+	{
+		if (RequestedBrainNames.Remove(RejectedBrainName) > 0)
 		{
-			BrainNames.Add(ToLongBrainName(BrainName, Workspace));
+			UE_LOG(LogInworldAIClient, Warning, TEXT("Character not loaded for BrainName: %s"), *RejectedBrainName);
 		}
 	}
 
-	if (BrainNames.Num() > 0)
+	if (bAutoLoadCharacters)
 	{
-		Client->LoadCharacters(BrainNames);
+		for (UInworldCharacter* Character : RegisteredCharacters.Get())
+		{
+			// rejected ones are requested again by the next registration or load, not in a loop
+			const FString BrainName = ToShortBrainName(Character->GetAgentInfo().BrainName);
+			const FString LongBrainName = ToLongBrainName(BrainName, Workspace);
+			if (!BrainNameToAgentInfo.Contains(BrainName) && !RejectedBrainNames.Contains(LongBrainName))
+			{
+				QueueCharacterLoad(LongBrainName);
+			}
+		}
 	}
 
 	bIsLoaded = true;
@@ -610,17 +773,76 @@ void UInworldSession::UnpossessAgents()
 		return;
 	}
 
-	for (UInworldCharacter* Character : RegisteredCharacters)
+	for (UInworldCharacter* Character : RegisteredCharacters.Get())
 	{
 		Character->Unpossess();
 	}
 
 	AgentIdToCharacter.Empty();
 	BrainNameToAgentInfo.Empty();
+	RebuildConversationFanOuts();
+	PendingLoadBrainNames.Empty();
+	ForgetRequestedCharacterLoads();
 	bIsLoaded = false;
 	OnRep_IsLoaded();
 }
 
+void UInworldSession::QueueCharacterLoad(const FString& BrainName)
+{
+	if (!RequestedBrainNames.Contains(BrainName))
+	{
+		PendingLoadBrainNames.AddUnique(BrainName);
+	}
+}
+
+void UInworldSession::FlushPendingCharacterLoads()
+{
+	if (PendingLoadBrainNames.Num() == 0)
+	{
+		return;
+	}
+
+	TArray<FString> BrainNames = MoveTemp(PendingLoadBrainNames);
+	PendingLoadBrainNames.Reset();
+
+	RequestCharacterLoads(BrainNames);
+}
+
+void UInworldSession::RequestCharacterLoads(const TArray<FString>& BrainNames)
+{
+	NO_CLIENT_RETURN(void())
+
+	RequestedBrainNames.Append(BrainNames);
+	InFlightLoadBrainNames.Add(BrainNames);
+	Client->LoadCharacters(BrainNames);
+}
+
+void UInworldSession::ForgetRequestedCharacterLoads()
+{
+	RequestedBrainNames.Empty();
+	InFlightLoadBrainNames.Empty();
+}
+
+void UInworldSession::RebuildConversationFanOut(FConversationFanOut& FanOut) const
+{
+	FanOut.Characters.Reset(FanOut.AgentIds.Num());
+	for (const FString& AgentId : FanOut.AgentIds)
+	{
+		if (UInworldCharacter* const* Character = AgentIdToCharacter.Find(AgentId))
+		{
+			FanOut.Characters.Add(*Character);
+		}
+	}
+}
+
+void UInworldSession::RebuildConversationFanOuts()
+{
+	for (auto& Entry : ConversationFanOuts)
+	{
+		RebuildConversationFanOut(Entry.Value);
+	}
+}
+
 void UInworldSession::OnRep_IsLoaded()
 {
 	OnLoadedDelegateNative.Broadcast(bIsLoaded);
@@ -645,11 +867,13 @@ void UInworldSession::FInworldSessionPacketVisitor::Visit(const FInworldConversa
 {
 	if (Event.EventType == EInworldConversationUpdateType::EVICTED)
 	{
-		Session->ConversationIdToAgentIds.Remove(Event.Routing.ConversationId);
+		Session->ConversationFanOuts.Remove(Event.Routing.ConversationId);
 	}
 	else
 	{
-		Session->ConversationIdToAgentIds.FindOrAdd(Event.Routing.ConversationId) = Event.Agents;
+		FConversationFanOut& FanOut = Session->ConversationFanOuts.FindOrAdd(Event.Routing.ConversationId);
+		FanOut.AgentIds = Event.Agents;
+		Session->RebuildConversationFanOut(FanOut);
 	}
 	UE_LOG(LogInworldAIClient, Log, TEXT("Conversation %s: %s, %d character(s):"),
 		Event.EventType == EInworldConversationUpdateType::STARTED ? TEXT("STARTED") : Event.EventType == EInworldConversationUpdateType::EVICTED ? TEXT("EVICTED") : TEXT("UPDATED"),
@@ -0,0 +1,281 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#include "InworldSessionGroup.h"
+#include "InworldSession.h"
+#include "InworldCharacter.h"
+#include "InworldPlayer.h"
+#include "InworldMacros.h"
+
+#include "InworldAIClientModule.h"
+
+#include "Runtime/Launch/Resources/Version.h"
+#include "GameFramework/Actor.h"
+
+#define EMPTY_ARG_RETURN(Arg, Return) INWORLD_WARN_AND_RETURN_EMPTY(LogInworldAIClient, UInworldSessionGroup, Arg, Return)
+
+static FVector GetOwnerLocation(const UObject* Object)
+{
+	const AActor* Owner = Object->GetTypedOuter<AActor>();
+	return Owner ? Owner->GetActorLocation() : FVector::ZeroVector;
+}
+
+UWorld* UInworldSessionGroup::GetWorld() const
+{
+	AActor* Owner = GetTypedOuter<AActor>();
+	return Owner ? Owner->GetWorld() : nullptr;
+}
+
+void UInworldSessionGroup::Tick(float DeltaTime)
+{
+	TimeSinceRebalance += DeltaTime;
+	if (TimeSinceRebalance >= RebalanceInterval)
+	{
+		TimeSinceRebalance = 0.f;
+		Rebalance();
+	}
+}
+
+TStatId UInworldSessionGroup::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UInworldSessionGroup, STATGROUP_Tickables);
+}
+
+void UInworldSessionGroup::Init(int32 NumShards)
+{
+	Destroy();
+
+	for (int32 i = 0; i < FMath::Max(NumShards, 1); ++i)
+	{
+		UInworldSession* Shard = NewObject<UInworldSession>(this);
+		Shard->Init();
+		Shards.Add(Shard);
+	}
+}
+
+void UInworldSessionGroup::Destroy()
+{
+	for (UInworldSession* Shard : Shards)
+	{
+		if (IsValid(Shard))
+		{
+			Shard->Destroy();
+#if ENGINE_MAJOR_VERSION == 5
+			Shard->MarkAsGarbage();
+#endif
+
+#if ENGINE_MAJOR_VERSION == 4
+			Shard->MarkPendingKill();
+#endif
+		}
+	}
+	Shards.Empty();
+	StartedShards.Empty();
+	StartParams.Reset();
+	NextCharacterShard = 0;
+	NextPlayerShard = 0;
+}
+
+void UInworldSessionGroup::StartSessionsFromScene(const FInworldScene& Scene, const FInworldPlayerProfile& PlayerProfile, const FInworldCapabilitySet& CapabilitySet, const TMap<FString, FString>& Metadata, const FString& WorkspaceOverride, const FInworldAuth& AuthOverride)
+{
+	StartParams = FStartParams{ Scene, PlayerProfile, CapabilitySet, Metadata, WorkspaceOverride, AuthOverride };
+	for (UInworldSession* Shard : Shards)
+	{
+		StartShard(Shard);
+	}
+}
+
+void UInworldSessionGroup::StopSessions()
+{
+	StartParams.Reset();
+	StartedShards.Empty();
+	for (UInworldSession* Shard : Shards)
+	{
+		Shard->StopSession();
+	}
+}
+
+void UInworldSessionGroup::PauseSessions()
+{
+	for (UInworldSession* Shard : Shards)
+	{
+		Shard->PauseSession();
+	}
+}
+
+void UInworldSessionGroup::ResumeSessions()
+{
+	for (UInworldSession* Shard : Shards)
+	{
+		Shard->ResumeSession();
+	}
+}
+
+void UInworldSessionGroup::RegisterCharacter(UInworldCharacter* Character)
+{
+	EMPTY_ARG_RETURN(Character, void())
+	EMPTY_ARG_RETURN(Shards, void())
+
+	UInworldSession* Shard = GetPreferredShard(Character);
+	if (IsSaturated(Shard))
+	{
+		Shard = GetLeastLoadedShard();
+	}
+	Character->SetSession(Shard);
+	StartShard(Shard);
+}
+
+void UInworldSessionGroup::UnregisterCharacter(UInworldCharacter* Character)
+{
+	EMPTY_ARG_RETURN(Character, void())
+
+	Character->SetSession(nullptr);
+}
+
+void UInworldSessionGroup::RegisterPlayer(UInworldPlayer* Player)
+{
+	EMPTY_ARG_RETURN(Player, void())
+	EMPTY_ARG_RETURN(Shards, void())
+
+	Player->SetSession(Shards[NextPlayerShard++ % Shards.Num()]);
+}
+
+void UInworldSessionGroup::UnregisterPlayer(UInworldPlayer* Player)
+{
+	EMPTY_ARG_RETURN(Player, void())
+
+	Player->SetSession(nullptr);
+}
+
+void UInworldSessionGroup::Rebalance()
+{
+	int32 NumMoves = 0;
+	for (UInworldSession* Shard : Shards)
+	{
+		// copy, moving a character unregisters it from the shard
+		const TArray<UInworldCharacter*> Characters = Shard->GetRegisteredCharacters();
+		for (UInworldCharacter* Character : Characters)
+		{
+			if (NumMoves >= MaxMovesPerRebalance)
+			{
+				return;
+			}
+
+			// moving reloads the character, never interrupt a conversation
+			if (!Character || Character->GetTargetPlayer() != nullptr)
+			{
+				continue;
+			}
+
+			UInworldSession* TargetShard = nullptr;
+			if (Shard->GetRegisteredCharacters().Num() > MaxCharactersPerShard)
+			{
+				TargetShard = GetLeastLoadedShard();
+			}
+			else if (ShardPolicy != EInworldSessionShardPolicy::RoundRobin)
+			{
+				TargetShard = GetPreferredShard(Character);
+			}
+
+			if (!TargetShard || TargetShard == Shard || IsSaturated(TargetShard))
+			{
+				continue;
+			}
+
+			UE_LOG(LogInworldAIClient, Verbose, TEXT("Moving character %s to shard %d"), *Character->GetAgentInfo().BrainName, Shards.IndexOfByKey(TargetShard));
+			Character->SetSession(TargetShard);
+			StartShard(TargetShard);
+			NumMoves++;
+		}
+	}
+}
+
+void UInworldSessionGroup::StartShard(UInworldSession* Shard)
+{
+	if (!StartParams.IsSet() || StartedShards.Contains(Shard))
+	{
+		return;
+	}
+
+	FInworldScene Scene = StartParams->Scene;
+	if (Shards.Num() > 1)
+	{
+		const TArray<UInworldCharacter*>& Characters = Shard->GetRegisteredCharacters();
+		if (Characters.Num() == 0)
+		{
+			return;
+		}
+
+		// starting from the scene would load all of its characters on every shard,
+		// the shard loads the rest of its characters once started
+		Scene.Type = EInworldSceneType::CHARACTER;
+		Scene.Name = Characters[0]->GetAgentInfo().BrainName;
+	}
+
+	StartedShards.Add(Shard);
+	Shard->StartSessionFromScene(Scene, StartParams->PlayerProfile, StartParams->CapabilitySet, StartParams->Metadata, StartParams->WorkspaceOverride, StartParams->AuthOverride);
+}
+
+UInworldSession* UInworldSessionGroup::GetPreferredShard(UInworldCharacter* Character)
+{
+	switch (ShardPolicy)
+	{
+	case EInworldSessionShardPolicy::Region:
+	{
+		const FVector Location = GetOwnerLocation(Character);
+		const FIntPoint Region(FMath::FloorToInt(Location.X / RegionSize), FMath::FloorToInt(Location.Y / RegionSize));
+		return Shards[GetTypeHash(Region) % Shards.Num()];
+	}
+	case EInworldSessionShardPolicy::Conversation:
+	{
+		const FVector Location = GetOwnerLocation(Character);
+		UInworldSession* ClosestShard = nullptr;
+		float ClosestDistSq = MAX_flt;
+		for (UInworldSession* Shard : Shards)
+		{
+			for (UInworldPlayer* Player : Shard->GetRegisteredPlayers())
+			{
+				const float DistSq = FVector::DistSquared(Location, GetOwnerLocation(Player));
+				if (DistSq < ClosestDistSq)
+				{
+					ClosestShard = Shard;
+					ClosestDistSq = DistSq;
+				}
+			}
+		}
+		return ClosestShard ? ClosestShard : GetLeastLoadedShard();
+	}
+	case EInworldSessionShardPolicy::RoundRobin:
+	default:
+		// keep characters where they are once placed
+		if (Character->GetSession() && Shards.Contains(Character->GetSession()))
+		{
+			return Character->GetSession();
+		}
+		return Shards[NextCharacterShard++ % Shards.Num()];
+	}
+}
+
+UInworldSession* UInworldSessionGroup::GetLeastLoadedShard() const
+{
+	UInworldSession* LeastLoadedShard = nullptr;
+	for (UInworldSession* Shard : Shards)
+	{
+		if (!LeastLoadedShard || Shard->GetRegisteredCharacters().Num() < LeastLoadedShard->GetRegisteredCharacters().Num())
+		{
+			LeastLoadedShard = Shard;
+		}
+	}
+	return LeastLoadedShard;
+}
+
+bool UInworldSessionGroup::IsSaturated(const UInworldSession* Shard) const
+{
+	return Shard->GetRegisteredCharacters().Num() >= MaxCharactersPerShard;
+}
+
+#undef EMPTY_ARG_RETURN
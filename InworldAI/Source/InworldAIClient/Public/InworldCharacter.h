@@ -47,6 +47,12 @@ public:
 	UFUNCTION()
 	void HandlePacket(const FInworldWrappedPacket& WrappedPacket);
 
+	/**
+	 * Get the packet types the character has listeners for.
+	 * @return A mask of EInworldPacketType bits.
+	 */
+	int32 GetSubscribedPacketTypes() const;
+
 	/**
 	 * Set the session.
 	 * @param InSession The session to set.
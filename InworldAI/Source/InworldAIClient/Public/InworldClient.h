@@ -16,6 +16,7 @@
 #endif
 
 #include <memory>
+#include <atomic>
 
 #include "InworldClient.generated.h"
 
@@ -361,6 +362,33 @@ public:
 	FOnInworldPacketReceived OnPacketReceivedDelegate;
 	FOnInworldPacketReceivedNative& OnPacketReceived() { return OnPacketReceivedDelegateNative; }
 
+	/**
+	 * Set which packet types are translated and broadcast, other packets are dropped as soon as they are received.
+	 * Control, conversation update and scene status packets are always delivered.
+	 * @param Mask The packet types to deliver.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Packet")
+	void SetPacketSubscriptionMask(UPARAM(meta = (Bitmask, BitmaskEnum = "EInworldPacketType")) int32 Mask);
+	/**
+	 * Get which packet types are translated and broadcast.
+	 * @return The packet types delivered.
+	 */
+	UFUNCTION(BlueprintPure, Category = "Packet")
+	int32 GetPacketSubscriptionMask() const { return PacketSubscriptionMask.load(std::memory_order_relaxed); }
+
+	/**
+	 * Get the number of packets of a type dropped because nothing is subscribed to them.
+	 * @param Type The packet type.
+	 * @return The number of dropped packets.
+	 */
+	UFUNCTION(BlueprintPure, Category = "Packet")
+	int32 GetDroppedPacketCount(EInworldPacketType Type) const;
+	/**
+	 * Reset the dropped packet counters.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Packet")
+	void ResetDroppedPacketCounts();
+
 	/**
 	 * Event dispatcher for when the session is about to pause.
 	 */
@@ -413,6 +441,12 @@ private:
 
 	bool bIsBeingDestroyed = false;
 
+	bool IsPacketTypeSubscribed(EInworldPacketType Type) const;
+
+	// written on the game thread, read on the NDK thread receiving packets
+	std::atomic<int32> PacketSubscriptionMask { Inworld::AllPacketTypes };
+	FThreadSafeCounter DroppedPacketCounts[static_cast<int32>(EInworldPacketType::Count)];
+
 #ifdef INWORLD_WITH_NDK
 #if !UE_BUILD_SHIPPING
 #ifdef INWORLD_AUDIO_DUMP
@@ -150,3 +150,22 @@ enum class EInworldPlayerSpeechMode : uint8
 	VAD_DETECT_ONLY = 1 UMETA(DisplayName="VAD - Detect Only"),
 	VAD_DETECT_AND_FILTER = 2 UMETA(DisplayName="VAD - Detect and Filter"),
 };
+
+UENUM(BlueprintType, meta = (Bitflags, UseEnumValuesAsMaskValuesInEditor = "false"))
+enum class EInworldPacketType : uint8
+{
+	Text,
+	VAD,
+	Data,
+	AudioData,
+	A2FHeader,
+	A2FContent,
+	Silence,
+	Control,
+	ConversationUpdate,
+	CurrentSceneStatus,
+	Emotion,
+	Custom,
+	Relation,
+	Count UMETA(Hidden),
+};
@@ -0,0 +1,142 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InworldPackets.h"
+
+template<typename TEvent>
+struct TInworldPacketTypeOf;
+
+#define INWORLD_PACKET_TYPE_OF(Event, Type) \
+	template<> struct TInworldPacketTypeOf<Event> { static constexpr EInworldPacketType Value = EInworldPacketType::Type; };
+
+INWORLD_PACKET_TYPE_OF(FInworldTextEvent, Text)
+INWORLD_PACKET_TYPE_OF(FInworldVADEvent, VAD)
+INWORLD_PACKET_TYPE_OF(FInworldDataEvent, Data)
+INWORLD_PACKET_TYPE_OF(FInworldAudioDataEvent, AudioData)
+INWORLD_PACKET_TYPE_OF(FInworldA2FHeaderEvent, A2FHeader)
+INWORLD_PACKET_TYPE_OF(FInworldA2FContentEvent, A2FContent)
+INWORLD_PACKET_TYPE_OF(FInworldSilenceEvent, Silence)
+INWORLD_PACKET_TYPE_OF(FInworldControlEvent, Control)
+INWORLD_PACKET_TYPE_OF(FInworldConversationUpdateEvent, ConversationUpdate)
+INWORLD_PACKET_TYPE_OF(FInworldCurrentSceneStatusEvent, CurrentSceneStatus)
+INWORLD_PACKET_TYPE_OF(FInworldEmotionEvent, Emotion)
+INWORLD_PACKET_TYPE_OF(FInworldCustomEvent, Custom)
+INWORLD_PACKET_TYPE_OF(FInworldRelationEvent, Relation)
+
+#undef INWORLD_PACKET_TYPE_OF
+
+/**
+ * Restricts a listener to the packets of one agent or one conversation, empty matches every packet.
+ */
+struct FInworldPacketFilter
+{
+	FInworldPacketFilter() = default;
+
+	static FInworldPacketFilter ForAgent(const FString& AgentId) { FInworldPacketFilter Filter; Filter.AgentId = AgentId; return Filter; }
+	static FInworldPacketFilter ForConversation(const FString& ConversationId) { FInworldPacketFilter Filter; Filter.ConversationId = ConversationId; return Filter; }
+
+	FString AgentId;
+	FString ConversationId;
+};
+
+DECLARE_MULTICAST_DELEGATE(FOnInworldPacketEventBusSubscriptionsChanged);
+
+/**
+ * Dispatches packets to listeners subscribed to their type.
+ * Listeners are bucketed by packet type and filter, so dispatch is a table lookup
+ * that only reaches the listeners interested in the packet.
+ */
+class INWORLDAICLIENT_API FInworldPacketEventBus
+{
+public:
+	using FListener = TFunction<void(const FInworldPacket&)>;
+
+	FInworldPacketEventBus() = default;
+	FInworldPacketEventBus(const FInworldPacketEventBus&) = delete;
+	FInworldPacketEventBus& operator=(const FInworldPacketEventBus&) = delete;
+
+	/**
+	 * Subscribe to packets of a type.
+	 * @param Type The packet type.
+	 * @param Listener The function called with each matching packet.
+	 * @param Filter Restricts the listener to an agent or a conversation.
+	 * @return The handle to unsubscribe with.
+	 */
+	FDelegateHandle Subscribe(EInworldPacketType Type, FListener Listener, const FInworldPacketFilter& Filter = FInworldPacketFilter());
+
+	template<typename TEvent>
+	FDelegateHandle Subscribe(TFunction<void(const TEvent&)> Listener, const FInworldPacketFilter& Filter = FInworldPacketFilter())
+	{
+		return Subscribe(TInworldPacketTypeOf<TEvent>::Value,
+			[Listener = MoveTemp(Listener)](const FInworldPacket& Packet) { Listener(static_cast<const TEvent&>(Packet)); },
+			Filter);
+	}
+
+	/**
+	 * Unsubscribe a listener, safe to call from within a listener.
+	 * @param Handle The handle returned by Subscribe.
+	 */
+	void Unsubscribe(FDelegateHandle Handle);
+	void UnsubscribeAll();
+
+	/**
+	 * Dispatch a packet to the listeners of its type.
+	 * Listeners subscribed during dispatch receive the next packet.
+	 * @param Packet The packet to dispatch.
+	 */
+	void Dispatch(const FInworldPacket& Packet);
+
+	/**
+	 * Get the packet types with at least one listener.
+	 * @return A mask of EInworldPacketType bits.
+	 */
+	int32 GetSubscribedPacketTypes() const;
+	int32 GetNumListeners(EInworldPacketType Type) const;
+
+	FOnInworldPacketEventBusSubscriptionsChanged& OnSubscriptionsChanged() { return OnSubscriptionsChangedDelegate; }
+
+private:
+	struct FListenerEntry
+	{
+		FDelegateHandle Handle;
+		FListener Listener;
+	};
+
+	struct FTypeListeners
+	{
+		TArray<FListenerEntry> Any;
+		TMap<FString, TArray<FListenerEntry>> ByAgent;
+		TMap<FString, TArray<FListenerEntry>> ByConversation;
+		int32 Num = 0;
+	};
+
+	struct FListenerKey
+	{
+		EInworldPacketType Type = EInworldPacketType::Count;
+		FInworldPacketFilter Filter;
+	};
+
+	TArray<FListenerEntry>& FindOrAddListeners(const FListenerKey& Key);
+	TArray<FListenerEntry>* FindListeners(const FListenerKey& Key);
+	void AddListener(const FListenerKey& Key, FListenerEntry&& Entry);
+	void RemoveListener(const FListenerKey& Key, FDelegateHandle Handle);
+	void Invoke(const TArray<FListenerEntry>& KeyListeners, const FInworldPacket& Packet) const;
+	void FlushPending();
+
+	FTypeListeners Listeners[static_cast<int32>(EInworldPacketType::Count)];
+	TMap<FDelegateHandle, FListenerKey> HandleToKey;
+
+	// listeners are not added or removed while their arrays are iterated
+	int32 DispatchDepth = 0;
+	TArray<TPair<FListenerKey, FListenerEntry>> PendingAdds;
+	TArray<TPair<FListenerKey, FDelegateHandle>> PendingRemoves;
+
+	FOnInworldPacketEventBusSubscriptionsChanged OnSubscriptionsChangedDelegate;
+};
@@ -0,0 +1,86 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InworldEnums.h"
+
+#include <atomic>
+
+struct FInworldPacket;
+
+/**
+ * Fixed-size copy of a received packet, strings are truncated to ASCII.
+ */
+struct FInworldPacketLogRecord
+{
+	static constexpr int32 IdLength = 40;
+	static constexpr int32 LabelLength = 32;
+
+	uint64 Sequence = 0;
+	double Time = 0.0;
+	EInworldPacketType Type = EInworldPacketType::Count;
+	EInworldActorType SourceType = EInworldActorType::UNKNOWN;
+	EInworldActorType TargetType = EInworldActorType::UNKNOWN;
+	/** Type specific: text length, chunk size, emotion, control action... */
+	int32 Value0 = 0;
+	int32 Value1 = 0;
+	ANSICHAR SourceName[IdLength] = {};
+	ANSICHAR TargetName[IdLength] = {};
+	ANSICHAR ConversationId[IdLength] = {};
+	ANSICHAR InteractionId[IdLength] = {};
+	ANSICHAR UtteranceId[IdLength] = {};
+	/** Type specific: text or custom event name prefix. */
+	ANSICHAR Label[LabelLength] = {};
+
+	FString ToString() const;
+};
+
+/**
+ * Ring buffer of the latest received packets, enabled with Inworld.Debug.LogAllPackets.
+ * Recording copies into a preallocated slot without locks or allocations,
+ * records are only formatted when dumped with Inworld.Debug.DumpPacketLog or on a crash.
+ */
+class INWORLDAICLIENT_API FInworldPacketLog
+{
+public:
+	static constexpr int32 Capacity = 2048;
+
+	static FInworldPacketLog& Get();
+	static bool IsEnabled();
+
+	/**
+	 * Record a packet, safe to call from any thread.
+	 * @param Packet The packet to record.
+	 */
+	void Record(const FInworldPacket& Packet);
+
+	/**
+	 * Copy the records, oldest first. Slots being written are skipped.
+	 * @param OutRecords The records.
+	 */
+	void GetRecords(TArray<FInworldPacketLogRecord>& OutRecords) const;
+
+	void Dump(FOutputDevice& Ar) const;
+
+private:
+	FInworldPacketLog();
+
+	struct FSlot
+	{
+		// 0 while written, sequence + 1 once the record is complete
+		std::atomic<uint64> Stamp{ 0 };
+		FInworldPacketLogRecord Record;
+	};
+
+	FSlot* GetOrAllocateSlots();
+	void OnHandleSystemError();
+
+	std::atomic<FSlot*> Slots{ nullptr };
+	std::atomic<uint64> NextSequence{ 0 };
+};
@@ -16,39 +16,33 @@
 
 #include "InworldPackets.generated.h"
 
+class FInworldPacketArchive;
+class FInworldReplicatedKeyDictionary;
+
 USTRUCT()
-struct FInworldReplicatedMapStruct
+struct INWORLDAICLIENT_API FInworldReplicatedMapStruct
 {
 	GENERATED_BODY()
 
 	UPROPERTY(NotReplicated)
 	TMap<FString, FString> RepMap;
 
-	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
-	{
-		TArray<FString> ParamKeys;
-		TArray<FString> ParamValues;
-
-		if (Ar.IsLoading())
-		{
-			Ar << ParamKeys;
-			Ar << ParamValues;
-			for (auto It = ParamKeys.CreateConstIterator(); It; ++It)
-			{
-				RepMap.Add(ParamKeys[It.GetIndex()], ParamValues[It.GetIndex()]);
-			}
-		}
-		else
-		{
-			RepMap.GenerateKeyArray(ParamKeys);
-			RepMap.GenerateValueArray(ParamValues);
-			Ar << ParamKeys;
-			Ar << ParamValues;
-		}
-
-		bOutSuccess = true;
-		return true;
-	}
+	/**
+	 * Keys go through the key dictionary of the connection, values that round trip
+	 * as integers, floats or booleans are packed, strings are length prefixed UTF-8.
+	 */
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+	/**
+	 * Serialize against a key dictionary.
+	 * @param Keys The dictionary of the connection, null sends keys inline.
+	 * @return Whether the map was read or written without error.
+	 */
+	bool NetSerializeWithKeys(FArchive& Ar, FInworldReplicatedKeyDictionary* Keys);
+
+	/** Bounds checked on read against malformed input, writes are truncated to them with a warning. */
+	static constexpr int32 MaxNum = 1024;
+	static constexpr int32 MaxValueBytes = 64 * 1024;
 };
 
 template<>
@@ -73,6 +67,7 @@ struct INWORLDAICLIENT_API FInworldActor
 	{}
 
 	void Serialize(FMemoryArchive& Ar);
+	void SerializeCompact(FInworldPacketArchive& Ar);
 
 	void AppendDebugString(FString& Str) const;
 
@@ -96,6 +91,7 @@ struct INWORLDAICLIENT_API FInworldRouting
 	{}
 
 	void Serialize(FMemoryArchive& Ar);
+	void SerializeCompact(FInworldPacketArchive& Ar);
 
 	void AppendDebugString(FString& Str) const;
 
@@ -121,6 +117,7 @@ struct INWORLDAICLIENT_API FInworldPacketId
 	{}
 
 	void Serialize(FMemoryArchive & Ar);
+	void SerializeCompact(FInworldPacketArchive& Ar);
 
 	void AppendDebugString(FString& Str) const;
 
@@ -169,6 +166,82 @@ public:
 	virtual void Visit(const FInworldRelationEvent& Event) {  }
 };
 
+namespace Inworld
+{
+	constexpr int32 PacketTypeBit(EInworldPacketType Type) { return 1 << static_cast<int32>(Type); }
+
+	constexpr int32 AllPacketTypes = (1 << static_cast<int32>(EInworldPacketType::Count)) - 1;
+
+	// session state (scene loading, conversations, interaction end) is driven by these, they are never dropped
+	constexpr int32 RequiredPacketTypes =
+		PacketTypeBit(EInworldPacketType::Control) |
+		PacketTypeBit(EInworldPacketType::ConversationUpdate) |
+		PacketTypeBit(EInworldPacketType::CurrentSceneStatus);
+}
+
+/**
+ * Strings interned by the packets of one stream, e.g. agent, interaction and utterance ids.
+ * The reader must see the packets in the order they were written.
+ */
+struct FInworldPacketNameTable
+{
+	void Reset() { Names.Reset(); NameToIndex.Reset(); }
+
+	TArray<FString> Names;
+	TMap<FString, int32> NameToIndex;
+};
+
+/**
+ * Compact packet format: UTF-8 strings, varint lengths and integers, optionally interned ids.
+ * Reads are bounds checked, malformed data sets the error flag instead of reading past the end.
+ */
+class INWORLDAICLIENT_API FInworldPacketArchive
+{
+public:
+	static constexpr uint8 CurrentVersion = 1;
+
+	FInworldPacketArchive(FArchive& InInner, uint8 InVersion = CurrentVersion, FInworldPacketNameTable* InNameTable = nullptr)
+		: Inner(InInner)
+		, Version(InVersion)
+		, NameTable(InNameTable)
+	{}
+
+	bool IsLoading() const { return Inner.IsLoading(); }
+	bool IsError() const { return bError || Inner.IsError(); }
+	void SetError() { bError = true; }
+	uint8 GetVersion() const { return Version; }
+
+	void SerializeVarUInt(uint64& Value);
+	void SerializeVarInt(int32& Value);
+	void SerializeByte(uint8& Value);
+	void SerializeBool(bool& Value);
+	void SerializeFloat(float& Value);
+	void SerializeDouble(double& Value);
+	void SerializeBytes(TArray<uint8>& Bytes);
+	void SerializeString(FString& Str);
+	// written as a reference when the string was already written to the stream's name table
+	void SerializeName(FString& Str);
+	// element count of an array that follows, rejects counts larger than the remaining data on load
+	void SerializeCount(int32& Count, int32 MinElementSize = 1);
+
+	template<typename TEnum>
+	void SerializeEnum(TEnum& Value)
+	{
+		uint8 Byte = static_cast<uint8>(Value);
+		SerializeByte(Byte);
+		Value = static_cast<TEnum>(Byte);
+	}
+
+private:
+	void SerializeRaw(void* Data, int64 Num);
+	int64 GetRemaining() const;
+
+	FArchive& Inner;
+	uint8 Version;
+	FInworldPacketNameTable* NameTable;
+	bool bError = false;
+};
+
 struct FInworldPacket;
 
 USTRUCT(BlueprintType)
@@ -197,8 +270,11 @@ struct INWORLDAICLIENT_API FInworldPacket
 	virtual ~FInworldPacket() = default;
 
 	virtual void Accept(InworldPacketVisitor& Visitor) {}
+	virtual EInworldPacketType GetPacketType() const { return EInworldPacketType::Count; }
 
+	// legacy format, kept readable for existing data
 	virtual void Serialize(FMemoryArchive& Ar);
+	virtual void SerializeCompact(FInworldPacketArchive& Ar);
 
 	FString ToDebugString() const;
 
@@ -219,6 +295,8 @@ struct INWORLDAICLIENT_API FInworldVADEvent : public FInworldPacket
 	virtual ~FInworldVADEvent() = default;
 
 	virtual void Accept(InworldPacketVisitor& Visitor) override { Visitor.Visit(*this); }
+	virtual EInworldPacketType GetPacketType() const override { return EInworldPacketType::VAD; }
+	virtual void SerializeCompact(FInworldPacketArchive& Ar) override;
 
 	UPROPERTY()
 	bool VoiceDetected = false;
@@ -235,6 +313,8 @@ struct INWORLDAICLIENT_API FInworldTextEvent : public FInworldPacket
 	virtual ~FInworldTextEvent() = default;
 
 	virtual void Accept(InworldPacketVisitor& Visitor) override { Visitor.Visit(*this); }
+	virtual EInworldPacketType GetPacketType() const override { return EInworldPacketType::Text; }
+	virtual void SerializeCompact(FInworldPacketArchive& Ar) override;
 
 	UPROPERTY()
 	FString Text;
@@ -253,6 +333,8 @@ struct INWORLDAICLIENT_API FInworldDataEvent : public FInworldPacket
 	virtual ~FInworldDataEvent() = default;
 
 	virtual void Accept(InworldPacketVisitor & Visitor) override { Visitor.Visit(*this); }
+	virtual EInworldPacketType GetPacketType() const override { return EInworldPacketType::Data; }
+	virtual void SerializeCompact(FInworldPacketArchive& Ar) override;
 
 	virtual void Serialize(FMemoryArchive& Ar) override;
 
@@ -269,6 +351,7 @@ struct INWORLDAICLIENT_API FInworldVisemeInfo
 	FInworldVisemeInfo() = default;
 
 	void Serialize(FMemoryArchive& Ar);
+	void SerializeCompact(FInworldPacketArchive& Ar);
 
 	FString Code;
 	float Timestamp = 0.f;
@@ -283,6 +366,8 @@ struct INWORLDAICLIENT_API FInworldAudioDataEvent : public FInworldDataEvent
 	virtual ~FInworldAudioDataEvent() = default;
 
 	virtual void Accept(InworldPacketVisitor& Visitor) override { Visitor.Visit(*this); }
+	virtual EInworldPacketType GetPacketType() const override { return EInworldPacketType::AudioData; }
+	virtual void SerializeCompact(FInworldPacketArchive& Ar) override;
 
 	static void ConvertToReplicatableEvents(const FInworldAudioDataEvent& Event, TArray<FInworldAudioDataEvent>& RepEvents);
 
@@ -303,6 +388,10 @@ struct INWORLDAICLIENT_API FInworldA2FHeaderEvent : public FInworldPacket
 	virtual ~FInworldA2FHeaderEvent() = default;
 
 	virtual void Accept(InworldPacketVisitor& Visitor) override { Visitor.Visit(*this); }
+	virtual EInworldPacketType GetPacketType() const override { return EInworldPacketType::A2FHeader; }
+	virtual void SerializeCompact(FInworldPacketArchive& Ar) override;
+
+	virtual void Serialize(FMemoryArchive& Ar) override;
 
 	int32 ChannelCount = 0;
 	int32 SamplesPerSecond = 0;
@@ -317,7 +406,7 @@ struct FInworldA2FAudioInfo
 {
 	GENERATED_BODY()
 
-	double TimeCode;
+	double TimeCode = 0.0;
 	TArray<uint8> Audio;
 };
 
@@ -326,7 +415,7 @@ struct FInworldA2FBlendShapeWeights
 {
 	GENERATED_BODY()
 
-	double TimeCode;
+	double TimeCode = 0.0;
 	TArray<float> Values;
 };
 
@@ -339,6 +428,12 @@ struct INWORLDAICLIENT_API FInworldA2FContentEvent : public FInworldPacket
 	virtual ~FInworldA2FContentEvent() = default;
 
 	virtual void Accept(InworldPacketVisitor& Visitor) override { Visitor.Visit(*this); }
+	virtual EInworldPacketType GetPacketType() const override { return EInworldPacketType::A2FContent; }
+	virtual void SerializeCompact(FInworldPacketArchive& Ar) override;
+
+	static void ConvertToReplicatableEvents(const FInworldA2FContentEvent& Event, TArray<FInworldA2FContentEvent>& RepEvents);
+
+	virtual void Serialize(FMemoryArchive& Ar) override;
 
 	FInworldA2FAudioInfo AudioInfo;
 	FInworldA2FBlendShapeWeights BlendShapeWeights;
@@ -355,6 +450,8 @@ struct INWORLDAICLIENT_API FInworldSilenceEvent : public FInworldPacket
 	virtual ~FInworldSilenceEvent() = default;
 
 	virtual void Accept(InworldPacketVisitor & Visitor) override { Visitor.Visit(*this); }
+	virtual EInworldPacketType GetPacketType() const override { return EInworldPacketType::Silence; }
+	virtual void SerializeCompact(FInworldPacketArchive& Ar) override;
 
 	UPROPERTY()
 	float Duration = 0.f;
@@ -371,6 +468,8 @@ struct INWORLDAICLIENT_API FInworldControlEvent : public FInworldPacket
 	virtual ~FInworldControlEvent() = default;
 
 	virtual void Accept(InworldPacketVisitor & Visitor) override { Visitor.Visit(*this); }
+	virtual EInworldPacketType GetPacketType() const override { return EInworldPacketType::Control; }
+	virtual void SerializeCompact(FInworldPacketArchive& Ar) override;
 
 	UPROPERTY()
 	EInworldControlEventAction Action = EInworldControlEventAction::UNKNOWN;
@@ -390,6 +489,8 @@ struct INWORLDAICLIENT_API FInworldConversationUpdateEvent : public FInworldCont
 	virtual ~FInworldConversationUpdateEvent() = default;
 
 	virtual void Accept(InworldPacketVisitor& Visitor) override { Visitor.Visit(*this); }
+	virtual EInworldPacketType GetPacketType() const override { return EInworldPacketType::ConversationUpdate; }
+	virtual void SerializeCompact(FInworldPacketArchive& Ar) override;
 
 	UPROPERTY()
 	TArray<FString> Agents;
@@ -410,6 +511,8 @@ struct INWORLDAICLIENT_API FInworldCurrentSceneStatusEvent : public FInworldCont
 	virtual ~FInworldCurrentSceneStatusEvent() = default;
 
 	virtual void Accept(InworldPacketVisitor& Visitor) override { Visitor.Visit(*this); }
+	virtual EInworldPacketType GetPacketType() const override { return EInworldPacketType::CurrentSceneStatus; }
+	virtual void SerializeCompact(FInworldPacketArchive& Ar) override;
 
 	FString SceneName;
 	FString SceneDescription;
@@ -429,6 +532,8 @@ struct INWORLDAICLIENT_API FInworldEmotionEvent : public FInworldPacket
 	virtual ~FInworldEmotionEvent() = default;
 
 	virtual void Accept(InworldPacketVisitor & Visitor) override { Visitor.Visit(*this); }
+	virtual EInworldPacketType GetPacketType() const override { return EInworldPacketType::Emotion; }
+	virtual void SerializeCompact(FInworldPacketArchive& Ar) override;
 	
 	UPROPERTY()
 	EInworldCharacterEmotionalBehavior Behavior = EInworldCharacterEmotionalBehavior::NEUTRAL;
@@ -447,6 +552,8 @@ struct INWORLDAICLIENT_API FInworldCustomEvent : public FInworldPacket
 	virtual ~FInworldCustomEvent() = default;
 
 	virtual void Accept(InworldPacketVisitor & Visitor) override { Visitor.Visit(*this); }
+	virtual EInworldPacketType GetPacketType() const override { return EInworldPacketType::Custom; }
+	virtual void SerializeCompact(FInworldPacketArchive& Ar) override;
 		
 	UPROPERTY()
 	FString Name;
@@ -466,6 +573,8 @@ struct INWORLDAICLIENT_API FInworldRelationEvent : public FInworldPacket
 	virtual ~FInworldRelationEvent() = default;
 
 	virtual void Accept(InworldPacketVisitor& Visitor) override { Visitor.Visit(*this); }
+	virtual EInworldPacketType GetPacketType() const override { return EInworldPacketType::Relation; }
+	virtual void SerializeCompact(FInworldPacketArchive& Ar) override;
 
 	UPROPERTY()
 	int32 Attraction = 0;
@@ -484,3 +593,30 @@ struct INWORLDAICLIENT_API FInworldRelationEvent : public FInworldPacket
 
 	virtual void AppendDebugString(FString& Str) const override;
 };
+
+namespace Inworld
+{
+	/**
+	 * Create an empty packet of a type.
+	 * @param Type The packet type.
+	 * @return The packet, invalid for unknown types.
+	 */
+	INWORLDAICLIENT_API TSharedPtr<FInworldPacket> MakePacket(EInworldPacketType Type);
+
+	/**
+	 * Write a packet in the compact format, prefixed with a header holding the version and type.
+	 * @param Ar The archive to write to.
+	 * @param Packet The packet to write.
+	 * @param NameTable The name table of the stream to intern ids with, nullptr to write them in full.
+	 */
+	INWORLDAICLIENT_API void WritePacket(FMemoryArchive& Ar, FInworldPacket& Packet, FInworldPacketNameTable* NameTable = nullptr);
+
+	/**
+	 * Read a packet in the compact format, or in the legacy format if the data has no compact header.
+	 * @param Ar The archive to read from.
+	 * @param NameTable The name table of the stream, required if the packet was written with one.
+	 * @param LegacyType The type of the packet if the data is in the legacy format, which has no type tag.
+	 * @return The packet, invalid if the data is malformed.
+	 */
+	INWORLDAICLIENT_API TSharedPtr<FInworldPacket> ReadPacket(FMemoryArchive& Ar, FInworldPacketNameTable* NameTable = nullptr, EInworldPacketType LegacyType = EInworldPacketType::Count);
+}
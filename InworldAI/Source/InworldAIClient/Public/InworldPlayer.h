@@ -12,9 +12,11 @@
 #include "UObject/Interface.h"
 #include "UObject/NoExportTypes.h"
 #include "GameFramework/Actor.h"
+#include "Tickable.h"
 #include "InworldEnums.h"
 #include "InworldTypes.h"
 #include "InworldPackets.h"
+#include "InworldReplicatedArrays.h"
 #include "InworldPlayer.generated.h"
 
 class UInworldSession;
@@ -34,7 +36,7 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnInworldPlayerVoiceDetection, bool
 DECLARE_MULTICAST_DELEGATE_OneParam(FOnInworldPlayerVoiceDetectionNative, bool /*bVoiceDetected*/);
 
 UCLASS(BlueprintType)
-class INWORLDAICLIENT_API UInworldPlayer : public UObject
+class INWORLDAICLIENT_API UInworldPlayer : public UObject, public FTickableGameObject
 {
 	GENERATED_BODY()
 public:
@@ -50,6 +52,15 @@ public:
 	virtual bool CallRemoteFunction(UFunction* Function, void* Parms, struct FOutParmRec* OutParms, FFrame* Stack) override;
 	// ~UObject
 
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return bConversationUpdatePending && Session.IsValid(); }
+	virtual bool IsTickableInEditor() const override { return true; }
+	virtual ETickableTickType GetTickableTickType() const override { return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Conditional; }
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	virtual TStatId GetStatId() const override;
+	// ~FTickableGameObject
+
 public:
 	/**
 	 * Handle the incoming packet.
@@ -58,6 +69,12 @@ public:
 	UFUNCTION()
 	void HandlePacket(const FInworldWrappedPacket& WrappedPacket);
 
+	/**
+	 * Get the packet types the player handles.
+	 * @return A mask of EInworldPacketType bits.
+	 */
+	int32 GetSubscribedPacketTypes() const;
+
 	/**
 	 * Set the session.
 	 * @param InSession The session to set.
@@ -128,7 +145,7 @@ public:
 	 * @return An array of target characters.
 	 */
 	UFUNCTION(BlueprintPure, Category = "Target")
-	const TArray<UInworldCharacter*>& GetTargetCharacters() const { return TargetCharacters; }
+	const TArray<UInworldCharacter*>& GetTargetCharacters() const { return TargetCharacters.Get(); }
 
 	/**
 	 * Add a target character to the conversation.
@@ -171,6 +188,13 @@ public:
 	FOnInworldPlayerTargetCharactersChanged OnTargetCharactersChangedDelegate;
 	FOnInworldPlayerTargetCharactersChangedNative& OnTargetCharactersChanged() { return OnTargetCharactersChangedDelegateNative; }
 
+	/**
+	 * Send pending target and participation changes to the conversation now instead of at the end of the frame.
+	 * Nothing is sent if the changes cancelled each other out.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Conversation")
+	void CommitConversationUpdate();
+
 	/**
 	 * Get the conversation ID.
 	 * @return The conversation ID.
@@ -196,6 +220,8 @@ public:
 	EInworldMicrophoneMode GetMicMode() const { return AudioSessionOptions.MicrophoneMode; }
 
 private:
+	void RequestConversationUpdate();
+	bool HasConversationChanged() const;
 	void UpdateConversation();
 
 private:
@@ -209,7 +235,7 @@ private:
 	bool bConversationParticipant = true;
 
 	UPROPERTY(Replicated)
-	TArray<UInworldCharacter*> TargetCharacters;
+	FInworldCharacterArray TargetCharacters;
 
 	UPROPERTY(ReplicatedUsing=OnRep_VoiceDetected)
 	bool bVoiceDetected = false;
@@ -222,6 +248,11 @@ private:
 	FString ConversationId;
 	FOnInworldPlayerConversationChangedNative OnConversationChangedDelegateNative;
 
+	// participants sent with the last conversation update
+	TArray<TWeakObjectPtr<UInworldCharacter>> ConversationCharacters;
+	bool bConversationCharactersParticipant = false;
+	bool bConversationUpdatePending = false;
+
 	FInworldAudioSessionOptions AudioSessionOptions;
 	bool bHasAudioSession = false;
 
@@ -0,0 +1,118 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Net/Serialization/FastArraySerializer.h"
+
+#include "InworldReplicatedArrays.generated.h"
+
+class UInworldCharacter;
+class UInworldPlayer;
+
+USTRUCT()
+struct INWORLDAICLIENT_API FInworldCharacterArrayItem : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	UInworldCharacter* Character = nullptr;
+};
+
+/**
+ * Array of characters replicated with delta updates.
+ * Keeps a flat array of the resolved characters for iteration on both server and clients.
+ */
+USTRUCT()
+struct INWORLDAICLIENT_API FInworldCharacterArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	bool Add(UInworldCharacter* Character);
+	bool Remove(UInworldCharacter* Character);
+	void Empty();
+
+	const TArray<UInworldCharacter*>& Get() const { return Characters; }
+
+	void PreReplicatedRemove(const TArrayView<int32>& RemovedIndices, int32 FinalSize);
+	void PostReplicatedAdd(const TArrayView<int32>& AddedIndices, int32 FinalSize);
+	void PostReplicatedChange(const TArrayView<int32>& ChangedIndices, int32 FinalSize);
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FInworldCharacterArrayItem, FInworldCharacterArray>(Items, DeltaParms, *this);
+	}
+
+private:
+	UPROPERTY()
+	TArray<FInworldCharacterArrayItem> Items;
+
+	/** Resolved objects of the items, a property so the garbage collector sees them. */
+	UPROPERTY(NotReplicated)
+	TArray<UInworldCharacter*> Characters;
+};
+
+template<>
+struct TStructOpsTypeTraits<FInworldCharacterArray> : public TStructOpsTypeTraitsBase2<FInworldCharacterArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+USTRUCT()
+struct INWORLDAICLIENT_API FInworldPlayerArrayItem : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	UInworldPlayer* Player = nullptr;
+};
+
+/**
+ * Array of players replicated with delta updates.
+ * Keeps a flat array of the resolved players for iteration on both server and clients.
+ */
+USTRUCT()
+struct INWORLDAICLIENT_API FInworldPlayerArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	bool Add(UInworldPlayer* Player);
+	bool Remove(UInworldPlayer* Player);
+	void Empty();
+
+	const TArray<UInworldPlayer*>& Get() const { return Players; }
+
+	void PreReplicatedRemove(const TArrayView<int32>& RemovedIndices, int32 FinalSize);
+	void PostReplicatedAdd(const TArrayView<int32>& AddedIndices, int32 FinalSize);
+	void PostReplicatedChange(const TArrayView<int32>& ChangedIndices, int32 FinalSize);
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FInworldPlayerArrayItem, FInworldPlayerArray>(Items, DeltaParms, *this);
+	}
+
+private:
+	UPROPERTY()
+	TArray<FInworldPlayerArrayItem> Items;
+
+	/** Resolved objects of the items, a property so the garbage collector sees them. */
+	UPROPERTY(NotReplicated)
+	TArray<UInworldPlayer*> Players;
+};
+
+template<>
+struct TStructOpsTypeTraits<FInworldPlayerArray> : public TStructOpsTypeTraitsBase2<FInworldPlayerArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
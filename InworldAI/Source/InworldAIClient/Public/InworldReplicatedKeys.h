@@ -0,0 +1,102 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UNetConnection;
+
+/**
+ * Map keys replicated over one connection, so repeated keys are sent as an index.
+ * A key is sent with its definition until the receiver acknowledges it, so keys
+ * referenced from different actor channels never arrive before their definition.
+ * Limits on counts and lengths apply to both sides, the sender truncates what's over them with a warning.
+ * Without acknowledgements every key keeps its definition and replication stays correct.
+ */
+class INWORLDAICLIENT_API FInworldReplicatedKeyDictionary
+{
+public:
+	static constexpr int32 MaxKeys = 1024;
+	static constexpr int32 MaxKeyBytes = 1024;
+
+	/**
+	 * Write or read a key.
+	 * @param Ar The archive, sets an error on malformed or unknown keys.
+	 * @param Key The key.
+	 * @param Keys The dictionary of the connection, null sends the key inline.
+	 */
+	static void SerializeKey(FArchive& Ar, FString& Key, FInworldReplicatedKeyDictionary* Keys);
+
+	/**
+	 * Sender side: the receiver has the keys with these indices.
+	 * Indices need not be consecutive, a key whose write was discarded doesn't hold back later keys.
+	 * @param Indices The indices acknowledged, indices of keys never sent are ignored.
+	 */
+	void Acknowledge(TArrayView<const int32> Indices);
+	int32 GetNumAcknowledged() const { return NumAcknowledged; }
+	int32 GetNumSent() const { return SentKeyToIndex.Num(); }
+
+	/**
+	 * Receiver side: get the acknowledgement to send back, once per key.
+	 * @param OutIndices The indices of keys received since the last acknowledgement.
+	 * @return Whether there is a new acknowledgement.
+	 */
+	bool ConsumeAcknowledgement(TArray<int32>& OutIndices);
+	bool HasPendingAcknowledgement() const { return PendingAcknowledgements.Num() > 0; }
+
+private:
+	enum class EKeyKind : uint32
+	{
+		Reference = 0,
+		Define = 1,
+		Inline = 2,
+	};
+
+	int32 FindOrAddSentKey(const FString& Key);
+	void AddReceivedKey(int32 Index, const FString& Key);
+	const FString* FindReceivedKey(int32 Index) const;
+
+	/** Keys that differ only in case are different keys. */
+	struct FCaseSensitiveKeyFuncs : TDefaultMapKeyFuncs<FString, int32, false>
+	{
+		static FORCEINLINE bool Matches(const FString& A, const FString& B) { return A.Equals(B, ESearchCase::CaseSensitive); }
+		static FORCEINLINE uint32 GetKeyHash(const FString& Key) { return FCrc::StrCrc32(*Key); }
+	};
+
+	TMap<FString, int32, FDefaultSetAllocator, FCaseSensitiveKeyFuncs> SentKeyToIndex;
+	TBitArray<> AcknowledgedKeyMask;
+	int32 NumAcknowledged = 0;
+
+	TArray<FString> ReceivedKeys;
+	TBitArray<> ReceivedKeyMask;
+	TArray<int32> PendingAcknowledgements;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnInworldReplicatedKeysReceived, UNetConnection* /*Connection*/);
+
+namespace Inworld
+{
+	/**
+	 * Get the key dictionary of a connection, it lives as long as the connection.
+	 * @return Null for a null connection.
+	 */
+	INWORLDAICLIENT_API FInworldReplicatedKeyDictionary* FindOrAddReplicatedKeys(UNetConnection* Connection);
+	INWORLDAICLIENT_API FInworldReplicatedKeyDictionary* FindReplicatedKeys(UNetConnection* Connection);
+
+	/**
+	 * Broadcast when a connection received new keys to acknowledge.
+	 * Called during net serialization, listeners should defer sending the acknowledgement.
+	 */
+	INWORLDAICLIENT_API FOnInworldReplicatedKeysReceived& OnReplicatedKeysReceived();
+
+	/**
+	 * Write or read a string as a packed length followed by UTF-8.
+	 * @param MaxBytes Longer strings are truncated at a character boundary with a warning when writing, and set an error on the archive when reading.
+	 */
+	INWORLDAICLIENT_API void SerializeReplicatedString(FArchive& Ar, FString& Str, int32 MaxBytes);
+}
@@ -11,11 +11,14 @@
 #include "UObject/Interface.h"
 #include "UObject/NoExportTypes.h"
 #include "GameFramework/Actor.h"
+#include "Tickable.h"
 #include "InworldClient.h"
 #include "InworldTypes.h"
 #include "InworldPackets.h"
+#include "InworldPacketEventBus.h"
 #include "InworldEnums.h"
 #include "InworldPlayer.h"
+#include "InworldReplicatedArrays.h"
 #include "InworldSession.generated.h"
 
 class UInworldPlayer;
@@ -46,8 +49,10 @@ DECLARE_MULTICAST_DELEGATE_OneParam(FOnInworldCustomEventNative, const FInworldC
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnInworldSessionLoaded, bool, bLoaded);
 DECLARE_MULTICAST_DELEGATE_OneParam(FOnInworldSessionLoadedNative, bool /*bLoaded*/);
 
+DECLARE_DELEGATE_RetVal_OneParam(bool, FInworldCharacterRelevanceNative, const UInworldCharacter* /*Character*/);
+
 UCLASS(BlueprintType)
-class INWORLDAICLIENT_API UInworldSession : public UObject
+class INWORLDAICLIENT_API UInworldSession : public UObject, public FTickableGameObject
 {
 	GENERATED_BODY()
 public:
@@ -63,6 +68,15 @@ public:
 	virtual bool CallRemoteFunction(UFunction* Function, void* Parms, struct FOutParmRec* OutParms, FFrame* Stack) override;
 	// ~UObject
 
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override { FlushPendingCharacterLoads(); }
+	virtual bool IsTickable() const override { return PendingLoadBrainNames.Num() > 0; }
+	virtual bool IsTickableInEditor() const override { return true; }
+	virtual ETickableTickType GetTickableTickType() const override { return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Conditional; }
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	virtual TStatId GetStatId() const override;
+	// ~FTickableGameObject
+
 public:
 	/**
 	 * Initialize the client.
@@ -90,6 +104,13 @@ public:
 	UFUNCTION()
 	void HandlePacket(const FInworldWrappedPacket& WrappedPacket);
 
+	/**
+	 * Get the packet event bus, packets handled by the session are dispatched to its listeners by type.
+	 * Packet types with listeners are added to the packet subscription.
+	 * @return The packet event bus.
+	 */
+	FInworldPacketEventBus& GetPacketEventBus() { return PacketEventBus; }
+
 	/**
 	 * Register a character.
 	 * @param Character The character to register.
@@ -109,7 +130,12 @@ public:
 	 * @return An array of registered characters.
 	 */
 	UFUNCTION(BlueprintPure, Category = "Register")
-	const TArray<UInworldCharacter*>& GetRegisteredCharacters() const { return RegisteredCharacters; }
+	const TArray<UInworldCharacter*>& GetRegisteredCharacters() const { return RegisteredCharacters.Get(); }
+
+	/**
+	 * Get the agents loaded on the connection by short brain name, whether or not a character possesses them.
+	 */
+	const TMap<FString, FInworldAgentInfo>& GetLoadedAgents() const { return BrainNameToAgentInfo; }
 
 	/**
 	 * Register a player.
@@ -130,7 +156,7 @@ public:
 	 * @return An array of registered players.
 	 */
 	UFUNCTION(BlueprintPure, Category = "Register")
-	const TArray<UInworldPlayer*>& GetRegisteredPlayers() const { return RegisteredPlayers; }
+	const TArray<UInworldPlayer*>& GetRegisteredPlayers() const { return RegisteredPlayers.Get(); }
 
     /**
 	 * Start a session from a scene.
@@ -262,6 +288,84 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Load|Character")
 	void UnloadCharacters(const TArray<UInworldCharacter*>& Characters);
 
+	/**
+	 * Set whether registered characters are loaded automatically once the session is loaded.
+	 * Disable to load and unload characters manually, e.g. by distance to the players.
+	 * @param bInAutoLoadCharacters Whether to load registered characters automatically.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Load|Character")
+	void SetAutoLoadCharacters(bool bInAutoLoadCharacters) { bAutoLoadCharacters = bInAutoLoadCharacters; }
+	/**
+	 * Check if registered characters are loaded automatically.
+	 * @return True if registered characters are loaded automatically, false otherwise.
+	 */
+	UFUNCTION(BlueprintPure, Category = "Load|Character")
+	bool GetAutoLoadCharacters() const { return bAutoLoadCharacters; }
+
+	/**
+	 * Set which characters are possessed when the session starts. The scene's agents of unregistered
+	 * or irrelevant characters are unloaded right away instead, load them with LoadCharacters once relevant.
+	 * Unbound, every registered character is possessed.
+	 */
+	void SetCharacterRelevance(FInworldCharacterRelevanceNative InCharacterRelevance) { CharacterRelevance = MoveTemp(InCharacterRelevance); }
+
+	/**
+	 * Set whether the client only delivers packet types registered characters and players listen to.
+	 * Packets of other types are dropped before they are translated. Off by default: the subscription is
+	 * built when characters and players register, delegates bound later need UpdatePacketSubscriptions.
+	 * @param bInAutoPacketSubscription Whether to build the packet subscription from the bound delegates.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Packet")
+	void SetAutoPacketSubscription(bool bInAutoPacketSubscription) { bAutoPacketSubscription = bInAutoPacketSubscription; UpdatePacketSubscriptions(); }
+	/**
+	 * Check if the packet subscription is built from the bound delegates.
+	 * @return True if the packet subscription is automatic, false if every packet is delivered.
+	 */
+	UFUNCTION(BlueprintPure, Category = "Packet")
+	bool GetAutoPacketSubscription() const { return bAutoPacketSubscription; }
+
+	/**
+	 * Set packet types to deliver in addition to the ones registered characters and players listen to,
+	 * e.g. for listeners bound to the client directly.
+	 * @param Mask The additional packet types.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Packet")
+	void SetAdditionalPacketSubscriptions(UPARAM(meta = (Bitmask, BitmaskEnum = "EInworldPacketType")) int32 Mask) { AdditionalPacketSubscriptions = Mask; UpdatePacketSubscriptions(); }
+	/**
+	 * Get the packet types delivered in addition to the ones registered characters and players listen to.
+	 * @return The additional packet types.
+	 */
+	UFUNCTION(BlueprintPure, Category = "Packet")
+	int32 GetAdditionalPacketSubscriptions() const { return AdditionalPacketSubscriptions; }
+
+	/**
+	 * Set whether capabilities producing only unsubscribed packet types are disabled when a session is started.
+	 * @param bInTrimCapabilities Whether to trim the capabilities to the packet subscription.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Packet")
+	void SetTrimCapabilities(bool bInTrimCapabilities) { bTrimCapabilities = bInTrimCapabilities; }
+	/**
+	 * Check if capabilities are trimmed to the packet subscription when a session is started.
+	 * @return True if capabilities are trimmed, false otherwise.
+	 */
+	UFUNCTION(BlueprintPure, Category = "Packet")
+	bool GetTrimCapabilities() const { return bTrimCapabilities; }
+
+	/**
+	 * Rebuild the packet subscription of the client.
+	 * Called on registration and when the session loads, call it after binding delegates later on.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Packet")
+	void UpdatePacketSubscriptions();
+
+	/**
+	 * Get the number of packets of a type dropped because nothing is subscribed to them.
+	 * @param Type The packet type.
+	 * @return The number of dropped packets.
+	 */
+	UFUNCTION(BlueprintPure, Category = "Packet")
+	int32 GetDroppedPacketCount(EInworldPacketType Type) const;
+
 	/**
 	 * Update a conversation for a player.
 	 * @param Player The player to update the conversation for.
@@ -448,6 +552,20 @@ private:
 	void PossessAgents(const TArray<FInworldAgentInfo>& AgentInfos);
 	void UnpossessAgents();
 
+	FInworldCapabilitySet TrimCapabilities(const FInworldCapabilitySet& CapabilitySet) const;
+
+	void QueueCharacterLoad(const FString& BrainName);
+	void FlushPendingCharacterLoads();
+
+	// characters of a conversation resolved once per conversation update, player packets are fanned out to them
+	struct FConversationFanOut
+	{
+		TArray<FString> AgentIds;
+		TArray<TWeakObjectPtr<UInworldCharacter>> Characters;
+	};
+	void RebuildConversationFanOut(FConversationFanOut& FanOut) const;
+	void RebuildConversationFanOuts();
+
 private:
 	UPROPERTY()
 	TObjectPtr<UInworldClient> Client;
@@ -460,27 +578,48 @@ private:
 	UPROPERTY(ReplicatedUsing = OnRep_IsLoaded)
 	bool bIsLoaded;
 
+	bool bAutoLoadCharacters = true;
+	FInworldCharacterRelevanceNative CharacterRelevance;
+
+	bool bAutoPacketSubscription = false;
+	int32 AdditionalPacketSubscriptions = 0;
+	bool bTrimCapabilities = false;
+
 	UFUNCTION()
 	void OnRep_ConnectionState();
 
 	UPROPERTY(ReplicatedUsing = OnRep_ConnectionState)
 	EInworldConnectionState ConnectionState;
 
+	FInworldPacketEventBus PacketEventBus;
+	FDelegateHandle OnPacketEventBusSubscriptionsChangedHandle;
+
 	FDelegateHandle OnClientPacketReceivedHandle;
 	FDelegateHandle OnClientConnectionStateChangedHandle;
 	FDelegateHandle OnClientPerceivedLatencyHandle;
 
 	UPROPERTY(Replicated)
-	TArray<UInworldCharacter*> RegisteredCharacters;
+	FInworldCharacterArray RegisteredCharacters;
 	UPROPERTY(Replicated)
-	TArray<UInworldPlayer*> RegisteredPlayers;
+	FInworldPlayerArray RegisteredPlayers;
 
 	TMap<FString, UInworldCharacter*> BrainNameToCharacter;
 	TMap<FString, UInworldCharacter*> AgentIdToCharacter;
 	TMap<FString, FInworldAgentInfo> BrainNameToAgentInfo;
-	TMap<FString, TArray<FString>> ConversationIdToAgentIds;
 	TMap<FString, UInworldPlayer*> ConversationIdToPlayer;
 
+	TMap<FString, FConversationFanOut> ConversationFanOuts;
+
+	// long brain names registered this frame, loaded together in one request
+	TArray<FString> PendingLoadBrainNames;
+	// long brain names requested and not possessed yet
+	TSet<FString> RequestedBrainNames;
+	// long brain names of each load request not answered yet, answers arrive in request order
+	TArray<TArray<FString>> InFlightLoadBrainNames;
+
+	void RequestCharacterLoads(const TArray<FString>& BrainNames);
+	void ForgetRequestedCharacterLoads();
+
 	FOnInworldSessionPrePauseNative OnPrePauseDelegateNative;
 	FOnInworldSessionPreStopNative OnPreStopDelegateNative;
 	FOnInworldConnectionStateChangedNative OnConnectionStateChangedDelegateNative;
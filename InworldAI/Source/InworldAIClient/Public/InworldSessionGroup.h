@@ -0,0 +1,188 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "Tickable.h"
+#include "InworldTypes.h"
+#include "InworldSessionGroup.generated.h"
+
+class UInworldSession;
+class UInworldCharacter;
+class UInworldPlayer;
+
+UENUM(BlueprintType)
+enum class EInworldSessionShardPolicy : uint8
+{
+	/** Characters are spread evenly in registration order */
+	RoundRobin,
+	/** Characters in the same region of the level share a shard */
+	Region,
+	/** Characters share the shard of the closest player, so the conversations they're likely in stay on one connection */
+	Conversation,
+};
+
+/**
+ * Spreads the characters of a scene across several sessions, each with its own connection.
+ * Characters are placed on a shard by the shard policy and moved while idle when their shard is saturated or no longer preferred.
+ * A conversation can't span shards, a player follows the character it targets to its shard.
+ */
+UCLASS(BlueprintType)
+class INWORLDAICLIENT_API UInworldSessionGroup : public UObject, public FTickableGameObject
+{
+	GENERATED_BODY()
+public:
+	// UObject
+	virtual UWorld* GetWorld() const override;
+	// ~UObject
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return Shards.Num() > 1 && RebalanceInterval > 0.f; }
+	virtual ETickableTickType GetTickableTickType() const override { return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Conditional; }
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	virtual TStatId GetStatId() const override;
+	// ~FTickableGameObject
+
+public:
+	/**
+	 * Create the shard sessions.
+	 * @param NumShards The number of sessions to spread the characters across.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Client")
+	void Init(int32 NumShards);
+
+	/**
+	 * Destroy the shard sessions, called by the owner when it's done with the group.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Client")
+	void Destroy();
+
+	/**
+	 * Get the shard sessions.
+	 * @return An array of sessions.
+	 */
+	UFUNCTION(BlueprintPure, Category = "Session")
+	const TArray<UInworldSession*>& GetShards() const { return Shards; }
+
+	/**
+	 * Start the shard sessions, each loads only the characters placed on it.
+	 * A shard starts from the first character placed on it and loads the rest as they're registered or moved to it,
+	 * so the backend loads every character once instead of once per shard. Shards without characters start when one is placed on them.
+	 * Scene level settings only apply to a group of a single shard, which starts from the scene.
+	 * @param Scene The scene the characters belong to.
+	 * @param PlayerProfile The player profile.
+	 * @param CapabilitySet The capability set.
+	 * @param Metadata Additional metadata.
+	 * @param WorkspaceOverride Override for the workspace.
+	 * @param AuthOverride Override for the authentication.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Session", meta = (AutoCreateRefTerm = "PlayerProfile, CapabilitySet, Metadata, AuthOverride"))
+	void StartSessionsFromScene(const FInworldScene& Scene, const FInworldPlayerProfile& PlayerProfile, const FInworldCapabilitySet& CapabilitySet, const TMap<FString, FString>& Metadata, const FString& WorkspaceOverride, const FInworldAuth& AuthOverride);
+
+	/**
+	 * Stop all shard sessions.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Session")
+	void StopSessions();
+
+	/**
+	 * Pause all shard sessions.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Session")
+	void PauseSessions();
+
+	/**
+	 * Resume all shard sessions.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Session")
+	void ResumeSessions();
+
+	/**
+	 * Register a character on the shard chosen by the shard policy.
+	 * @param Character The character to register.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Register")
+	void RegisterCharacter(UInworldCharacter* Character);
+
+	/**
+	 * Unregister a character from its shard.
+	 * @param Character The character to unregister.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Register")
+	void UnregisterCharacter(UInworldCharacter* Character);
+
+	/**
+	 * Register a player, players are spread evenly across the shards.
+	 * @param Player The player to register.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Register")
+	void RegisterPlayer(UInworldPlayer* Player);
+
+	/**
+	 * Unregister a player from its shard.
+	 * @param Player The player to unregister.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Register")
+	void UnregisterPlayer(UInworldPlayer* Player);
+
+	/**
+	 * Move idle characters off saturated shards and onto the shard preferred by the shard policy.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Register")
+	void Rebalance();
+
+	/** How characters are placed on shards */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Shard")
+	EInworldSessionShardPolicy ShardPolicy = EInworldSessionShardPolicy::RoundRobin;
+
+	/** Characters a shard holds before new characters go to the least loaded shard */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Shard", meta = (ClampMin = 1))
+	int32 MaxCharactersPerShard = 32;
+
+	/** Size of a region for the Region policy */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Shard", meta = (ClampMin = 1.f))
+	float RegionSize = 5000.f;
+
+	/** Seconds between rebalances, 0 to only rebalance on demand */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Shard", meta = (ClampMin = 0.f))
+	float RebalanceInterval = 5.f;
+
+	/** Characters moved per rebalance, each move reloads the character on its new shard */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Shard", meta = (ClampMin = 1))
+	int32 MaxMovesPerRebalance = 4;
+
+private:
+	void StartShard(UInworldSession* Shard);
+	UInworldSession* GetPreferredShard(UInworldCharacter* Character);
+	UInworldSession* GetLeastLoadedShard() const;
+	bool IsSaturated(const UInworldSession* Shard) const;
+
+	UPROPERTY()
+	TArray<UInworldSession*> Shards;
+
+	UPROPERTY()
+	TArray<UInworldSession*> StartedShards;
+
+	struct FStartParams
+	{
+		FInworldScene Scene;
+		FInworldPlayerProfile PlayerProfile;
+		FInworldCapabilitySet CapabilitySet;
+		TMap<FString, FString> Metadata;
+		FString WorkspaceOverride;
+		FInworldAuth AuthOverride;
+	};
+	/** Set while the sessions are started, used to start shards when characters are placed on them. */
+	TOptional<FStartParams> StartParams;
+
+	int32 NextCharacterShard = 0;
+	int32 NextPlayerShard = 0;
+	float TimeSinceRebalance = 0.f;
+};
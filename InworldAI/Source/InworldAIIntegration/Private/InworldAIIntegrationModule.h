@@ -9,9 +9,12 @@
 
 #include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
+#include "Stats/Stats.h"
 
 INWORLDAIINTEGRATION_API DECLARE_LOG_CATEGORY_EXTERN(LogInworldAIIntegration, Log, All);
 
+DECLARE_STATS_GROUP(TEXT("Inworld"), STATGROUP_Inworld, STATCAT_Advanced);
+
 class INWORLDAIINTEGRATION_API FInworldAIIntegrationModule : public IModuleInterface
 {
 public:
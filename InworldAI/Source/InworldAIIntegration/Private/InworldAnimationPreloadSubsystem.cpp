@@ -0,0 +1,224 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#include "InworldAnimationPreloadSubsystem.h"
+
+#include "InworldAIIntegrationModule.h"
+
+#include "Algo/StableSort.h"
+#include "Animation/AnimMontage.h"
+#include "HAL/IConsoleManager.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+static TAutoConsoleVariable<int32> CVarAnimationPreloadBudgetMB(
+TEXT("Inworld.Animation.PreloadBudgetMB"), 64,
+TEXT("Memory budget of the animations streamed in ahead of use, least recently used ones are released first")
+);
+
+static int64 GetAssetSize(const UObject* Object)
+{
+	int64 Size = Object->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+
+	// the montage itself is small, the animations it references are streamed in and held along with it
+	if (const UAnimMontage* Montage = Cast<UAnimMontage>(Object))
+	{
+		TSet<const UAnimSequenceBase*> Sequences;
+		for (const FSlotAnimationTrack& Slot : Montage->SlotAnimTracks)
+		{
+			for (const FAnimSegment& Segment : Slot.AnimTrack.AnimSegments)
+			{
+#if ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 1
+				const UAnimSequenceBase* Sequence = Segment.GetAnimReference();
+#else
+				const UAnimSequenceBase* Sequence = Segment.AnimReference;
+#endif
+				if (Sequence == nullptr)
+				{
+					continue;
+				}
+
+				bool bAlreadyCounted = false;
+				Sequences.Add(Sequence, &bAlreadyCounted);
+				if (!bAlreadyCounted)
+				{
+					Size += Sequence->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+				}
+			}
+		}
+	}
+	return Size;
+}
+
+void UInworldAnimationPreloadSubsystem::Preload(TArrayView<const FSoftObjectPath> Paths)
+{
+	++UseCounter;
+	for (const FSoftObjectPath& Path : Paths)
+	{
+		FEntry& Entry = Entries.FindOrAdd(Path);
+		Entry.LastUsed = UseCounter;
+		if (Entry.Handle.IsValid())
+		{
+			continue;
+		}
+
+		Stats.NumRequested++;
+		// completion may run before the request returns, and failures remove the entry
+		TSharedPtr<FStreamableHandle> Handle = StreamableManager.RequestAsyncLoad(Path, FStreamableDelegate::CreateUObject(this, &UInworldAnimationPreloadSubsystem::OnLoaded, Path));
+		FEntry* Requested = Entries.Find(Path);
+		if (Requested == nullptr)
+		{
+			continue;
+		}
+		if (!Handle.IsValid())
+		{
+			Entries.Remove(Path);
+			continue;
+		}
+		Requested->Handle = MoveTemp(Handle);
+	}
+}
+
+void UInworldAnimationPreloadSubsystem::NotifyLookup(const FSoftObjectPath& Path, bool bStreamedIn)
+{
+	if (bStreamedIn)
+	{
+		Stats.NumHits++;
+		// keeps montages in use from being evicted first
+		if (FEntry* Entry = Entries.Find(Path))
+		{
+			Entry->LastUsed = ++UseCounter;
+		}
+		return;
+	}
+
+	Stats.NumMisses++;
+	Preload(MakeArrayView(&Path, 1));
+}
+
+void UInworldAnimationPreloadSubsystem::RecordEmotionTransition(EInworldCharacterEmotionalBehavior From, EInworldCharacterEmotionalBehavior To)
+{
+	const int32 FromIdx = static_cast<int32>(From);
+	const int32 ToIdx = static_cast<int32>(To);
+	if (FromIdx >= NumEmotions || ToIdx >= NumEmotions || FromIdx == ToIdx)
+	{
+		return;
+	}
+
+	uint16* Row = EmotionTransitions[FromIdx];
+	if (Row[ToIdx] == MAX_uint16)
+	{
+		// age the row so recent behavior keeps counting
+		for (int32 i = 0; i < NumEmotions; ++i)
+		{
+			Row[i] /= 2;
+		}
+	}
+	Row[ToIdx]++;
+}
+
+void UInworldAnimationPreloadSubsystem::PredictNextEmotions(EInworldCharacterEmotionalBehavior From, int32 Num, TArray<EInworldCharacterEmotionalBehavior>& OutEmotions) const
+{
+	OutEmotions.Reset();
+
+	const int32 FromIdx = static_cast<int32>(From);
+	if (FromIdx >= NumEmotions || Num <= 0)
+	{
+		return;
+	}
+
+	const uint16* Row = EmotionTransitions[FromIdx];
+	for (int32 i = 0; i < NumEmotions; ++i)
+	{
+		if (Row[i] > 0)
+		{
+			OutEmotions.Add(static_cast<EInworldCharacterEmotionalBehavior>(i));
+		}
+	}
+	Algo::StableSortBy(OutEmotions, [Row](EInworldCharacterEmotionalBehavior Emotion) { return Row[static_cast<int32>(Emotion)]; }, TGreater<>());
+	if (OutEmotions.Num() > Num)
+	{
+		OutEmotions.SetNum(Num);
+	}
+}
+
+void UInworldAnimationPreloadSubsystem::Deinitialize()
+{
+	for (auto& Entry : Entries)
+	{
+		if (Entry.Value.Handle.IsValid())
+		{
+			Entry.Value.Handle->CancelHandle();
+		}
+	}
+	Entries.Empty();
+	Stats.ResidentBytes = 0;
+
+	Super::Deinitialize();
+}
+
+void UInworldAnimationPreloadSubsystem::OnLoaded(FSoftObjectPath Path)
+{
+	FEntry* Entry = Entries.Find(Path);
+	if (Entry == nullptr || Entry->bLoaded)
+	{
+		return;
+	}
+
+	UObject* Object = Path.ResolveObject();
+	if (Object == nullptr)
+	{
+		// forgotten, so the next use requests it again
+		UE_LOG(LogInworldAIIntegration, Warning, TEXT("Failed to preload animation %s"), *Path.ToString());
+		if (Entry->Handle.IsValid())
+		{
+			Entry->Handle->ReleaseHandle();
+		}
+		Entries.Remove(Path);
+		Stats.NumFailed++;
+		return;
+	}
+
+	Entry->bLoaded = true;
+	Entry->Size = GetAssetSize(Object);
+	Stats.NumLoaded++;
+	Stats.ResidentBytes += Entry->Size;
+
+	EvictToBudget();
+}
+
+void UInworldAnimationPreloadSubsystem::EvictToBudget()
+{
+	const int64 Budget = static_cast<int64>(FMath::Max(CVarAnimationPreloadBudgetMB.GetValueOnGameThread(), 0)) * 1024 * 1024;
+	while (Stats.ResidentBytes > Budget)
+	{
+		// assets of the latest request are kept even over budget
+		const FSoftObjectPath* LeastRecentlyUsed = nullptr;
+		uint64 LeastRecentUse = UseCounter;
+		for (const auto& Entry : Entries)
+		{
+			if (Entry.Value.bLoaded && Entry.Value.LastUsed < LeastRecentUse)
+			{
+				LeastRecentlyUsed = &Entry.Key;
+				LeastRecentUse = Entry.Value.LastUsed;
+			}
+		}
+		if (LeastRecentlyUsed == nullptr)
+		{
+			return;
+		}
+
+		// the asset is unloaded by the next garbage collection unless referenced elsewhere
+		FEntry Entry;
+		Entries.RemoveAndCopyValue(FSoftObjectPath(*LeastRecentlyUsed), Entry);
+		if (Entry.Handle.IsValid())
+		{
+			Entry.Handle->ReleaseHandle();
+		}
+		Stats.ResidentBytes -= Entry.Size;
+		Stats.NumEvicted++;
+	}
+}
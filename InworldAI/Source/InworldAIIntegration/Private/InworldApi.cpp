@@ -20,11 +20,6 @@
 #include "GameFramework/GameStateBase.h"
 #include "Runtime/Launch/Resources/Version.h"
 
-static TAutoConsoleVariable<bool> CVarLogAllPackets(
-TEXT("Inworld.Debug.LogAllPackets"), false,
-TEXT("Enable/Disable logging all packets going from server")
-);
-
 #define EMPTY_ARG_RETURN(Arg, Return) INWORLD_WARN_AND_RETURN_EMPTY(LogInworldAIIntegration, UInworldApiSubsystem, Arg, Return)
 #define NO_SESSION_RETURN(Return) EMPTY_ARG_RETURN(InworldSession, Return)
 #define NO_CLIENT_RETURN(Return) NO_SESSION_RETURN(Return) EMPTY_ARG_RETURN(InworldSession->GetClient(), Return)
@@ -33,6 +28,7 @@ UInworldApiSubsystem::UInworldApiSubsystem()
     : Super()
     , AudioRepl(nullptr)
     , InworldSession(nullptr)
+    , InworldSessionGroup(nullptr)
 {}
 
 void UInworldApiSubsystem::SetInworldSession(UInworldSession* Session)
@@ -40,6 +36,10 @@ void UInworldApiSubsystem::SetInworldSession(UInworldSession* Session)
     if (InworldSession != Session)
     {
         InworldSession = Session;
+        if (!InworldSession)
+        {
+            return;
+        }
         InworldSession->OnLoaded().AddLambda(
             [this](bool bLoaded) -> void
             {
@@ -273,6 +273,28 @@ void UInworldApiSubsystem::CancelResponse(const FString& AgentId, const FString&
     InworldSession->GetClient()->CancelResponse(AgentId, InteractionId, UtteranceIds);
 }
 
+void UInworldApiSubsystem::NotifyCustomTriggers(TArrayView<const FString> Names)
+{
+    if (Names.Num() == 0)
+    {
+        return;
+    }
+
+    OnCustomTriggersNative.Broadcast(Names);
+    if (OnCustomTriggers.IsBound())
+    {
+        OnCustomTriggers.Broadcast(TArray<FString>(Names.GetData(), Names.Num()));
+    }
+
+    if (OnCustomTrigger.IsBound())
+    {
+        for (const FString& Name : Names)
+        {
+            OnCustomTrigger.Broadcast(Name);
+        }
+    }
+}
+
 void UInworldApiSubsystem::StartAudioReplication()
 {
 	if (!AudioRepl && GetWorld()->GetNetMode() != NM_Standalone)
@@ -318,7 +340,33 @@ void UInworldApiSubsystem::ReplicateAudioEventFromServer(FInworldAudioDataEvent&
     }
 }
 
+void UInworldApiSubsystem::ReplicateA2FHeaderEventFromServer(const FInworldA2FHeaderEvent& Packet)
+{
+    if (AudioRepl)
+    {
+        AudioRepl->ReplicateA2FHeaderEvent(Packet);
+    }
+}
+
+void UInworldApiSubsystem::ReplicateA2FContentEventFromServer(const FInworldA2FContentEvent& Packet)
+{
+    if (AudioRepl)
+    {
+        AudioRepl->ReplicateA2FContentEvent(Packet);
+    }
+}
+
 void UInworldApiSubsystem::HandleAudioEventOnClient(TSharedPtr<FInworldAudioDataEvent> Packet)
+{
+    HandleReplicatedPacketOnClient(Packet);
+}
+
+void UInworldApiSubsystem::HandleA2FEventOnClient(TSharedPtr<FInworldPacket> Packet)
+{
+    HandleReplicatedPacketOnClient(Packet);
+}
+
+void UInworldApiSubsystem::HandleReplicatedPacketOnClient(TSharedPtr<FInworldPacket> Packet)
 {
     NO_SESSION_RETURN(void())
     EMPTY_ARG_RETURN(Packet, void())
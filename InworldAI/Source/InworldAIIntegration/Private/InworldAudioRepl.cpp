@@ -19,6 +19,23 @@
 #include <Engine/NetConnection.h>
 #include <Engine/World.h>
 
+static TAutoConsoleVariable<int32> CVarA2FWeightBits(
+TEXT("Inworld.A2F.ReplicationWeightBits"), 8,
+TEXT("Bits per replicated A2F blend shape weight, 8 or 16")
+);
+
+static TAutoConsoleVariable<int32> CVarA2FKeyFrameInterval(
+TEXT("Inworld.A2F.ReplicationKeyFrameInterval"), 30,
+TEXT("Number of delta coded A2F frames replicated between key frames")
+);
+
+enum class EInworldReplPacketType : uint8
+{
+	Audio,
+	A2FHeader,
+	A2FContent,
+};
+
 void UInworldAudioRepl::PostLoad()
 {
 	Super::PostLoad();
@@ -51,17 +68,65 @@ TStatId UInworldAudioRepl::GetStatId() const
 
 void UInworldAudioRepl::ReplicateAudioEvent(FInworldAudioDataEvent& Event)
 {
-	auto It = GetWorld()->GetControllerIterator();
-	if (!It)
-	{
-		return;
-	}
+	TArray<uint8> Data;
+	FMemoryWriter Ar(Data);
+
+	uint8 Type = static_cast<uint8>(EInworldReplPacketType::Audio);
+	Ar << Type;
+	// datagrams may be lost, ids are not interned across them
+	Inworld::WritePacket(Ar, Event);
+
+	SendData(Data);
+}
+
+void UInworldAudioRepl::ReplicateA2FHeaderEvent(const FInworldA2FHeaderEvent& Event)
+{
+	// a header starts a new blend shape stream, next content frame is a key frame
+	A2FStreams.Remove(Event.Routing.Source.Name);
 
 	TArray<uint8> Data;
 	FMemoryWriter Ar(Data);
-	Event.Serialize(Ar);
 
-	for (; It; ++It)
+	uint8 Type = static_cast<uint8>(EInworldReplPacketType::A2FHeader);
+	Ar << Type;
+	FInworldA2FHeaderEvent RepEvent = Event;
+	Inworld::WritePacket(Ar, RepEvent);
+
+	SendData(Data);
+}
+
+void UInworldAudioRepl::ReplicateA2FContentEvent(const FInworldA2FContentEvent& Event)
+{
+	// audio is split like audio data events, blend shape weights are quantized and delta coded separately
+	TArray<FInworldA2FContentEvent> RepEvents;
+	FInworldA2FContentEvent::ConvertToReplicatableEvents(Event, RepEvents);
+
+	for (int32 i = 0; i < RepEvents.Num(); ++i)
+	{
+		TArray<uint8> Data;
+		FMemoryWriter Ar(Data);
+
+		uint8 Type = static_cast<uint8>(EInworldReplPacketType::A2FContent);
+		Ar << Type;
+
+		FInworldA2FContentEvent& RepEvent = RepEvents[i];
+		const TArray<float> Values = MoveTemp(RepEvent.BlendShapeWeights.Values);
+		Inworld::WritePacket(Ar, RepEvent);
+
+		uint8 bWeights = i == RepEvents.Num() - 1;
+		Ar << bWeights;
+		if (bWeights)
+		{
+			SerializeA2FBlendShapeWeights(Ar, Event.Routing.Source.Name, Values);
+		}
+
+		SendData(Data);
+	}
+}
+
+void UInworldAudioRepl::SendData(TArray<uint8>& Data)
+{
+	for (auto It = GetWorld()->GetControllerIterator(); It; ++It)
 	{
 		if (UNetConnection* Connection = It->Get()->GetNetConnection())
 		{
@@ -70,6 +135,148 @@ void UInworldAudioRepl::ReplicateAudioEvent(FInworldAudioDataEvent& Event)
 	}
 }
 
+void UInworldAudioRepl::SerializeA2FBlendShapeWeights(FArchive& Ar, const FString& AgentId, const TArray<float>& Values)
+{
+	uint8 Bits = CVarA2FWeightBits.GetValueOnGameThread() > 8 ? 16 : 8;
+	const float MaxQuantized = Bits == 16 ? MAX_uint16 : MAX_uint8;
+
+	FA2FStreamState& Stream = A2FStreams.FindOrAdd(AgentId);
+
+	TArray<uint16> Weights;
+	Weights.SetNumUninitialized(Values.Num());
+	for (int32 i = 0; i < Values.Num(); ++i)
+	{
+		Weights[i] = static_cast<uint16>(FMath::RoundToInt(FMath::Clamp(Values[i], 0.f, 1.f) * MaxQuantized));
+	}
+
+	uint8 bKeyFrame = !Stream.bValid || Stream.Bits != Bits || Stream.Weights.Num() != Weights.Num() || Stream.FramesSinceKeyFrame >= CVarA2FKeyFrameInterval.GetValueOnGameThread();
+
+	Stream.Sequence++;
+	Stream.FramesSinceKeyFrame = bKeyFrame ? 0 : Stream.FramesSinceKeyFrame + 1;
+
+	Ar << Bits;
+	Ar << bKeyFrame;
+	Ar << Stream.Sequence;
+
+	uint32 Num = Weights.Num();
+	Ar.SerializeIntPacked(Num);
+
+	for (int32 i = 0; i < Weights.Num(); ++i)
+	{
+		if (bKeyFrame)
+		{
+			if (Bits == 16)
+			{
+				Ar << Weights[i];
+			}
+			else
+			{
+				uint8 Weight = static_cast<uint8>(Weights[i]);
+				Ar << Weight;
+			}
+		}
+		else
+		{
+			// zigzag so small negative deltas stay small once packed
+			const int32 Delta = static_cast<int32>(Weights[i]) - static_cast<int32>(Stream.Weights[i]);
+			uint32 ZigZag = static_cast<uint32>((Delta << 1) ^ (Delta >> 31));
+			Ar.SerializeIntPacked(ZigZag);
+		}
+	}
+
+	Stream.Weights = MoveTemp(Weights);
+	Stream.Bits = Bits;
+	Stream.bValid = true;
+}
+
+bool UInworldAudioRepl::DeserializeA2FBlendShapeWeights(FArchive& Ar, const FString& AgentId, TArray<float>& Values)
+{
+	uint8 Bits;
+	uint8 bKeyFrame;
+	uint16 Sequence;
+	uint32 Num;
+	Ar << Bits;
+	Ar << bKeyFrame;
+	Ar << Sequence;
+	Ar.SerializeIntPacked(Num);
+
+	if (Ar.IsError() || (Bits != 8 && Bits != 16) || Num > static_cast<uint32>(Ar.TotalSize() - Ar.Tell()))
+	{
+		return false;
+	}
+
+	const float MaxQuantized = Bits == 16 ? MAX_uint16 : MAX_uint8;
+
+	FA2FStreamState& Stream = A2FStreams.FindOrAdd(AgentId);
+
+	TArray<uint16> Weights;
+	Weights.SetNumUninitialized(Num);
+
+	if (bKeyFrame)
+	{
+		for (uint16& Weight : Weights)
+		{
+			if (Bits == 16)
+			{
+				Ar << Weight;
+			}
+			else
+			{
+				uint8 Weight8;
+				Ar << Weight8;
+				Weight = Weight8;
+			}
+		}
+	}
+	else
+	{
+		// delta against a frame we don't have, keep the audio and hold the last weights until the next key frame
+		if (!Stream.bValid || Stream.Bits != Bits || Stream.Weights.Num() != Weights.Num() || static_cast<uint16>(Stream.Sequence + 1) != Sequence)
+		{
+			Stream.bValid = false;
+			if (Stream.Bits != Bits || Stream.Weights.Num() != Weights.Num())
+			{
+				Stream.Weights.SetNumZeroed(Weights.Num());
+				Stream.Bits = Bits;
+			}
+
+			Values.SetNumUninitialized(Stream.Weights.Num());
+			for (int32 i = 0; i < Values.Num(); ++i)
+			{
+				Values[i] = Stream.Weights[i] / MaxQuantized;
+			}
+			return true;
+		}
+
+		for (int32 i = 0; i < Weights.Num(); ++i)
+		{
+			uint32 ZigZag;
+			Ar.SerializeIntPacked(ZigZag);
+			const int32 Delta = static_cast<int32>(ZigZag >> 1) ^ -static_cast<int32>(ZigZag & 1);
+			Weights[i] = static_cast<uint16>(static_cast<int32>(Stream.Weights[i]) + Delta);
+		}
+	}
+
+	if (Ar.IsError())
+	{
+		Stream.bValid = false;
+		return false;
+	}
+
+	Values.SetNumUninitialized(Weights.Num());
+	for (int32 i = 0; i < Weights.Num(); ++i)
+	{
+		Values[i] = Weights[i] / MaxQuantized;
+	}
+
+	Stream.Weights = MoveTemp(Weights);
+	Stream.Sequence = Sequence;
+	Stream.Bits = Bits;
+	Stream.bValid = true;
+
+	return true;
+}
+
 void UInworldAudioRepl::ListenAudioSocket()
 {
 	auto* Ctrl = GetWorld()->GetFirstPlayerController();
@@ -90,22 +297,62 @@ void UInworldAudioRepl::ListenAudioSocket()
 		return;
 	}
 
-
-	TArray<uint8> Data;
-	if (!GetAudioSocket(*Driver->GetLocalAddr().Get()).ProcessData(Data))
+	auto* InworldApi = GetWorld()->GetSubsystem<UInworldApiSubsystem>();
+	if (!ensure(InworldApi))
 	{
 		return;
 	}
 
-	FMemoryReader Ar(Data);
+	// A2F streams a datagram per frame next to the audio, drain everything that arrived since last tick
+	Inworld::FSocketBase& Socket = GetAudioSocket(*Driver->GetLocalAddr().Get());
+	TArray<uint8> Data;
+	while (Socket.ProcessData(Data))
+	{
+		FMemoryReader Ar(Data);
 
-	TSharedPtr<FInworldAudioDataEvent> Event = MakeShared<FInworldAudioDataEvent>();
-	Event->Serialize(Ar);
+		uint8 Type;
+		Ar << Type;
 
-	auto* InworldApi = GetWorld()->GetSubsystem<UInworldApiSubsystem>();
-	if (ensure(InworldApi))
-	{
-		InworldApi->HandleAudioEventOnClient(Event);
+		switch (static_cast<EInworldReplPacketType>(Type))
+		{
+		case EInworldReplPacketType::Audio:
+		{
+			TSharedPtr<FInworldAudioDataEvent> Event = StaticCastSharedPtr<FInworldAudioDataEvent>(Inworld::ReadPacket(Ar, nullptr, EInworldPacketType::AudioData));
+			if (Event.IsValid() && Event->GetPacketType() == EInworldPacketType::AudioData)
+			{
+				InworldApi->HandleAudioEventOnClient(Event);
+			}
+			break;
+		}
+		case EInworldReplPacketType::A2FHeader:
+		{
+			TSharedPtr<FInworldA2FHeaderEvent> Event = StaticCastSharedPtr<FInworldA2FHeaderEvent>(Inworld::ReadPacket(Ar, nullptr, EInworldPacketType::A2FHeader));
+			if (Event.IsValid() && Event->GetPacketType() == EInworldPacketType::A2FHeader)
+			{
+				A2FStreams.Remove(Event->Routing.Source.Name);
+				InworldApi->HandleA2FEventOnClient(Event);
+			}
+			break;
+		}
+		case EInworldReplPacketType::A2FContent:
+		{
+			TSharedPtr<FInworldA2FContentEvent> Event = StaticCastSharedPtr<FInworldA2FContentEvent>(Inworld::ReadPacket(Ar, nullptr, EInworldPacketType::A2FContent));
+			if (!Event.IsValid() || Event->GetPacketType() != EInworldPacketType::A2FContent)
+			{
+				break;
+			}
+			uint8 bWeights = 0;
+			Ar << bWeights;
+			if (Ar.IsError() || (bWeights && !DeserializeA2FBlendShapeWeights(Ar, Event->Routing.Source.Name, Event->BlendShapeWeights.Values)))
+			{
+				break;
+			}
+			InworldApi->HandleA2FEventOnClient(Event);
+			break;
+		}
+		default:
+			break;
+		}
 	}
 }
 
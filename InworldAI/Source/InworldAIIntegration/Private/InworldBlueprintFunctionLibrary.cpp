@@ -9,6 +9,7 @@
 #include "InworldBlueprintFunctionLibrary.h"
 
 #include "InworldAIIntegrationSettings.h"
+#include "InworldStudioClient.h"
 
 #include "InworldSession.h"
 #include "InworldSessionComponent.h"
@@ -17,9 +18,6 @@
 #include "InworldPlayer.h"
 #include "InworldPlayerComponent.h"
 
-#include "HttpModule.h"
-#include "Interfaces/IHttpRequest.h"
-#include "Interfaces/IHttpResponse.h"
 #include "JsonObjectConverter.h"
 
 #include "Interfaces/IPluginManager.h"
@@ -65,72 +63,84 @@ const FString& UInworldBlueprintFunctionLibrary::GetStudioApiKey()
 }
 
 template<typename T, typename U>
-void GetInworldStudioResource(const U& Callback, const FString& URL, const FString& Auth)
+void GetInworldStudioResource(const U& Callback, const FString& URL, const FString& Auth, bool bPaginated, bool bCacheable = true)
 {
-    FHttpRequestPtr HttpRequest = FHttpModule::Get().CreateRequest();
-    HttpRequest->SetURL(URL);
-    HttpRequest->SetVerb("GET");
-    HttpRequest->SetHeader("Content-Type", "application/json");
-    HttpRequest->SetHeader("Authorization", "Basic " + Auth);
-    HttpRequest->SetHeader("Grpc-Metadata-X-Authorization-Bearer-Type", "studio_api");
-    HttpRequest->OnProcessRequestComplete().BindLambda(
-        [Callback](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bSuccess)
-        {
-            const int32 ResponseCode = Response->GetResponseCode();
-            const FString ResponseString = Response->GetContentAsString();
+    UInworldStudioClientSubsystem* StudioClientSubsystem = UInworldStudioClientSubsystem::Get();
+    if (StudioClientSubsystem == nullptr)
+    {
+        Callback.ExecuteIfBound(T(), false, TEXT("Inworld Studio client unavailable."));
+        return;
+    }
 
+    StudioClientSubsystem->GetClient().GetResource(URL, Auth, bCacheable, bPaginated,
+        [Callback](bool bSuccess, const FString& Json, const FString& Error)
+        {
             T Resource;
             bool bValid = false;
-            FString Error;
-            if (EHttpResponseCodes::IsOk(Response->GetResponseCode()))
+            FString ResourceError = Error;
+            if (bSuccess)
             {
-                if (FJsonObjectConverter::JsonObjectStringToUStruct(Response->GetContentAsString(), &Resource))
+                if (FJsonObjectConverter::JsonObjectStringToUStruct(Json, &Resource))
                 {
                     bValid = true;
                 }
                 else
                 {
-                    Error = FString::Format(TEXT("Invalid Inworld Studio response. json={0}"), { ResponseString });
+                    ResourceError = FString::Format(TEXT("Invalid Inworld Studio response. json={0}"), { Json });
                 }
             }
-            else
-            {
-                Error = FString::Format(TEXT("Invalid Inworld Studio response. code={0} error={1}"), { FString::FromInt(ResponseCode), ResponseString });
-            }
-            Callback.ExecuteIfBound(Resource, bValid, Error);
+            Callback.ExecuteIfBound(Resource, bValid, ResourceError);
         }
     );
-    HttpRequest->ProcessRequest();
 }
 
 void UInworldBlueprintFunctionLibrary::GetInworldStudioProjects(const FOnInworldStudioProjects& Callback, const FString& StudioApiKeyOverride)
 {
     const FString InworldStudioApiKey = StudioApiKeyOverride.IsEmpty() ? GetStudioApiKey() : StudioApiKeyOverride;
-    GetInworldStudioResource<FInworldStudioProjects>(Callback, FString::Format(TEXT("https://{0}/studio/v1/workspace-collections"), { GetStudioApiUrl() }), InworldStudioApiKey);
+    GetInworldStudioResource<FInworldStudioProjects>(Callback, FString::Format(TEXT("https://{0}/studio/v1/workspace-collections"), { GetStudioApiUrl() }), InworldStudioApiKey, false);
 }
 
 void UInworldBlueprintFunctionLibrary::GetInworldStudioWorkspaces(const FOnInworldStudioWorkspaces& Callback, const FString& StudioApiKeyOverride)
 {
     const FString InworldStudioApiKey = StudioApiKeyOverride.IsEmpty() ? GetStudioApiKey() : StudioApiKeyOverride;
-    GetInworldStudioResource<FInworldStudioWorkspaces>(Callback, FString::Format(TEXT("https://{0}/studio/v1/workspaces"), { GetStudioApiUrl() }), InworldStudioApiKey);
+    GetInworldStudioResource<FInworldStudioWorkspaces>(Callback, FString::Format(TEXT("https://{0}/studio/v1/workspaces"), { GetStudioApiUrl() }), InworldStudioApiKey, false);
 }
 
 void UInworldBlueprintFunctionLibrary::GetInworldStudioApiKeys(const FOnInworldStudioApiKeys& Callback, const FString& Workspace, const FString& StudioApiKeyOverride)
 {
     const FString InworldStudioApiKey = StudioApiKeyOverride.IsEmpty() ? GetStudioApiKey() : StudioApiKeyOverride;
-    GetInworldStudioResource<FInworldStudioApiKeys>(Callback, FString::Format(TEXT("https://{0}/studio/v1/workspaces/{1}/apikeys"), { GetStudioApiUrl(), Workspace }), InworldStudioApiKey);
+    // secrets aren't kept on disk
+    GetInworldStudioResource<FInworldStudioApiKeys>(Callback, FString::Format(TEXT("https://{0}/studio/v1/workspaces/{1}/apikeys"), { GetStudioApiUrl(), Workspace }), InworldStudioApiKey, false, false);
 }
 
 void UInworldBlueprintFunctionLibrary::GetInworldStudioCharacters(const FOnInworldStudioCharacters& Callback, const FString& Workspace, const FString& StudioApiKeyOverride)
 {
     const FString InworldStudioApiKey = StudioApiKeyOverride.IsEmpty() ? GetStudioApiKey() : StudioApiKeyOverride;
-    GetInworldStudioResource<FInworldStudioCharacters>(Callback, FString::Format(TEXT("https://{0}/studio/v1/workspaces/{1}/characters"), { GetStudioApiUrl(), Workspace }), InworldStudioApiKey);
+    GetInworldStudioResource<FInworldStudioCharacters>(Callback, FString::Format(TEXT("https://{0}/studio/v1/workspaces/{1}/characters"), { GetStudioApiUrl(), Workspace }), InworldStudioApiKey, true);
 }
 
 void UInworldBlueprintFunctionLibrary::GetInworldStudioScenes(const FOnInworldStudioScenes& Callback, const FString& Workspace, const FString& StudioApiKeyOverride)
 {
     const FString InworldStudioApiKey = StudioApiKeyOverride.IsEmpty() ? GetStudioApiKey() : StudioApiKeyOverride;
-    GetInworldStudioResource<FInworldStudioScenes>(Callback, FString::Format(TEXT("https://{0}/studio/v1/workspaces/{1}/scenes"), { GetStudioApiUrl(), Workspace }), InworldStudioApiKey);
+    GetInworldStudioResource<FInworldStudioScenes>(Callback, FString::Format(TEXT("https://{0}/studio/v1/workspaces/{1}/scenes"), { GetStudioApiUrl(), Workspace }), InworldStudioApiKey, true);
+}
+
+void UInworldBlueprintFunctionLibrary::GetInworldStudioWorkspaceContents(const FOnInworldStudioWorkspaceContents& Callback, const FString& Workspace, const FString& StudioApiKeyOverride)
+{
+    UInworldStudioClientSubsystem* StudioClientSubsystem = UInworldStudioClientSubsystem::Get();
+    if (StudioClientSubsystem == nullptr)
+    {
+        Callback.ExecuteIfBound({}, {}, false, TEXT("Inworld Studio client unavailable."));
+        return;
+    }
+
+    const FString InworldStudioApiKey = StudioApiKeyOverride.IsEmpty() ? GetStudioApiKey() : StudioApiKeyOverride;
+    StudioClientSubsystem->GetClient().GetWorkspaceContents(GetStudioApiUrl(), Workspace, InworldStudioApiKey,
+        [Callback](const FInworldStudioCharacters& Characters, const FInworldStudioScenes& Scenes, bool bSuccess, const FString& Error)
+        {
+            Callback.ExecuteIfBound(Characters, Scenes, bSuccess, Error);
+        }
+    );
 }
 
 bool UInworldBlueprintFunctionLibrary::SoundWaveToDataArray(USoundWave* SoundWave, TArray<uint8>& OutDataArray)
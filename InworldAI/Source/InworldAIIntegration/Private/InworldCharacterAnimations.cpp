@@ -5,72 +5,336 @@
  * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
  */
 #include "InworldCharacterAnimations.h"
+#include "InworldAnimationPreloadSubsystem.h"
 #include "Animation/AnimMontage.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/StableSort.h"
+#include "UObject/ObjectKey.h"
 
 #include "InworldAIIntegrationModule.h"
 
-template<class TKey, class TDataTable>
-UAnimMontage* GetMontageByKey(TKey Key, float UtteranceDuration, const UDataTable* DataTable, bool bAllowTrailingGestures, EInworldCharacterEmotionStrength EmotionStrength, TArray<UAnimMontage*>& Montages)
+namespace Inworld
 {
-	if (!ensure(DataTable))
+	struct FAnimationIndexKey
 	{
-		UE_LOG(LogInworldAIIntegration, Error, TEXT("Setup animation data table!"));
-		return nullptr;
+		EInworldCharacterEmotionalBehavior Emotion = EInworldCharacterEmotionalBehavior::NEUTRAL;
+		EInworldCharacterEmotionStrength Strength = EInworldCharacterEmotionStrength::UNSPECIFIED;
+		FString Semantic;
+
+		bool operator==(const FAnimationIndexKey& Other) const
+		{
+			return Emotion == Other.Emotion && Strength == Other.Strength && Semantic == Other.Semantic;
+		}
+
+		friend uint32 GetTypeHash(const FAnimationIndexKey& Key)
+		{
+			return HashCombine(GetTypeHash(Key.Semantic), (static_cast<uint32>(Key.Emotion) << 8) | static_cast<uint32>(Key.Strength));
+		}
+	};
+
+	static FAnimationIndexKey MakeAnimationIndexKey(EInworldCharacterEmotionalBehavior Emotion, EInworldCharacterEmotionStrength Strength)
+	{
+		return { Emotion, Strength, FString() };
 	}
 
-	if (Montages.Num() == 0)
+	static FAnimationIndexKey MakeAnimationIndexKey(const FString& Semantic, EInworldCharacterEmotionStrength Strength)
 	{
+		return { EInworldCharacterEmotionalBehavior::NEUTRAL, Strength, Semantic };
+	}
+
+	static float GetMontagePlayLength(const UAnimMontage* Montage)
+	{
+		return Montage ? Montage->GetPlayLength() : 0.f;
+	}
+
+	/** The rows keep the montage alive, the index only observes it. */
+	struct FIndexedMontage
+	{
+		TWeakObjectPtr<UAnimMontage> Montage;
+		float PlayLength = 0.f;
+	};
+
+	struct FIndexedMontages
+	{
+		/** Sorted by play length. */
+		TArray<FIndexedMontage> Montages;
+		/** Rows with soft references, only the loaded montages are used. */
+		TArray<TSoftObjectPtr<UAnimMontage>> SoftMontages;
+	};
+
+	static void AddRowMontages(FIndexedMontages& IndexedMontages, const TArray<UAnimMontage*>& RowMontages)
+	{
+		for (UAnimMontage* Montage : RowMontages)
+		{
+			if (Montage)
+			{
+				IndexedMontages.Montages.Add({ Montage, Montage->GetPlayLength() });
+			}
+		}
+	}
+
+	static void AddRowMontages(FIndexedMontages& IndexedMontages, const TArray<TSoftObjectPtr<UAnimMontage>>& RowMontages)
+	{
+		for (const TSoftObjectPtr<UAnimMontage>& Montage : RowMontages)
+		{
+			if (!Montage.IsNull())
+			{
+				IndexedMontages.SoftMontages.Add(Montage);
+			}
+		}
+	}
+
+	/** Montages of a data table by key. */
+	struct FAnimationTableIndex
+	{
+		TMap<FAnimationIndexKey, FIndexedMontages> Montages;
+		/** AddRow and RemoveRow at runtime don't broadcast OnDataTableChanged, a different row count rebuilds too. */
+		int32 NumRows = 0;
+		bool bDirty = true;
+	};
+
+	using FAnimationTableIndices = TMap<TObjectKey<UDataTable>, TUniquePtr<FAnimationTableIndex>>;
+
+	static FAnimationTableIndices& GetAnimationTableIndices()
+	{
+		static FAnimationTableIndices AnimationTableIndices;
+		return AnimationTableIndices;
+	}
+
+	// built on first lookup and rebuilt on the next lookup after the table changes, game thread only
+	template<class TDataTable>
+	static const FAnimationTableIndex& FindOrBuildAnimationTableIndex(const UDataTable* DataTable, bool bForceRebuild = false)
+	{
+		FAnimationTableIndices& Indices = GetAnimationTableIndices();
+		const TObjectKey<UDataTable> TableKey(DataTable);
+		TUniquePtr<FAnimationTableIndex>* Index = Indices.Find(TableKey);
+		if (Index == nullptr)
+		{
+			for (auto It = Indices.CreateIterator(); It; ++It)
+			{
+				if (It->Key.ResolveObjectPtr() == nullptr)
+				{
+					It.RemoveCurrent();
+				}
+			}
+
+			Index = &Indices.Add(TableKey, MakeUnique<FAnimationTableIndex>());
+			const_cast<UDataTable*>(DataTable)->OnDataTableChanged().AddLambda([TableKey]()
+				{
+					if (TUniquePtr<FAnimationTableIndex>* ChangedIndex = GetAnimationTableIndices().Find(TableKey))
+					{
+						(*ChangedIndex)->bDirty = true;
+					}
+				});
+		}
+
+		FAnimationTableIndex& TableIndex = **Index;
+		if (!TableIndex.bDirty && !bForceRebuild && TableIndex.NumRows == DataTable->GetRowMap().Num())
+		{
+			return TableIndex;
+		}
+
+		TableIndex.Montages.Reset();
 		DataTable->ForeachRow<TDataTable>(TEXT("InworldAnim"),
-			[&Montages, Key, EmotionStrength, DataTable](const FName& Name, const TDataTable& Row)
+			[&TableIndex, DataTable](const FName& Name, const TDataTable& Row)
 			{
-				if (Key == Row.Key &&
-					ensureMsgf(Row.Montages.Num() > 0, TEXT("You must add montages to Data Table, %s:%s"), *DataTable->GetName(), *Name.ToString()) &&
-					EmotionStrength == Row.Strength)
+				if (ensureMsgf(Row.Montages.Num() > 0, TEXT("You must add montages to Data Table, %s:%s"), *DataTable->GetName(), *Name.ToString()))
 				{
-					Montages = Row.Montages;
+					AddRowMontages(TableIndex.Montages.FindOrAdd(MakeAnimationIndexKey(Row.Key, Row.Strength)), Row.Montages);
 				}
 			});
+		for (auto& Entry : TableIndex.Montages)
+		{
+			Algo::StableSortBy(Entry.Value.Montages, &FIndexedMontage::PlayLength);
+		}
+		TableIndex.NumRows = DataTable->GetRowMap().Num();
+		TableIndex.bDirty = false;
+
+		return TableIndex;
 	}
 
-	if (Montages.Num() == 0)
+	template<class TDataTable>
+	static const FIndexedMontages* FindIndexedMontages(const UDataTable* DataTable, const FAnimationIndexKey& Key)
 	{
-		return nullptr;
+		const FIndexedMontages* IndexedMontages = FindOrBuildAnimationTableIndex<TDataTable>(DataTable).Montages.Find(Key);
+		// a row replaced without notification may have let its montage be collected
+		if (IndexedMontages && IndexedMontages->Montages.ContainsByPredicate([](const FIndexedMontage& Montage) { return !Montage.Montage.IsValid(); }))
+		{
+			IndexedMontages = FindOrBuildAnimationTableIndex<TDataTable>(DataTable, true).Montages.Find(Key);
+		}
+		return IndexedMontages;
 	}
 
-	int32 Idx = -1;
-	float DurationDif = TNumericLimits<float>::Max();
-	for (int32 i = 0; i < Montages.Num(); i++)
+	// Montages are sorted by the projected play length
+	template<class TMontage, class TProjection>
+	static int32 FindSortedMontageIndex(const TArray<TMontage>& Montages, float UtteranceDuration, bool bAllowTrailingGestures, TProjection Projection)
 	{
-		auto* Montage = Montages[i];
-		const float MontageDuration = Montage->GetPlayLength();
-		float Dif = UtteranceDuration - MontageDuration;
-		if (bAllowTrailingGestures)
+		int32 Idx = INDEX_NONE;
+		float DurationDif = TNumericLimits<float>::Max();
+
+		// longest montage that ends within the utterance, first of equal lengths
+		const int32 Upper = Algo::UpperBoundBy(Montages, UtteranceDuration, Projection);
+		if (Upper > 0)
 		{
-			Dif = FMath::Abs(Dif);
+			const float MontageDuration = Invoke(Projection, Montages[Upper - 1]);
+			Idx = Algo::LowerBoundBy(Montages, MontageDuration, Projection);
+			DurationDif = UtteranceDuration - MontageDuration;
 		}
 
-		if (Dif >= 0.f && Dif < DurationDif)
+		// shortest montage that outlasts the utterance
+		if (bAllowTrailingGestures && Upper < Montages.Num())
 		{
-			Idx = i;
-			DurationDif = Dif;
+			const float Dif = Invoke(Projection, Montages[Upper]) - UtteranceDuration;
+			if (Dif < DurationDif)
+			{
+				Idx = Upper;
+			}
 		}
+
+		return Idx;
 	}
 
-	if (Idx == -1)
+	/** A pool filled from the index, still sorted while its allocation and size are the ones left by the last lookup. */
+	struct FSortedPool
+	{
+		UAnimMontage* const* Data = nullptr;
+		int32 Num = 0;
+	};
+
+	using FSortedPools = TMap<const TArray<UAnimMontage*>*, FSortedPool>;
+
+	// game thread only, like the index
+	static FSortedPools& GetSortedPools()
 	{
+		static FSortedPools SortedPools;
+		return SortedPools;
+	}
+
+	static bool IsSortedPool(const TArray<UAnimMontage*>& Montages)
+	{
+		const FSortedPool* Pool = GetSortedPools().Find(&Montages);
+		return Pool && Pool->Data == Montages.GetData() && Pool->Num == Montages.Num();
+	}
+
+	static void MarkSortedPool(const TArray<UAnimMontage*>& Montages)
+	{
+		FSortedPools& Pools = GetSortedPools();
+		if (Montages.Num() == 0)
+		{
+			Pools.Remove(&Montages);
+			return;
+		}
+
+		// marks of destroyed pools are dropped once in a while, a reused address fails IsSortedPool anyway
+		constexpr int32 MaxSortedPools = 256;
+		if (Pools.Num() >= MaxSortedPools && !Pools.Contains(&Montages))
+		{
+			Pools.Reset();
+		}
+		Pools.Add(&Montages, { Montages.GetData(), Montages.Num() });
+	}
+
+	// pools filled from the index are sorted, pools built or changed by the caller may not be
+	static int32 FindMontageIndex(const TArray<UAnimMontage*>& Montages, float UtteranceDuration, bool bAllowTrailingGestures, bool bSorted)
+	{
+		if (bSorted)
+		{
+			return FindSortedMontageIndex(Montages, UtteranceDuration, bAllowTrailingGestures, &GetMontagePlayLength);
+		}
+
+		int32 Idx = INDEX_NONE;
+		float DurationDif = TNumericLimits<float>::Max();
+		for (int32 i = 0; i < Montages.Num(); i++)
+		{
+			if (Montages[i] == nullptr)
+			{
+				continue;
+			}
+
+			float Dif = UtteranceDuration - Montages[i]->GetPlayLength();
+			if (bAllowTrailingGestures)
+			{
+				Dif = FMath::Abs(Dif);
+			}
+
+			if (Dif >= 0.f && Dif < DurationDif)
+			{
+				Idx = i;
+				DurationDif = Dif;
+			}
+		}
+		return Idx;
+	}
+}
+
+template<class TKey, class TDataTable>
+UAnimMontage* GetMontageByKey(const TKey& Key, float UtteranceDuration, const UDataTable* DataTable, bool bAllowTrailingGestures, EInworldCharacterEmotionStrength EmotionStrength, TArray<UAnimMontage*>& Montages, UInworldAnimationPreloadSubsystem* PreloadSubsystem)
+{
+	if (!ensure(DataTable))
+	{
+		UE_LOG(LogInworldAIIntegration, Error, TEXT("Setup animation data table!"));
 		return nullptr;
 	}
 
+	bool bSorted = Inworld::IsSortedPool(Montages);
+	if (Montages.Num() == 0)
+	{
+		bSorted = true;
+		if (const Inworld::FIndexedMontages* KeyMontages = Inworld::FindIndexedMontages<TDataTable>(DataTable, Inworld::MakeAnimationIndexKey(Key, EmotionStrength)))
+		{
+			Montages.Reserve(KeyMontages->Montages.Num());
+			for (const Inworld::FIndexedMontage& IndexedMontage : KeyMontages->Montages)
+			{
+				Montages.Add(IndexedMontage.Montage.Get());
+			}
+			if (KeyMontages->SoftMontages.Num() > 0)
+			{
+				// never loads, montages not streamed in yet are skipped and requested for the next refill
+				for (const TSoftObjectPtr<UAnimMontage>& SoftMontage : KeyMontages->SoftMontages)
+				{
+					UAnimMontage* Montage = SoftMontage.Get();
+					if (Montage)
+					{
+						Montages.Add(Montage);
+					}
+					if (PreloadSubsystem)
+					{
+						PreloadSubsystem->NotifyLookup(SoftMontage.ToSoftObjectPath(), Montage != nullptr);
+					}
+				}
+				Algo::StableSortBy(Montages, &Inworld::GetMontagePlayLength);
+			}
+		}
+	}
+
+	const int32 Idx = Inworld::FindMontageIndex(Montages, UtteranceDuration, bAllowTrailingGestures, bSorted);
+	if (Idx == INDEX_NONE)
+	{
+		if (bSorted)
+		{
+			Inworld::MarkSortedPool(Montages);
+		}
+		return nullptr;
+	}
+
+	// keeps the remaining montages sorted
 	auto* Montage = Montages[Idx];
 	Montages.RemoveAt(Idx);
+	if (bSorted)
+	{
+		Inworld::MarkSortedPool(Montages);
+	}
 
 	return Montage;
 }
 
-UAnimMontage* UInworldCharacterAnimationsLib::GetMontageForEmotion(const UDataTable* AnimationDT, EInworldCharacterEmotionalBehavior Emotion, EInworldCharacterEmotionStrength EmotionStrength, float UtteranceDuration, bool bAllowTrailingGestures, bool bFindNeutralGestureIfSearchFailed, UPARAM(ref) TArray<UAnimMontage*>& Montages)
+template<class TDataTable>
+UAnimMontage* GetMontageForEmotionInTable(const UDataTable* AnimationDT, EInworldCharacterEmotionalBehavior Emotion, EInworldCharacterEmotionStrength EmotionStrength, float UtteranceDuration, bool bAllowTrailingGestures, bool bFindNeutralGestureIfSearchFailed, TArray<UAnimMontage*>& Montages, UInworldAnimationPreloadSubsystem* PreloadSubsystem)
 {
 	// find montage by emotional state and strength
-	auto* Montage = GetMontageByKey<EInworldCharacterEmotionalBehavior, FInworldAnimationTableRow>(Emotion, UtteranceDuration, AnimationDT, bAllowTrailingGestures, EmotionStrength, Montages);
+	auto* Montage = GetMontageByKey<EInworldCharacterEmotionalBehavior, TDataTable>(Emotion, UtteranceDuration, AnimationDT, bAllowTrailingGestures, EmotionStrength, Montages, PreloadSubsystem);
 	if (Montage)
 	{
 		return Montage;
@@ -79,7 +343,7 @@ UAnimMontage* UInworldCharacterAnimationsLib::GetMontageForEmotion(const UDataTa
 	// find montage by emotional state only(in unspecified strength data table row)
 	if (EmotionStrength != EInworldCharacterEmotionStrength::UNSPECIFIED)
 	{
-		Montage = GetMontageByKey<EInworldCharacterEmotionalBehavior, FInworldAnimationTableRow>(Emotion, UtteranceDuration, AnimationDT, bAllowTrailingGestures, EInworldCharacterEmotionStrength::UNSPECIFIED, Montages);
+		Montage = GetMontageByKey<EInworldCharacterEmotionalBehavior, TDataTable>(Emotion, UtteranceDuration, AnimationDT, bAllowTrailingGestures, EInworldCharacterEmotionStrength::UNSPECIFIED, Montages, PreloadSubsystem);
 		if (Montage)
 		{
 			return Montage;
@@ -89,14 +353,38 @@ UAnimMontage* UInworldCharacterAnimationsLib::GetMontageForEmotion(const UDataTa
 	// find montage for neutral emotional state
 	if (bFindNeutralGestureIfSearchFailed && Emotion != EInworldCharacterEmotionalBehavior::NEUTRAL)
 	{
-		return GetMontageByKey<EInworldCharacterEmotionalBehavior, FInworldAnimationTableRow>(EInworldCharacterEmotionalBehavior::NEUTRAL, UtteranceDuration, AnimationDT, bAllowTrailingGestures, EInworldCharacterEmotionStrength::UNSPECIFIED, Montages);
+		return GetMontageByKey<EInworldCharacterEmotionalBehavior, TDataTable>(EInworldCharacterEmotionalBehavior::NEUTRAL, UtteranceDuration, AnimationDT, bAllowTrailingGestures, EInworldCharacterEmotionStrength::UNSPECIFIED, Montages, PreloadSubsystem);
 	}
 
 	return nullptr;
 }
 
+UAnimMontage* UInworldCharacterAnimationsLib::GetMontageForEmotion(const UObject* WorldContextObject, const UDataTable* AnimationDT, EInworldCharacterEmotionalBehavior Emotion, EInworldCharacterEmotionStrength EmotionStrength, float UtteranceDuration, bool bAllowTrailingGestures, bool bFindNeutralGestureIfSearchFailed, UPARAM(ref) TArray<UAnimMontage*>& Montages)
+{
+	if (AnimationDT && AnimationDT->GetRowStruct() == FInworldAnimationSoftTableRow::StaticStruct())
+	{
+		UWorld* World = GEngine && WorldContextObject ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+		UInworldAnimationPreloadSubsystem* PreloadSubsystem = World ? World->GetSubsystem<UInworldAnimationPreloadSubsystem>() : nullptr;
+		return GetMontageForEmotionInTable<FInworldAnimationSoftTableRow>(AnimationDT, Emotion, EmotionStrength, UtteranceDuration, bAllowTrailingGestures, bFindNeutralGestureIfSearchFailed, Montages, PreloadSubsystem);
+	}
+	return GetMontageForEmotionInTable<FInworldAnimationTableRow>(AnimationDT, Emotion, EmotionStrength, UtteranceDuration, bAllowTrailingGestures, bFindNeutralGestureIfSearchFailed, Montages, nullptr);
+}
+
 UAnimMontage* UInworldCharacterAnimationsLib::GetMontageForCustomGesture(const UDataTable* AnimationDT, const FString& Semantic, float UtteranceDuration, bool bAllowTrailingGestures, bool bFindNeutralGestureIfSearchFailed)
 {
-	TArray<UAnimMontage*> Montages;
-	return GetMontageByKey<FString, FInworldSemanticGestureTableRow>(Semantic, UtteranceDuration, AnimationDT, bAllowTrailingGestures, EInworldCharacterEmotionStrength::UNSPECIFIED, Montages);
+	if (!ensure(AnimationDT))
+	{
+		UE_LOG(LogInworldAIIntegration, Error, TEXT("Setup animation data table!"));
+		return nullptr;
+	}
+
+	// no montage pool to consume, search the index in place
+	const Inworld::FIndexedMontages* IndexedMontages = Inworld::FindIndexedMontages<FInworldSemanticGestureTableRow>(AnimationDT, Inworld::MakeAnimationIndexKey(Semantic, EInworldCharacterEmotionStrength::UNSPECIFIED));
+	if (IndexedMontages == nullptr)
+	{
+		return nullptr;
+	}
+
+	const int32 Idx = Inworld::FindSortedMontageIndex(IndexedMontages->Montages, UtteranceDuration, bAllowTrailingGestures, &Inworld::FIndexedMontage::PlayLength);
+	return Idx != INDEX_NONE ? IndexedMontages->Montages[Idx].Montage.Get() : nullptr;
 }
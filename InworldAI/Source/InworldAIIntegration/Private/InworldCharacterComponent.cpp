@@ -90,7 +90,15 @@ void UInworldCharacterComponent::InitializeComponent()
 		}
 		else if (bFindSession)
 		{
-			InworldCharacter->SetSession(World->GetSubsystem<UInworldApiSubsystem>()->GetInworldSession());
+			UInworldApiSubsystem* InworldApiSubsystem = World->GetSubsystem<UInworldApiSubsystem>();
+			if (UInworldSessionGroup* SessionGroup = InworldApiSubsystem->GetInworldSessionGroup())
+			{
+				SessionGroup->RegisterCharacter(InworldCharacter);
+			}
+			else
+			{
+				InworldCharacter->SetSession(InworldApiSubsystem->GetInworldSession());
+			}
 		}
 	}
 
@@ -144,6 +152,9 @@ void UInworldCharacterComponent::BeginPlay()
 
 void UInworldCharacterComponent::EndPlay(EEndPlayReason::Type Reason)
 {
+	// events of this frame still reach the clients, the batch is sent on tick otherwise
+	FlushPendingRepEvents();
+
 	if (GetOwnerRole() == ROLE_Authority)
 	{
 		InworldCharacter->SetBrainName({});
@@ -155,6 +166,8 @@ void UInworldCharacterComponent::EndPlay(EEndPlayReason::Type Reason)
         Pb->ClearCharacterComponent();
     }
 
+	RepUtteranceTexts.Empty();
+
     Super::EndPlay(Reason);
 }
 
@@ -162,6 +175,8 @@ void UInworldCharacterComponent::TickComponent(float DeltaTime, enum ELevelTick
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
+	FlushPendingRepEvents();
+
 	if (GetNetMode() == NM_DedicatedServer)
 	{
 		return;
@@ -253,6 +268,7 @@ bool UInworldCharacterComponent::IsInteractingWithPlayer() const
 
 void UInworldCharacterComponent::Interrupt()
 {
+	RepUtteranceTexts.Empty();
 	MessageQueue->TryToInterrupt({});
 }
 
@@ -260,6 +276,8 @@ void UInworldCharacterComponent::Interrupt(const FString& InterruptingInteractio
 {
 	EMPTY_ARG_RETURN(InterruptingInteractionId, void())
 
+	// interrupted utterances never get their final text
+	RemoveRepUtteranceTexts([&InterruptingInteractionId](const FString& InteractionId) { return InteractionId != InterruptingInteractionId; });
 	MessageQueue->TryToInterrupt(InterruptingInteractionId);
 }
 
@@ -331,7 +349,7 @@ bool IsAudioEnabled(UInworldSession* InworldSession)
 	return InworldClient->GetCapabilities().Audio;
 }
 
-void UInworldCharacterComponent::Multicast_VisitText_Implementation(const FInworldTextEvent& Event, bool bTextOnly)
+void UInworldCharacterComponent::VisitText(const FInworldTextEvent& Event, bool bTextOnly)
 {
     if (GetNetMode() == NM_DedicatedServer)
     {
@@ -374,7 +392,7 @@ void UInworldCharacterComponent::Multicast_VisitText_Implementation(const FInwor
 	}
 }
 
-void UInworldCharacterComponent::Multicast_VisitVAD_Implementation(const FInworldVADEvent& Event)
+void UInworldCharacterComponent::VisitVAD(const FInworldVADEvent& Event)
 {
 	if (GetNetMode() == NM_DedicatedServer)
 	{
@@ -402,7 +420,7 @@ void UInworldCharacterComponent::VisitAudioOnClient(const FInworldAudioDataEvent
 	MessageQueue->AddOrUpdateMessage<FCharacterMessageUtterance>(Event);
 }
 
-void UInworldCharacterComponent::Multicast_VisitSilence_Implementation(const FInworldSilenceEvent& Event)
+void UInworldCharacterComponent::VisitSilence(const FInworldSilenceEvent& Event)
 {
 	if (GetNetMode() == NM_DedicatedServer)
 	{
@@ -412,8 +430,13 @@ void UInworldCharacterComponent::Multicast_VisitSilence_Implementation(const FIn
 	MessageQueue->AddOrUpdateMessage<FCharacterMessageSilence>(Event);
 }
 
-void UInworldCharacterComponent::Multicast_VisitControl_Implementation(const FInworldControlEvent& Event)
+void UInworldCharacterComponent::VisitControl(const FInworldControlEvent& Event)
 {
+	if (Event.Action == EInworldControlEventAction::INTERACTION_END)
+	{
+		RemoveRepUtteranceTexts([&Event](const FString& InteractionId) { return InteractionId == Event.PacketId.InteractionId; });
+	}
+
 	if (GetNetMode() == NM_DedicatedServer)
 	{
 		return;
@@ -425,7 +448,7 @@ void UInworldCharacterComponent::Multicast_VisitControl_Implementation(const FIn
 	}
 }
 
-void UInworldCharacterComponent::Multicast_VisitCustom_Implementation(const FInworldCustomEvent& Event)
+void UInworldCharacterComponent::VisitCustom(const FInworldCustomEvent& Event)
 {
 	if (GetNetMode() == NM_DedicatedServer)
 	{
@@ -437,7 +460,7 @@ void UInworldCharacterComponent::Multicast_VisitCustom_Implementation(const FInw
 	MessageQueue->AddOrUpdateMessage<FCharacterMessageTrigger>(Event);
 }
 
-void UInworldCharacterComponent::Multicast_VisitRelation_Implementation(const FInworldRelationEvent& Event)
+void UInworldCharacterComponent::VisitRelation(const FInworldRelationEvent& Event)
 {
 	if (GetNetMode() == NM_DedicatedServer)
 	{
@@ -447,7 +470,7 @@ void UInworldCharacterComponent::Multicast_VisitRelation_Implementation(const FI
 	MessageQueue->AddOrUpdateMessage<FCharacterMessageTrigger>(Event);
 }
 
-void UInworldCharacterComponent::Multicast_VisitEmotion_Implementation(const FInworldEmotionEvent& Event)
+void UInworldCharacterComponent::VisitEmotion(const FInworldEmotionEvent& Event)
 {
 	if (GetNetMode() == NM_DedicatedServer)
 	{
@@ -465,12 +488,46 @@ void UInworldCharacterComponent::Multicast_VisitEmotion_Implementation(const FIn
 
 void UInworldCharacterComponent::OnInworldTextEvent(const FInworldTextEvent& Event)
 {
-    Multicast_VisitText(Event, !IsAudioEnabled(InworldCharacter->GetSession()));
+	const bool bTextOnly = !IsAudioEnabled(InworldCharacter->GetSession());
+	VisitText(Event, bTextOnly);
+
+	if (!IsReplicatingEvents())
+	{
+		return;
+	}
+
+	// partial text grows with every event, replicate only the appended part
+	const FString& UtteranceId = Event.PacketId.UtteranceId;
+	if (Event.Final)
+	{
+		RepUtteranceTexts.Remove(UtteranceId);
+		PendingRepEvents.Add(Event, bTextOnly, INDEX_NONE);
+		return;
+	}
+
+	FRepUtteranceText& RepText = RepUtteranceTexts.FindOrAdd(UtteranceId);
+	RepText.InteractionId = Event.PacketId.InteractionId;
+	if (RepText.Text.IsEmpty() || !Event.Text.StartsWith(RepText.Text, ESearchCase::CaseSensitive))
+	{
+		RepText.Text = Event.Text;
+		PendingRepEvents.Add(Event, bTextOnly, INDEX_NONE);
+		return;
+	}
+
+	FInworldTextEvent DeltaEvent = Event;
+	DeltaEvent.Text = Event.Text.RightChop(RepText.Text.Len());
+	PendingRepEvents.Add(DeltaEvent, bTextOnly, RepText.Text.Len());
+	RepText.Text = Event.Text;
 }
 
 void UInworldCharacterComponent::OnInworldVADEvent(const FInworldVADEvent& Event)
 {
-	Multicast_VisitVAD(Event);
+	VisitVAD(Event);
+
+	if (IsReplicatingEvents())
+	{
+		PendingRepEvents.Add(Event);
+	}
 }
 
 bool IsA2FEnabled(UInworldSession* InworldSession)
@@ -481,7 +538,7 @@ bool IsA2FEnabled(UInworldSession* InworldSession)
 
 void UInworldCharacterComponent::OnInworldAudioEvent(const FInworldAudioDataEvent& Event)
 {
-	// TODO: Support Networked A2F
+	// audio is carried by A2F content events, see OnInworldA2FContentEvent
 	if (IsA2FEnabled(InworldCharacter->GetSession()))
 	{
 		return;
@@ -513,39 +570,271 @@ void UInworldCharacterComponent::OnInworldAudioEvent(const FInworldAudioDataEven
 
 void UInworldCharacterComponent::OnInworldA2FHeaderEvent(const FInworldA2FHeaderEvent& Event)
 {
-	// TODO: Support Networked A2F
-	MessageQueue->AddOrUpdateMessage<FCharacterMessageUtterance>(Event);
+	if (GetNetMode() != NM_DedicatedServer)
+	{
+		MessageQueue->AddOrUpdateMessage<FCharacterMessageUtterance>(Event);
+	}
+
+	if (GetNetMode() == NM_Standalone || GetNetMode() == NM_Client)
+	{
+		return;
+	}
+
+	UInworldApiSubsystem* InworldSubsystem = GetWorld()->GetSubsystem<UInworldApiSubsystem>();
+	if (ensure(InworldSubsystem))
+	{
+		InworldSubsystem->ReplicateA2FHeaderEventFromServer(Event);
+	}
 }
 
 void UInworldCharacterComponent::OnInworldA2FContentEvent(const FInworldA2FContentEvent& Event)
 {
-	// TODO: Support Networked A2F
-	MessageQueue->AddOrUpdateMessage<FCharacterMessageUtterance>(Event);
+	if (GetNetMode() != NM_DedicatedServer)
+	{
+		MessageQueue->AddOrUpdateMessage<FCharacterMessageUtterance>(Event);
+	}
+
+	if (GetNetMode() == NM_Standalone || GetNetMode() == NM_Client)
+	{
+		return;
+	}
+
+	UInworldApiSubsystem* InworldSubsystem = GetWorld()->GetSubsystem<UInworldApiSubsystem>();
+	if (ensure(InworldSubsystem))
+	{
+		InworldSubsystem->ReplicateA2FContentEventFromServer(Event);
+	}
 }
 
 void UInworldCharacterComponent::OnInworldSilenceEvent(const FInworldSilenceEvent& Event)
 {
-    Multicast_VisitSilence(Event);
+	VisitSilence(Event);
+
+	if (IsReplicatingEvents())
+	{
+		PendingRepEvents.Add(Event);
+	}
 }
 
 void UInworldCharacterComponent::OnInworldControlEvent(const FInworldControlEvent& Event)
 {
-    Multicast_VisitControl(Event);
+	VisitControl(Event);
+
+	// clients only handle interaction end
+	if (IsReplicatingEvents() && Event.Action == EInworldControlEventAction::INTERACTION_END)
+	{
+		PendingRepEvents.Add(Event);
+	}
 }
 
 void UInworldCharacterComponent::OnInworldEmotionEvent(const FInworldEmotionEvent& Event)
 {
-    Multicast_VisitEmotion(Event);
+	VisitEmotion(Event);
+
+	if (IsReplicatingEvents())
+	{
+		PendingRepEvents.Add(Event);
+	}
 }
 
 void UInworldCharacterComponent::OnInworldCustomEvent(const FInworldCustomEvent& Event)
 {
-	Multicast_VisitCustom(Event);
+	VisitCustom(Event);
+
+	if (IsReplicatingEvents())
+	{
+		PendingRepEvents.Add(Event);
+	}
 }
 
 void UInworldCharacterComponent::OnInworldRelationEvent(const FInworldRelationEvent& Event)
 {
-	Multicast_VisitRelation(Event);
+	VisitRelation(Event);
+
+	if (IsReplicatingEvents())
+	{
+		PendingRepEvents.Add(Event);
+	}
+}
+
+void UInworldCharacterComponent::RemoveRepUtteranceTexts(TFunctionRef<bool(const FString& InteractionId)> Predicate)
+{
+	for (auto It = RepUtteranceTexts.CreateIterator(); It; ++It)
+	{
+		if (Predicate(It.Value().InteractionId))
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+bool UInworldCharacterComponent::IsReplicatingEvents() const
+{
+	return GetNetMode() == NM_DedicatedServer || GetNetMode() == NM_ListenServer;
+}
+
+void UInworldCharacterComponent::FlushPendingRepEvents()
+{
+	if (PendingRepEvents.IsEmpty())
+	{
+		return;
+	}
+
+	Multicast_VisitEvents(PendingRepEvents);
+	PendingRepEvents.Reset();
+}
+
+void UInworldCharacterComponent::Multicast_VisitEvents_Implementation(const FInworldCharacterRepEventBatch& Batch)
+{
+	// the server has visited the events as they arrived
+	if (GetOwnerRole() == ROLE_Authority)
+	{
+		return;
+	}
+
+	int32 TextIdx = 0, VADIdx = 0, SilenceIdx = 0, ControlIdx = 0, EmotionIdx = 0, CustomIdx = 0, RelationIdx = 0;
+	for (const EInworldCharacterRepEventType Type : Batch.Order)
+	{
+		switch (Type)
+		{
+		case EInworldCharacterRepEventType::Text:
+		{
+			const FInworldCharacterRepTextEvent& RepEvent = Batch.TextEvents[TextIdx++];
+			FInworldTextEvent Event = RepEvent.Event;
+			const FString& UtteranceId = Event.PacketId.UtteranceId;
+			if (RepEvent.BaseLength != INDEX_NONE)
+			{
+				const FRepUtteranceText* BaseText = RepUtteranceTexts.Find(UtteranceId);
+				if (!BaseText || BaseText->Text.Len() != RepEvent.BaseLength)
+				{
+					// missed the start of the utterance, wait for the full text
+					break;
+				}
+				Event.Text = BaseText->Text + Event.Text;
+			}
+
+			if (Event.Final)
+			{
+				RepUtteranceTexts.Remove(UtteranceId);
+			}
+			else
+			{
+				RepUtteranceTexts.Add(UtteranceId, { Event.PacketId.InteractionId, Event.Text });
+			}
+
+			VisitText(Event, RepEvent.bTextOnly);
+			break;
+		}
+		case EInworldCharacterRepEventType::VAD:
+			VisitVAD(Batch.VADEvents[VADIdx++]);
+			break;
+		case EInworldCharacterRepEventType::Silence:
+			VisitSilence(Batch.SilenceEvents[SilenceIdx++]);
+			break;
+		case EInworldCharacterRepEventType::Control:
+			VisitControl(Batch.ControlEvents[ControlIdx++]);
+			break;
+		case EInworldCharacterRepEventType::Emotion:
+			VisitEmotion(Batch.EmotionEvents[EmotionIdx++]);
+			break;
+		case EInworldCharacterRepEventType::Custom:
+			VisitCustom(Batch.CustomEvents[CustomIdx++]);
+			break;
+		case EInworldCharacterRepEventType::Relation:
+			VisitRelation(Batch.RelationEvents[RelationIdx++]);
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+void FInworldCharacterRepEventBatch::Add(const FInworldTextEvent& Event, bool bTextOnly, int32 BaseLength)
+{
+	// merge consecutive updates of the same partial text
+	if (Order.Num() > 0 && Order.Last() == EInworldCharacterRepEventType::Text)
+	{
+		FInworldCharacterRepTextEvent& LastRepEvent = TextEvents.Last();
+		if (!LastRepEvent.Event.Final && LastRepEvent.Event.PacketId.UtteranceId == Event.PacketId.UtteranceId)
+		{
+			const FString Text = BaseLength == INDEX_NONE ? Event.Text : LastRepEvent.Event.Text + Event.Text;
+			if (BaseLength != INDEX_NONE)
+			{
+				BaseLength = LastRepEvent.BaseLength;
+			}
+			LastRepEvent.Event = Event;
+			LastRepEvent.Event.Text = Text;
+			LastRepEvent.BaseLength = BaseLength;
+			LastRepEvent.bTextOnly = bTextOnly;
+			return;
+		}
+	}
+
+	FInworldCharacterRepTextEvent& RepEvent = TextEvents.AddDefaulted_GetRef();
+	RepEvent.Event = Event;
+	RepEvent.BaseLength = BaseLength;
+	RepEvent.bTextOnly = bTextOnly;
+	Order.Add(EInworldCharacterRepEventType::Text);
+}
+
+void FInworldCharacterRepEventBatch::Add(const FInworldVADEvent& Event)
+{
+	VADEvents.Add(Event);
+	Order.Add(EInworldCharacterRepEventType::VAD);
+}
+
+void FInworldCharacterRepEventBatch::Add(const FInworldSilenceEvent& Event)
+{
+	SilenceEvents.Add(Event);
+	Order.Add(EInworldCharacterRepEventType::Silence);
+}
+
+void FInworldCharacterRepEventBatch::Add(const FInworldControlEvent& Event)
+{
+	ControlEvents.Add(Event);
+	Order.Add(EInworldCharacterRepEventType::Control);
+}
+
+void FInworldCharacterRepEventBatch::Add(const FInworldEmotionEvent& Event)
+{
+	// only consecutive ones, so the order relative to other events is kept
+	if (Order.Num() > 0 && Order.Last() == EInworldCharacterRepEventType::Emotion)
+	{
+		EmotionEvents.Last() = Event;
+		return;
+	}
+	EmotionEvents.Add(Event);
+	Order.Add(EInworldCharacterRepEventType::Emotion);
+}
+
+void FInworldCharacterRepEventBatch::Add(const FInworldCustomEvent& Event)
+{
+	CustomEvents.Add(Event);
+	Order.Add(EInworldCharacterRepEventType::Custom);
+}
+
+void FInworldCharacterRepEventBatch::Add(const FInworldRelationEvent& Event)
+{
+	// only consecutive ones, so the order relative to other events is kept
+	if (Order.Num() > 0 && Order.Last() == EInworldCharacterRepEventType::Relation)
+	{
+		RelationEvents.Last() = Event;
+		return;
+	}
+	RelationEvents.Add(Event);
+	Order.Add(EInworldCharacterRepEventType::Relation);
+}
+
+void FInworldCharacterRepEventBatch::Reset()
+{
+	Order.Reset();
+	TextEvents.Reset();
+	VADEvents.Reset();
+	SilenceEvents.Reset();
+	ControlEvents.Reset();
+	EmotionEvents.Reset();
+	CustomEvents.Reset();
+	RelationEvents.Reset();
 }
 
 void UInworldCharacterComponent::Handle(const FCharacterMessageUtterance& Message)
@@ -555,6 +844,8 @@ void UInworldCharacterComponent::Handle(const FCharacterMessageUtterance& Messag
 
 void UInworldCharacterComponent::Interrupt(const FCharacterMessageUtterance& Message)
 {
+	RepUtteranceTexts.Remove(Message.UtteranceId);
+
 	const FString& InteractionId = Message.InteractionId;
 	if (!PendingCancelResponses.Contains(Message.InteractionId))
 	{
@@ -107,6 +107,12 @@ void operator<<(FCharacterMessageUtterance& Message, const FInworldA2FContentEve
 	ensure(UtteranceData);
 	UtteranceData->SoundData.Append(Event.AudioInfo.Audio);
 
+	// replicated frames split across datagrams carry the weights with the last one
+	if (Event.BlendShapeWeights.Values.Num() == 0)
+	{
+		return;
+	}
+
 	TMap<FName, float> BlendShapeMap;
 	for (int32 i = 0; i < UtteranceData->BlendShapeNames.Num(); ++i)
 	{
@@ -7,6 +7,20 @@
 #include "InworldCharacterMessageQueue.h"
 #include "InworldAIIntegrationModule.h"
 
+#include "HAL/IConsoleManager.h"
+
+// per message logs are compiled out of shipping and test builds unless the project defines this
+#ifndef INWORLD_LOG_CHARACTER_MESSAGES
+#define INWORLD_LOG_CHARACTER_MESSAGES !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+#endif
+
+#if INWORLD_LOG_CHARACTER_MESSAGES
+static TAutoConsoleVariable<int32> CVarCharacterMessageLogSampling(
+TEXT("Inworld.Debug.CharacterMessageLogSampling"), 1,
+TEXT("Log one of every N handled character messages, 0 disables the logs")
+);
+#endif
+
 void FCharacterMessageQueue::TryToPause()
 {
 	if (!bIsPaused && CanPauseCurrentMessageQueueEntry())
@@ -107,8 +121,14 @@ void FCharacterMessageQueue::TryToProgress()
 
 		PendingMessageQueueEntries.RemoveAt(0);
 
-		auto CurrentMessage = CurrentMessageQueueEntry->GetCharacterMessage();
-		UE_LOG(LogInworldAIIntegration, Log, TEXT("Handle character message '%s::%s'"), *CurrentMessage->InteractionId, *CurrentMessage->UtteranceId);
+#if INWORLD_LOG_CHARACTER_MESSAGES
+		const int32 LogSampling = CVarCharacterMessageLogSampling.GetValueOnGameThread();
+		if (LogSampling > 0 && NumHandledMessages++ % LogSampling == 0)
+		{
+			auto CurrentMessage = CurrentMessageQueueEntry->GetCharacterMessage();
+			UE_LOG(LogInworldAIIntegration, Log, TEXT("Handle character message '%s::%s'"), *CurrentMessage->InteractionId, *CurrentMessage->UtteranceId);
+		}
+#endif
 
 		TSharedPtr<FCharacterMessageQueueLock> LockPinned = MakeLock();
 		QueueLock = LockPinned;
@@ -0,0 +1,98 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#include "InworldCharacterPlaybackAnimationPreload.h"
+#include "InworldAnimationPreloadSubsystem.h"
+#include "InworldCharacterAnimations.h"
+
+#include "InworldAIIntegrationModule.h"
+
+#include <Engine/DataTable.h>
+#include <Engine/World.h>
+#include <GameFramework/Actor.h>
+
+void UInworldCharacterPlaybackAnimationPreload::BeginPlay_Implementation()
+{
+	Super::BeginPlay_Implementation();
+
+	EmotionMontages.Empty();
+	if (AnimationTable == nullptr)
+	{
+		return;
+	}
+
+	if (AnimationTable->GetRowStruct() != FInworldAnimationSoftTableRow::StaticStruct())
+	{
+		UE_LOG(LogInworldAIIntegration, Warning, TEXT("Animation preloading needs FInworldAnimationSoftTableRow rows, %s isn't preloaded"), *AnimationTable->GetName());
+		return;
+	}
+
+	// strengths share the emotion entry, the strength isn't known before the emotion event
+	AnimationTable->ForeachRow<FInworldAnimationSoftTableRow>(TEXT("InworldAnimPreload"),
+		[this](const FName& Name, const FInworldAnimationSoftTableRow& Row)
+		{
+			TArray<FSoftObjectPath>& Paths = EmotionMontages.FindOrAdd(Row.Key);
+			for (const TSoftObjectPtr<UAnimMontage>& Montage : Row.Montages)
+			{
+				if (!Montage.IsNull())
+				{
+					Paths.AddUnique(Montage.ToSoftObjectPath());
+				}
+			}
+		});
+
+	if (UInworldAnimationPreloadSubsystem* Subsystem = GetPreloadSubsystem())
+	{
+		if (const TArray<FSoftObjectPath>* Paths = EmotionMontages.Find(EInworldCharacterEmotionalBehavior::NEUTRAL))
+		{
+			Subsystem->Preload(*Paths);
+		}
+	}
+}
+
+void UInworldCharacterPlaybackAnimationPreload::OnCharacterEmotion_Implementation(EInworldCharacterEmotionalBehavior Emotion, EInworldCharacterEmotionStrength Strength)
+{
+	UInworldAnimationPreloadSubsystem* Subsystem = GetPreloadSubsystem();
+	if (Subsystem == nullptr || EmotionMontages.Num() == 0)
+	{
+		return;
+	}
+
+	if (Emotion != CurrentEmotion)
+	{
+		Subsystem->RecordEmotionTransition(CurrentEmotion, Emotion);
+		CurrentEmotion = Emotion;
+	}
+
+	// predictions first, so the current emotion is the most recently used
+	TArray<EInworldCharacterEmotionalBehavior> NextEmotions;
+	Subsystem->PredictNextEmotions(Emotion, NumPredictedEmotions, NextEmotions);
+	for (EInworldCharacterEmotionalBehavior NextEmotion : NextEmotions)
+	{
+		if (const TArray<FSoftObjectPath>* Paths = EmotionMontages.Find(NextEmotion))
+		{
+			Subsystem->Preload(*Paths);
+		}
+	}
+
+	if (const TArray<FSoftObjectPath>* Paths = EmotionMontages.Find(Emotion))
+	{
+		Subsystem->Preload(*Paths);
+	}
+}
+
+UInworldAnimationPreloadSubsystem* UInworldCharacterPlaybackAnimationPreload::GetPreloadSubsystem()
+{
+	if (!PreloadSubsystem.IsValid() && OwnerActor.IsValid())
+	{
+		if (UWorld* World = OwnerActor->GetWorld())
+		{
+			PreloadSubsystem = World->GetSubsystem<UInworldAnimationPreloadSubsystem>();
+		}
+	}
+	return PreloadSubsystem.Get();
+}
@@ -15,42 +15,108 @@ void FInworldCharacterInteractionHistory::Add(const FString& InteractionId, cons
 		return;
 	}
 
-	auto* Interaction = Interactions.FindByPredicate([UtteranceId](const auto& I) { return I.UtteranceId == UtteranceId; });
-	if (Interaction)
+	if (const int32* Sequence = UtteranceIdToSequence.Find(UtteranceId))
 	{
-		*Interaction = FInworldCharacterInteraction(InteractionId, UtteranceId, Text, bPlayerInteraction);
+		const int32 Index = *Sequence - FirstSequence;
+		Entries[GetSlot(Index)] = FInworldCharacterInteraction(InteractionId, UtteranceId, Text, bPlayerInteraction);
+		bInteractionsDirty = true;
+		OnUpdatedDelegate.Broadcast(Index);
 		return;
 	}
 
-	Interactions.Emplace(InteractionId, UtteranceId, Text, bPlayerInteraction);
-
-	if (Interactions.Num() > MaxEntries)
+	if (Entries.Num() != MaxEntries)
+	{
+		SetMaxEntries(MaxEntries);
+	}
+	if (NumEntries == MaxEntries)
 	{
-		Interactions.RemoveAt(0, 1, false);
+		Evict();
 	}
+
+	const int32 Index = NumEntries++;
+	Entries[GetSlot(Index)] = FInworldCharacterInteraction(InteractionId, UtteranceId, Text, bPlayerInteraction);
+	UtteranceIdToSequence.Add(UtteranceId, FirstSequence + Index);
+	bInteractionsDirty = true;
+	OnAppendedDelegate.Broadcast(Index);
 }
 
 void FInworldCharacterInteractionHistory::Clear()
 {
-	Interactions.Empty();
+	if (NumEntries == 0)
+	{
+		return;
+	}
+
+	for (int32 Index = 0; Index < NumEntries; ++Index)
+	{
+		Entries[GetSlot(Index)] = FInworldCharacterInteraction();
+	}
+	Head = 0;
+	NumEntries = 0;
+	FirstSequence = 0;
+	UtteranceIdToSequence.Reset();
+	bInteractionsDirty = true;
+	OnClearedDelegate.Broadcast();
 }
 
 void FInworldCharacterInteractionHistory::SetMaxEntries(uint32 Val)
 {
-	MaxEntries = Val;
-	Interactions.Reserve(MaxEntries);
+	MaxEntries = FMath::Max<int32>(Val, 1);
+	while (NumEntries > MaxEntries)
+	{
+		Evict();
+	}
+
+	TArray<FInworldCharacterInteraction> NewEntries;
+	NewEntries.SetNum(MaxEntries);
+	for (int32 Index = 0; Index < NumEntries; ++Index)
+	{
+		NewEntries[Index] = MoveTemp(Entries[GetSlot(Index)]);
+	}
+	Entries = MoveTemp(NewEntries);
+	Head = 0;
+}
+
+const TArray<FInworldCharacterInteraction>& FInworldCharacterInteractionHistory::GetInteractions() const
+{
+	if (bInteractionsDirty)
+	{
+		Interactions.Reset(NumEntries);
+		for (int32 Index = 0; Index < NumEntries; ++Index)
+		{
+			Interactions.Add(GetInteraction(Index));
+		}
+		bInteractionsDirty = false;
+	}
+	return Interactions;
 }
 
 void FInworldCharacterInteractionHistory::CancelUtterance(const FString& InteractionId, const FString& UtteranceId)
 {
 	CanceledInteractions.Add(InteractionId);
-	Interactions.RemoveAll([&UtteranceId, &InteractionId](const auto& I) { return I.UtteranceId == UtteranceId && I.InteractionId == InteractionId; });
+
+	const int32* Sequence = UtteranceIdToSequence.Find(UtteranceId);
+	if (Sequence == nullptr || GetInteraction(*Sequence - FirstSequence).InteractionId != InteractionId)
+	{
+		return;
+	}
+
+	const int32 RemovedIndex = *Sequence - FirstSequence;
+	UtteranceIdToSequence.Remove(UtteranceId);
+	for (int32 Index = RemovedIndex; Index < NumEntries - 1; ++Index)
+	{
+		FInworldCharacterInteraction& Entry = Entries[GetSlot(Index)];
+		Entry = MoveTemp(Entries[GetSlot(Index + 1)]);
+		UtteranceIdToSequence[Entry.UtteranceId] = FirstSequence + Index;
+	}
+	Entries[GetSlot(--NumEntries)] = FInworldCharacterInteraction();
+	bInteractionsDirty = true;
+	OnRemovedDelegate.Broadcast(RemovedIndex);
 }
 
 bool FInworldCharacterInteractionHistory::IsInteractionCanceled(const FString& InteractionId) const
 {
-	int32 Idx;
-	return CanceledInteractions.Find(InteractionId, Idx);
+	return CanceledInteractions.Contains(InteractionId);
 }
 
 void FInworldCharacterInteractionHistory::ClearCanceledInteraction(const FString& InteractionId)
@@ -58,33 +124,87 @@ void FInworldCharacterInteractionHistory::ClearCanceledInteraction(const FString
 	CanceledInteractions.Remove(InteractionId);
 }
 
+void FInworldCharacterInteractionHistory::Evict()
+{
+	FInworldCharacterInteraction& Oldest = Entries[Head];
+	UtteranceIdToSequence.Remove(Oldest.UtteranceId);
+	Oldest = FInworldCharacterInteraction();
+	Head = (Head + 1) % Entries.Num();
+	--NumEntries;
+	++FirstSequence;
+	bInteractionsDirty = true;
+	OnEvictedDelegate.Broadcast();
+}
+
 void UInworldCharacterPlaybackHistory::BeginPlay_Implementation()
 {
 	Super::BeginPlay_Implementation();
 
 	InteractionHistory.SetMaxEntries(InteractionHistoryMaxEntries);
+	InteractionHistory.OnAppended().AddUObject(this, &UInworldCharacterPlaybackHistory::OnHistoryAppended);
+	InteractionHistory.OnUpdated().AddUObject(this, &UInworldCharacterPlaybackHistory::OnHistoryUpdated);
+	InteractionHistory.OnEvicted().AddUObject(this, &UInworldCharacterPlaybackHistory::OnHistoryEvicted);
+	InteractionHistory.OnRemoved().AddUObject(this, &UInworldCharacterPlaybackHistory::OnHistoryRemoved);
+	InteractionHistory.OnCleared().AddUObject(this, &UInworldCharacterPlaybackHistory::OnHistoryCleared);
+}
 
+FInworldCharacterInteraction UInworldCharacterPlaybackHistory::GetInteraction(int32 Index) const
+{
+	return Index >= 0 && Index < InteractionHistory.Num() ? InteractionHistory.GetInteraction(Index) : FInworldCharacterInteraction();
 }
 
 void UInworldCharacterPlaybackHistory::OnCharacterUtterance_Implementation(const FCharacterMessageUtterance& Message)
 {
 	InteractionHistory.Add(Message);
-	OnInteractionsChanged.Broadcast(InteractionHistory.GetInteractions());
+	BroadcastInteractionsChanged();
 }
 
 void UInworldCharacterPlaybackHistory::OnCharacterUtteranceInterrupt_Implementation(const FCharacterMessageUtterance& Message)
 {
 	InteractionHistory.CancelUtterance(Message.InteractionId, Message.UtteranceId);
-	OnInteractionsChanged.Broadcast(InteractionHistory.GetInteractions());
+	BroadcastInteractionsChanged();
 }
 
 void UInworldCharacterPlaybackHistory::OnCharacterPlayerTalk_Implementation(const FCharacterMessagePlayerTalk& Message)
 {
 	InteractionHistory.Add(Message);
-	OnInteractionsChanged.Broadcast(InteractionHistory.GetInteractions());
+	BroadcastInteractionsChanged();
 }
 
 void UInworldCharacterPlaybackHistory::OnCharacterInteractionEnd_Implementation(const FCharacterMessageInteractionEnd& Message)
 {
 	InteractionHistory.ClearCanceledInteraction(Message.InteractionId);
 }
+
+void UInworldCharacterPlaybackHistory::OnHistoryAppended(int32 Index)
+{
+	OnInteractionAppended.Broadcast(InteractionHistory.GetInteraction(Index), Index);
+}
+
+void UInworldCharacterPlaybackHistory::OnHistoryUpdated(int32 Index)
+{
+	OnInteractionUpdated.Broadcast(InteractionHistory.GetInteraction(Index), Index);
+}
+
+void UInworldCharacterPlaybackHistory::OnHistoryEvicted()
+{
+	OnInteractionEvicted.Broadcast();
+}
+
+void UInworldCharacterPlaybackHistory::OnHistoryRemoved(int32 Index)
+{
+	OnInteractionRemoved.Broadcast(Index);
+}
+
+void UInworldCharacterPlaybackHistory::OnHistoryCleared()
+{
+	OnInteractionsCleared.Broadcast();
+}
+
+void UInworldCharacterPlaybackHistory::BroadcastInteractionsChanged()
+{
+	if (OnInteractionsChanged.IsBound())
+	{
+		OnInteractionsChanged.Broadcast(InteractionHistory.GetInteractions());
+	}
+}
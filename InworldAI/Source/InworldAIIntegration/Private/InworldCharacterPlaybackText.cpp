@@ -8,13 +8,22 @@
 #include "InworldCharacterPlaybackText.h"
 #include "InworldCharacterMessage.h"
 
-UInworldCharacterPlaybackText::FInworldCharacterText::FInworldCharacterText(const FString& InUtteranceId, const FString& InText, bool bInTextFinal, bool bInIsPlayer)
+UInworldCharacterPlaybackText::FInworldCharacterText::FInworldCharacterText(const FString& InUtteranceId, bool bInIsPlayer)
 	: Id(InUtteranceId)
-	, Text(InText)
-	, bTextFinal(bInTextFinal)
 	, bIsPlayer(bInIsPlayer)
 {}
 
+bool UInworldCharacterPlaybackText::GetText(const FString& Id, FString& Text) const
+{
+	const FInworldCharacterText* CharacterText = CharacterTexts.Find(Id);
+	if (CharacterText == nullptr)
+	{
+		return false;
+	}
+	Text = CharacterText->Text;
+	return true;
+}
+
 void UInworldCharacterPlaybackText::OnCharacterUtterance_Implementation(const FCharacterMessageUtterance& Message)
 {
 	UpdateUtterance(Message.InteractionId, Message.UtteranceId, Message.Text, Message.bTextFinal, false);
@@ -22,9 +31,19 @@ void UInworldCharacterPlaybackText::OnCharacterUtterance_Implementation(const FC
 
 void UInworldCharacterPlaybackText::OnCharacterUtteranceInterrupt_Implementation(const FCharacterMessageUtterance& Message)
 {
-	auto* CharacterText = CharacterTexts.FindByPredicate([Message](const auto& Text) { return Text.Id == Message.UtteranceId; });
-	if(CharacterText)
+	FInworldCharacterText* CharacterText = CharacterTexts.Find(Message.UtteranceId);
+	if (CharacterText == nullptr)
 	{
+		// interrupted before any text, later chunks are dropped
+		CharacterText = &CharacterTexts.Add(Message.UtteranceId, FInworldCharacterText(Message.UtteranceId, false));
+		CharacterText->bInterrupted = true;
+		InteractionIdToUtteranceIdMap.FindOrAdd(Message.InteractionId).Add(Message.UtteranceId);
+		return;
+	}
+
+	if (!CharacterText->bInterrupted)
+	{
+		CharacterText->bInterrupted = true;
 		OnCharacterTextInterrupt.Broadcast(CharacterText->Id);
 	}
 }
@@ -36,37 +55,66 @@ void UInworldCharacterPlaybackText::OnCharacterPlayerTalk_Implementation(const F
 
 void UInworldCharacterPlaybackText::OnCharacterInteractionEnd_Implementation(const FCharacterMessageInteractionEnd& Message)
 {
-	const FString InteractionId = Message.InteractionId;
-	if (InteractionIdToUtteranceIdMap.Contains(InteractionId))
+	TArray<FString> InteractionUtteranceIds;
+	if (InteractionIdToUtteranceIdMap.RemoveAndCopyValue(Message.InteractionId, InteractionUtteranceIds))
 	{
-		const TArray<FString>& InteractionUtteranceIds = InteractionIdToUtteranceIdMap[InteractionId];
-		CharacterTexts.RemoveAll([InteractionUtteranceIds](const auto& Text) { return InteractionUtteranceIds.Contains(Text.Id); });
-		InteractionIdToUtteranceIdMap.Remove(InteractionId);
+		for (const FString& UtteranceId : InteractionUtteranceIds)
+		{
+			CharacterTexts.Remove(UtteranceId);
+		}
 	}
 }
 
 void UInworldCharacterPlaybackText::UpdateUtterance(const FString& InteractionId, const FString& UtteranceId, const FString& Text, bool bTextFinal, bool bIsPlayer)
 {
-	if (!InteractionIdToUtteranceIdMap.Contains(InteractionId))
+	FInworldCharacterText* CharacterText = CharacterTexts.Find(UtteranceId);
+	if (CharacterText == nullptr)
 	{
-		InteractionIdToUtteranceIdMap.Add(InteractionId, TArray<FString>());
+		CharacterText = &CharacterTexts.Add(UtteranceId, FInworldCharacterText(UtteranceId, bIsPlayer));
+		InteractionIdToUtteranceIdMap.FindOrAdd(InteractionId).Add(UtteranceId);
+		OnCharacterTextStart.Broadcast(CharacterText->Id, CharacterText->bIsPlayer);
+	}
+	else if (CharacterText->bInterrupted || CharacterText->bTextFinal)
+	{
+		// late chunks of an interrupted or finished utterance
+		return;
 	}
 
-	auto* CharacterText = CharacterTexts.FindByPredicate([UtteranceId](const auto& Text) { return Text.Id == UtteranceId; });
-	if (CharacterText)
+	FString& CurrentText = CharacterText->Text;
+	if (!bTextFinal && Text.Len() < CurrentText.Len() && CurrentText.StartsWith(Text, ESearchCase::CaseSensitive))
 	{
-		*CharacterText = FInworldCharacterText(UtteranceId, Text, bTextFinal, bIsPlayer);
+		// an older chunk arriving after a newer one
+		return;
 	}
-	else
+
+	int32 Start = CurrentText.Len();
+	if (Text.Len() < Start || FCString::Strncmp(*Text, *CurrentText, Start) != 0)
 	{
-		CharacterText = &CharacterTexts.Emplace_GetRef(UtteranceId, Text, bTextFinal, bIsPlayer);
-		InteractionIdToUtteranceIdMap[InteractionId].Add(CharacterText->Id);
-		OnCharacterTextStart.Broadcast(CharacterText->Id, CharacterText->bIsPlayer);
+		Start = 0;
+		const int32 MaxStart = FMath::Min(Text.Len(), CurrentText.Len());
+		while (Start < MaxStart && Text[Start] == CurrentText[Start])
+		{
+			++Start;
+		}
+	}
+
+	if (Start < CurrentText.Len() || Start < Text.Len())
+	{
+		CurrentText.LeftInline(Start, false);
+		CurrentText.AppendChars(*Text + Start, Text.Len() - Start);
+
+		if (OnCharacterTextDeltaNative.IsBound() || OnCharacterTextDelta.IsBound())
+		{
+			const FString Delta = Text.Mid(Start);
+			OnCharacterTextDeltaNative.Broadcast(CharacterText->Id, CharacterText->bIsPlayer, Start, Delta);
+			OnCharacterTextDelta.Broadcast(CharacterText->Id, CharacterText->bIsPlayer, Start, Delta);
+		}
 	}
+	CharacterText->bTextFinal = bTextFinal;
 
-	OnCharacterTextChanged.Broadcast(CharacterText->Id, CharacterText->bIsPlayer, CharacterText->Text);
+	OnCharacterTextChanged.Broadcast(CharacterText->Id, CharacterText->bIsPlayer, CurrentText);
 	if (CharacterText->bTextFinal)
 	{
-		OnCharacterTextFinal.Broadcast(CharacterText->Id, CharacterText->bIsPlayer, CharacterText->Text);
+		OnCharacterTextFinal.Broadcast(CharacterText->Id, CharacterText->bIsPlayer, CurrentText);
 	}
 }
@@ -12,20 +12,51 @@
 
 void UInworldCharacterPlaybackTrigger::OnCharacterTrigger_Implementation(const FCharacterMessageTrigger& Message)
 {
-	if (!PendingTriggers.Contains(Message.InteractionId))
+	const double Time = FPlatformTime::Seconds();
+	FPendingTriggers* Triggers = PendingTriggers.Find(Message.InteractionId);
+	if (Triggers == nullptr)
 	{
-		PendingTriggers.Add(Message.InteractionId, {});
+		RemoveExpiredTriggers(Time);
+		Triggers = &PendingTriggers.Add(Message.InteractionId);
 	}
-	PendingTriggers[Message.InteractionId].Add(Message);
+	Triggers->Names.Add(Message.Name);
+	Triggers->Time = Time;
 }
 
 void UInworldCharacterPlaybackTrigger::OnCharacterInteractionEnd_Implementation(const FCharacterMessageInteractionEnd& Message)
 {
-	if (PendingTriggers.Contains(Message.InteractionId))
+	FPendingTriggers Triggers;
+	if (!PendingTriggers.RemoveAndCopyValue(Message.InteractionId, Triggers))
 	{
-		for (auto& Trigger : PendingTriggers[Message.InteractionId])
+		return;
+	}
+
+	if (UInworldApiSubsystem* InworldApiSubsystem = GetApiSubsystem())
+	{
+		InworldApiSubsystem->NotifyCustomTriggers(Triggers.Names);
+	}
+}
+
+UInworldApiSubsystem* UInworldCharacterPlaybackTrigger::GetApiSubsystem()
+{
+	if (!ApiSubsystem.IsValid() && OwnerActor.IsValid())
+	{
+		if (UWorld* World = OwnerActor->GetWorld())
+		{
+			ApiSubsystem = World->GetSubsystem<UInworldApiSubsystem>();
+		}
+	}
+	return ApiSubsystem.Get();
+}
+
+void UInworldCharacterPlaybackTrigger::RemoveExpiredTriggers(double Time)
+{
+	// only checked when a new interaction starts, the map holds a handful of interactions at most
+	for (auto It = PendingTriggers.CreateIterator(); It; ++It)
+	{
+		if (Time - It->Value.Time > PendingTriggerLifetime)
 		{
-			OwnerActor->GetWorld()->GetSubsystem<UInworldApiSubsystem>()->NotifyCustomTrigger(Trigger.Name);
+			It.RemoveCurrent();
 		}
 	}
 }
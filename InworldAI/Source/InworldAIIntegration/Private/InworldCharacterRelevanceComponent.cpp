@@ -0,0 +1,219 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#include "InworldCharacterRelevanceComponent.h"
+#include "InworldApi.h"
+#include "InworldCharacter.h"
+#include "InworldPlayer.h"
+#include "InworldSession.h"
+
+#include "InworldAIIntegrationModule.h"
+
+#include <Engine/World.h>
+#include <GameFramework/Actor.h>
+
+UInworldCharacterRelevanceComponent::UInworldCharacterRelevanceComponent()
+	: Super()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.TickInterval = 0.25f;
+}
+
+void UInworldCharacterRelevanceComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (GetOwnerRole() != ROLE_Authority)
+	{
+		SetComponentTickEnabled(false);
+		return;
+	}
+
+	InworldSession = FindSession();
+	if (InworldSession.IsValid())
+	{
+		InworldSession->SetAutoLoadCharacters(false);
+		InworldSession->SetCharacterRelevance(FInworldCharacterRelevanceNative::CreateUObject(this, &UInworldCharacterRelevanceComponent::IsCharacterRelevant));
+	}
+}
+
+void UInworldCharacterRelevanceComponent::EndPlay(EEndPlayReason::Type Reason)
+{
+	if (InworldSession.IsValid())
+	{
+		InworldSession->SetAutoLoadCharacters(true);
+		InworldSession->SetCharacterRelevance({});
+	}
+	InworldSession = nullptr;
+	PendingLoads.Empty();
+
+	Super::EndPlay(Reason);
+}
+
+void UInworldCharacterRelevanceComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	UInworldSession* Session = InworldSession.Get();
+	if (!Session || !Session->IsLoaded())
+	{
+		PendingLoads.Empty();
+		return;
+	}
+
+	UpdateRelevance(Session);
+}
+
+UInworldSession* UInworldCharacterRelevanceComponent::FindSession() const
+{
+	TArray<UActorComponent*> SessionOwnerComponents = GetOwner()->GetComponentsByInterface(UInworldSessionOwnerInterface::StaticClass());
+	if (SessionOwnerComponents.Num() > 0)
+	{
+		return IInworldSessionOwnerInterface::Execute_GetInworldSession(SessionOwnerComponents[0]);
+	}
+
+	UInworldApiSubsystem* InworldApiSubsystem = GetWorld()->GetSubsystem<UInworldApiSubsystem>();
+	return InworldApiSubsystem ? InworldApiSubsystem->GetInworldSession() : nullptr;
+}
+
+void UInworldCharacterRelevanceComponent::GetPlayerPaths(const UInworldSession* Session, TArray<FPlayerPath>& OutPlayerPaths) const
+{
+	for (UInworldPlayer* Player : Session->GetRegisteredPlayers())
+	{
+		const AActor* PlayerActor = Player ? Player->GetTypedOuter<AActor>() : nullptr;
+		if (PlayerActor)
+		{
+			const FVector Location = PlayerActor->GetActorLocation();
+			OutPlayerPaths.Add({ Location, Location + PlayerActor->GetVelocity() * PreloadTime });
+		}
+	}
+}
+
+float UInworldCharacterRelevanceComponent::GetDistSqToPlayers(const UInworldCharacter* Character, const TArray<FPlayerPath>& PlayerPaths) const
+{
+	// never unload a character in the middle of a conversation
+	if (Character->GetTargetPlayer() != nullptr)
+	{
+		return 0.f;
+	}
+
+	const FVector Location = Character->GetTypedOuter<AActor>()->GetActorLocation();
+	float DistSq = MAX_flt;
+	for (const FPlayerPath& Path : PlayerPaths)
+	{
+		DistSq = FMath::Min(DistSq, FMath::PointDistToSegmentSquared(Location, Path.Start, Path.End));
+	}
+	return DistSq;
+}
+
+bool UInworldCharacterRelevanceComponent::IsCharacterRelevant(const UInworldCharacter* Character) const
+{
+	const UInworldSession* Session = InworldSession.Get();
+	if (!Session || !Character || !Character->GetTypedOuter<AActor>())
+	{
+		return false;
+	}
+
+	// the next tick caps the loaded characters to MaxLoadedCharacters
+	TArray<FPlayerPath> PlayerPaths;
+	GetPlayerPaths(Session, PlayerPaths);
+	return GetDistSqToPlayers(Character, PlayerPaths) <= LoadRadius * LoadRadius;
+}
+
+void UInworldCharacterRelevanceComponent::UpdateRelevance(UInworldSession* Session)
+{
+	TArray<FPlayerPath> PlayerPaths;
+	GetPlayerPaths(Session, PlayerPaths);
+	if (PlayerPaths.Num() == 0)
+	{
+		return;
+	}
+
+	const double Time = GetWorld()->GetTimeSeconds();
+	for (auto It = PendingLoads.CreateIterator(); It; ++It)
+	{
+		if (!It->Key.IsValid() || It->Key->IsPossessed() || Time - It->Value > LoadTimeout)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	struct FCandidate
+	{
+		UInworldCharacter* Character;
+		float DistSq;
+		bool bLoaded;
+	};
+
+	TArray<FCandidate> Relevant;
+	TArray<UInworldCharacter*> CharactersToUnload;
+	const float LoadRadiusSq = LoadRadius * LoadRadius;
+	const float UnloadRadiusSq = FMath::Max(LoadRadius, UnloadRadius) * FMath::Max(LoadRadius, UnloadRadius);
+	for (UInworldCharacter* Character : Session->GetRegisteredCharacters())
+	{
+		if (!Character || !Character->GetTypedOuter<AActor>())
+		{
+			continue;
+		}
+
+		const bool bLoaded = Character->IsPossessed() || PendingLoads.Contains(Character);
+		const float DistSq = GetDistSqToPlayers(Character, PlayerPaths);
+
+		if (DistSq <= (bLoaded ? UnloadRadiusSq : LoadRadiusSq))
+		{
+			Relevant.Add({ Character, DistSq, bLoaded });
+		}
+		else if (bLoaded)
+		{
+			CharactersToUnload.Add(Character);
+		}
+	}
+
+	if (MaxLoadedCharacters > 0 && Relevant.Num() > MaxLoadedCharacters)
+	{
+		Relevant.Sort([](const FCandidate& A, const FCandidate& B) { return A.DistSq < B.DistSq; });
+		for (int32 i = MaxLoadedCharacters; i < Relevant.Num(); ++i)
+		{
+			if (Relevant[i].bLoaded)
+			{
+				CharactersToUnload.Add(Relevant[i].Character);
+			}
+		}
+		Relevant.SetNum(MaxLoadedCharacters);
+	}
+
+	TArray<UInworldCharacter*> CharactersToLoad;
+	for (const FCandidate& Candidate : Relevant)
+	{
+		if (!Candidate.bLoaded)
+		{
+			CharactersToLoad.Add(Candidate.Character);
+		}
+	}
+
+	if (CharactersToUnload.Num() > 0)
+	{
+		for (UInworldCharacter* Character : CharactersToUnload)
+		{
+			PendingLoads.Remove(Character);
+		}
+
+		UE_LOG(LogInworldAIIntegration, Verbose, TEXT("Unloading %d irrelevant character(s)"), CharactersToUnload.Num());
+		Session->UnloadCharacters(CharactersToUnload);
+	}
+
+	if (CharactersToLoad.Num() > 0)
+	{
+		for (UInworldCharacter* Character : CharactersToLoad)
+		{
+			PendingLoads.Add(Character, Time);
+		}
+
+		UE_LOG(LogInworldAIIntegration, Verbose, TEXT("Loading %d relevant character(s)"), CharactersToLoad.Num());
+		Session->LoadCharacters(CharactersToLoad);
+	}
+}
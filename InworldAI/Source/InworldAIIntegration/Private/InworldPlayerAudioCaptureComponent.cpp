@@ -324,6 +324,7 @@ void UInworldPlayerAudioCaptureComponent::EvaluateVoiceCapture()
         const bool bIsMicHot = !bMuted;
         const bool bIsWorldPlaying = !GetWorld()->IsPaused();
         const bool bIsParticipating = InworldPlayer->IsConversationParticipant();
+        InworldPlayer->CommitConversationUpdate();
         const bool bHasConversation = !InworldPlayer->GetConversationId().IsEmpty();
         UInworldSession* InworldSession = InworldPlayer->GetSession();
         const EInworldConnectionState ConnectionState = InworldSession ? InworldSession->GetConnectionState() : EInworldConnectionState::Idle;
@@ -9,10 +9,14 @@
 #include "InworldApi.h"
 #include "InworldMacros.h"
 #include "InworldCharacterComponent.h"
+#include "InworldReplicatedKeys.h"
 
 #include "InworldAIIntegrationModule.h"
 
 #include <Engine/World.h>
+#include <Engine/NetConnection.h>
+#include <Engine/NetDriver.h>
+#include <TimerManager.h>
 #include <Net/UnrealNetwork.h>
 #include "Runtime/Launch/Resources/Version.h"
 
@@ -77,7 +81,15 @@ void UInworldPlayerComponent::InitializeComponent()
     {
         if (bFindSession)
         {
-            InworldPlayer->SetSession(World->GetSubsystem<UInworldApiSubsystem>()->GetInworldSession());
+            UInworldApiSubsystem* InworldApiSubsystem = World->GetSubsystem<UInworldApiSubsystem>();
+            if (UInworldSessionGroup* SessionGroup = InworldApiSubsystem->GetInworldSessionGroup())
+            {
+                SessionGroup->RegisterPlayer(InworldPlayer);
+            }
+            else
+            {
+                InworldPlayer->SetSession(InworldApiSubsystem->GetInworldSession());
+            }
         }
         else if (InworldSessionOwner)
         {
@@ -111,6 +123,74 @@ void UInworldPlayerComponent::BeginPlay()
     if (GetOwnerRole() == ROLE_Authority)
     {
     }
+    else
+    {
+        // the owner may be possessed by this client only later, keys received until then are acknowledged once it is
+        OnReplicatedKeysReceivedHandle = Inworld::OnReplicatedKeysReceived().AddUObject(this, &UInworldPlayerComponent::OnReplicatedKeysReceived);
+        OnReplicatedKeysReceived(GetServerConnection());
+    }
+}
+
+void UInworldPlayerComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    Inworld::OnReplicatedKeysReceived().Remove(OnReplicatedKeysReceivedHandle);
+    if (UWorld* World = GetWorld())
+    {
+        World->GetTimerManager().ClearTimer(AcknowledgeReplicatedKeysHandle);
+    }
+
+    Super::EndPlay(EndPlayReason);
+}
+
+UNetConnection* UInworldPlayerComponent::GetServerConnection() const
+{
+    UWorld* World = GetWorld();
+    UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr;
+    return NetDriver ? NetDriver->ServerConnection : nullptr;
+}
+
+void UInworldPlayerComponent::OnReplicatedKeysReceived(UNetConnection* Connection)
+{
+    if (Connection == nullptr || Connection != GetServerConnection() || AcknowledgeReplicatedKeysHandle.IsValid())
+    {
+        return;
+    }
+
+    // received during net serialization, the RPC is sent once it is done
+    AcknowledgeReplicatedKeysHandle = GetWorld()->GetTimerManager().SetTimerForNextTick(this, &UInworldPlayerComponent::AcknowledgeReplicatedKeys);
+}
+
+void UInworldPlayerComponent::AcknowledgeReplicatedKeys()
+{
+    AcknowledgeReplicatedKeysHandle.Invalidate();
+
+    UNetConnection* ServerConnection = GetServerConnection();
+    FInworldReplicatedKeyDictionary* Keys = Inworld::FindReplicatedKeys(ServerConnection);
+    if (Keys == nullptr || !Keys->HasPendingAcknowledgement())
+    {
+        return;
+    }
+
+    // the server RPC needs the owner possessed by this client, check again until it is or another player component acknowledges
+    if (GetOwner()->GetNetConnection() != ServerConnection)
+    {
+        GetWorld()->GetTimerManager().SetTimer(AcknowledgeReplicatedKeysHandle, this, &UInworldPlayerComponent::AcknowledgeReplicatedKeys, 0.5f, false);
+        return;
+    }
+
+    TArray<int32> Indices;
+    if (Keys->ConsumeAcknowledgement(Indices))
+    {
+        Server_AcknowledgeReplicatedKeys(Indices);
+    }
+}
+
+void UInworldPlayerComponent::Server_AcknowledgeReplicatedKeys_Implementation(const TArray<int32>& Indices)
+{
+    if (FInworldReplicatedKeyDictionary* Keys = Inworld::FindReplicatedKeys(GetOwner()->GetNetConnection()))
+    {
+        Keys->Acknowledge(Indices);
+    }
 }
 
 void UInworldPlayerComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
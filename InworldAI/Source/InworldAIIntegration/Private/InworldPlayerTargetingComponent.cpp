@@ -8,13 +8,14 @@
 #include "InworldPlayerTargetingComponent.h"
 #include "InworldPlayer.h"
 #include "InworldPlayerComponent.h"
+#include "InworldPlayerTargetingSubsystem.h"
 #include "Camera/CameraComponent.h"
 #include "Engine/World.h"
 
 
 UInworldPlayerTargetingComponent::UInworldPlayerTargetingComponent()
 {
-    PrimaryComponentTick.bCanEverTick = true;
+    PrimaryComponentTick.bCanEverTick = false;
 }
 
 void UInworldPlayerTargetingComponent::BeginPlay()
@@ -22,149 +23,45 @@ void UInworldPlayerTargetingComponent::BeginPlay()
     Super::BeginPlay();
 
     if (GetOwnerRole() != ROLE_Authority)
-    {
-        PrimaryComponentTick.SetTickFunctionEnable(false);
-    }
-    else
-	{
-		PrimaryComponentTick.SetTickFunctionEnable(true);
-        TArray<UActorComponent*> PlayerOwnerComponents = GetOwner()->GetComponentsByInterface(UInworldPlayerOwnerInterface::StaticClass());
-        if (ensureMsgf(PlayerOwnerComponents.Num() > 0, TEXT("The owner of the AudioCapture must contain an InworldPlayerOwner!")))
-        {
-            InworldPlayer = IInworldPlayerOwnerInterface::Execute_GetInworldPlayer(PlayerOwnerComponents[0]);
-        }
-    }
-}
-
-void UInworldPlayerTargetingComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
-{
-    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
-
-    UpdateTargetCharacters();
-}
-
-void UInworldPlayerTargetingComponent::UpdateTargetCharacters()
-{
-    if (!InworldPlayer.IsValid())
     {
         return;
     }
 
-    UInworldSession* InworldSession = InworldPlayer->GetSession();
-    if (!InworldSession || (InworldSession->GetConnectionState() != EInworldConnectionState::Connected && InworldSession->GetConnectionState() != EInworldConnectionState::Reconnecting))
+    TArray<UActorComponent*> PlayerOwnerComponents = GetOwner()->GetComponentsByInterface(UInworldPlayerOwnerInterface::StaticClass());
+    if (ensureMsgf(PlayerOwnerComponents.Num() > 0, TEXT("The owner of the AudioCapture must contain an InworldPlayerOwner!")))
     {
-        return;
+        InworldPlayer = IInworldPlayerOwnerInterface::Execute_GetInworldPlayer(PlayerOwnerComponents[0]);
     }
+    CameraComponent = Cast<UCameraComponent>(GetOwner()->GetComponentByClass(UCameraComponent::StaticClass()));
 
-    // clear all targets if just switched from multiple targeting
-    TArray<UInworldCharacter*> TargetCharacters = InworldPlayer->GetTargetCharacters();
-    if (!bMultipleTargets && TargetCharacters.Num() > 1)
+    if (UInworldPlayerTargetingSubsystem* TargetingSubsystem = GetWorld()->GetSubsystem<UInworldPlayerTargetingSubsystem>())
     {
-        InworldPlayer->ClearAllTargetCharacters();
-        TargetCharacters.Empty();
+        TargetingSubsystem->RegisterTargetingComponent(this);
     }
+}
 
-    // clear all targets out of range
-    const float MinDistSq = InteractionDistance * InteractionDistance;
-    const FVector Location = GetOwner()->GetActorLocation();
-    for (int32 i = 0; i < TargetCharacters.Num(); i++)
+void UInworldPlayerTargetingComponent::EndPlay(EEndPlayReason::Type Reason)
+{
+    if (UInworldPlayerTargetingSubsystem* TargetingSubsystem = GetWorld()->GetSubsystem<UInworldPlayerTargetingSubsystem>())
     {
-        UInworldCharacter* Character = TargetCharacters[i];
-        AActor* OuterActor = Character->GetTypedOuter<AActor>();
-        const FVector CharacterLocation = OuterActor != nullptr ? OuterActor->GetActorLocation() : FVector::ZeroVector;
-        const float DistSq = FVector::DistSquared(Location, CharacterLocation);
-        if (DistSq > MinDistSq)
-        {
-            InworldPlayer->RemoveTargetCharacter(Character);
-            TargetCharacters.RemoveAt(i);
-            i--;
-        }
+        TargetingSubsystem->UnregisterTargetingComponent(this);
     }
 
-    const TArray<UInworldCharacter*>& Characters = InworldSession->GetRegisteredCharacters();
-    UInworldCharacter* BestTarget = nullptr;
-    float BestTargetDot = -1.f;
-    for (UInworldCharacter* Character : Characters)
-    {
-        if (!Character->IsPossessed())
-        {
-            continue;
-        }
-
-        UInworldPlayer* Player = Character->GetTargetPlayer();
-        if (Player && Player != InworldPlayer)
-        {
-            continue;
-        }
-
-        AActor* OuterActor = Character->GetTypedOuter<AActor>();
-        if (!OuterActor)
-        {
-            continue;
-        }
-
-        const FVector CharacterLocation = OuterActor->GetActorLocation();
-        const float DistSq = FVector::DistSquared(Location, CharacterLocation);
-        if (DistSq > MinDistSq)
-        {
-            continue;
-        }
-
-        // if multiple targets enabled add all characters in range
-        if (bMultipleTargets)
-        {
-            int32 Idx;
-            if (TargetCharacters.Find(Character, Idx))
-            {
-                continue;
-            }
-
-            TargetCharacters.Add(Character);
-            InworldPlayer->AddTargetCharacter(Character);
-            continue;
-        }
-
-        // if multiple targets disabled target one character in range that we're looking at
-        const FVector2D Direction2D = FVector2D(CharacterLocation - Location).GetSafeNormal();
-        FVector2D Forward2D;
-        if (auto* CameraComponent = Cast<UCameraComponent>(GetOwner()->GetComponentByClass(UCameraComponent::StaticClass())))
-        {
-            Forward2D = FVector2D(CameraComponent->K2_GetComponentRotation().Vector());
-        }
-        else
-        {
-            Forward2D = FVector2D(GetOwner()->GetActorRotation().Vector());
-        }
-
-        const float Dot = FVector2D::DotProduct(Forward2D, Direction2D);
-        if (Dot < BestTargetDot)
-        {
-            continue;
-        }
-
-        BestTarget = Character;
-        BestTargetDot = Dot;
-    }
+    Super::EndPlay(Reason);
+}
 
-    if (bMultipleTargets)
+FVector2D UInworldPlayerTargetingComponent::GetForward2D()
+{
+    // camera could be swapped at runtime, search again only once the cached one is gone
+    if (CameraComponent.IsStale())
     {
-        return;
+        CameraComponent = Cast<UCameraComponent>(GetOwner()->GetComponentByClass(UCameraComponent::StaticClass()));
     }
 
-    UInworldCharacter* CurrentTarget = TargetCharacters.Num() != 0 ? TargetCharacters[0] : nullptr;
-    if (CurrentTarget != BestTarget)
+    if (CameraComponent.IsValid())
     {
-        if (CurrentTarget)
-        {
-			InworldPlayer->RemoveTargetCharacter(CurrentTarget);
-			TargetCharacters.Empty();
-        }
-
-        if (BestTarget)
-        {
-			TargetCharacters.Add(BestTarget);
-            InworldPlayer->AddTargetCharacter(BestTarget);
-        }
+        return FVector2D(CameraComponent->K2_GetComponentRotation().Vector());
     }
-}
 
+    return FVector2D(GetOwner()->GetActorRotation().Vector());
+}
@@ -0,0 +1,353 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#include "InworldPlayerTargetingSubsystem.h"
+#include "InworldPlayerTargetingComponent.h"
+#include "InworldCharacter.h"
+#include "InworldPlayer.h"
+#include "InworldSession.h"
+
+#include "InworldAIIntegrationModule.h"
+
+#include "Async/ParallelFor.h"
+#include <GameFramework/Actor.h>
+
+DECLARE_CYCLE_STAT(TEXT("Player Targeting"), STAT_InworldPlayerTargeting, STATGROUP_Inworld);
+
+static TAutoConsoleVariable<float> CVarTargetingCellSize(
+TEXT("Inworld.Targeting.CellSize"), 1000.f,
+TEXT("Size of the spatial hash cells used to find characters in interaction distance")
+);
+
+namespace Inworld
+{
+	struct FTargetingQuery
+	{
+		UInworldPlayer* Player;
+		UInworldSession* Session;
+		const FInworldCharacterSpatialHash* SpatialHash;
+		TArray<UInworldCharacter*> TargetCharacters;
+		FVector Location;
+		FVector2D Forward2D;
+		float InteractionDistance;
+		bool bMultipleTargets;
+	};
+
+	struct FTargetingResult
+	{
+		TArray<UInworldCharacter*> CharactersToRemove;
+		TArray<UInworldCharacter*> CharactersToAdd;
+		bool bClearAll = false;
+	};
+
+	// runs on worker threads, only reads the query and the spatial hash snapshot
+	static void EvaluateTargets(const FTargetingQuery& Query, FTargetingResult& Result)
+	{
+		TArray<UInworldCharacter*> TargetCharacters = Query.TargetCharacters;
+
+		// clear all targets if just switched from multiple targeting
+		if (!Query.bMultipleTargets && TargetCharacters.Num() > 1)
+		{
+			Result.bClearAll = true;
+			TargetCharacters.Empty();
+		}
+
+		// clear all targets out of range
+		const float MinDistSq = Query.InteractionDistance * Query.InteractionDistance;
+		for (int32 i = 0; i < TargetCharacters.Num(); i++)
+		{
+			const FInworldCharacterSpatialHash::FEntry* Entry = Query.SpatialHash->Find(TargetCharacters[i]);
+			if (!Entry || FVector::DistSquared(Query.Location, Entry->Location) > MinDistSq)
+			{
+				Result.CharactersToRemove.Add(TargetCharacters[i]);
+				TargetCharacters.RemoveAt(i);
+				i--;
+			}
+		}
+
+		UInworldCharacter* BestTarget = nullptr;
+		float BestTargetDot = -1.f;
+		Query.SpatialHash->ForEachInRadius(Query.Location, Query.InteractionDistance,
+			[&](const FInworldCharacterSpatialHash::FEntry& Entry)
+			{
+				if (!Entry.bPossessed)
+				{
+					return;
+				}
+
+				if (Entry.TargetPlayer && Entry.TargetPlayer != Query.Player)
+				{
+					return;
+				}
+
+				// if multiple targets enabled add all characters in range
+				if (Query.bMultipleTargets)
+				{
+					if (TargetCharacters.Contains(Entry.Character))
+					{
+						return;
+					}
+
+					TargetCharacters.Add(Entry.Character);
+					Result.CharactersToAdd.Add(Entry.Character);
+					return;
+				}
+
+				// if multiple targets disabled target one character in range that we're looking at
+				const FVector2D Direction2D = FVector2D(Entry.Location - Query.Location).GetSafeNormal();
+				const float Dot = FVector2D::DotProduct(Query.Forward2D, Direction2D);
+				if (Dot < BestTargetDot)
+				{
+					return;
+				}
+
+				BestTarget = Entry.Character;
+				BestTargetDot = Dot;
+			}
+		);
+
+		if (Query.bMultipleTargets)
+		{
+			return;
+		}
+
+		UInworldCharacter* CurrentTarget = TargetCharacters.Num() != 0 ? TargetCharacters[0] : nullptr;
+		if (CurrentTarget != BestTarget)
+		{
+			if (CurrentTarget)
+			{
+				Result.CharactersToRemove.Add(CurrentTarget);
+			}
+
+			if (BestTarget)
+			{
+				Result.CharactersToAdd.Add(BestTarget);
+			}
+		}
+	}
+}
+
+void FInworldCharacterSpatialHash::Update(const TArray<UInworldCharacter*>& Characters, float InCellSize)
+{
+	LastUpdateFrame = GFrameCounter;
+
+	if (CellSize != InCellSize)
+	{
+		CellSize = FMath::Max(InCellSize, 1.f);
+		Entries.Empty();
+		Cells.Empty();
+	}
+
+	for (UInworldCharacter* Character : Characters)
+	{
+		AActor* OuterActor = Character ? Character->GetTypedOuter<AActor>() : nullptr;
+		if (!OuterActor)
+		{
+			continue;
+		}
+
+		const FVector Location = OuterActor->GetActorLocation();
+		const FIntPoint Cell = GetCell(Location);
+
+		FEntry* Entry = Entries.Find(Character);
+		if (!Entry)
+		{
+			Entry = &Entries.Add(Character, { Character, nullptr, Location, Cell, LastUpdateFrame, false });
+			Cells.FindOrAdd(Cell).Add(Character);
+		}
+		else if (Entry->Cell != Cell)
+		{
+			RemoveFromCell(Character, Entry->Cell);
+			Cells.FindOrAdd(Cell).Add(Character);
+			Entry->Cell = Cell;
+		}
+
+		Entry->TargetPlayer = Character->GetTargetPlayer();
+		Entry->Location = Location;
+		Entry->UpdateFrame = LastUpdateFrame;
+		Entry->bPossessed = Character->IsPossessed();
+	}
+
+	// characters that weren't updated are no longer registered
+	for (auto It = Entries.CreateIterator(); It; ++It)
+	{
+		if (It->Value.UpdateFrame != LastUpdateFrame)
+		{
+			RemoveFromCell(It->Key, It->Value.Cell);
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void FInworldCharacterSpatialHash::ForEachInRadius(const FVector& Location, float Radius, TFunctionRef<void(const FEntry&)> Func) const
+{
+	const FIntPoint MinCell = GetCell(Location - FVector(Radius, Radius, 0.f));
+	const FIntPoint MaxCell = GetCell(Location + FVector(Radius, Radius, 0.f));
+	const float RadiusSq = Radius * Radius;
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			const TArray<UInworldCharacter*>* Cell = Cells.Find(FIntPoint(X, Y));
+			if (!Cell)
+			{
+				continue;
+			}
+
+			for (UInworldCharacter* Character : *Cell)
+			{
+				const FEntry& Entry = Entries[Character];
+				if (FVector::DistSquared(Location, Entry.Location) <= RadiusSq)
+				{
+					Func(Entry);
+				}
+			}
+		}
+	}
+}
+
+FIntPoint FInworldCharacterSpatialHash::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+}
+
+void FInworldCharacterSpatialHash::RemoveFromCell(UInworldCharacter* Character, const FIntPoint& Cell)
+{
+	if (TArray<UInworldCharacter*>* CellCharacters = Cells.Find(Cell))
+	{
+		CellCharacters->RemoveSingleSwap(Character);
+		if (CellCharacters->Num() == 0)
+		{
+			Cells.Remove(Cell);
+		}
+	}
+}
+
+const FInworldCharacterSpatialHash& UInworldPlayerTargetingSubsystem::GetCharacterSpatialHash(UInworldSession* Session)
+{
+	FInworldCharacterSpatialHash* SpatialHash = SessionSpatialHashes.Find(Session);
+	if (!SpatialHash)
+	{
+		for (auto It = SessionSpatialHashes.CreateIterator(); It; ++It)
+		{
+			if (!It->Key.IsValid())
+			{
+				It.RemoveCurrent();
+			}
+		}
+		SpatialHash = &SessionSpatialHashes.Add(Session);
+	}
+
+	if (SpatialHash->GetLastUpdateFrame() != GFrameCounter)
+	{
+		SpatialHash->Update(Session->GetRegisteredCharacters(), CVarTargetingCellSize.GetValueOnGameThread());
+	}
+
+	return *SpatialHash;
+}
+
+void UInworldPlayerTargetingSubsystem::RegisterTargetingComponent(UInworldPlayerTargetingComponent* Component)
+{
+	TargetingComponents.AddUnique(Component);
+}
+
+void UInworldPlayerTargetingSubsystem::UnregisterTargetingComponent(UInworldPlayerTargetingComponent* Component)
+{
+	TargetingComponents.RemoveSingle(Component);
+}
+
+bool UInworldPlayerTargetingSubsystem::DoesSupportWorldType(EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UInworldPlayerTargetingSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_InworldPlayerTargeting);
+
+	TargetingComponents.RemoveAll([](const TWeakObjectPtr<UInworldPlayerTargetingComponent>& Component) { return !Component.IsValid(); });
+
+	TArray<Inworld::FTargetingQuery> Queries;
+	Queries.Reserve(TargetingComponents.Num());
+	for (const TWeakObjectPtr<UInworldPlayerTargetingComponent>& WeakComponent : TargetingComponents)
+	{
+		UInworldPlayerTargetingComponent* Component = WeakComponent.Get();
+		Component->TimeSinceUpdate += DeltaTime;
+		if (Component->TimeSinceUpdate < Component->UpdateInterval)
+		{
+			continue;
+		}
+		Component->TimeSinceUpdate = 0.f;
+
+		UInworldPlayer* Player = Component->InworldPlayer.Get();
+		if (!Player)
+		{
+			continue;
+		}
+
+		UInworldSession* Session = Player->GetSession();
+		if (!Session || (Session->GetConnectionState() != EInworldConnectionState::Connected && Session->GetConnectionState() != EInworldConnectionState::Reconnecting))
+		{
+			continue;
+		}
+
+		// snapshot the characters of every session before any hash is referenced
+		GetCharacterSpatialHash(Session);
+
+		Inworld::FTargetingQuery& Query = Queries.AddDefaulted_GetRef();
+		Query.Player = Player;
+		Query.Session = Session;
+		Query.TargetCharacters = Player->GetTargetCharacters();
+		Query.Location = Component->GetOwner()->GetActorLocation();
+		Query.Forward2D = Component->bMultipleTargets ? FVector2D::ZeroVector : Component->GetForward2D();
+		Query.InteractionDistance = Component->InteractionDistance;
+		Query.bMultipleTargets = Component->bMultipleTargets;
+	}
+
+	for (Inworld::FTargetingQuery& Query : Queries)
+	{
+		Query.SpatialHash = &GetCharacterSpatialHash(Query.Session);
+	}
+
+	TArray<Inworld::FTargetingResult> Results;
+	Results.SetNum(Queries.Num());
+	ParallelFor(Queries.Num(),
+		[&Queries, &Results](int32 Idx)
+		{
+			Inworld::EvaluateTargets(Queries[Idx], Results[Idx]);
+		},
+		Queries.Num() < 2
+	);
+
+	for (int32 i = 0; i < Queries.Num(); ++i)
+	{
+		UInworldPlayer* Player = Queries[i].Player;
+		const Inworld::FTargetingResult& Result = Results[i];
+
+		if (Result.bClearAll)
+		{
+			Player->ClearAllTargetCharacters();
+		}
+
+		for (UInworldCharacter* Character : Result.CharactersToRemove)
+		{
+			Player->RemoveTargetCharacter(Character);
+		}
+
+		// another player could have taken the character earlier in this loop, AddTargetCharacter checks for it
+		for (UInworldCharacter* Character : Result.CharactersToAdd)
+		{
+			Player->AddTargetCharacter(Character);
+		}
+	}
+}
+
+TStatId UInworldPlayerTargetingSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UInworldPlayerTargetingSubsystem, STATGROUP_Tickables);
+}
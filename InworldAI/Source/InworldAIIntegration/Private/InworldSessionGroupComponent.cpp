@@ -0,0 +1,106 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#include "InworldSessionGroupComponent.h"
+#include "InworldApi.h"
+#include "InworldMacros.h"
+
+#include "InworldAIIntegrationModule.h"
+
+#include "Runtime/Launch/Resources/Version.h"
+#include <Engine/World.h>
+
+#define EMPTY_ARG_RETURN(Arg, Return) INWORLD_WARN_AND_RETURN_EMPTY(LogInworldAIIntegration, UInworldSessionGroupComponent, Arg, Return)
+#define NO_SESSION_GROUP_RETURN(Return) EMPTY_ARG_RETURN(InworldSessionGroup, Return)
+
+UInworldSessionGroupComponent::UInworldSessionGroupComponent()
+	: Super()
+	, InworldSessionGroup(nullptr)
+	, PreviousInworldSession(nullptr)
+{}
+
+void UInworldSessionGroupComponent::OnRegister()
+{
+	Super::OnRegister();
+
+	UWorld* World = GetWorld();
+	if (World && (World->WorldType == EWorldType::Game || World->WorldType == EWorldType::PIE) && World->GetNetMode() != NM_Client)
+	{
+		InworldSessionGroup = NewObject<UInworldSessionGroup>(this);
+		InworldSessionGroup->ShardPolicy = ShardPolicy;
+		InworldSessionGroup->MaxCharactersPerShard = MaxCharactersPerShard;
+		InworldSessionGroup->RegionSize = RegionSize;
+		InworldSessionGroup->Init(NumShards);
+
+		// the first shard stands in for code that expects a single session
+		UInworldApiSubsystem* InworldApiSubsystem = World->GetSubsystem<UInworldApiSubsystem>();
+		PreviousInworldSession = InworldApiSubsystem->GetInworldSessionIfSet();
+		InworldApiSubsystem->SetInworldSessionGroup(InworldSessionGroup);
+		InworldApiSubsystem->SetInworldSession(InworldSessionGroup->GetShards()[0]);
+	}
+}
+
+void UInworldSessionGroupComponent::OnUnregister()
+{
+	Super::OnUnregister();
+
+	if (IsValid(InworldSessionGroup))
+	{
+		UWorld* World = GetWorld();
+		UInworldApiSubsystem* InworldApiSubsystem = World ? World->GetSubsystem<UInworldApiSubsystem>() : nullptr;
+		if (InworldApiSubsystem && InworldApiSubsystem->GetInworldSessionGroup() == InworldSessionGroup)
+		{
+			InworldApiSubsystem->SetInworldSessionGroup(nullptr);
+		}
+		if (InworldApiSubsystem && InworldSessionGroup->GetShards().Contains(InworldApiSubsystem->GetInworldSessionIfSet()))
+		{
+			InworldApiSubsystem->SetInworldSession(PreviousInworldSession);
+		}
+
+		InworldSessionGroup->Destroy();
+#if ENGINE_MAJOR_VERSION == 5
+		InworldSessionGroup->MarkAsGarbage();
+#endif
+
+#if ENGINE_MAJOR_VERSION == 4
+		InworldSessionGroup->MarkPendingKill();
+#endif
+	}
+	InworldSessionGroup = nullptr;
+	PreviousInworldSession = nullptr;
+}
+
+void UInworldSessionGroupComponent::StartSessionsFromScene(const FInworldScene& Scene)
+{
+	NO_SESSION_GROUP_RETURN(void())
+
+	InworldSessionGroup->StartSessionsFromScene(Scene, PlayerProfile, CapabilitySet, Metadata, Workspace, Auth);
+}
+
+void UInworldSessionGroupComponent::StopSessions()
+{
+	NO_SESSION_GROUP_RETURN(void())
+
+	InworldSessionGroup->StopSessions();
+}
+
+void UInworldSessionGroupComponent::PauseSessions()
+{
+	NO_SESSION_GROUP_RETURN(void())
+
+	InworldSessionGroup->PauseSessions();
+}
+
+void UInworldSessionGroupComponent::ResumeSessions()
+{
+	NO_SESSION_GROUP_RETURN(void())
+
+	InworldSessionGroup->ResumeSessions();
+}
+
+#undef EMPTY_ARG_RETURN
+#undef NO_SESSION_GROUP_RETURN
@@ -0,0 +1,461 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#include "InworldStudioClient.h"
+#include "InworldAIIntegrationModule.h"
+#include "InworldAIIntegrationSettings.h"
+
+#include "Engine/Engine.h"
+#include "GenericPlatform/GenericPlatformHttp.h"
+#include "HAL/FileManager.h"
+#include "HttpModule.h"
+#include "Interfaces/IHttpRequest.h"
+#include "Interfaces/IHttpResponse.h"
+#include "JsonObjectConverter.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/SecureHash.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+struct FInworldStudioClient::FPagedFetch
+{
+	FString Url;
+	FString ApiKey;
+	bool bCacheable = false;
+	bool bPaginated = false;
+	FString PageToken;
+	TSharedPtr<FJsonObject> Merged;
+	FOnResource Callback;
+};
+
+FInworldStudioClient::FInworldStudioClient(const FString& InCacheDirectory, FTransport InTransport)
+	: CacheDirectory(InCacheDirectory)
+	, Transport(InTransport ? MoveTemp(InTransport) : MakeHttpTransport())
+{}
+
+void FInworldStudioClient::GetResource(const FString& Url, const FString& ApiKey, bool bCacheable, bool bPaginated, FOnResource Callback)
+{
+	TSharedRef<FPagedFetch> Fetch = MakeShared<FPagedFetch>();
+	Fetch->Url = Url;
+	Fetch->ApiKey = ApiKey;
+	Fetch->bCacheable = bCacheable;
+	Fetch->bPaginated = bPaginated;
+	Fetch->Callback = MoveTemp(Callback);
+	FetchNextPage(Fetch);
+}
+
+void FInworldStudioClient::GetWorkspaceContents(const FString& ApiUrl, const FString& Workspace, const FString& ApiKey, FOnWorkspaceContents Callback)
+{
+	struct FContents
+	{
+		FInworldStudioCharacters Characters;
+		FInworldStudioScenes Scenes;
+		int32 NumPending = 2;
+		FString Error;
+		FOnWorkspaceContents Callback;
+
+		void Complete(const FString& InError)
+		{
+			if (Error.IsEmpty())
+			{
+				Error = InError;
+			}
+			if (--NumPending == 0)
+			{
+				Callback(Characters, Scenes, Error.IsEmpty(), Error);
+			}
+		}
+	};
+	TSharedRef<FContents> Contents = MakeShared<FContents>();
+	Contents->Callback = MoveTemp(Callback);
+
+	// both resources are queued at once, they run in parallel within the in flight limit
+	GetResource(FString::Format(TEXT("https://{0}/studio/v1/workspaces/{1}/characters"), { ApiUrl, Workspace }), ApiKey, true, true,
+		[Contents](bool bSuccess, const FString& Json, const FString& Error)
+		{
+			if (bSuccess && !FJsonObjectConverter::JsonObjectStringToUStruct(Json, &Contents->Characters))
+			{
+				Contents->Complete(FString::Format(TEXT("Invalid Inworld Studio response. json={0}"), { Json }));
+				return;
+			}
+			Contents->Complete(Error);
+		});
+	GetResource(FString::Format(TEXT("https://{0}/studio/v1/workspaces/{1}/scenes"), { ApiUrl, Workspace }), ApiKey, true, true,
+		[Contents](bool bSuccess, const FString& Json, const FString& Error)
+		{
+			if (bSuccess && !FJsonObjectConverter::JsonObjectStringToUStruct(Json, &Contents->Scenes))
+			{
+				Contents->Complete(FString::Format(TEXT("Invalid Inworld Studio response. json={0}"), { Json }));
+				return;
+			}
+			Contents->Complete(Error);
+		});
+}
+
+void FInworldStudioClient::SetMaxInFlight(int32 InMaxInFlight)
+{
+	MaxInFlight = FMath::Max(InMaxInFlight, 1);
+	SendNext();
+}
+
+void FInworldStudioClient::SetMaxDiskBytes(int64 InMaxDiskBytes)
+{
+	MaxDiskBytes = FMath::Max<int64>(InMaxDiskBytes, 0);
+	if (!CacheDirectory.IsEmpty())
+	{
+		EvictDisk(FString());
+	}
+}
+
+void FInworldStudioClient::ClearCache()
+{
+	MemoryCache.Empty();
+	if (!CacheDirectory.IsEmpty())
+	{
+		IFileManager::Get().DeleteDirectory(*CacheDirectory, false, true);
+		DiskFiles.Empty();
+		Stats.DiskBytes = 0;
+		bDiskScanned = true;
+	}
+}
+
+FInworldStudioClient::FTransport FInworldStudioClient::MakeHttpTransport()
+{
+	return [](const FInworldStudioHttpRequest& Request, FOnResponse OnResponse)
+	{
+		FHttpRequestPtr HttpRequest = FHttpModule::Get().CreateRequest();
+		HttpRequest->SetURL(Request.Url);
+		HttpRequest->SetVerb("GET");
+		for (const TPair<FString, FString>& Header : Request.Headers)
+		{
+			HttpRequest->SetHeader(Header.Key, Header.Value);
+		}
+		HttpRequest->OnProcessRequestComplete().BindLambda(
+			[OnResponse](FHttpRequestPtr, FHttpResponsePtr HttpResponse, bool bSuccess)
+			{
+				FInworldStudioHttpResponse Response;
+				Response.bSuccess = bSuccess && HttpResponse.IsValid();
+				if (HttpResponse.IsValid())
+				{
+					Response.Code = HttpResponse->GetResponseCode();
+					Response.Content = HttpResponse->GetContentAsString();
+					Response.ETag = HttpResponse->GetHeader(TEXT("ETag"));
+				}
+				OnResponse(Response);
+			}
+		);
+		HttpRequest->ProcessRequest();
+	};
+}
+
+void FInworldStudioClient::FetchNextPage(TSharedRef<FPagedFetch> Fetch)
+{
+	FInworldStudioHttpRequest Request;
+	Request.Url = Fetch->Url;
+	if (Fetch->bPaginated)
+	{
+		Request.Url += FString::Printf(TEXT("%spageSize=%d"), Fetch->Url.Contains(TEXT("?")) ? TEXT("&") : TEXT("?"), PageSize);
+		if (!Fetch->PageToken.IsEmpty())
+		{
+			Request.Url += TEXT("&pageToken=") + FGenericPlatformHttp::UrlEncode(Fetch->PageToken);
+		}
+	}
+	Request.Headers.Add(TEXT("Content-Type"), TEXT("application/json"));
+	Request.Headers.Add(TEXT("Authorization"), TEXT("Basic ") + Fetch->ApiKey);
+	Request.Headers.Add(TEXT("Grpc-Metadata-X-Authorization-Bearer-Type"), TEXT("studio_api"));
+
+	// keyed by the api key too, responses depend on its permissions
+	FString CacheKey;
+	FCachedResponse Cached;
+	bool bHasCached = false;
+	if (Fetch->bCacheable)
+	{
+		const FTCHARToUTF8 Converted(*(Request.Url + TEXT("\n") + Fetch->ApiKey));
+		uint8 Hash[FSHA1::DigestSize];
+		FSHA1::HashBuffer(Converted.Get(), Converted.Length(), Hash);
+		CacheKey = BytesToHex(Hash, FSHA1::DigestSize);
+
+		bHasCached = FindCached(CacheKey, Cached);
+		if (bHasCached)
+		{
+			Request.Headers.Add(TEXT("If-None-Match"), Cached.ETag);
+		}
+	}
+
+	TWeakPtr<FInworldStudioClient> WeakThis = AsShared();
+	Send(MoveTemp(Request), [WeakThis, Fetch, CacheKey, Cached = MoveTemp(Cached), bHasCached](const FInworldStudioHttpResponse& Response)
+	{
+		TSharedPtr<FInworldStudioClient> This = WeakThis.Pin();
+		if (!This.IsValid())
+		{
+			return;
+		}
+		This->Stats.NumPages++;
+
+		FString Content;
+		if (bHasCached && Response.Code == EHttpResponseCodes::NotModified)
+		{
+			This->Stats.NumNotModified++;
+			Content = Cached.Content;
+		}
+		else if (Response.bSuccess && EHttpResponseCodes::IsOk(Response.Code))
+		{
+			Content = Response.Content;
+			if (!CacheKey.IsEmpty() && !Response.ETag.IsEmpty())
+			{
+				This->StoreCached(CacheKey, { Response.ETag, Response.Content });
+			}
+		}
+		else
+		{
+			Fetch->Callback(false, FString(), FString::Format(TEXT("Invalid Inworld Studio response. code={0} error={1}"), { FString::FromInt(Response.Code), Response.Content }));
+			return;
+		}
+
+		TSharedPtr<FJsonObject> Page;
+		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Content);
+		if (!FJsonSerializer::Deserialize(Reader, Page) || !Page.IsValid())
+		{
+			Fetch->Callback(false, FString(), FString::Format(TEXT("Invalid Inworld Studio response. json={0}"), { Content }));
+			return;
+		}
+
+		if (!Fetch->Merged.IsValid())
+		{
+			Fetch->Merged = Page;
+		}
+		else
+		{
+			for (const TPair<FString, TSharedPtr<FJsonValue>>& Field : Page->Values)
+			{
+				const TArray<TSharedPtr<FJsonValue>>* PageItems = nullptr;
+				if (Field.Value->TryGetArray(PageItems) && Fetch->Merged->HasTypedField<EJson::Array>(Field.Key))
+				{
+					TArray<TSharedPtr<FJsonValue>> Items = Fetch->Merged->GetArrayField(Field.Key);
+					Items.Append(*PageItems);
+					Fetch->Merged->SetArrayField(Field.Key, Items);
+				}
+			}
+		}
+
+		FString NextPageToken;
+		Page->TryGetStringField(TEXT("nextPageToken"), NextPageToken);
+		if (Fetch->bPaginated && !NextPageToken.IsEmpty() && NextPageToken != Fetch->PageToken)
+		{
+			Fetch->PageToken = NextPageToken;
+			This->FetchNextPage(Fetch);
+			return;
+		}
+
+		Fetch->Merged->RemoveField(TEXT("nextPageToken"));
+		FString Json;
+		TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+		FJsonSerializer::Serialize(Fetch->Merged.ToSharedRef(), Writer);
+		Fetch->Callback(true, Json, FString());
+	});
+}
+
+void FInworldStudioClient::Send(FInworldStudioHttpRequest&& Request, FOnResponse&& OnResponse)
+{
+	Queue.Emplace(MoveTemp(Request), MoveTemp(OnResponse));
+	SendNext();
+}
+
+void FInworldStudioClient::SendNext()
+{
+	while (NumInFlight < MaxInFlight && Queue.Num() > 0)
+	{
+		TPair<FInworldStudioHttpRequest, FOnResponse> Next = MoveTemp(Queue[0]);
+		Queue.RemoveAt(0);
+
+		NumInFlight++;
+		Stats.NumRequests++;
+		Stats.MaxInFlight = FMath::Max(Stats.MaxInFlight, NumInFlight);
+
+		TWeakPtr<FInworldStudioClient> WeakThis = AsShared();
+		Transport(Next.Key, [WeakThis, OnResponse = MoveTemp(Next.Value)](const FInworldStudioHttpResponse& Response)
+		{
+			TSharedPtr<FInworldStudioClient> This = WeakThis.Pin();
+			if (!This.IsValid())
+			{
+				return;
+			}
+			This->NumInFlight--;
+			OnResponse(Response);
+			This->SendNext();
+		});
+	}
+}
+
+bool FInworldStudioClient::FindCached(const FString& Key, FCachedResponse& OutResponse)
+{
+	if (const FCachedResponse* Cached = MemoryCache.Find(Key))
+	{
+		OutResponse = *Cached;
+		return true;
+	}
+
+	FString JsonString;
+	if (CacheDirectory.IsEmpty() || !FFileHelper::LoadFileToString(JsonString, *GetCacheFilePath(Key)))
+	{
+		return false;
+	}
+
+	TSharedPtr<FJsonObject> JsonObject;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(JsonString);
+	if (!FJsonSerializer::Deserialize(Reader, JsonObject) ||
+		!JsonObject->TryGetStringField(TEXT("etag"), OutResponse.ETag) ||
+		!JsonObject->TryGetStringField(TEXT("content"), OutResponse.Content))
+	{
+		UE_LOG(LogInworldAIIntegration, Warning, TEXT("Invalid cached Studio response %s"), *GetCacheFilePath(Key));
+		return false;
+	}
+
+	MemoryCache.Add(Key, OutResponse);
+	// revalidated responses are the last to be evicted
+	ScanDisk();
+	if (FDiskFile* File = DiskFiles.Find(Key))
+	{
+		File->Order = ++DiskCounter;
+	}
+	return true;
+}
+
+void FInworldStudioClient::StoreCached(const FString& Key, const FCachedResponse& Response)
+{
+	MemoryCache.Add(Key, Response);
+	if (CacheDirectory.IsEmpty())
+	{
+		return;
+	}
+
+	TSharedRef<FJsonObject> JsonObject = MakeShared<FJsonObject>();
+	JsonObject->SetStringField(TEXT("etag"), Response.ETag);
+	JsonObject->SetStringField(TEXT("content"), Response.Content);
+
+	FString JsonString;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonString);
+	if (!FJsonSerializer::Serialize(JsonObject, Writer) || !FFileHelper::SaveStringToFile(JsonString, *GetCacheFilePath(Key), FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		UE_LOG(LogInworldAIIntegration, Warning, TEXT("Failed to save cached Studio response %s"), *GetCacheFilePath(Key));
+		return;
+	}
+
+	ScanDisk();
+	AddToDisk(Key, FTCHARToUTF8(*JsonString).Length());
+	EvictDisk(Key);
+}
+
+FString FInworldStudioClient::GetCacheFilePath(const FString& Key) const
+{
+	return FPaths::Combine(CacheDirectory, Key + TEXT(".json"));
+}
+
+void FInworldStudioClient::EvictDisk(const FString& LatestKey)
+{
+	ScanDisk();
+	while (Stats.DiskBytes > MaxDiskBytes)
+	{
+		// the latest response is kept even over the limit
+		const FString* Oldest = nullptr;
+		uint64 OldestOrder = MAX_uint64;
+		for (const auto& File : DiskFiles)
+		{
+			if (File.Value.Order < OldestOrder && File.Key != LatestKey)
+			{
+				Oldest = &File.Key;
+				OldestOrder = File.Value.Order;
+			}
+		}
+		if (Oldest == nullptr)
+		{
+			return;
+		}
+
+		// forgotten even if the delete fails, so a locked file can't stall eviction, still served from memory this session
+		const FString Key = *Oldest;
+		if (IFileManager::Get().Delete(*GetCacheFilePath(Key), false, false, true))
+		{
+			Stats.NumEvicted++;
+		}
+		RemoveFromDisk(Key);
+	}
+}
+
+void FInworldStudioClient::ScanDisk()
+{
+	if (bDiskScanned || CacheDirectory.IsEmpty())
+	{
+		return;
+	}
+	bDiskScanned = true;
+
+	struct FFile
+	{
+		FString Key;
+		FDateTime ModificationTime;
+		int64 Size;
+	};
+	TArray<FFile> Files;
+	IFileManager::Get().IterateDirectoryStat(*CacheDirectory, [&Files](const TCHAR* Path, const FFileStatData& StatData)
+	{
+		if (!StatData.bIsDirectory && FPaths::GetExtension(Path) == TEXT("json"))
+		{
+			Files.Add({ FPaths::GetBaseFilename(Path), StatData.ModificationTime, StatData.FileSize });
+		}
+		return true;
+	});
+
+	// files of previous runs are older than any stored from now on
+	Files.Sort([](const FFile& A, const FFile& B) { return A.ModificationTime < B.ModificationTime; });
+	for (const FFile& File : Files)
+	{
+		AddToDisk(File.Key, File.Size);
+	}
+}
+
+void FInworldStudioClient::AddToDisk(const FString& Key, int64 Size)
+{
+	RemoveFromDisk(Key);
+	DiskFiles.Add(Key, { Size, ++DiskCounter });
+	Stats.DiskBytes += Size;
+}
+
+void FInworldStudioClient::RemoveFromDisk(const FString& Key)
+{
+	FDiskFile File;
+	if (DiskFiles.RemoveAndCopyValue(Key, File))
+	{
+		Stats.DiskBytes -= File.Size;
+	}
+}
+
+UInworldStudioClientSubsystem* UInworldStudioClientSubsystem::Get()
+{
+	return GEngine ? GEngine->GetEngineSubsystem<UInworldStudioClientSubsystem>() : nullptr;
+}
+
+void UInworldStudioClientSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const UInworldAIIntegrationSettings* InworldAIIntegrationSettings = GetDefault<UInworldAIIntegrationSettings>();
+	const FString CacheDirectory = InworldAIIntegrationSettings->bCacheStudioResponses ? FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("InworldAI"), TEXT("StudioCache")) : FString();
+	Client = MakeShared<FInworldStudioClient>(CacheDirectory);
+	Client->SetMaxInFlight(InworldAIIntegrationSettings->MaxInFlightStudioRequests);
+	Client->SetMaxDiskBytes(static_cast<int64>(InworldAIIntegrationSettings->MaxStudioCacheDiskMB) * 1024 * 1024);
+}
+
+void UInworldStudioClientSubsystem::Deinitialize()
+{
+	// pending callbacks are dropped with the client
+	Client.Reset();
+
+	Super::Deinitialize();
+}
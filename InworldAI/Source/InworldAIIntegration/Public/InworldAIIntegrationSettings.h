@@ -29,4 +29,22 @@ public:
 	 */
 	UPROPERTY(config, EditAnywhere, Category = "Inworld")
 	FString StudioApiKey;
+
+	/**
+	 * Keep Studio responses on disk and revalidate them instead of downloading them again.
+	 */
+	UPROPERTY(config, EditAnywhere, Category = "Inworld")
+	bool bCacheStudioResponses = true;
+
+	/**
+	 * Disk limit of the cached Studio responses, oldest ones are deleted first.
+	 */
+	UPROPERTY(config, EditAnywhere, Category = "Inworld", meta = (EditCondition = "bCacheStudioResponses", ClampMin = "0"))
+	int32 MaxStudioCacheDiskMB = 32;
+
+	/**
+	 * The maximum number of Studio requests in flight, further requests are queued.
+	 */
+	UPROPERTY(config, EditAnywhere, Category = "Inworld", meta = (ClampMin = "1"))
+	int32 MaxInFlightStudioRequests = 4;
 };
@@ -0,0 +1,117 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InworldEnums.h"
+#include "Engine/StreamableManager.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "InworldAnimationPreloadSubsystem.generated.h"
+
+USTRUCT(BlueprintType)
+struct INWORLDAIINTEGRATION_API FInworldAnimationPreloadStats
+{
+	GENERATED_BODY()
+
+	/** Assets requested to be streamed in. */
+	UPROPERTY(BlueprintReadOnly, Category = "Animation")
+	int32 NumRequested = 0;
+
+	/** Assets streamed in. */
+	UPROPERTY(BlueprintReadOnly, Category = "Animation")
+	int32 NumLoaded = 0;
+
+	/** Assets released to stay within the budget. */
+	UPROPERTY(BlueprintReadOnly, Category = "Animation")
+	int32 NumEvicted = 0;
+
+	/** Assets that failed to stream in, they are requested again on their next use. */
+	UPROPERTY(BlueprintReadOnly, Category = "Animation")
+	int32 NumFailed = 0;
+
+	/** Soft montages found streamed in when GetMontageForEmotion fills a pool, each one a load hitch avoided. */
+	UPROPERTY(BlueprintReadOnly, Category = "Animation")
+	int32 NumHits = 0;
+
+	/** Soft montages GetMontageForEmotion skipped because they weren't streamed in yet. */
+	UPROPERTY(BlueprintReadOnly, Category = "Animation")
+	int32 NumMisses = 0;
+
+	/** Estimated size of the assets held by the preloader, montages include the animations they reference. */
+	UPROPERTY(BlueprintReadOnly, Category = "Animation")
+	int64 ResidentBytes = 0;
+};
+
+/**
+ * Streams animation assets in ahead of use and keeps the most recently used ones within
+ * a memory budget (Inworld.Animation.PreloadBudgetMB). Also learns which emotion tends to follow
+ * another, across all characters of the world, to predict what to stream in next.
+ */
+UCLASS()
+class INWORLDAIINTEGRATION_API UInworldAnimationPreloadSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Request assets to be streamed in asynchronously, assets already requested are only marked as used.
+	 * @param Paths The assets to load.
+	 */
+	void Preload(TArrayView<const FSoftObjectPath> Paths);
+
+	/**
+	 * Count a montage found by a lookup, a skipped montage is requested so the next lookup finds it.
+	 * @param Path The montage of a matching row.
+	 * @param bStreamedIn Whether the montage was loaded and used, false if it was skipped.
+	 */
+	void NotifyLookup(const FSoftObjectPath& Path, bool bStreamedIn);
+
+	/**
+	 * Record that an emotion followed another one.
+	 */
+	void RecordEmotionTransition(EInworldCharacterEmotionalBehavior From, EInworldCharacterEmotionalBehavior To);
+
+	/**
+	 * Get the emotions most often seen after an emotion, most likely first.
+	 * @param From The current emotion.
+	 * @param Num The maximum number of emotions.
+	 * @param OutEmotions The predicted emotions, excluding From.
+	 */
+	void PredictNextEmotions(EInworldCharacterEmotionalBehavior From, int32 Num, TArray<EInworldCharacterEmotionalBehavior>& OutEmotions) const;
+
+	/**
+	 * Get the preloading stats.
+	 */
+	UFUNCTION(BlueprintPure, Category = "Animation")
+	FInworldAnimationPreloadStats GetStats() const { return Stats; }
+
+	virtual void Deinitialize() override;
+
+private:
+	void OnLoaded(FSoftObjectPath Path);
+	void EvictToBudget();
+
+	struct FEntry
+	{
+		TSharedPtr<FStreamableHandle> Handle;
+		int64 Size = 0;
+		uint64 LastUsed = 0;
+		bool bLoaded = false;
+	};
+
+	static constexpr int32 NumEmotions = static_cast<int32>(EInworldCharacterEmotionalBehavior::JOY) + 1;
+
+	FStreamableManager StreamableManager;
+	TMap<FSoftObjectPath, FEntry> Entries;
+	uint64 UseCounter = 0;
+
+	uint16 EmotionTransitions[NumEmotions][NumEmotions] = {};
+
+	FInworldAnimationPreloadStats Stats;
+};
@@ -13,6 +13,7 @@
 
 #include "InworldClient.h"
 #include "InworldSession.h"
+#include "InworldSessionGroup.h"
 #include "InworldEnums.h"
 #include "InworldTypes.h"
 #include "InworldPackets.h"
@@ -25,6 +26,8 @@ class UInworldAudioRepl;
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnConnectionStateChanged, EInworldConnectionState, State);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnCharactersInitialized, bool, bCharactersInitialized);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FCustomTrigger, FString, Name);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FCustomTriggers, const TArray<FString>&, Names);
+DECLARE_MULTICAST_DELEGATE_OneParam(FCustomTriggersNative, TArrayView<const FString> /*Names*/);
 
 UCLASS(BlueprintType, Config = InworldAI)
 class INWORLDAIINTEGRATION_API UInworldApiSubsystem : public UWorldSubsystem
@@ -43,6 +46,18 @@ public:
     UFUNCTION(BlueprintPure, Category = "Session")
     UInworldSession* GetInworldSession();
 
+    /** The current session without creating one. */
+    UInworldSession* GetInworldSessionIfSet() const { return InworldSession; }
+
+    void SetInworldSessionGroup(UInworldSessionGroup* SessionGroup) { InworldSessionGroup = SessionGroup; }
+
+    /**
+     * Get the session group characters and players are spread across, if any.
+     * @return The session group, nullptr when a single session is used.
+     */
+    UFUNCTION(BlueprintPure, Category = "Session")
+    UInworldSessionGroup* GetInworldSessionGroup() const { return InworldSessionGroup; }
+
     /**
      * Start InworldAI session
      * Call after all Player/Character components have been registered
@@ -214,7 +229,13 @@ public:
      * Custom events meant to be triggered on interaction end (see InworldCharacterComponent)
      * @param Name Name of the custom trigger
      */
-    void NotifyCustomTrigger(const FString& Name) { OnCustomTrigger.Broadcast(Name); }
+    void NotifyCustomTrigger(const FString& Name) { NotifyCustomTriggers(MakeArrayView(&Name, 1)); }
+
+    /**
+     * Call on interaction end with all custom events of the interaction
+     * @param Names Names of the custom triggers, in arrival order
+     */
+    void NotifyCustomTriggers(TArrayView<const FString> Names);
 
     /** 
     * Call this in multiplayer on BeginPlay both on server and client
@@ -232,7 +253,10 @@ public:
 #endif
 
 	   void ReplicateAudioEventFromServer(FInworldAudioDataEvent& Packet);
+    void ReplicateA2FHeaderEventFromServer(const FInworldA2FHeaderEvent& Packet);
+    void ReplicateA2FContentEventFromServer(const FInworldA2FContentEvent& Packet);
     void HandleAudioEventOnClient(TSharedPtr<FInworldAudioDataEvent> Packet);
+    void HandleA2FEventOnClient(TSharedPtr<FInworldPacket> Packet);
 
     /**
      * Event dispatcher for when the connection state changes. (Deprecated, use InworldSession->OnConnectionStateChanged.)
@@ -252,13 +276,27 @@ public:
     UPROPERTY(BlueprintAssignable, BlueprintCallable, Category = "EventDispatchers", meta = (DeprecatedProperty, DeprecationMessage = "Use InworldCharacter->OnTrigger."))
     FCustomTrigger OnCustomTrigger;
 
+    /**
+     * Event dispatcher for all custom triggers of an interaction at once, in arrival order.
+     */
+    UPROPERTY(BlueprintAssignable, Category = "EventDispatchers")
+    FCustomTriggers OnCustomTriggers;
+
+    /** Same as OnCustomTriggers, without copying the names. */
+    FCustomTriggersNative OnCustomTriggersNative;
+
 private:
+    void HandleReplicatedPacketOnClient(TSharedPtr<FInworldPacket> Packet);
+
     UPROPERTY()
     UInworldAudioRepl* AudioRepl;
 
     UPROPERTY()
     UInworldSession* InworldSession;
 
+    UPROPERTY()
+    UInworldSessionGroup* InworldSessionGroup;
+
 #if defined(WITH_GAMEPLAY_DEBUGGER) && WITH_GAMEPLAY_DEBUGGER
 	friend class FInworldGameplayDebuggerCategory;
 #endif
@@ -15,6 +15,8 @@
 #include "InworldAudioRepl.generated.h"
 
 struct FInworldAudioDataEvent;
+struct FInworldA2FHeaderEvent;
+struct FInworldA2FContentEvent;
 namespace Inworld { class FSocketBase; }
 
 UCLASS()
@@ -30,11 +32,33 @@ public:
 	virtual TStatId GetStatId() const override;
 	
 	void ReplicateAudioEvent(FInworldAudioDataEvent& Event);
+	void ReplicateA2FHeaderEvent(const FInworldA2FHeaderEvent& Event);
+	void ReplicateA2FContentEvent(const FInworldA2FContentEvent& Event);
 
 private:
 	void ListenAudioSocket();
 
+	void SendData(TArray<uint8>& Data);
+
+	void SerializeA2FBlendShapeWeights(FArchive& Ar, const FString& AgentId, const TArray<float>& Values);
+	bool DeserializeA2FBlendShapeWeights(FArchive& Ar, const FString& AgentId, TArray<float>& Values);
+
 	Inworld::FSocketBase& GetAudioSocket(const FInternetAddr& IpAddr);
 
 	TMap<FString, TUniquePtr<Inworld::FSocketBase>> AudioSockets;
+
+	/**
+	 * Quantized blend shape weights of the last frame sent or received for an agent.
+	 * Content frames are delta coded against it, so sender and receiver keep one per agent.
+	 */
+	struct FA2FStreamState
+	{
+		TArray<uint16> Weights;
+		uint16 Sequence = 0;
+		uint8 Bits = 0;
+		int32 FramesSinceKeyFrame = 0;
+		bool bValid = false;
+	};
+
+	TMap<FString, FA2FStreamState> A2FStreams;
 };
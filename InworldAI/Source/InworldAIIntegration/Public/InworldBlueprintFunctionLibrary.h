@@ -99,6 +99,7 @@ public:
 	DECLARE_DYNAMIC_DELEGATE_ThreeParams(FOnInworldStudioCharacters, const FInworldStudioCharacters&, Characters, bool, bSuccess, const FString&, Error);
 	/**
 	 * Get Inworld Studio Characters.
+	 * Use GetInworldStudioWorkspaceContents when the scenes are needed too, it fetches both in parallel.
 	 * @param Callback The delegate to be called upon completion.
 	 * @param Workspace The workspace for which to retrieve the characters.
 	 * @param StudioApiKeyOverride The optional Studio API key override.
@@ -109,6 +110,7 @@ public:
 	DECLARE_DYNAMIC_DELEGATE_ThreeParams(FOnInworldStudioScenes, const FInworldStudioScenes&, Scenes, bool, bSuccess, const FString&, Error);
 	/**
 	 * Get Inworld Studio Scenes.
+	 * Use GetInworldStudioWorkspaceContents when the characters are needed too, it fetches both in parallel.
 	 * @param Callback The delegate to be called upon completion.
 	 * @param Workspace The workspace for which to retrieve the scenes.
 	 * @param StudioApiKeyOverride The optional Studio API key override.
@@ -116,6 +118,16 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Inworld|Studio", meta = (AdvancedDisplay = "2", AutoCreateRefTerm = "StudioApiKeyOverride"))
 	static void GetInworldStudioScenes(const FOnInworldStudioScenes& Callback, const FString& Workspace, const FString& StudioApiKeyOverride);
 
+	DECLARE_DYNAMIC_DELEGATE_FourParams(FOnInworldStudioWorkspaceContents, const FInworldStudioCharacters&, Characters, const FInworldStudioScenes&, Scenes, bool, bSuccess, const FString&, Error);
+	/**
+	 * Get the Inworld Studio Characters and Scenes of a workspace, fetched in parallel.
+	 * @param Callback The delegate to be called upon completion.
+	 * @param Workspace The workspace for which to retrieve the characters and scenes.
+	 * @param StudioApiKeyOverride The optional Studio API key override.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Inworld|Studio", meta = (AdvancedDisplay = "2", AutoCreateRefTerm = "StudioApiKeyOverride"))
+	static void GetInworldStudioWorkspaceContents(const FOnInworldStudioWorkspaceContents& Callback, const FString& Workspace, const FString& StudioApiKeyOverride);
+
 	/**
 	 * Convert a SoundWave to a byte array.
 	 * @param SoundWave The SoundWave to convert.
@@ -40,6 +40,35 @@ public:
 	TArray<UAnimMontage*> Montages;
 };
 
+/**
+ * Emotion animations referenced softly, montages are streamed in by UInworldCharacterPlaybackAnimationPreload.
+ */
+USTRUCT(BlueprintType)
+struct INWORLDAIINTEGRATION_API FInworldAnimationSoftTableRow : public FTableRowBase
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * The key representing the emotional behavior of the character.
+	 */
+	UPROPERTY(BlueprintReadOnly, EditDefaultsOnly, Category = "Animation", DisplayName = "Emotion")
+	EInworldCharacterEmotionalBehavior Key = EInworldCharacterEmotionalBehavior::NEUTRAL;
+
+	/**
+	 * The strength of the character's emotion.
+	 */
+	UPROPERTY(BlueprintReadOnly, EditDefaultsOnly, Category = "Animation")
+	EInworldCharacterEmotionStrength Strength = EInworldCharacterEmotionStrength::UNSPECIFIED;
+
+	/**
+	 * An array of animation montages for the character, only loaded montages are returned by GetMontageForEmotion.
+	 * Montages skipped because they aren't loaded are counted as preload misses and requested.
+	 */
+	UPROPERTY(BlueprintReadOnly, EditDefaultsOnly, Category = "Animation")
+	TArray<TSoftObjectPtr<UAnimMontage>> Montages;
+};
+
 USTRUCT(BlueprintType)
 struct INWORLDAIINTEGRATION_API FInworldSemanticGestureTableRow : public FTableRowBase
 {
@@ -74,17 +103,18 @@ public:
 	/**
 	 * Retrieves the animation montage for a specific emotion and emotion strength.
 	 *
-	 * @param AnimationDT The animation data table to search.
+	 * @param WorldContextObject Soft montages are counted in the UInworldAnimationPreloadSubsystem of its world.
+	 * @param AnimationDT The animation data table to search, FInworldAnimationTableRow or FInworldAnimationSoftTableRow rows.
 	 * @param Emotion The emotional behavior of the character.
 	 * @param EmotionStrength The strength of the character's emotion.
 	 * @param UtteranceDuration The duration of the utterance.
 	 * @param bAllowTrailingGestures Whether to allow trailing gestures.
 	 * @param bFindNeutralGestureIfSearchFailed Whether to find a neutral gesture if the search fails.
-	 * @param Montages An array of animation montages.
+	 * @param Montages Montages left to play. Refilled from the data table sorted by play length when empty, the returned montage is removed. Pools filled or resized by the caller are searched linearly.
 	 * @return The animation montage for the specified emotion and emotion strength.
 	 */
-	UFUNCTION(BlueprintPure, Category = "Inworld")
-	static UAnimMontage* GetMontageForEmotion(const UDataTable* AnimationDT, EInworldCharacterEmotionalBehavior Emotion, EInworldCharacterEmotionStrength EmotionStrength, float UtteranceDuration, bool bAllowTrailingGestures, bool bFindNeutralGestureIfSearchFailed, UPARAM(ref) TArray<UAnimMontage*>& Montages);
+	UFUNCTION(BlueprintPure, Category = "Inworld", meta = (WorldContext = "WorldContextObject"))
+	static UAnimMontage* GetMontageForEmotion(const UObject* WorldContextObject, const UDataTable* AnimationDT, EInworldCharacterEmotionalBehavior Emotion, EInworldCharacterEmotionStrength EmotionStrength, float UtteranceDuration, bool bAllowTrailingGestures, bool bFindNeutralGestureIfSearchFailed, UPARAM(ref) TArray<UAnimMontage*>& Montages);
 
 	/**
 	 * Retrieves the animation montage for a custom gesture based on semantics.
@@ -27,6 +27,74 @@
 class UInworldPlayerComponent;
 class FInternetAddr;
 
+UENUM()
+enum class EInworldCharacterRepEventType : uint8
+{
+	Text,
+	VAD,
+	Silence,
+	Control,
+	Emotion,
+	Custom,
+	Relation,
+};
+
+USTRUCT()
+struct FInworldCharacterRepTextEvent
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FInworldTextEvent Event;
+
+	/** Length of the utterance text the Event text is appended to, INDEX_NONE if Event holds the full text. */
+	UPROPERTY()
+	int32 BaseLength = INDEX_NONE;
+
+	UPROPERTY()
+	bool bTextOnly = false;
+};
+
+/**
+ * Character events received by the server during a frame, replicated to clients with a single RPC.
+ * Consecutive emotion and relation events are coalesced to the latest one.
+ */
+USTRUCT()
+struct FInworldCharacterRepEventBatch
+{
+	GENERATED_BODY()
+
+	void Add(const FInworldTextEvent& Event, bool bTextOnly, int32 BaseLength);
+	void Add(const FInworldVADEvent& Event);
+	void Add(const FInworldSilenceEvent& Event);
+	void Add(const FInworldControlEvent& Event);
+	void Add(const FInworldEmotionEvent& Event);
+	void Add(const FInworldCustomEvent& Event);
+	void Add(const FInworldRelationEvent& Event);
+
+	bool IsEmpty() const { return Order.Num() == 0; }
+	void Reset();
+
+	/** Event types in arrival order, each one consumes the next event of its type. */
+	UPROPERTY()
+	TArray<EInworldCharacterRepEventType> Order;
+
+	UPROPERTY()
+	TArray<FInworldCharacterRepTextEvent> TextEvents;
+	UPROPERTY()
+	TArray<FInworldVADEvent> VADEvents;
+	UPROPERTY()
+	TArray<FInworldSilenceEvent> SilenceEvents;
+	UPROPERTY()
+	TArray<FInworldControlEvent> ControlEvents;
+	UPROPERTY()
+	TArray<FInworldEmotionEvent> EmotionEvents;
+	UPROPERTY()
+	TArray<FInworldCustomEvent> CustomEvents;
+	UPROPERTY()
+	TArray<FInworldRelationEvent> RelationEvents;
+};
+
 UCLASS(ClassGroup = (Inworld), meta = (BlueprintSpawnableComponent))
 class INWORLDAIINTEGRATION_API UInworldCharacterComponent : public UActorComponent, public IInworldCharacterOwnerInterface, public ICharacterMessageVisitor
 {
@@ -336,24 +404,39 @@ private:
 	void OnInworldRelationEvent(const FInworldRelationEvent& Event);
 
 	UFUNCTION(NetMulticast, Reliable)
-	void Multicast_VisitText(const FInworldTextEvent& Event, bool bTextOnly);
-	UFUNCTION(NetMulticast, Reliable)
-	void Multicast_VisitVAD(const FInworldVADEvent& Event);
-	UFUNCTION(NetMulticast, Reliable)
-	void Multicast_VisitSilence(const FInworldSilenceEvent& Event);
-	UFUNCTION(NetMulticast, Reliable)
-	void Multicast_VisitControl(const FInworldControlEvent& Event);
-	UFUNCTION(NetMulticast, Reliable)
-	void Multicast_VisitEmotion(const FInworldEmotionEvent& Event);
-	UFUNCTION(NetMulticast, Reliable)
-	void Multicast_VisitCustom(const FInworldCustomEvent& Event);
-	UFUNCTION(NetMulticast, Reliable)
-	void Multicast_VisitRelation(const FInworldRelationEvent& Event);
+	void Multicast_VisitEvents(const FInworldCharacterRepEventBatch& Batch);
+
+	void VisitText(const FInworldTextEvent& Event, bool bTextOnly);
+	void VisitVAD(const FInworldVADEvent& Event);
+	void VisitSilence(const FInworldSilenceEvent& Event);
+	void VisitControl(const FInworldControlEvent& Event);
+	void VisitEmotion(const FInworldEmotionEvent& Event);
+	void VisitCustom(const FInworldCustomEvent& Event);
+	void VisitRelation(const FInworldRelationEvent& Event);
+
+	bool IsReplicatingEvents() const;
+	void FlushPendingRepEvents();
 
 	bool IsCustomGesture(const FString& CustomEventName) const;
 
 	void VisitAudioOnClient(const FInworldAudioDataEvent& Event);
 
+	FInworldCharacterRepEventBatch PendingRepEvents;
+
+	struct FRepUtteranceText
+	{
+		FString InteractionId;
+		FString Text;
+	};
+
+	/**
+	 * Utterance text replicated so far (server) or received so far (client) by utterance id, text events are replicated as deltas against it.
+	 * Removed on the final text, or with the interaction when it ends or is interrupted.
+	 */
+	TMap<FString, FRepUtteranceText> RepUtteranceTexts;
+
+	void RemoveRepUtteranceTexts(TFunctionRef<bool(const FString& InteractionId)> Predicate);
+
 	TQueue<FInworldAudioDataEvent> PendingRepAudioEvents;
 
 	UPROPERTY()
@@ -184,6 +184,8 @@ private:
 	bool bIsProgressing = false;
 	bool bIsPaused = false;
 
+	uint32 NumHandledMessages = 0;
+
 	TOptional<FString> NextInterruptingInteractionId;
 	TMap<FString, bool> InteractionInterruptibleState;
 	enum class EInworldInteractionInterruptibleState : uint8
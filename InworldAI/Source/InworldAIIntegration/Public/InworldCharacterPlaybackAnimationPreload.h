@@ -0,0 +1,46 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InworldCharacterPlayback.h"
+
+#include "InworldCharacterPlaybackAnimationPreload.generated.h"
+
+class UDataTable;
+class UInworldAnimationPreloadSubsystem;
+
+/**
+ * Streams in the montages of the character's emotion as soon as the emotion event arrives,
+ * before the next utterance picks a montage, along with the emotions most likely to follow.
+ */
+UCLASS(BlueprintType, Blueprintable)
+class INWORLDAIINTEGRATION_API UInworldCharacterPlaybackAnimationPreload : public UInworldCharacterPlayback
+{
+	GENERATED_BODY()
+
+public:
+	/** Animation data table with FInworldAnimationSoftTableRow rows. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Animation")
+	UDataTable* AnimationTable = nullptr;
+
+	/** Number of likely next emotions to stream in along with the current one. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Animation", meta = (ClampMin = "0"))
+	int32 NumPredictedEmotions = 2;
+
+protected:
+	virtual void BeginPlay_Implementation() override;
+	virtual void OnCharacterEmotion_Implementation(EInworldCharacterEmotionalBehavior Emotion, EInworldCharacterEmotionStrength Strength) override;
+
+private:
+	UInworldAnimationPreloadSubsystem* GetPreloadSubsystem();
+
+	TMap<EInworldCharacterEmotionalBehavior, TArray<FSoftObjectPath>> EmotionMontages;
+	EInworldCharacterEmotionalBehavior CurrentEmotion = EInworldCharacterEmotionalBehavior::NEUTRAL;
+	TWeakObjectPtr<UInworldAnimationPreloadSubsystem> PreloadSubsystem;
+};
@@ -38,8 +38,17 @@ struct FInworldCharacterInteraction
 	bool bPlayerInteraction = false;
 };
 
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnInworldCharacterInteractionHistoryIndex, int32 /*Index*/);
+DECLARE_MULTICAST_DELEGATE(FOnInworldCharacterInteractionHistoryEvicted);
+DECLARE_MULTICAST_DELEGATE(FOnInworldCharacterInteractionHistoryCleared);
+
+/**
+ * Bounded history of interactions, oldest first.
+ * Interactions are kept in a ring buffer and found by utterance id through a map,
+ * so adding, updating and evicting do not move the other interactions.
+ */
 USTRUCT(BlueprintType)
-struct FInworldCharacterInteractionHistory
+struct INWORLDAIINTEGRATION_API FInworldCharacterInteractionHistory
 {
 	GENERATED_BODY();
 
@@ -50,17 +59,55 @@ struct FInworldCharacterInteractionHistory
 
 	void SetMaxEntries(uint32 Val);
 
-	TArray<FInworldCharacterInteraction>& GetInteractions() { return Interactions; }
+	int32 Num() const { return NumEntries; }
+	const FInworldCharacterInteraction& GetInteraction(int32 Index) const { return Entries[GetSlot(Index)]; }
+
+	/**
+	 * Get all the interactions, the array is rebuilt only after changes.
+	 * @return The interactions, oldest first.
+	 */
+	const TArray<FInworldCharacterInteraction>& GetInteractions() const;
 
 	void CancelUtterance(const FString& InteractionId, const FString& UtteranceId);
 	bool IsInteractionCanceled(const FString& InteractionId) const;
 	void ClearCanceledInteraction(const FString& InteractionId);
 
+	/** An interaction was added at the end. */
+	FOnInworldCharacterInteractionHistoryIndex& OnAppended() { return OnAppendedDelegate; }
+	/** The text of an interaction changed. */
+	FOnInworldCharacterInteractionHistoryIndex& OnUpdated() { return OnUpdatedDelegate; }
+	/** The oldest interaction was dropped to make room, indices shift down by one. */
+	FOnInworldCharacterInteractionHistoryEvicted& OnEvicted() { return OnEvictedDelegate; }
+	/** A canceled interaction was removed, later indices shift down by one. */
+	FOnInworldCharacterInteractionHistoryIndex& OnRemoved() { return OnRemovedDelegate; }
+	/** All interactions were removed. */
+	FOnInworldCharacterInteractionHistoryCleared& OnCleared() { return OnClearedDelegate; }
+
 private:
-	TArray<FInworldCharacterInteraction> Interactions;
-	TArray<FString> CanceledInteractions;
+	int32 GetSlot(int32 Index) const { return (Head + Index) % Entries.Num(); }
+	void Evict();
+
+	/** Fixed capacity ring, NumEntries interactions starting at Head. */
+	TArray<FInworldCharacterInteraction> Entries;
+	int32 Head = 0;
+	int32 NumEntries = 0;
+
+	/** Sequence numbers only change on removal, the index is the sequence minus FirstSequence. */
+	TMap<FString, int32> UtteranceIdToSequence;
+	int32 FirstSequence = 0;
+
+	TSet<FString> CanceledInteractions;
+
+	mutable TArray<FInworldCharacterInteraction> Interactions;
+	mutable bool bInteractionsDirty = false;
 
 	int32 MaxEntries = 50;
+
+	FOnInworldCharacterInteractionHistoryIndex OnAppendedDelegate;
+	FOnInworldCharacterInteractionHistoryIndex OnUpdatedDelegate;
+	FOnInworldCharacterInteractionHistoryEvicted OnEvictedDelegate;
+	FOnInworldCharacterInteractionHistoryIndex OnRemovedDelegate;
+	FOnInworldCharacterInteractionHistoryCleared OnClearedDelegate;
 };
 
 UCLASS(BlueprintType, Blueprintable)
@@ -76,6 +123,40 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = "EventDispatchers")
 	FOnInworldCharacterInteractionsChanged OnInteractionsChanged;
 
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnInworldCharacterInteractionChanged, const FInworldCharacterInteraction&, Interaction, int32, Index);
+	/**
+	 * Event dispatcher for when an interaction is added at the end of the history.
+	 */
+	UPROPERTY(BlueprintAssignable, Category = "EventDispatchers")
+	FOnInworldCharacterInteractionChanged OnInteractionAppended;
+
+	/**
+	 * Event dispatcher for when the text of an interaction in the history changes.
+	 */
+	UPROPERTY(BlueprintAssignable, Category = "EventDispatchers")
+	FOnInworldCharacterInteractionChanged OnInteractionUpdated;
+
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnInworldCharacterInteractionEvicted);
+	/**
+	 * Event dispatcher for when the oldest interaction is dropped from a full history.
+	 */
+	UPROPERTY(BlueprintAssignable, Category = "EventDispatchers")
+	FOnInworldCharacterInteractionEvicted OnInteractionEvicted;
+
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnInworldCharacterInteractionRemoved, int32, Index);
+	/**
+	 * Event dispatcher for when a canceled interaction is removed from the history.
+	 */
+	UPROPERTY(BlueprintAssignable, Category = "EventDispatchers")
+	FOnInworldCharacterInteractionRemoved OnInteractionRemoved;
+
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnInworldCharacterInteractionsCleared);
+	/**
+	 * Event dispatcher for when all interactions are removed from the history.
+	 */
+	UPROPERTY(BlueprintAssignable, Category = "EventDispatchers")
+	FOnInworldCharacterInteractionsCleared OnInteractionsCleared;
+
 	/**
 	 * Returns the array of Inworld character interactions.
 	 * @return The array of Inworld character interactions.
@@ -83,6 +164,20 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Interactions")
 	const TArray<FInworldCharacterInteraction>& GetInteractions() { return InteractionHistory.GetInteractions(); }
 
+	/**
+	 * Returns the number of interactions in the history.
+	 */
+	UFUNCTION(BlueprintPure, Category = "Interactions")
+	int32 GetNumInteractions() const { return InteractionHistory.Num(); }
+
+	/**
+	 * Returns an interaction of the history.
+	 * @param Index The index of the interaction, 0 is the oldest.
+	 * @return The interaction, empty if the index is out of range.
+	 */
+	UFUNCTION(BlueprintPure, Category = "Interactions")
+	FInworldCharacterInteraction GetInteraction(int32 Index) const;
+
 	virtual void BeginPlay_Implementation() override;
 
 	/**
@@ -97,6 +192,15 @@ private:
 	virtual void OnCharacterPlayerTalk_Implementation(const FCharacterMessagePlayerTalk& Message) override;
 	virtual void OnCharacterInteractionEnd_Implementation(const FCharacterMessageInteractionEnd& Message) override;
 
+	void OnHistoryAppended(int32 Index);
+	void OnHistoryUpdated(int32 Index);
+	void OnHistoryEvicted();
+	void OnHistoryRemoved(int32 Index);
+	void OnHistoryCleared();
+
+	/** The full array is only built for listeners of OnInteractionsChanged. */
+	void BroadcastInteractionsChanged();
+
 	FInworldCharacterInteractionHistory InteractionHistory;
 };
 
@@ -33,6 +33,17 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = "EventDispatchers")
 	FOnInworldCharacterTextChanged OnCharacterTextChanged;
 
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_FourParams(FOnInworldCharacterTextDelta, const FString&, Id, bool, bIsPlayer, int32, Start, const FString&, Delta);
+	/**
+	 * Event dispatcher for the part of the Inworld character text that changed.
+	 * The text keeps its first Start characters followed by Delta, Start is the previous length when text is only revealed.
+	 */
+	UPROPERTY(BlueprintAssignable, Category = "EventDispatchers")
+	FOnInworldCharacterTextDelta OnCharacterTextDelta;
+
+	DECLARE_MULTICAST_DELEGATE_FourParams(FOnInworldCharacterTextDeltaNative, const FString& /*Id*/, bool /*bIsPlayer*/, int32 /*Start*/, const FString& /*Delta*/);
+	FOnInworldCharacterTextDeltaNative OnCharacterTextDeltaNative;
+
 	DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnInworldCharacterTextFinal, const FString&, Id, bool, bIsPlayer, const FString&, Text);
 	/**
 	 * Event dispatcher for when Inworld character text is finalized.
@@ -47,6 +58,15 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = "EventDispatchers")
 	FOnInworldCharacterTextInterrupt OnCharacterTextInterrupt;
 
+	/**
+	 * Get the current text of an utterance.
+	 * @param Id The utterance id.
+	 * @param Text The text.
+	 * @return Whether the utterance is known.
+	 */
+	UFUNCTION(BlueprintPure, Category = "Text")
+	bool GetText(const FString& Id, FString& Text) const;
+
 protected:
 	virtual void OnCharacterUtterance_Implementation(const FCharacterMessageUtterance& Message) override;
 	virtual void OnCharacterUtteranceInterrupt_Implementation(const FCharacterMessageUtterance& Message) override;
@@ -61,13 +81,15 @@ private:
 	struct FInworldCharacterText
 	{
 		FInworldCharacterText() = default;
-		FInworldCharacterText(const FString& InUtteranceId, const FString& InText, bool bInTextFinal, bool bInIsPlayer);
+		FInworldCharacterText(const FString& InUtteranceId, bool bInIsPlayer);
 
 		FString Id;
+		/** Only the changed tail is rewritten on updates. */
 		FString Text;
 		bool bTextFinal = false;
 		bool bIsPlayer = false;
+		bool bInterrupted = false;
 	};
 
-	TArray<FInworldCharacterText> CharacterTexts;
+	TMap<FString, FInworldCharacterText> CharacterTexts;
 };
@@ -12,16 +12,32 @@
 
 #include "InworldCharacterPlaybackTrigger.generated.h"
 
+class UInworldApiSubsystem;
+
 UCLASS(BlueprintType, Blueprintable)
 class INWORLDAIINTEGRATION_API UInworldCharacterPlaybackTrigger : public UInworldCharacterPlayback
 {
 	GENERATED_BODY()
 
+public:
+	/** Seconds to keep triggers of an interaction that never ends, e.g. when the session is interrupted. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trigger")
+	float PendingTriggerLifetime = 120.f;
+
 protected:
 	virtual void OnCharacterTrigger_Implementation(const FCharacterMessageTrigger& Message) override;
 	virtual void OnCharacterInteractionEnd_Implementation(const FCharacterMessageInteractionEnd& Message) override;
 
 private:
-	TMap<FString, TArray<FCharacterMessageTrigger>> PendingTriggers;
-};
+	UInworldApiSubsystem* GetApiSubsystem();
+	void RemoveExpiredTriggers(double Time);
 
+	struct FPendingTriggers
+	{
+		TArray<FString, TInlineAllocator<4>> Names;
+		double Time = 0.0;
+	};
+
+	TMap<FString, FPendingTriggers> PendingTriggers;
+	TWeakObjectPtr<UInworldApiSubsystem> ApiSubsystem;
+};
@@ -0,0 +1,76 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+
+#include "InworldCharacterRelevanceComponent.generated.h"
+
+class UInworldSession;
+class UInworldCharacter;
+
+/**
+ * Streams the characters of a session in and out by distance to the registered players.
+ * Add next to the session owner, registered characters are then no longer loaded up front.
+ * The scene still loads all its characters when the session starts, only the ones within LoadRadius
+ * are possessed and the others are unloaded right away.
+ */
+UCLASS(ClassGroup = (Inworld), meta = (BlueprintSpawnableComponent))
+class INWORLDAIINTEGRATION_API UInworldCharacterRelevanceComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UInworldCharacterRelevanceComponent();
+
+	virtual void BeginPlay() override;
+	virtual void EndPlay(EEndPlayReason::Type Reason) override;
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	/** Characters closer than this to a player are loaded */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Relevance", meta = (ClampMin = 0.f))
+	float LoadRadius = 2000.f;
+
+	/** Loaded characters further than this from every player are unloaded, keep above LoadRadius to avoid thrashing at the edge */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Relevance", meta = (ClampMin = 0.f))
+	float UnloadRadius = 2500.f;
+
+	/** Maximum characters loaded at once, closest first, 0 for no limit */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Relevance", meta = (ClampMin = 0))
+	int32 MaxLoadedCharacters = 8;
+
+	/** Seconds of player movement to look ahead, so characters are loaded before the player arrives */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Relevance", meta = (ClampMin = 0.f))
+	float PreloadTime = 2.f;
+
+	/** Seconds to wait for a requested character before requesting it again */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Relevance", meta = (ClampMin = 0.f))
+	float LoadTimeout = 10.f;
+
+private:
+	UInworldSession* FindSession() const;
+
+	// players are tested as a segment from the current to the predicted location
+	struct FPlayerPath
+	{
+		FVector Start;
+		FVector End;
+	};
+
+	void GetPlayerPaths(const UInworldSession* Session, TArray<FPlayerPath>& OutPlayerPaths) const;
+	/** Squared distance to the closest player path, 0 for a character in a conversation. */
+	float GetDistSqToPlayers(const UInworldCharacter* Character, const TArray<FPlayerPath>& PlayerPaths) const;
+
+	bool IsCharacterRelevant(const UInworldCharacter* Character) const;
+	void UpdateRelevance(UInworldSession* Session);
+
+	TWeakObjectPtr<UInworldSession> InworldSession;
+
+	TMap<TWeakObjectPtr<UInworldCharacter>, double> PendingLoads;
+};
@@ -15,6 +15,7 @@
 
 class UInworldApiSubsystem;
 class UInworldCharacterComponent;
+class UNetConnection;
 
 UCLASS(ClassGroup = (Inworld), meta = (BlueprintSpawnableComponent))
 class INWORLDAIINTEGRATION_API UInworldPlayerComponent : public UActorComponent, public IInworldPlayerOwnerInterface
@@ -34,6 +35,7 @@ public:
     virtual void UninitializeComponent() override;
 
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
     virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
     virtual bool ReplicateSubobjects(UActorChannel* Channel, FOutBunch* Bunch, FReplicationFlags* RepFlags) override;
@@ -194,6 +196,17 @@ protected:
     FString UiName = "Player";
 
 private:
+    UNetConnection* GetServerConnection() const;
+    void OnReplicatedKeysReceived(UNetConnection* Connection);
+    void AcknowledgeReplicatedKeys();
+
+    /** Lets the server send replicated map keys of this connection with these indices as indices. */
+    UFUNCTION(Server, Reliable)
+    void Server_AcknowledgeReplicatedKeys(const TArray<int32>& Indices);
+
+    FDelegateHandle OnReplicatedKeysReceivedHandle;
+    FTimerHandle AcknowledgeReplicatedKeysHandle;
+
     UPROPERTY(Replicated)
     UInworldPlayer* InworldPlayer;
 
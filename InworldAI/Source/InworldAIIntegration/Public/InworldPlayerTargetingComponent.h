@@ -15,7 +15,12 @@
 class UInworldApiSubsystem;
 class UInworldPlayer;
 class UInworldCharacter;
+class UCameraComponent;
 
+/**
+ * Targets characters in interaction distance of the owner.
+ * Targets of all components in the world are evaluated together by UInworldPlayerTargetingSubsystem.
+ */
 UCLASS(ClassGroup = (Inworld), meta = (BlueprintSpawnableComponent))
 class INWORLDAIINTEGRATION_API UInworldPlayerTargetingComponent : public UActorComponent
 {
@@ -25,10 +30,7 @@ public:
 	UInworldPlayerTargetingComponent();
 
     virtual void BeginPlay() override;
-    virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
-
-private:
-	void UpdateTargetCharacters();
+    virtual void EndPlay(EEndPlayReason::Type Reason) override;
 
 public:
 	/** Minimum distance to start interacting with a character */
@@ -39,6 +41,18 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Interaction")
 	bool bMultipleTargets = false;
 
+	/** Seconds between target updates, 0 to update every frame */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Interaction", meta = (ClampMin = 0.f))
+	float UpdateInterval = 0.f;
+
 private:
+	FVector2D GetForward2D();
+
 	TWeakObjectPtr<UInworldPlayer> InworldPlayer;
+
+	TWeakObjectPtr<UCameraComponent> CameraComponent;
+
+	float TimeSinceUpdate = 0.f;
+
+	friend class UInworldPlayerTargetingSubsystem;
 };
@@ -0,0 +1,103 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+
+#include "InworldPlayerTargetingSubsystem.generated.h"
+
+class UInworldCharacter;
+class UInworldPlayer;
+class UInworldSession;
+class UInworldPlayerTargetingComponent;
+
+/**
+ * Uniform grid of characters on the XY plane.
+ * Characters are moved between cells when their location changes.
+ * Entries hold a snapshot of the character state taken on Update, so queries are safe from any thread.
+ */
+class INWORLDAIINTEGRATION_API FInworldCharacterSpatialHash
+{
+public:
+	struct FEntry
+	{
+		UInworldCharacter* Character;
+		UInworldPlayer* TargetPlayer;
+		FVector Location;
+		FIntPoint Cell;
+		uint64 UpdateFrame;
+		bool bPossessed;
+	};
+
+	/**
+	 * Sync the grid with the characters and their current state.
+	 * Characters missing from the array are removed.
+	 */
+	void Update(const TArray<UInworldCharacter*>& Characters, float InCellSize);
+
+	/**
+	 * Call Func for every character within Radius of Location, only visiting the cells overlapping the radius.
+	 */
+	void ForEachInRadius(const FVector& Location, float Radius, TFunctionRef<void(const FEntry&)> Func) const;
+
+	/**
+	 * Find the entry of a character.
+	 * @return The entry, nullptr if the character isn't in the grid.
+	 */
+	const FEntry* Find(UInworldCharacter* Character) const { return Entries.Find(Character); }
+
+	uint64 GetLastUpdateFrame() const { return LastUpdateFrame; }
+
+private:
+	FIntPoint GetCell(const FVector& Location) const;
+	void RemoveFromCell(UInworldCharacter* Character, const FIntPoint& Cell);
+
+	TMap<UInworldCharacter*, FEntry> Entries;
+	TMap<FIntPoint, TArray<UInworldCharacter*>> Cells;
+
+	float CellSize = 0.f;
+	uint64 LastUpdateFrame = MAX_uint64;
+};
+
+/**
+ * Evaluates the targets of every UInworldPlayerTargetingComponent in the world once per frame.
+ * Players are evaluated in parallel against the spatial hash snapshot, results are applied on the game thread.
+ */
+UCLASS()
+class INWORLDAIINTEGRATION_API UInworldPlayerTargetingSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Get the spatial hash of the characters registered in the session, updated once per frame.
+	 * @param Session The session the characters are registered in.
+	 * @return The spatial hash.
+	 */
+	const FInworldCharacterSpatialHash& GetCharacterSpatialHash(UInworldSession* Session);
+
+	void RegisterTargetingComponent(UInworldPlayerTargetingComponent* Component);
+	void UnregisterTargetingComponent(UInworldPlayerTargetingComponent* Component);
+
+	/** Subsystem interface */
+	virtual bool DoesSupportWorldType(EWorldType::Type WorldType) const override;
+
+	/** Tickable interface */
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return TargetingComponents.Num() > 0; }
+	virtual ETickableTickType GetTickableTickType() const override { return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Conditional; }
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	virtual TStatId GetStatId() const override;
+
+private:
+	TMap<TWeakObjectPtr<UInworldSession>, FInworldCharacterSpatialHash> SessionSpatialHashes;
+
+	TArray<TWeakObjectPtr<UInworldPlayerTargetingComponent>> TargetingComponents;
+};
@@ -0,0 +1,124 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "InworldSessionGroup.h"
+#include "InworldSessionGroupComponent.generated.h"
+
+/**
+ * Owns a session group on the server and makes it the one character and player components register with.
+ * Use instead of UInworldSessionComponent when one connection can't keep up with the number of characters.
+ */
+UCLASS(Blueprintable, ClassGroup = (Inworld), meta = (BlueprintSpawnableComponent))
+class INWORLDAIINTEGRATION_API UInworldSessionGroupComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UInworldSessionGroupComponent();
+
+	virtual void OnRegister() override;
+	virtual void OnUnregister() override;
+
+	/**
+	 * Get the session group.
+	 * @return The session group, nullptr on clients.
+	 */
+	UFUNCTION(BlueprintPure, Category = "Session")
+	UInworldSessionGroup* GetInworldSessionGroup() const { return InworldSessionGroup; }
+
+	/**
+	 * Start all shard sessions from a scene.
+	 * @param Scene The scene to initialize.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Session")
+	void StartSessionsFromScene(const FInworldScene& Scene);
+
+	/**
+	 * Stop all shard sessions.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Session")
+	void StopSessions();
+
+	/**
+	 * Pause all shard sessions.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Session")
+	void PauseSessions();
+
+	/**
+	 * Resume all shard sessions.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Session")
+	void ResumeSessions();
+
+protected:
+	/**
+	 * Number of sessions, each with its own connection.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Shard", meta = (ClampMin = 1))
+	int32 NumShards = 2;
+
+	/**
+	 * How characters are placed on shards.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Shard")
+	EInworldSessionShardPolicy ShardPolicy = EInworldSessionShardPolicy::RoundRobin;
+
+	/**
+	 * Characters a shard holds before new characters go to the least loaded shard.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Shard", meta = (ClampMin = 1))
+	int32 MaxCharactersPerShard = 32;
+
+	/**
+	 * Size of a region for the Region policy.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Shard", meta = (ClampMin = 1.f))
+	float RegionSize = 5000.f;
+
+	/**
+	 * Workspace configuration.
+	 */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Config")
+	FString Workspace;
+
+	/**
+	 * Authentication configuration.
+	 */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Config")
+	FInworldAuth Auth;
+
+	/**
+	 * Player Profile configuration.
+	 */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Config")
+	FInworldPlayerProfile PlayerProfile;
+
+	/**
+	 * CapabilitySet configuration.
+	 */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Config")
+	FInworldCapabilitySet CapabilitySet;
+
+	/**
+	 * Metadata map for additional configuration details.
+	 */
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Config")
+	TMap<FString, FString> Metadata;
+
+private:
+	UPROPERTY()
+	UInworldSessionGroup* InworldSessionGroup;
+
+	/** Subsystem session replaced by the first shard, restored when the group goes away. */
+	UPROPERTY()
+	UInworldSession* PreviousInworldSession;
+};
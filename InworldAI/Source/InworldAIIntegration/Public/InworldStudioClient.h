@@ -0,0 +1,167 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "InworldStudioTypes.h"
+
+#include "InworldStudioClient.generated.h"
+
+struct FInworldStudioHttpRequest
+{
+	FString Url;
+	TMap<FString, FString> Headers;
+};
+
+struct FInworldStudioHttpResponse
+{
+	bool bSuccess = false;
+	int32 Code = 0;
+	FString Content;
+	FString ETag;
+};
+
+struct FInworldStudioClientStats
+{
+	int32 NumRequests = 0;
+	/** Requests answered with 304, served from the cache. */
+	int32 NumNotModified = 0;
+	int32 NumPages = 0;
+	int32 MaxInFlight = 0;
+	/** Cached responses deleted from disk because of the size limit. */
+	int32 NumEvicted = 0;
+	int64 DiskBytes = 0;
+};
+
+/**
+ * Fetches Studio resources, following page tokens and merging the pages of paginated resources.
+ * Responses are cached on disk up to a size limit and revalidated with If-None-Match, the number of requests in flight is limited.
+ * Game thread only.
+ */
+class INWORLDAIINTEGRATION_API FInworldStudioClient : public TSharedFromThis<FInworldStudioClient>
+{
+public:
+	using FOnResponse = TFunction<void(const FInworldStudioHttpResponse& Response)>;
+	/** Sends a GET request, the response must be passed on the game thread. */
+	using FTransport = TFunction<void(const FInworldStudioHttpRequest& Request, FOnResponse OnResponse)>;
+	using FOnResource = TFunction<void(bool bSuccess, const FString& Json, const FString& Error)>;
+
+	/**
+	 * @param InCacheDirectory Where responses are cached, empty to keep them in memory only.
+	 * @param InTransport Sends the requests, HTTP by default.
+	 */
+	explicit FInworldStudioClient(const FString& InCacheDirectory = FString(), FTransport InTransport = FTransport());
+
+	/**
+	 * Fetch a resource, every page of it when paginated, the arrays of the pages are merged into the first page.
+	 * @param Url The resource url without paging parameters.
+	 * @param ApiKey The Studio API key.
+	 * @param bCacheable Whether the response may be stored, false for secrets.
+	 * @param bPaginated Whether the endpoint takes pageSize and pageToken, the url is sent as is otherwise.
+	 * @param Callback Called with the merged json.
+	 */
+	void GetResource(const FString& Url, const FString& ApiKey, bool bCacheable, bool bPaginated, FOnResource Callback);
+
+	using FOnWorkspaceContents = TFunction<void(const FInworldStudioCharacters& Characters, const FInworldStudioScenes& Scenes, bool bSuccess, const FString& Error)>;
+
+	/**
+	 * Fetch the characters and scenes of a workspace in parallel.
+	 */
+	void GetWorkspaceContents(const FString& ApiUrl, const FString& Workspace, const FString& ApiKey, FOnWorkspaceContents Callback);
+
+	void SetMaxInFlight(int32 InMaxInFlight);
+	void SetPageSize(int32 InPageSize) { PageSize = FMath::Max(InPageSize, 1); }
+
+	/**
+	 * @param InMaxDiskBytes Oldest cached responses are deleted past this size.
+	 */
+	void SetMaxDiskBytes(int64 InMaxDiskBytes);
+
+	/**
+	 * Remove the cached responses from memory and disk.
+	 */
+	void ClearCache();
+
+	const FInworldStudioClientStats& GetStats() const { return Stats; }
+
+	static FTransport MakeHttpTransport();
+
+private:
+	struct FCachedResponse
+	{
+		FString ETag;
+		FString Content;
+	};
+
+	struct FPagedFetch;
+
+	void FetchNextPage(TSharedRef<FPagedFetch> Fetch);
+	void Send(FInworldStudioHttpRequest&& Request, FOnResponse&& OnResponse);
+	void SendNext();
+
+	bool FindCached(const FString& Key, FCachedResponse& OutResponse);
+	void StoreCached(const FString& Key, const FCachedResponse& Response);
+	FString GetCacheFilePath(const FString& Key) const;
+
+	void EvictDisk(const FString& LatestKey);
+	void ScanDisk();
+	void AddToDisk(const FString& Key, int64 Size);
+	void RemoveFromDisk(const FString& Key);
+
+	FString CacheDirectory;
+	FTransport Transport;
+
+	TMap<FString, FCachedResponse> MemoryCache;
+
+	struct FDiskFile
+	{
+		int64 Size = 0;
+		uint64 Order = 0;
+	};
+
+	/** Files of the cache directory, scanned once so stores don't list the directory. */
+	TMap<FString, FDiskFile> DiskFiles;
+	uint64 DiskCounter = 0;
+	bool bDiskScanned = false;
+	int64 MaxDiskBytes = 32 * 1024 * 1024;
+
+	TArray<TPair<FInworldStudioHttpRequest, FOnResponse>> Queue;
+	int32 NumInFlight = 0;
+	int32 MaxInFlight = 4;
+	int32 PageSize = 100;
+
+	FInworldStudioClientStats Stats;
+};
+
+/**
+ * Owns the Studio client shared by the Blueprint function library and the editor, configured by UInworldAIIntegrationSettings.
+ */
+UCLASS()
+class INWORLDAIINTEGRATION_API UInworldStudioClientSubsystem : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UInworldStudioClientSubsystem* Get();
+
+	FInworldStudioClient& GetClient() { return *Client; }
+
+	/**
+	 * Remove the cached Studio responses, the next requests fetch everything again.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Inworld|Studio")
+	void ClearStudioCache() { Client->ClearCache(); }
+
+	/** Subsystem interface */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+private:
+	TSharedPtr<FInworldStudioClient> Client;
+};
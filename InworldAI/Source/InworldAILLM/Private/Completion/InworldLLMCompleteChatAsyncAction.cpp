@@ -9,13 +9,15 @@
 #include "JsonObjectConverter.h"
 #include "Algo/Transform.h"
 
-UInworldLLMCompleteChatAsyncAction* UInworldLLMCompleteChatAsyncAction::CompleteChat(const TArray<FInworldLLMCompleteChatMessage>& Messages, const FInworldLLMTextGenerationConfig& TextGenerationConfig, const FString& ApiKeyOverride, const FString& UserIdOverride, const FString& ModelOverride, const FString& ServiceProviderOverride, bool JsonMode)
+UInworldLLMCompleteChatAsyncAction* UInworldLLMCompleteChatAsyncAction::CompleteChat(const TArray<FInworldLLMCompleteChatMessage>& Messages, const FInworldLLMTextGenerationConfig& TextGenerationConfig, const FString& ApiKeyOverride, const FString& UserIdOverride, const FString& ModelOverride, const FString& ServiceProviderOverride, bool JsonMode, EInworldLLMRequestPriority Priority, float Timeout)
 {
     UInworldLLMCompleteChatAsyncAction* Action = NewObject<UInworldLLMCompleteChatAsyncAction>();
     if (!ApiKeyOverride.IsEmpty()) Action->ApiKey = ApiKeyOverride;
     if (!UserIdOverride.IsEmpty()) Action->UserId = UserIdOverride;
     if (!ModelOverride.IsEmpty()) Action->Model = ModelOverride;
     if (!ServiceProviderOverride.IsEmpty()) Action->ServiceProvider = ServiceProviderOverride;
+    Action->Priority = Priority;
+    Action->Timeout = Timeout;
 
     Action->Request.serving_id.user_id = Action->UserId;
     Action->Request.serving_id.model_id.model = Action->Model;
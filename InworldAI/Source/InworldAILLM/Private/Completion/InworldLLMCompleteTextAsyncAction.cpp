@@ -9,12 +9,14 @@
 #include "JsonObjectConverter.h"
 #include "Algo/Transform.h"
 
-UInworldLLMCompleteTextAsyncAction* UInworldLLMCompleteTextAsyncAction::CompleteText(const FString& Text, const FInworldLLMTextGenerationConfig& TextGenerationConfig, const FString& ApiKeyOverride, const FString& UserIdOverride, const FString& ModelOverride)
+UInworldLLMCompleteTextAsyncAction* UInworldLLMCompleteTextAsyncAction::CompleteText(const FString& Text, const FInworldLLMTextGenerationConfig& TextGenerationConfig, const FString& ApiKeyOverride, const FString& UserIdOverride, const FString& ModelOverride, EInworldLLMRequestPriority Priority, float Timeout)
 {
     UInworldLLMCompleteTextAsyncAction* Action = NewObject<UInworldLLMCompleteTextAsyncAction>();
     if (!ApiKeyOverride.IsEmpty()) Action->ApiKey = ApiKeyOverride;
     if (!UserIdOverride.IsEmpty()) Action->UserId = UserIdOverride;
     if (!ModelOverride.IsEmpty()) Action->Model = ModelOverride;
+    Action->Priority = Priority;
+    Action->Timeout = Timeout;
 
     Action->Request.serving_id.user_id = Action->UserId;
     Action->Request.serving_id.model_id.model = Action->Model;
@@ -12,6 +12,18 @@
 #include "Serialization/JsonSerializer.h"
 #include "InworldAILLMModule.h"
 #include "InworldAILLMSettings.h"
+#include "Completion/InworldLLMCompletionCache.h"
+#include "Async/Async.h"
+
+static float GetRequestTemperature(const TSharedPtr<FJsonObject>& RequestJson)
+{
+    double Temperature = 0.0;
+    if (RequestJson->HasTypedField<EJson::Object>(TEXT("text_generation_config")))
+    {
+        RequestJson->GetObjectField(TEXT("text_generation_config"))->TryGetNumberField(TEXT("temperature"), Temperature);
+    }
+    return static_cast<float>(Temperature);
+}
 
 UInworldLLMCompletionAsyncActionBase::UInworldLLMCompletionAsyncActionBase(const FObjectInitializer& ObjectInitializer)
     : Super(ObjectInitializer)
@@ -29,27 +41,88 @@ UInworldLLMCompletionAsyncActionBase::UInworldLLMCompletionAsyncActionBase(const
 
 void UInworldLLMCompletionAsyncActionBase::Activate()
 {
-    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> HttpRequest = FHttpModule::Get().CreateRequest();
-    HttpRequest->SetURL("https://" + ApiUrl + "/llm/v1alpha/completions:" + GetCompletionType());
-    HttpRequest->SetVerb("POST");
-    HttpRequest->SetHeader("Content-Type", "application/json");
-    HttpRequest->SetHeader("Authorization", "Basic " + ApiKey);
-
     TSharedPtr<FJsonObject> RequestJson = MakeShared<FJsonObject>();
     FString JsonString;
-    TSharedRef< TJsonWriter<> > Writer = TJsonWriterFactory<>::Create(&JsonString);
-    if (GetRequestJson(RequestJson) && FJsonSerializer::Serialize(RequestJson.ToSharedRef(), Writer))
+    HttpRequest = CreateHttpRequest(RequestJson, JsonString);
+    if (HttpRequest.IsValid())
     {
-        HttpRequest->SetContentAsString(JsonString);
+        UInworldLLMCompletionCacheSubsystem* CacheSubsystem = UInworldLLMCompletionCacheSubsystem::Get();
+        if (FInworldLLMCompletionCache* Cache = CacheSubsystem ? CacheSubsystem->GetCache() : nullptr)
+        {
+            if (CacheSubsystem->IsCacheable(GetRequestTemperature(RequestJson)))
+            {
+                CacheKey = FInworldLLMCompletionCache::MakeKey(HttpRequest->GetURL(), JsonString);
+                TArray<FString> CachedLines;
+                if (Cache->Find(CacheKey, CachedLines))
+                {
+                    HttpRequest.Reset();
+                    HandleCachedResponse(CachedLines);
+                    return;
+                }
+            }
+            else
+            {
+                Cache->NotifyBypassed();
+            }
+        }
 
 #if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION > 3
         HttpRequest->OnRequestProgress64().BindUObject(this, &UInworldLLMCompletionAsyncActionBase::HandleOnRequestProgress64);
 #else
         HttpRequest->OnRequestProgress().BindUObject(this, &UInworldLLMCompletionAsyncActionBase::HandleOnRequestProgress);
 #endif
-        HttpRequest->OnProcessRequestComplete().BindUObject(this, &UInworldLLMCompletionAsyncActionBase::HandleOnProcessRequestComplete);
+        UInworldLLMSchedulerSubsystem* SchedulerSubsystem = UInworldLLMSchedulerSubsystem::Get();
+        if (SchedulerSubsystem == nullptr)
+        {
+            HttpRequest->OnProcessRequestComplete().BindUObject(this, &UInworldLLMCompletionAsyncActionBase::HandleOnProcessRequestComplete);
+            HttpRequest->ProcessRequest();
+            return;
+        }
+
+        // the slot is released even if the action is gone by the time the request completes,
+        // the id is known from Start on since the request may complete before Schedule returns
+        TWeakObjectPtr<UInworldLLMCompletionAsyncActionBase> WeakThis(this);
+        TSharedRef<uint64> RequestId = MakeShared<uint64>(0);
+        HttpRequest->OnProcessRequestComplete().BindLambda([WeakThis, RequestId](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bSuccess)
+        {
+            if (UInworldLLMSchedulerSubsystem* Subsystem = UInworldLLMSchedulerSubsystem::Get())
+            {
+                Subsystem->GetScheduler().Finish(*RequestId);
+            }
+            if (WeakThis.IsValid())
+            {
+                WeakThis->HandleOnProcessRequestComplete(Request, Response, bSuccess);
+            }
+        });
 
-        HttpRequest->ProcessRequest();
+        FInworldLLMScheduledRequest ScheduledRequest;
+        ScheduledRequest.Start = [WeakThis, RequestId, Request = HttpRequest.ToSharedRef()](uint64 Id)
+        {
+            *RequestId = Id;
+            if (WeakThis.IsValid())
+            {
+                Request->ProcessRequest();
+            }
+            else if (UInworldLLMSchedulerSubsystem* Subsystem = UInworldLLMSchedulerSubsystem::Get())
+            {
+                Subsystem->GetScheduler().Finish(*RequestId);
+            }
+        };
+        ScheduledRequest.Abort = [Request = HttpRequest.ToSharedRef()]()
+        {
+            // completes the request unsuccessfully
+            Request->CancelRequest();
+        };
+        ScheduledRequest.Drop = [WeakThis]()
+        {
+            if (WeakThis.IsValid())
+            {
+                WeakThis->HttpRequest.Reset();
+                WeakThis->HandleComplete(false);
+                WeakThis->SetReadyToDestroy();
+            }
+        };
+        ScheduledRequestId = SchedulerSubsystem->GetScheduler().Schedule(Priority, Timeout, MoveTemp(ScheduledRequest));
     }
     else
     {
@@ -58,6 +131,86 @@ void UInworldLLMCompletionAsyncActionBase::Activate()
     }
 }
 
+TSharedPtr<FInworldLLMTokenStream, ESPMode::ThreadSafe> UInworldLLMCompletionAsyncActionBase::StartTokenStream(FInworldLLMTokenStream::FOnTokens OnTokens, FInworldLLMTokenStream::FOnComplete OnComplete)
+{
+    TSharedRef<FInworldLLMTokenStream, ESPMode::ThreadSafe> Stream = MakeShared<FInworldLLMTokenStream, ESPMode::ThreadSafe>();
+    Stream->OnTokens = MoveTemp(OnTokens);
+    Stream->OnComplete = MoveTemp(OnComplete);
+    return ScheduleTokenStream(Stream) ? Stream : TSharedPtr<FInworldLLMTokenStream, ESPMode::ThreadSafe>();
+}
+
+TSharedPtr<FInworldLLMTokenStream, ESPMode::ThreadSafe> UInworldLLMCompletionAsyncActionBase::StartTokenStream(TSharedRef<FInworldLLMTokenMarshal, ESPMode::ThreadSafe> Marshal)
+{
+    TSharedRef<FInworldLLMTokenStream, ESPMode::ThreadSafe> Stream = MakeShared<FInworldLLMTokenStream, ESPMode::ThreadSafe>();
+    Marshal->Bind(*Stream);
+    if (!ScheduleTokenStream(Stream))
+    {
+        // stops the marshal ticker
+        Stream->Cancel();
+        return nullptr;
+    }
+    return Stream;
+}
+
+bool UInworldLLMCompletionAsyncActionBase::ScheduleTokenStream(TSharedRef<FInworldLLMTokenStream, ESPMode::ThreadSafe> Stream)
+{
+    TSharedPtr<FJsonObject> RequestJson = MakeShared<FJsonObject>();
+    FString JsonString;
+    TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> Request = CreateHttpRequest(RequestJson, JsonString);
+    if (!Request.IsValid())
+    {
+        UE_LOG(LogInworldAILLM, Error, TEXT("Invalid Request Format."));
+        return false;
+    }
+
+    UInworldLLMSchedulerSubsystem* SchedulerSubsystem = UInworldLLMSchedulerSubsystem::Get();
+    if (SchedulerSubsystem == nullptr)
+    {
+        Stream->Start(Request.ToSharedRef());
+        return true;
+    }
+
+    // the stream finishes on the HTTP thread, the scheduler is game thread only
+    TSharedRef<uint64> RequestId = MakeShared<uint64>(0);
+    Stream->OnFinished.BindLambda([RequestId]()
+    {
+        AsyncTask(ENamedThreads::GameThread, [RequestId]()
+        {
+            if (UInworldLLMSchedulerSubsystem* Subsystem = UInworldLLMSchedulerSubsystem::Get())
+            {
+                Subsystem->GetScheduler().Finish(*RequestId);
+            }
+        });
+    });
+
+    // past the deadline the stream completes with failure
+    FInworldLLMScheduledRequest ScheduledRequest = Stream->MakeScheduledRequest([Stream, RequestId, Request = Request.ToSharedRef()](uint64 Id)
+    {
+        *RequestId = Id;
+        Stream->Start(Request);
+    });
+    SchedulerSubsystem->GetScheduler().Schedule(Priority, Timeout, MoveTemp(ScheduledRequest));
+
+    return true;
+}
+
+TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> UInworldLLMCompletionAsyncActionBase::CreateHttpRequest(TSharedPtr<FJsonObject>& RequestJson, FString& JsonString) const
+{
+    TSharedRef< TJsonWriter<> > Writer = TJsonWriterFactory<>::Create(&JsonString);
+    if (!GetRequestJson(RequestJson) || !FJsonSerializer::Serialize(RequestJson.ToSharedRef(), Writer))
+    {
+        return nullptr;
+    }
+
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+    Request->SetURL("https://" + ApiUrl + "/llm/v1alpha/completions:" + GetCompletionType());
+    Request->SetVerb("POST");
+    Request->SetHeader("Content-Type", "application/json");
+    Request->SetHeader("Authorization", "Basic " + ApiKey);
+    Request->SetContentAsString(JsonString);
+    return Request;
+}
+
 #if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION > 3
 void UInworldLLMCompletionAsyncActionBase::HandleOnRequestProgress64(FHttpRequestPtr Request, uint64 BytesSent, uint64 BytesReceived)
 #else
@@ -79,42 +232,81 @@ void UInworldLLMCompletionAsyncActionBase::HandleOnRequestProgress(FHttpRequestP
 
 void UInworldLLMCompletionAsyncActionBase::HandleOnProcessRequestComplete(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bSuccess)
 {
-    const int32 ResponseCode = Response->GetResponseCode();
-    const FString FullResponseString = Response->GetContentAsString();
+    const int32 ResponseCode = Response.IsValid() ? Response->GetResponseCode() : EHttpResponseCodes::Unknown;
     if (EHttpResponseCodes::IsOk(ResponseCode))
     {
         HandleNextResponseChunk(Response);
-        if (ProcessedContentLength < FullResponseString.Len())
+        ResponseParser.Finish([this](const FString& Line) { HandleResponseLine(Line); });
+        if (bInvalidResponse)
         {
-            UE_LOG(LogInworldAILLM, Error, TEXT("Invalid Response Format. json=%s"), *FullResponseString);
+            UE_LOG(LogInworldAILLM, Error, TEXT("Invalid Response Format. json=%s"), *Response->GetContentAsString());
             HandleComplete(false);
         }
         else
         {
+            UInworldLLMCompletionCacheSubsystem* CacheSubsystem = UInworldLLMCompletionCacheSubsystem::Get();
+            FInworldLLMCompletionCache* Cache = CacheSubsystem ? CacheSubsystem->GetCache() : nullptr;
+            if (Cache && !CacheKey.IsEmpty() && ResponseLines.Num() > 0)
+            {
+                Cache->Store(CacheKey, ResponseLines);
+            }
             HandleComplete(true);
         }
     }
     else
     {
-        UE_LOG(LogInworldAILLM, Error, TEXT("Invalid Inworld Studio response. code=%d error=%s"), ResponseCode, *FullResponseString);
+        UE_LOG(LogInworldAILLM, Error, TEXT("Invalid Inworld Studio response. code=%d error=%s"), ResponseCode, Response.IsValid() ? *Response->GetContentAsString() : TEXT(""));
         HandleComplete(false);
     }
 
+    HttpRequest.Reset();
+
     SetReadyToDestroy();
 }
 
+void UInworldLLMCompletionAsyncActionBase::HandleCachedResponse(const TArray<FString>& Lines)
+{
+    // replayed like a response received in a single chunk
+    CacheKey.Empty();
+    for (const FString& Line : Lines)
+    {
+        HandleResponseLine(Line);
+    }
+    HandleComplete(!bInvalidResponse);
+
+    SetReadyToDestroy();
+}
+
+void UInworldLLMCompletionAsyncActionBase::Cancel()
+{
+    UInworldLLMSchedulerSubsystem* SchedulerSubsystem = UInworldLLMSchedulerSubsystem::Get();
+    if (SchedulerSubsystem && SchedulerSubsystem->GetScheduler().Cancel(ScheduledRequestId))
+    {
+        return;
+    }
+
+    if (HttpRequest.IsValid())
+    {
+        HttpRequest->CancelRequest();
+    }
+}
+
 void UInworldLLMCompletionAsyncActionBase::HandleNextResponseChunk(FHttpResponsePtr Response)
 {
-    const FString NextResponseString = Response->GetContentAsString().RightChop(ProcessedContentLength);
-    TArray<FString> ResponseStringLines;
-    NextResponseString.ParseIntoArrayLines(ResponseStringLines);
-    for (const FString& ResponseStringLine : ResponseStringLines)
-    {
-        TSharedPtr<FJsonObject> JsonObject;
-        TSharedRef< TJsonReader<> >  Reader = TJsonReaderFactory<>::Create(ResponseStringLine);
-        if (FJsonSerializer::Deserialize(Reader, JsonObject) && HandleResponseJson(JsonObject))
-        {
-            ProcessedContentLength += ResponseStringLine.Len() + 1;
-        }
+    // only the bytes received since the previous chunk are scanned
+    ResponseParser.FeedContent(Response->GetContent(), [this](const FString& Line) { HandleResponseLine(Line); });
+}
+
+void UInworldLLMCompletionAsyncActionBase::HandleResponseLine(const FString& Line)
+{
+    TSharedPtr<FJsonObject> JsonObject;
+    TSharedRef< TJsonReader<> >  Reader = TJsonReaderFactory<>::Create(Line);
+    if (!FJsonSerializer::Deserialize(Reader, JsonObject) || !HandleResponseJson(JsonObject))
+    {
+        bInvalidResponse = true;
+    }
+    else if (!CacheKey.IsEmpty())
+    {
+        ResponseLines.Add(Line);
     }
 }
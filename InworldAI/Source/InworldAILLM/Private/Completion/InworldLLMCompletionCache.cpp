@@ -0,0 +1,345 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#include "Completion/InworldLLMCompletionCache.h"
+#include "InworldAILLMModule.h"
+#include "InworldAILLMSettings.h"
+
+#include "Engine/Engine.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/SecureHash.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+FInworldLLMCompletionCache::FInworldLLMCompletionCache(const FString& InDirectory, FClock InClock)
+	: Directory(InDirectory)
+	, Clock(InClock ? MoveTemp(InClock) : FClock([]() { return FDateTime::UtcNow(); }))
+{}
+
+FString FInworldLLMCompletionCache::MakeKey(const FString& Url, const FString& Body)
+{
+	const FTCHARToUTF8 Converted(*(Url + TEXT("\n") + Body));
+	uint8 Hash[FSHA1::DigestSize];
+	FSHA1::HashBuffer(Converted.Get(), Converted.Length(), Hash);
+	return BytesToHex(Hash, FSHA1::DigestSize);
+}
+
+bool FInworldLLMCompletionCache::Find(const FString& Key, TArray<FString>& OutLines)
+{
+	if (FEntry* Entry = Entries.Find(Key))
+	{
+		if (!IsExpired(Entry->StoreTime))
+		{
+			Entry->LastUsed = ++UseCounter;
+			OutLines = Entry->Lines;
+			Stats.NumMemoryHits++;
+			return true;
+		}
+		RemoveFromMemory(Key);
+		IFileManager::Get().Delete(*GetFilePath(Key), false, false, true);
+		RemoveFromDisk(Key);
+	}
+
+	FDateTime StoreTime;
+	if (LoadFromDisk(Key, OutLines, StoreTime))
+	{
+		if (!IsExpired(StoreTime))
+		{
+			AddToMemory(Key, CopyTemp(OutLines), StoreTime);
+			Stats.NumDiskHits++;
+			return true;
+		}
+		IFileManager::Get().Delete(*GetFilePath(Key), false, false, true);
+		RemoveFromDisk(Key);
+		OutLines.Reset();
+	}
+
+	Stats.NumMisses++;
+	return false;
+}
+
+void FInworldLLMCompletionCache::Store(const FString& Key, const TArray<FString>& Lines)
+{
+	const FDateTime StoreTime = Clock();
+	RemoveFromMemory(Key);
+	AddToMemory(Key, CopyTemp(Lines), StoreTime);
+	SaveToDisk(Key, Lines, StoreTime);
+	Stats.NumStored++;
+}
+
+void FInworldLLMCompletionCache::Clear()
+{
+	Entries.Empty();
+	Stats.MemoryBytes = 0;
+	if (!Directory.IsEmpty())
+	{
+		IFileManager::Get().DeleteDirectory(*Directory, false, true);
+		DiskFiles.Empty();
+		Stats.DiskBytes = 0;
+		bDiskScanned = true;
+	}
+}
+
+void FInworldLLMCompletionCache::SetLimits(double InTimeToLive, int64 InMaxMemoryBytes, int64 InMaxDiskBytes)
+{
+	TimeToLive = FMath::Max(InTimeToLive, 0.0);
+	MaxMemoryBytes = FMath::Max<int64>(InMaxMemoryBytes, 0);
+	MaxDiskBytes = FMath::Max<int64>(InMaxDiskBytes, 0);
+	EvictMemory();
+	if (!Directory.IsEmpty())
+	{
+		EvictDisk(FString());
+	}
+}
+
+void FInworldLLMCompletionCache::AddToMemory(const FString& Key, TArray<FString>&& Lines, FDateTime StoreTime)
+{
+	FEntry& Entry = Entries.Add(Key);
+	Entry.Size = Key.Len() * sizeof(TCHAR);
+	for (const FString& Line : Lines)
+	{
+		Entry.Size += Line.Len() * sizeof(TCHAR);
+	}
+	Entry.Lines = MoveTemp(Lines);
+	Entry.StoreTime = StoreTime;
+	Entry.LastUsed = ++UseCounter;
+	Stats.MemoryBytes += Entry.Size;
+
+	EvictMemory();
+}
+
+void FInworldLLMCompletionCache::RemoveFromMemory(const FString& Key)
+{
+	FEntry Entry;
+	if (Entries.RemoveAndCopyValue(Key, Entry))
+	{
+		Stats.MemoryBytes -= Entry.Size;
+	}
+}
+
+bool FInworldLLMCompletionCache::IsExpired(FDateTime StoreTime) const
+{
+	return TimeToLive > 0.0 && (Clock() - StoreTime).GetTotalSeconds() > TimeToLive;
+}
+
+bool FInworldLLMCompletionCache::LoadFromDisk(const FString& Key, TArray<FString>& OutLines, FDateTime& OutStoreTime) const
+{
+	FString JsonString;
+	if (Directory.IsEmpty() || !FFileHelper::LoadFileToString(JsonString, *GetFilePath(Key)))
+	{
+		return false;
+	}
+
+	TSharedPtr<FJsonObject> JsonObject;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(JsonString);
+	FString StoreTimeString;
+	const TArray<TSharedPtr<FJsonValue>>* JsonLines = nullptr;
+	if (!FJsonSerializer::Deserialize(Reader, JsonObject) ||
+		!JsonObject->TryGetStringField(TEXT("storeTime"), StoreTimeString) ||
+		!FDateTime::ParseIso8601(*StoreTimeString, OutStoreTime) ||
+		!JsonObject->TryGetArrayField(TEXT("lines"), JsonLines))
+	{
+		UE_LOG(LogInworldAILLM, Warning, TEXT("Invalid cached completion %s"), *GetFilePath(Key));
+		return false;
+	}
+
+	OutLines.Reset(JsonLines->Num());
+	for (const TSharedPtr<FJsonValue>& JsonLine : *JsonLines)
+	{
+		OutLines.Add(JsonLine->AsString());
+	}
+	return true;
+}
+
+void FInworldLLMCompletionCache::SaveToDisk(const FString& Key, const TArray<FString>& Lines, FDateTime StoreTime)
+{
+	if (Directory.IsEmpty())
+	{
+		return;
+	}
+
+	TArray<TSharedPtr<FJsonValue>> JsonLines;
+	JsonLines.Reserve(Lines.Num());
+	for (const FString& Line : Lines)
+	{
+		JsonLines.Add(MakeShared<FJsonValueString>(Line));
+	}
+	TSharedRef<FJsonObject> JsonObject = MakeShared<FJsonObject>();
+	JsonObject->SetStringField(TEXT("storeTime"), StoreTime.ToIso8601());
+	JsonObject->SetArrayField(TEXT("lines"), JsonLines);
+
+	FString JsonString;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonString);
+	if (!FJsonSerializer::Serialize(JsonObject, Writer) || !FFileHelper::SaveStringToFile(JsonString, *GetFilePath(Key), FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		UE_LOG(LogInworldAILLM, Warning, TEXT("Failed to save cached completion %s"), *GetFilePath(Key));
+		return;
+	}
+
+	ScanDisk();
+	AddToDisk(Key, FTCHARToUTF8(*JsonString).Length());
+	EvictDisk(Key);
+}
+
+void FInworldLLMCompletionCache::EvictMemory()
+{
+	while (Stats.MemoryBytes > MaxMemoryBytes)
+	{
+		// the latest response is kept even over the limit
+		const FString* LeastRecentlyUsed = nullptr;
+		uint64 LeastRecentUse = UseCounter;
+		for (const auto& Entry : Entries)
+		{
+			if (Entry.Value.LastUsed < LeastRecentUse)
+			{
+				LeastRecentlyUsed = &Entry.Key;
+				LeastRecentUse = Entry.Value.LastUsed;
+			}
+		}
+		if (LeastRecentlyUsed == nullptr)
+		{
+			return;
+		}
+
+		// still served from disk if persisted
+		RemoveFromMemory(FString(*LeastRecentlyUsed));
+		Stats.NumEvicted++;
+	}
+}
+
+void FInworldLLMCompletionCache::EvictDisk(const FString& LatestKey)
+{
+	ScanDisk();
+	while (Stats.DiskBytes > MaxDiskBytes)
+	{
+		// the latest response is kept even over the limit
+		const FString* Oldest = nullptr;
+		uint64 OldestOrder = MAX_uint64;
+		for (const auto& File : DiskFiles)
+		{
+			if (File.Value.Order < OldestOrder && File.Key != LatestKey)
+			{
+				Oldest = &File.Key;
+				OldestOrder = File.Value.Order;
+			}
+		}
+		if (Oldest == nullptr)
+		{
+			return;
+		}
+
+		// forgotten even if the delete fails, so a locked file can't stall eviction
+		const FString Key = *Oldest;
+		if (IFileManager::Get().Delete(*GetFilePath(Key), false, false, true))
+		{
+			Stats.NumEvicted++;
+		}
+		RemoveFromDisk(Key);
+	}
+}
+
+void FInworldLLMCompletionCache::ScanDisk()
+{
+	if (bDiskScanned || Directory.IsEmpty())
+	{
+		return;
+	}
+	bDiskScanned = true;
+
+	struct FFile
+	{
+		FString Key;
+		FDateTime ModificationTime;
+		int64 Size;
+	};
+	TArray<FFile> Files;
+	IFileManager::Get().IterateDirectoryStat(*Directory, [&Files](const TCHAR* Path, const FFileStatData& StatData)
+	{
+		if (!StatData.bIsDirectory && FPaths::GetExtension(Path) == TEXT("json"))
+		{
+			Files.Add({ FPaths::GetBaseFilename(Path), StatData.ModificationTime, StatData.FileSize });
+		}
+		return true;
+	});
+
+	// files of previous runs are older than any stored from now on
+	Files.Sort([](const FFile& A, const FFile& B) { return A.ModificationTime < B.ModificationTime; });
+	for (const FFile& File : Files)
+	{
+		AddToDisk(File.Key, File.Size);
+	}
+}
+
+void FInworldLLMCompletionCache::AddToDisk(const FString& Key, int64 Size)
+{
+	RemoveFromDisk(Key);
+	DiskFiles.Add(Key, { Size, ++DiskCounter });
+	Stats.DiskBytes += Size;
+}
+
+void FInworldLLMCompletionCache::RemoveFromDisk(const FString& Key)
+{
+	FDiskFile File;
+	if (DiskFiles.RemoveAndCopyValue(Key, File))
+	{
+		Stats.DiskBytes -= File.Size;
+	}
+}
+
+FString FInworldLLMCompletionCache::GetFilePath(const FString& Key) const
+{
+	return FPaths::Combine(Directory, Key + TEXT(".json"));
+}
+
+UInworldLLMCompletionCacheSubsystem* UInworldLLMCompletionCacheSubsystem::Get()
+{
+	return GEngine ? GEngine->GetEngineSubsystem<UInworldLLMCompletionCacheSubsystem>() : nullptr;
+}
+
+bool UInworldLLMCompletionCacheSubsystem::IsCacheable(float Temperature) const
+{
+	return Cache.IsValid() && Temperature <= MaxCacheableTemperature;
+}
+
+void UInworldLLMCompletionCacheSubsystem::ClearCache()
+{
+	if (Cache.IsValid())
+	{
+		Cache->Clear();
+	}
+}
+
+FInworldLLMCompletionCacheStats UInworldLLMCompletionCacheSubsystem::GetStats() const
+{
+	return Cache.IsValid() ? Cache->GetStats() : FInworldLLMCompletionCacheStats();
+}
+
+void UInworldLLMCompletionCacheSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const UInworldAILLMSettings* LLMSettings = GetDefault<UInworldAILLMSettings>();
+	if (!LLMSettings->bEnableCompletionCache)
+	{
+		return;
+	}
+
+	const FString Directory = LLMSettings->bPersistCompletionCache ? FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("InworldAI"), TEXT("LLMCache")) : FString();
+	Cache = MakeUnique<FInworldLLMCompletionCache>(Directory);
+	Cache->SetLimits(LLMSettings->CompletionCacheTimeToLive, static_cast<int64>(LLMSettings->CompletionCacheMaxMemoryMB) * 1024 * 1024, static_cast<int64>(LLMSettings->CompletionCacheMaxDiskMB) * 1024 * 1024);
+	MaxCacheableTemperature = LLMSettings->MaxCacheableTemperature;
+}
+
+void UInworldLLMCompletionCacheSubsystem::Deinitialize()
+{
+	Cache.Reset();
+
+	Super::Deinitialize();
+}
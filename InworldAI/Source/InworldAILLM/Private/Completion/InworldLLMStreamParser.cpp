@@ -0,0 +1,114 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#include "Completion/InworldLLMStreamParser.h"
+
+namespace Inworld
+{
+	static bool StartsWith(const uint8* Data, int32 Num, const ANSICHAR* Prefix, int32 PrefixNum)
+	{
+		return Num >= PrefixNum && FMemory::Memcmp(Data, Prefix, PrefixNum) == 0;
+	}
+}
+
+void FInworldLLMStreamParser::Feed(const uint8* Data, int32 Num, FLineFunc Func)
+{
+	NumConsumedBytes += Num;
+
+	const uint8* End = Data + Num;
+	while (Data < End)
+	{
+		const uint8* NewLine = Data;
+		while (NewLine < End && *NewLine != '\n')
+		{
+			++NewLine;
+		}
+		if (NewLine == End)
+		{
+			PendingLine.Append(Data, End - Data);
+			return;
+		}
+
+		if (PendingLine.Num() > 0)
+		{
+			// completes a line split between chunks
+			PendingLine.Append(Data, NewLine - Data);
+			HandleLine(PendingLine.GetData(), PendingLine.Num(), Func);
+			PendingLine.Reset();
+		}
+		else
+		{
+			HandleLine(Data, NewLine - Data, Func);
+		}
+		Data = NewLine + 1;
+	}
+}
+
+void FInworldLLMStreamParser::FeedContent(const TArray<uint8>& Content, FLineFunc Func)
+{
+	const int64 Offset = static_cast<int64>(NumConsumedBytes);
+	if (Content.Num() > Offset)
+	{
+		Feed(Content.GetData() + Offset, Content.Num() - Offset, Func);
+	}
+}
+
+void FInworldLLMStreamParser::Finish(FLineFunc Func)
+{
+	if (PendingLine.Num() > 0)
+	{
+		HandleLine(PendingLine.GetData(), PendingLine.Num(), Func);
+		PendingLine.Reset();
+	}
+}
+
+void FInworldLLMStreamParser::Reset()
+{
+	PendingLine.Reset();
+	NumConsumedBytes = 0;
+	bDone = false;
+}
+
+void FInworldLLMStreamParser::HandleLine(const uint8* Line, int32 Num, FLineFunc Func)
+{
+	if (Num > 0 && Line[Num - 1] == '\r')
+	{
+		--Num;
+	}
+
+	// SSE fields, only data is of interest, comments start with a colon
+	if (Inworld::StartsWith(Line, Num, "data:", 5))
+	{
+		Line += 5;
+		Num -= 5;
+		if (Num > 0 && Line[0] == ' ')
+		{
+			++Line;
+			--Num;
+		}
+		if (Inworld::StartsWith(Line, Num, "[DONE]", 6) && Num == 6)
+		{
+			bDone = true;
+			return;
+		}
+	}
+	else if ((Num > 0 && Line[0] == ':') || Inworld::StartsWith(Line, Num, "event:", 6) ||
+		Inworld::StartsWith(Line, Num, "id:", 3) || Inworld::StartsWith(Line, Num, "retry:", 6))
+	{
+		return;
+	}
+
+	if (Num == 0)
+	{
+		return;
+	}
+
+	const FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(Line), Num);
+	LineString.Reset();
+	LineString.AppendChars(Converted.Get(), Converted.Length());
+	Func(LineString);
+}
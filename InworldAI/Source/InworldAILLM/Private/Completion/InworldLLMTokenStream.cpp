@@ -0,0 +1,338 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#include "Completion/InworldLLMTokenStream.h"
+#include "InworldAILLMModule.h"
+
+#include "Interfaces/IHttpResponse.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+#if ENGINE_MAJOR_VERSION == 4
+using FInworldCoreTicker = FTicker;
+#else
+using FInworldCoreTicker = FTSTicker;
+#endif
+
+void FInworldLLMTokenStream::Start(TSharedRef<IHttpRequest, ESPMode::ThreadSafe> InRequest)
+{
+	{
+		FScopeLock ScopeLock(&Lock);
+		if (!bCanceled)
+		{
+			Request = InRequest;
+		}
+	}
+	if (bCanceled)
+	{
+		ReleaseRequest();
+		return;
+	}
+
+	// the request keeps the stream alive until it completes
+	TSharedRef<FInworldLLMTokenStream, ESPMode::ThreadSafe> Self = AsShared();
+	InRequest->SetDelegateThreadPolicy(EHttpRequestDelegateThreadPolicy::CompleteOnHttpThread);
+#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION > 3
+	InRequest->OnRequestProgress64().BindLambda([Self](FHttpRequestPtr HttpRequest, uint64 BytesSent, uint64 BytesReceived)
+#else
+	InRequest->OnRequestProgress().BindLambda([Self](FHttpRequestPtr HttpRequest, int32 BytesSent, int32 BytesReceived)
+#endif
+	{
+		FHttpResponsePtr Response = HttpRequest->GetResponse();
+		if (Response.IsValid() && (EHttpResponseCodes::IsOk(Response->GetResponseCode()) || Response->GetResponseCode() == EHttpResponseCodes::Unknown))
+		{
+			Self->ReceiveContent(Response->GetContent());
+		}
+	});
+	InRequest->OnProcessRequestComplete().BindLambda([Self](FHttpRequestPtr HttpRequest, FHttpResponsePtr Response, bool bSuccess)
+	{
+		const bool bResponseOk = bSuccess && Response.IsValid() && EHttpResponseCodes::IsOk(Response->GetResponseCode());
+		if (bResponseOk)
+		{
+			Self->ReceiveContent(Response->GetContent());
+		}
+		else if (!Self->IsCanceled())
+		{
+			UE_LOG(LogInworldAILLM, Error, TEXT("Invalid Inworld Studio response. code=%d"), Response.IsValid() ? Response->GetResponseCode() : 0);
+		}
+		Self->ReceiveComplete(bResponseOk);
+	});
+	InRequest->ProcessRequest();
+}
+
+void FInworldLLMTokenStream::ReceiveContent(const TArray<uint8>& Content)
+{
+	FScopeLock ScopeLock(&Lock);
+	if (!bCanceled && !bComplete)
+	{
+		Parser.FeedContent(Content, [this](const FString& Line) { HandleLine(Line); });
+	}
+}
+
+void FInworldLLMTokenStream::ReceiveComplete(bool bSuccess)
+{
+	{
+		FScopeLock ScopeLock(&Lock);
+		if (!bComplete && !bCanceled)
+		{
+			Parser.Finish([this](const FString& Line) { HandleLine(Line); });
+			bComplete = true;
+			if (!bCanceled)
+			{
+				OnComplete.ExecuteIfBound(bSuccess);
+			}
+		}
+		bComplete = true;
+	}
+	ReleaseRequest();
+}
+
+void FInworldLLMTokenStream::Cancel()
+{
+	TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> CanceledRequest;
+	{
+		// waits for a callback in progress on another thread
+		FScopeLock ScopeLock(&Lock);
+		if (bCanceled || bComplete)
+		{
+			return;
+		}
+		// the parser may be mid chunk when canceled from a callback, it's released with the request
+		bCanceled = true;
+		CanceledRequest = Request;
+	}
+
+	OnCanceled.ExecuteIfBound();
+
+	if (CanceledRequest.IsValid())
+	{
+		// completes the request, which releases it
+		CanceledRequest->CancelRequest();
+	}
+}
+
+void FInworldLLMTokenStream::Abort()
+{
+	TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> AbortedRequest;
+	{
+		FScopeLock ScopeLock(&Lock);
+		if (bCanceled || bComplete)
+		{
+			return;
+		}
+		// the rest of the response is dropped, not parsed
+		bComplete = true;
+		AbortedRequest = Request;
+		OnComplete.ExecuteIfBound(false);
+	}
+
+	if (AbortedRequest.IsValid())
+	{
+		// completes the request, which releases it
+		AbortedRequest->CancelRequest();
+	}
+	else
+	{
+		ReleaseRequest();
+	}
+}
+
+FInworldLLMScheduledRequest FInworldLLMTokenStream::MakeScheduledRequest(TFunction<void(uint64)> Start)
+{
+	TSharedRef<FInworldLLMTokenStream, ESPMode::ThreadSafe> Self = AsShared();
+	FInworldLLMScheduledRequest ScheduledRequest;
+	ScheduledRequest.Start = MoveTemp(Start);
+	ScheduledRequest.Abort = [Self]() { Self->Abort(); };
+	ScheduledRequest.Drop = [Self]() { Self->Abort(); };
+	return ScheduledRequest;
+}
+
+bool FInworldLLMTokenStream::GetTokenDelta(const FString& Line, FString& OutDelta)
+{
+	TSharedPtr<FJsonObject> JsonObject;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Line);
+	if (!FJsonSerializer::Deserialize(Reader, JsonObject) || !JsonObject->HasTypedField<EJson::Object>(TEXT("result")))
+	{
+		return false;
+	}
+
+	const TArray<TSharedPtr<FJsonValue>>* Choices = nullptr;
+	if (!JsonObject->GetObjectField(TEXT("result"))->TryGetArrayField(TEXT("choices"), Choices) || Choices->Num() == 0 || (*Choices)[0]->Type != EJson::Object)
+	{
+		return false;
+	}
+
+	const TSharedPtr<FJsonObject> Choice = (*Choices)[0]->AsObject();
+	if (Choice->HasTypedField<EJson::Object>(TEXT("message")))
+	{
+		return Choice->GetObjectField(TEXT("message"))->TryGetStringField(TEXT("content"), OutDelta);
+	}
+	return Choice->TryGetStringField(TEXT("text"), OutDelta);
+}
+
+void FInworldLLMTokenStream::HandleLine(const FString& Line)
+{
+	// a callback may cancel the stream mid chunk
+	if (bCanceled)
+	{
+		return;
+	}
+
+	FString Delta;
+	if (!GetTokenDelta(Line, Delta))
+	{
+		UE_LOG(LogInworldAILLM, Warning, TEXT("Invalid Response Format. json=%s"), *Line);
+		return;
+	}
+	if (!Delta.IsEmpty())
+	{
+		OnTokens.ExecuteIfBound(Delta);
+	}
+}
+
+void FInworldLLMTokenStream::ReleaseRequest()
+{
+	bool bNotifyFinished = false;
+	{
+		FScopeLock ScopeLock(&Lock);
+		Request.Reset();
+		Parser.Reset();
+		if (!bFinished && (bComplete || bCanceled))
+		{
+			bFinished = true;
+			bNotifyFinished = true;
+		}
+	}
+	if (bNotifyFinished)
+	{
+		OnFinished.ExecuteIfBound();
+	}
+}
+
+FInworldLLMTokenMarshal::FInworldLLMTokenMarshal(FInworldLLMTokenStream::FOnTokens InOnTokens, FInworldLLMTokenStream::FOnComplete InOnComplete)
+	: OnTokens(MoveTemp(InOnTokens))
+	, OnComplete(MoveTemp(InOnComplete))
+{}
+
+FInworldLLMTokenMarshal::~FInworldLLMTokenMarshal()
+{
+	if (TickerHandle.IsValid())
+	{
+		FInworldCoreTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+	}
+}
+
+TSharedRef<FInworldLLMTokenMarshal, ESPMode::ThreadSafe> FInworldLLMTokenMarshal::Create(FInworldLLMTokenStream::FOnTokens InOnTokens, FInworldLLMTokenStream::FOnComplete InOnComplete)
+{
+	TSharedRef<FInworldLLMTokenMarshal, ESPMode::ThreadSafe> Marshal = MakeShared<FInworldLLMTokenMarshal, ESPMode::ThreadSafe>(MoveTemp(InOnTokens), MoveTemp(InOnComplete));
+	TWeakPtr<FInworldLLMTokenMarshal, ESPMode::ThreadSafe> WeakMarshal = Marshal;
+	Marshal->TickerHandle = FInworldCoreTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([WeakMarshal](float DeltaTime)
+	{
+		TSharedPtr<FInworldLLMTokenMarshal, ESPMode::ThreadSafe> PinnedMarshal = WeakMarshal.Pin();
+		if (PinnedMarshal.IsValid() && PinnedMarshal->Flush())
+		{
+			return true;
+		}
+		if (PinnedMarshal.IsValid())
+		{
+			PinnedMarshal->TickerHandle.Reset();
+		}
+		return false;
+	}));
+	return Marshal;
+}
+
+void FInworldLLMTokenMarshal::Bind(FInworldLLMTokenStream& Stream)
+{
+	TSharedRef<FInworldLLMTokenMarshal, ESPMode::ThreadSafe> Self = AsShared();
+	Stream.OnTokens.BindLambda([Self](const FString& Delta) { Self->PushTokens(Delta); });
+	Stream.OnComplete.BindLambda([Self](bool bSuccess) { Self->PushComplete(bSuccess); });
+	Stream.OnCanceled.BindLambda([Self]() { Self->Cancel(); });
+}
+
+void FInworldLLMTokenMarshal::PushTokens(const FString& Delta)
+{
+	FScopeLock ScopeLock(&Lock);
+	if (!bCanceled)
+	{
+		PendingTokens += Delta;
+	}
+}
+
+void FInworldLLMTokenMarshal::PushComplete(bool bSuccess)
+{
+	FScopeLock ScopeLock(&Lock);
+	if (!bCanceled)
+	{
+		PendingComplete = bSuccess;
+	}
+}
+
+void FInworldLLMTokenMarshal::Cancel()
+{
+	{
+		FScopeLock BroadcastScopeLock(&BroadcastLock);
+		FScopeLock ScopeLock(&Lock);
+		if (bCanceled)
+		{
+			return;
+		}
+		bCanceled = true;
+		PendingTokens.Empty();
+		PendingComplete.Reset();
+	}
+
+	// the core ticker is game thread only in UE4, elsewhere the next tick sees the cancel and removes it
+	if (IsInGameThread() && TickerHandle.IsValid())
+	{
+		FInworldCoreTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+}
+
+bool FInworldLLMTokenMarshal::Flush()
+{
+	check(IsInGameThread());
+
+	if (bCompleted || bCanceled)
+	{
+		return false;
+	}
+
+	// a callback may cancel, Cancel on another thread waits for the broadcasts
+	FScopeLock BroadcastScopeLock(&BroadcastLock);
+
+	FString Tokens;
+	TOptional<bool> Complete;
+	{
+		FScopeLock ScopeLock(&Lock);
+		if (bCanceled)
+		{
+			return false;
+		}
+		Tokens = MoveTemp(PendingTokens);
+		PendingTokens.Reset();
+		Complete = PendingComplete;
+	}
+
+	if (!Tokens.IsEmpty())
+	{
+		NumBroadcasts++;
+		OnTokens.ExecuteIfBound(Tokens);
+	}
+	if (bCanceled)
+	{
+		return false;
+	}
+	if (Complete.IsSet())
+	{
+		bCompleted = true;
+		OnComplete.ExecuteIfBound(Complete.GetValue());
+		return false;
+	}
+	return true;
+}
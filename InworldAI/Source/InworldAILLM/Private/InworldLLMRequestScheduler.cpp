@@ -0,0 +1,264 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#include "InworldLLMRequestScheduler.h"
+#include "InworldAILLMSettings.h"
+#include "InworldAILLMModule.h"
+
+#include "Engine/Engine.h"
+
+FInworldLLMRequestScheduler::FInworldLLMRequestScheduler(FClock InClock)
+	: Clock(InClock ? MoveTemp(InClock) : FClock([]() { return FPlatformTime::Seconds(); }))
+{}
+
+uint64 FInworldLLMRequestScheduler::Schedule(EInworldLLMRequestPriority Priority, float Timeout, FInworldLLMScheduledRequest&& Request)
+{
+	FEntry Entry;
+	Entry.Id = NextId++;
+	Entry.Priority = Priority;
+	Entry.QueueTime = Clock();
+	Entry.Deadline = Timeout > 0.f ? Entry.QueueTime + Timeout : 0.0;
+	Entry.Request = MoveTemp(Request);
+
+	if (Entry.Deadline > 0.0)
+	{
+		NumDeadlines++;
+	}
+
+	const uint64 Id = Entry.Id;
+	GetQueue(Priority).Add(MoveTemp(Entry));
+	UpdateQueueMetrics();
+
+	StartNext();
+	return Id;
+}
+
+void FInworldLLMRequestScheduler::Finish(uint64 Id)
+{
+	const int32 Index = InFlight.IndexOfByPredicate([Id](const FEntry& Entry) { return Entry.Id == Id; });
+	if (Index == INDEX_NONE)
+	{
+		return;
+	}
+
+	FEntry Entry;
+	RemoveInFlight(Index, Entry);
+	Metrics.NumFinished++;
+
+	StartNext();
+}
+
+bool FInworldLLMRequestScheduler::Cancel(uint64 Id)
+{
+	for (TArray<FEntry>* Queue : { &PlayerFacingQueue, &BackgroundQueue })
+	{
+		const int32 Index = Queue->IndexOfByPredicate([Id](const FEntry& Entry) { return Entry.Id == Id; });
+		if (Index != INDEX_NONE)
+		{
+			FEntry Entry = MoveTemp((*Queue)[Index]);
+			Queue->RemoveAt(Index);
+			NumDeadlines -= Entry.Deadline > 0.0 ? 1 : 0;
+			Metrics.NumCanceled++;
+			UpdateQueueMetrics();
+
+			if (Entry.Request.Drop)
+			{
+				Entry.Request.Drop();
+			}
+			return true;
+		}
+	}
+
+	const int32 Index = InFlight.IndexOfByPredicate([Id](const FEntry& Entry) { return Entry.Id == Id; });
+	if (Index == INDEX_NONE)
+	{
+		return false;
+	}
+
+	FEntry Entry;
+	RemoveInFlight(Index, Entry);
+	Metrics.NumCanceled++;
+
+	if (Entry.Request.Abort)
+	{
+		Entry.Request.Abort();
+	}
+	StartNext();
+	return true;
+}
+
+void FInworldLLMRequestScheduler::Update()
+{
+	if (NumDeadlines == 0)
+	{
+		return;
+	}
+
+	const double Now = Clock();
+	TArray<FEntry> Dropped;
+	TArray<FEntry> Aborted;
+
+	for (TArray<FEntry>* Queue : { &PlayerFacingQueue, &BackgroundQueue })
+	{
+		for (int32 i = Queue->Num() - 1; i >= 0; --i)
+		{
+			if ((*Queue)[i].Deadline > 0.0 && (*Queue)[i].Deadline <= Now)
+			{
+				Dropped.Add(MoveTemp((*Queue)[i]));
+				Queue->RemoveAt(i);
+				NumDeadlines--;
+			}
+		}
+	}
+
+	for (int32 i = InFlight.Num() - 1; i >= 0; --i)
+	{
+		if (InFlight[i].Deadline > 0.0 && InFlight[i].Deadline <= Now)
+		{
+			Aborted.AddDefaulted();
+			RemoveInFlight(i, Aborted.Last());
+		}
+	}
+
+	if (Dropped.Num() == 0 && Aborted.Num() == 0)
+	{
+		return;
+	}
+
+	Metrics.NumExpired += Dropped.Num() + Aborted.Num();
+	UpdateQueueMetrics();
+
+	// callbacks may schedule or cancel requests, the scheduler is consistent by now
+	for (FEntry& Entry : Dropped)
+	{
+		if (Entry.Request.Drop)
+		{
+			Entry.Request.Drop();
+		}
+	}
+	for (FEntry& Entry : Aborted)
+	{
+		if (Entry.Request.Abort)
+		{
+			Entry.Request.Abort();
+		}
+	}
+
+	StartNext();
+}
+
+void FInworldLLMRequestScheduler::SetLimits(int32 InMaxInFlight, int32 InMaxBackgroundInFlight)
+{
+	MaxInFlight = FMath::Max(InMaxInFlight, 1);
+	MaxBackgroundInFlight = FMath::Clamp(InMaxBackgroundInFlight, 0, MaxInFlight);
+	StartNext();
+}
+
+void FInworldLLMRequestScheduler::StartNext()
+{
+	// Start may finish synchronously, the outer call keeps starting
+	if (bStarting)
+	{
+		return;
+	}
+	TGuardValue<bool> StartingGuard(bStarting, true);
+
+	while (true)
+	{
+		TArray<FEntry>* Queue = nullptr;
+		if (PlayerFacingQueue.Num() > 0 && CanStart(EInworldLLMRequestPriority::PlayerFacing))
+		{
+			Queue = &PlayerFacingQueue;
+		}
+		else if (BackgroundQueue.Num() > 0 && CanStart(EInworldLLMRequestPriority::Background))
+		{
+			Queue = &BackgroundQueue;
+		}
+		if (Queue == nullptr)
+		{
+			return;
+		}
+
+		FEntry& Entry = InFlight.Add_GetRef(MoveTemp((*Queue)[0]));
+		Queue->RemoveAt(0);
+		if (Entry.Priority == EInworldLLMRequestPriority::Background)
+		{
+			NumBackgroundInFlight++;
+		}
+
+		const float QueueTime = static_cast<float>(Clock() - Entry.QueueTime);
+		TotalQueueTime += QueueTime;
+		Metrics.NumStarted++;
+		Metrics.AverageQueueTime = static_cast<float>(TotalQueueTime / Metrics.NumStarted);
+		Metrics.MaxQueueTime = FMath::Max(Metrics.MaxQueueTime, QueueTime);
+		UpdateQueueMetrics();
+
+		// copied, Start may finish or cancel the entry
+		const uint64 Id = Entry.Id;
+		const TFunction<void(uint64)> Start = Entry.Request.Start;
+		if (Start)
+		{
+			Start(Id);
+		}
+	}
+}
+
+bool FInworldLLMRequestScheduler::CanStart(EInworldLLMRequestPriority Priority) const
+{
+	if (InFlight.Num() >= MaxInFlight)
+	{
+		return false;
+	}
+	return Priority != EInworldLLMRequestPriority::Background || NumBackgroundInFlight < MaxBackgroundInFlight;
+}
+
+void FInworldLLMRequestScheduler::RemoveInFlight(int32 Index, FEntry& OutEntry)
+{
+	OutEntry = MoveTemp(InFlight[Index]);
+	InFlight.RemoveAt(Index);
+	if (OutEntry.Priority == EInworldLLMRequestPriority::Background)
+	{
+		NumBackgroundInFlight--;
+	}
+	NumDeadlines -= OutEntry.Deadline > 0.0 ? 1 : 0;
+	UpdateQueueMetrics();
+}
+
+void FInworldLLMRequestScheduler::UpdateQueueMetrics()
+{
+	Metrics.NumQueuedPlayerFacing = PlayerFacingQueue.Num();
+	Metrics.NumQueuedBackground = BackgroundQueue.Num();
+	Metrics.NumInFlight = InFlight.Num();
+}
+
+TArray<FInworldLLMRequestScheduler::FEntry>& FInworldLLMRequestScheduler::GetQueue(EInworldLLMRequestPriority Priority)
+{
+	return Priority == EInworldLLMRequestPriority::Background ? BackgroundQueue : PlayerFacingQueue;
+}
+
+UInworldLLMSchedulerSubsystem* UInworldLLMSchedulerSubsystem::Get()
+{
+	return GEngine ? GEngine->GetEngineSubsystem<UInworldLLMSchedulerSubsystem>() : nullptr;
+}
+
+void UInworldLLMSchedulerSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const UInworldAILLMSettings* LLMSettings = GetDefault<UInworldAILLMSettings>();
+	Scheduler.SetLimits(LLMSettings->MaxInFlightRequests, LLMSettings->MaxBackgroundInFlightRequests);
+}
+
+void UInworldLLMSchedulerSubsystem::Tick(float DeltaTime)
+{
+	Scheduler.Update();
+}
+
+TStatId UInworldLLMSchedulerSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UInworldLLMSchedulerSubsystem, STATGROUP_Tickables);
+}
@@ -27,10 +27,12 @@ public:
 	 * @param ModelOverride (Optional) Override for the model.
 	 * @param ServiceProviderOverride (Optional) Override for service provider.
 	 * @param JsonMode (Optional) Coerce model to return valid JSON. Only available for OpenAI models.
+	 * @param Priority (Optional) Player facing requests are sent before background ones.
+	 * @param Timeout (Optional) Seconds before the request fails, including the time queued. 0 for no timeout.
 	 * @return A pointer to the async action for completing the chat.
 	 */
 	UFUNCTION(BlueprintCallable, Category = "LLMService", meta = (AdvancedDisplay = "2", AutoCreateRefTerm = "TextGenerationConfig", BlueprintInternalUseOnly = "true"))
-	static UInworldLLMCompleteChatAsyncAction* CompleteChat(const TArray<FInworldLLMCompleteChatMessage>& Messages, const FInworldLLMTextGenerationConfig& TextGenerationConfig, const FString& ApiKeyOverride = "", const FString& UserIdOverride = "", const FString& ModelOverride = "", const FString& ServiceProviderOverride = "", bool JsonMode = false);
+	static UInworldLLMCompleteChatAsyncAction* CompleteChat(const TArray<FInworldLLMCompleteChatMessage>& Messages, const FInworldLLMTextGenerationConfig& TextGenerationConfig, const FString& ApiKeyOverride = "", const FString& UserIdOverride = "", const FString& ModelOverride = "", const FString& ServiceProviderOverride = "", bool JsonMode = false, EInworldLLMRequestPriority Priority = EInworldLLMRequestPriority::PlayerFacing, float Timeout = 0.f);
 
 protected:
 	virtual FString GetCompletionType() const override { return "completeChat"; }
@@ -25,10 +25,12 @@ public:
 	 * @param ApiKeyOverride (Optional) Override for the API key.
 	 * @param UserIdOverride (Optional) Override for the user ID.
 	 * @param ModelOverride (Optional) Override for the model.
+	 * @param Priority (Optional) Player facing requests are sent before background ones.
+	 * @param Timeout (Optional) Seconds before the request fails, including the time queued. 0 for no timeout.
 	 * @return A pointer to the async action for completing text generation.
 	 */
 	UFUNCTION(BlueprintCallable, Category = "LLMService", meta = (AdvancedDisplay = "2", AutoCreateRefTerm = "TextGenerationConfig", BlueprintInternalUseOnly = "true"))
-	static UInworldLLMCompleteTextAsyncAction* CompleteText(const FString& Text, const FInworldLLMTextGenerationConfig& TextGenerationConfig, const FString& ApiKeyOverride = "", const FString& UserIdOverride = "", const FString& ModelOverride = "");
+	static UInworldLLMCompleteTextAsyncAction* CompleteText(const FString& Text, const FInworldLLMTextGenerationConfig& TextGenerationConfig, const FString& ApiKeyOverride = "", const FString& UserIdOverride = "", const FString& ModelOverride = "", EInworldLLMRequestPriority Priority = EInworldLLMRequestPriority::PlayerFacing, float Timeout = 0.f);
 
 protected:
 	virtual FString GetCompletionType() const override { return "completeText"; }
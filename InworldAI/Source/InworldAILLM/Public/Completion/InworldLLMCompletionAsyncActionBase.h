@@ -14,6 +14,9 @@
 #include "Interfaces/IHttpResponse.h"
 #include "Dom/JsonObject.h"
 #include "Completion/InworldLLMCompletionTypes.h"
+#include "Completion/InworldLLMStreamParser.h"
+#include "Completion/InworldLLMTokenStream.h"
+#include "InworldLLMRequestScheduler.h"
 #include "InworldLLMCompletionAsyncActionBase.generated.h"
 
 
@@ -29,6 +32,25 @@ public:
 
 	virtual void Activate() override;
 
+	/**
+	 * Cancel the completion, a queued request is dropped and a sent one is aborted. OnFailure is broadcast.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LLMService")
+	void Cancel();
+
+	/**
+	 * Stream the completion natively instead of activating the action, the Blueprint delegates aren't broadcast and the cache isn't used.
+	 * Deltas are received on the HTTP thread where supported, see FInworldLLMTokenMarshal to receive them on the game thread.
+	 * @return The stream, cancel it to abort the request. Null if the request is invalid.
+	 */
+	TSharedPtr<FInworldLLMTokenStream, ESPMode::ThreadSafe> StartTokenStream(FInworldLLMTokenStream::FOnTokens OnTokens, FInworldLLMTokenStream::FOnComplete OnComplete);
+
+	/**
+	 * Stream the completion to a marshal, bound before the request is scheduled so no delta is missed.
+	 * @return The stream, cancel it to abort the request and the marshal. Null if the request is invalid.
+	 */
+	TSharedPtr<FInworldLLMTokenStream, ESPMode::ThreadSafe> StartTokenStream(TSharedRef<FInworldLLMTokenMarshal, ESPMode::ThreadSafe> Marshal);
+
 	/**
 	 * Event dispatcher for progress updates during the completion action.
 	 */
@@ -56,6 +78,9 @@ protected:
 	FString Model;
 	FString ServiceProvider;
 
+	EInworldLLMRequestPriority Priority = EInworldLLMRequestPriority::PlayerFacing;
+	float Timeout = 0.f;
+
 protected:
 	virtual FString GetCompletionType() const PURE_VIRTUAL(UInworldLLMCompletionAsyncActionBase::GetCompletionType, return FString{};)
 
@@ -70,8 +95,20 @@ private:
 #else
 	void HandleOnRequestProgress(FHttpRequestPtr Request, int32 BytesSent, int32 BytesReceived);
 #endif
+	TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> CreateHttpRequest(TSharedPtr<FJsonObject>& RequestJson, FString& JsonString) const;
+	bool ScheduleTokenStream(TSharedRef<FInworldLLMTokenStream, ESPMode::ThreadSafe> Stream);
 	void HandleOnProcessRequestComplete(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bSuccess);
 	void HandleNextResponseChunk(FHttpResponsePtr Response);
+	void HandleResponseLine(const FString& Line);
+	void HandleCachedResponse(const TArray<FString>& Lines);
+
+	FInworldLLMStreamParser ResponseParser;
+	bool bInvalidResponse = false;
+
+	/** Set when the response may be cached, the valid response lines are kept to store them once complete. */
+	FString CacheKey;
+	TArray<FString> ResponseLines;
 
-	uint64 ProcessedContentLength = 0;
+	TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> HttpRequest;
+	uint64 ScheduledRequestId = 0;
 };
@@ -0,0 +1,177 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+
+#include "InworldLLMCompletionCache.generated.h"
+
+USTRUCT(BlueprintType)
+struct INWORLDAILLM_API FInworldLLMCompletionCacheStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "LLMService")
+	int32 NumMemoryHits = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LLMService")
+	int32 NumDiskHits = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LLMService")
+	int32 NumMisses = 0;
+
+	/** Requests not looked up, e.g. because of a non-deterministic temperature. */
+	UPROPERTY(BlueprintReadOnly, Category = "LLMService")
+	int32 NumBypassed = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LLMService")
+	int32 NumStored = 0;
+
+	/** Responses removed from memory or disk because of the size limits. */
+	UPROPERTY(BlueprintReadOnly, Category = "LLMService")
+	int32 NumEvicted = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LLMService")
+	int64 MemoryBytes = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LLMService")
+	int64 DiskBytes = 0;
+};
+
+/**
+ * Completion responses keyed by a hash of the full request, kept in memory and on disk.
+ * Responses are stored as the received response lines so hits replay through the same delegates.
+ * Game thread only.
+ */
+class INWORLDAILLM_API FInworldLLMCompletionCache
+{
+public:
+	using FClock = TFunction<FDateTime()>;
+
+	/**
+	 * @param InDirectory Where responses are persisted, empty to keep them in memory only.
+	 * @param InClock Returns the current UTC time, FDateTime::UtcNow by default.
+	 */
+	explicit FInworldLLMCompletionCache(const FString& InDirectory = FString(), FClock InClock = FClock());
+
+	/**
+	 * Stable key of a request, the body is the serialized request json.
+	 */
+	static FString MakeKey(const FString& Url, const FString& Body);
+
+	/**
+	 * Find the response lines of a request, memory first then disk. Expired responses are removed.
+	 * @return Whether the response was found.
+	 */
+	bool Find(const FString& Key, TArray<FString>& OutLines);
+
+	void Store(const FString& Key, const TArray<FString>& Lines);
+
+	/**
+	 * Remove all responses from memory and disk.
+	 */
+	void Clear();
+
+	/**
+	 * @param InTimeToLive Seconds a response stays valid, 0 to never expire.
+	 * @param InMaxMemoryBytes Least recently used responses are released from memory past this size.
+	 * @param InMaxDiskBytes Oldest response files are deleted past this size.
+	 */
+	void SetLimits(double InTimeToLive, int64 InMaxMemoryBytes, int64 InMaxDiskBytes);
+
+	void NotifyBypassed() { Stats.NumBypassed++; }
+
+	const FInworldLLMCompletionCacheStats& GetStats() const { return Stats; }
+
+private:
+	struct FEntry
+	{
+		TArray<FString> Lines;
+		FDateTime StoreTime;
+		int64 Size = 0;
+		uint64 LastUsed = 0;
+	};
+
+	void AddToMemory(const FString& Key, TArray<FString>&& Lines, FDateTime StoreTime);
+	void RemoveFromMemory(const FString& Key);
+	bool IsExpired(FDateTime StoreTime) const;
+	bool LoadFromDisk(const FString& Key, TArray<FString>& OutLines, FDateTime& OutStoreTime) const;
+	void SaveToDisk(const FString& Key, const TArray<FString>& Lines, FDateTime StoreTime);
+	void EvictMemory();
+	void EvictDisk(const FString& LatestKey);
+	void ScanDisk();
+	void AddToDisk(const FString& Key, int64 Size);
+	void RemoveFromDisk(const FString& Key);
+	FString GetFilePath(const FString& Key) const;
+
+	FString Directory;
+	FClock Clock;
+
+	TMap<FString, FEntry> Entries;
+	uint64 UseCounter = 0;
+
+	struct FDiskFile
+	{
+		int64 Size = 0;
+		uint64 Order = 0;
+	};
+
+	/** Files of the directory, scanned once so stores don't list and stat the directory. */
+	TMap<FString, FDiskFile> DiskFiles;
+	uint64 DiskCounter = 0;
+	bool bDiskScanned = false;
+
+	double TimeToLive = 0.0;
+	int64 MaxMemoryBytes = 16 * 1024 * 1024;
+	int64 MaxDiskBytes = 64 * 1024 * 1024;
+
+	FInworldLLMCompletionCacheStats Stats;
+};
+
+/**
+ * Owns the completion cache shared by all LLM completion actions, configured by UInworldAILLMSettings.
+ */
+UCLASS()
+class INWORLDAILLM_API UInworldLLMCompletionCacheSubsystem : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UInworldLLMCompletionCacheSubsystem* Get();
+
+	/**
+	 * The cache, null when disabled in the settings.
+	 */
+	FInworldLLMCompletionCache* GetCache() { return Cache.Get(); }
+
+	/**
+	 * Whether a response generated with the given temperature may be served from the cache.
+	 */
+	bool IsCacheable(float Temperature) const;
+
+	/**
+	 * Remove all cached completions from memory and disk.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LLMService")
+	void ClearCache();
+
+	/**
+	 * Get the cache hit and size statistics.
+	 */
+	UFUNCTION(BlueprintPure, Category = "LLMService")
+	FInworldLLMCompletionCacheStats GetStats() const;
+
+	/** Subsystem interface */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+private:
+	TUniquePtr<FInworldLLMCompletionCache> Cache;
+	float MaxCacheableTemperature = 0.f;
+};
@@ -0,0 +1,56 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Splits a streamed response into lines as bytes arrive.
+ * Accepts newline delimited JSON and server-sent events, for SSE only the data of "data:" fields is returned.
+ * Each received byte is scanned once and each completed line is converted and handed out once,
+ * partial lines, including split UTF-8 sequences, are kept until their newline arrives.
+ */
+class INWORLDAILLM_API FInworldLLMStreamParser
+{
+public:
+	using FLineFunc = TFunctionRef<void(const FString& Line)>;
+
+	/**
+	 * Consume newly received bytes.
+	 * @param Data The bytes received since the previous call.
+	 * @param Num The number of bytes.
+	 * @param Func Called for every completed non-empty line.
+	 */
+	void Feed(const uint8* Data, int32 Num, FLineFunc Func);
+
+	/**
+	 * Consume the bytes of Content past the ones already fed, Content being the whole response received so far.
+	 */
+	void FeedContent(const TArray<uint8>& Content, FLineFunc Func);
+
+	/**
+	 * Hand out the last line when the stream ends without a newline.
+	 */
+	void Finish(FLineFunc Func);
+
+	void Reset();
+
+	/** Bytes fed since the last reset. */
+	uint64 GetNumConsumedBytes() const { return NumConsumedBytes; }
+
+	/** Whether a stream terminator ("data: [DONE]") was received. */
+	bool IsDone() const { return bDone; }
+
+private:
+	void HandleLine(const uint8* Line, int32 Num, FLineFunc Func);
+
+	TArray<uint8> PendingLine;
+	FString LineString;
+	uint64 NumConsumedBytes = 0;
+	bool bDone = false;
+};
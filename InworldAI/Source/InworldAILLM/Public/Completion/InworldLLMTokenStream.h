@@ -0,0 +1,152 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Interfaces/IHttpRequest.h"
+#include "Containers/Ticker.h"
+#include "Completion/InworldLLMStreamParser.h"
+#include "InworldLLMRequestScheduler.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+#include <atomic>
+
+/**
+ * Native streaming of a completion, token deltas are handed out on the thread receiving the response.
+ * That is the HTTP thread where the engine supports it, callbacks must be thread safe and must not block.
+ * Use FInworldLLMTokenMarshal to receive them on the game thread instead.
+ */
+class INWORLDAILLM_API FInworldLLMTokenStream : public TSharedFromThis<FInworldLLMTokenStream, ESPMode::ThreadSafe>
+{
+public:
+	DECLARE_DELEGATE_OneParam(FOnTokens, const FString& /*Delta*/);
+	DECLARE_DELEGATE_OneParam(FOnComplete, bool /*bSuccess*/);
+
+	/** Text of the first choice received since the previous call. Set before Start. */
+	FOnTokens OnTokens;
+	/** Called once when the response ends or is aborted, not called once canceled. Set before Start. */
+	FOnComplete OnComplete;
+	/** Called once when the stream is done including when canceled, for bookkeeping. Set before Start. */
+	FSimpleDelegate OnFinished;
+	/** Called once from Cancel before it returns, on the canceling thread. Set before Start. */
+	FSimpleDelegate OnCanceled;
+
+	/**
+	 * Send the request and receive its response.
+	 */
+	void Start(TSharedRef<IHttpRequest, ESPMode::ThreadSafe> InRequest);
+
+	/**
+	 * Consume the response received so far, may be called from any thread.
+	 * @param Content The whole response content received so far.
+	 */
+	void ReceiveContent(const TArray<uint8>& Content);
+
+	/**
+	 * End the response, may be called from any thread.
+	 */
+	void ReceiveComplete(bool bSuccess);
+
+	/**
+	 * Abort the request and release its buffers, may be called from any thread including from the callbacks.
+	 * No tokens are delivered once this returns.
+	 */
+	void Cancel();
+
+	bool IsCanceled() const { return bCanceled; }
+
+	/**
+	 * Abort the request and complete with failure, may be called from any thread. No tokens are delivered once this returns.
+	 * Unlike Cancel, the consumer is told the stream ended, e.g. when the scheduler drops it past its deadline.
+	 */
+	void Abort();
+
+	/**
+	 * Callbacks to schedule the stream with, a request dropped or aborted by the scheduler aborts the stream.
+	 * @param Start Sends the request, see FInworldLLMScheduledRequest::Start.
+	 */
+	FInworldLLMScheduledRequest MakeScheduledRequest(TFunction<void(uint64 /*Id*/)> Start);
+
+	/**
+	 * Extract the token delta from a response line of completeChat or completeText.
+	 */
+	static bool GetTokenDelta(const FString& Line, FString& OutDelta);
+
+private:
+	void HandleLine(const FString& Line);
+	void ReleaseRequest();
+
+	mutable FCriticalSection Lock;
+	FInworldLLMStreamParser Parser;
+	TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> Request;
+	std::atomic<bool> bCanceled { false };
+	bool bComplete = false;
+	bool bFinished = false;
+};
+
+/**
+ * Collects the deltas of a stream from any thread and broadcasts them on the game thread,
+ * deltas received within a frame are coalesced so there is at most one broadcast per frame.
+ */
+class INWORLDAILLM_API FInworldLLMTokenMarshal : public TSharedFromThis<FInworldLLMTokenMarshal, ESPMode::ThreadSafe>
+{
+public:
+	FInworldLLMTokenMarshal(FInworldLLMTokenStream::FOnTokens InOnTokens, FInworldLLMTokenStream::FOnComplete InOnComplete);
+	~FInworldLLMTokenMarshal();
+
+	/**
+	 * Create a marshal flushed by the core ticker every frame until the stream completes or is canceled.
+	 */
+	static TSharedRef<FInworldLLMTokenMarshal, ESPMode::ThreadSafe> Create(FInworldLLMTokenStream::FOnTokens InOnTokens, FInworldLLMTokenStream::FOnComplete InOnComplete);
+
+	/**
+	 * Route the callbacks of the stream through this marshal, the stream keeps the marshal alive.
+	 * Canceling the stream cancels the marshal.
+	 */
+	void Bind(FInworldLLMTokenStream& Stream);
+
+	/**
+	 * Drop the deltas not broadcast yet and stop flushing, may be called from any thread including from the callbacks.
+	 * Nothing is broadcast once this returns. The ticker is removed right away on the game thread, on the next tick otherwise.
+	 */
+	void Cancel();
+
+	bool IsCanceled() const { return bCanceled; }
+	bool IsTicking() const { return TickerHandle.IsValid(); }
+
+	void PushTokens(const FString& Delta);
+	void PushComplete(bool bSuccess);
+
+	/**
+	 * Broadcast the deltas received since the previous flush as one delta, then the completion. Game thread only.
+	 * @return Whether the stream is still running.
+	 */
+	bool Flush();
+
+	int32 GetNumBroadcasts() const { return NumBroadcasts; }
+
+private:
+	FInworldLLMTokenStream::FOnTokens OnTokens;
+	FInworldLLMTokenStream::FOnComplete OnComplete;
+
+	FCriticalSection Lock;
+	FString PendingTokens;
+	TOptional<bool> PendingComplete;
+	bool bCompleted = false;
+	std::atomic<bool> bCanceled { false };
+
+	/** Held while broadcasting, so Cancel on another thread waits for a broadcast in progress. */
+	FCriticalSection BroadcastLock;
+
+	int32 NumBroadcasts = 0;
+#if ENGINE_MAJOR_VERSION == 4
+	FDelegateHandle TickerHandle;
+#else
+	FTSTicker::FDelegateHandle TickerHandle;
+#endif
+};
@@ -48,4 +48,52 @@ public:
 	 */
 	UPROPERTY(config, EditAnywhere, Category = "Inworld")
 	FString ServiceProvider;
+
+	/**
+	 * The maximum number of completion requests in flight, further requests are queued.
+	 */
+	UPROPERTY(config, EditAnywhere, Category = "Scheduling", meta = (ClampMin = "1"))
+	int32 MaxInFlightRequests = 4;
+
+	/**
+	 * The maximum number of background completion requests in flight, the remaining slots are kept for player facing requests.
+	 */
+	UPROPERTY(config, EditAnywhere, Category = "Scheduling", meta = (ClampMin = "0"))
+	int32 MaxBackgroundInFlightRequests = 2;
+
+	/**
+	 * Serve identical completion requests from a cache instead of sending them again.
+	 */
+	UPROPERTY(config, EditAnywhere, Category = "Caching")
+	bool bEnableCompletionCache = false;
+
+	/**
+	 * Keep cached completions on disk so they survive restarts.
+	 */
+	UPROPERTY(config, EditAnywhere, Category = "Caching", meta = (EditCondition = "bEnableCompletionCache"))
+	bool bPersistCompletionCache = true;
+
+	/**
+	 * Seconds a cached completion stays valid, 0 to never expire.
+	 */
+	UPROPERTY(config, EditAnywhere, Category = "Caching", meta = (EditCondition = "bEnableCompletionCache", ClampMin = "0"))
+	float CompletionCacheTimeToLive = 86400.f;
+
+	/**
+	 * Memory limit of the cached completions, least recently used ones are released first.
+	 */
+	UPROPERTY(config, EditAnywhere, Category = "Caching", meta = (EditCondition = "bEnableCompletionCache", ClampMin = "0"))
+	int32 CompletionCacheMaxMemoryMB = 16;
+
+	/**
+	 * Disk limit of the cached completions, oldest ones are deleted first.
+	 */
+	UPROPERTY(config, EditAnywhere, Category = "Caching", meta = (EditCondition = "bEnableCompletionCache && bPersistCompletionCache", ClampMin = "0"))
+	int32 CompletionCacheMaxDiskMB = 64;
+
+	/**
+	 * Requests with a higher temperature aren't deterministic and always go to the service.
+	 */
+	UPROPERTY(config, EditAnywhere, Category = "Caching", meta = (EditCondition = "bEnableCompletionCache", ClampMin = "0"))
+	float MaxCacheableTemperature = 0.f;
 };
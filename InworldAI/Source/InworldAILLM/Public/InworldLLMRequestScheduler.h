@@ -0,0 +1,183 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "Tickable.h"
+
+#include "InworldLLMRequestScheduler.generated.h"
+
+UENUM(BlueprintType)
+enum class EInworldLLMRequestPriority : uint8
+{
+	/** Requests the player waits on, always started first. */
+	PlayerFacing,
+	/** Requests nobody waits on, e.g. ambient barks, limited to a share of the in flight requests. */
+	Background,
+};
+
+USTRUCT(BlueprintType)
+struct INWORLDAILLM_API FInworldLLMSchedulerMetrics
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "LLMService")
+	int32 NumQueuedPlayerFacing = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LLMService")
+	int32 NumQueuedBackground = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LLMService")
+	int32 NumInFlight = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LLMService")
+	int32 NumStarted = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LLMService")
+	int32 NumFinished = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LLMService")
+	int32 NumCanceled = 0;
+
+	/** Requests dropped or aborted because their deadline passed. */
+	UPROPERTY(BlueprintReadOnly, Category = "LLMService")
+	int32 NumExpired = 0;
+
+	/** Average seconds spent queued by started requests. */
+	UPROPERTY(BlueprintReadOnly, Category = "LLMService")
+	float AverageQueueTime = 0.f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LLMService")
+	float MaxQueueTime = 0.f;
+};
+
+/**
+ * Callbacks of a scheduled request.
+ */
+struct FInworldLLMScheduledRequest
+{
+	/**
+	 * Send the request. The scheduler must be told with Finish once it completes.
+	 * Gets the request id, Start may run before Schedule returns and finish the request right away.
+	 */
+	TFunction<void(uint64 /*Id*/)> Start;
+	/** Abort the request after Start, it is already removed from the scheduler. */
+	TFunction<void()> Abort;
+	/** The request is dropped before Start, canceled or past its deadline. */
+	TFunction<void()> Drop;
+};
+
+/**
+ * Limits the number of LLM requests in flight, player facing requests are started before background ones.
+ * Background requests never take more than MaxBackgroundInFlight slots so player facing requests aren't starved.
+ * Game thread only.
+ */
+class INWORLDAILLM_API FInworldLLMRequestScheduler
+{
+public:
+	using FClock = TFunction<double()>;
+
+	explicit FInworldLLMRequestScheduler(FClock InClock = FClock());
+
+	/**
+	 * Queue a request, it may be started right away.
+	 * @param Priority The priority class.
+	 * @param Timeout Seconds the request may take including queuing, 0 for no deadline.
+	 * @param Request The request callbacks.
+	 * @return The request id, never 0.
+	 */
+	uint64 Schedule(EInworldLLMRequestPriority Priority, float Timeout, FInworldLLMScheduledRequest&& Request);
+
+	/**
+	 * Release the slot of a completed request and start the next one. Unknown ids are ignored.
+	 */
+	void Finish(uint64 Id);
+
+	/**
+	 * Drop a queued request or abort an in flight one.
+	 * @return Whether the request was still queued or in flight.
+	 */
+	bool Cancel(uint64 Id);
+
+	/**
+	 * Drop queued requests and abort in flight ones past their deadline.
+	 */
+	void Update();
+
+	void SetLimits(int32 InMaxInFlight, int32 InMaxBackgroundInFlight);
+
+	bool HasDeadlines() const { return NumDeadlines > 0; }
+	const FInworldLLMSchedulerMetrics& GetMetrics() const { return Metrics; }
+
+private:
+	struct FEntry
+	{
+		uint64 Id = 0;
+		EInworldLLMRequestPriority Priority = EInworldLLMRequestPriority::PlayerFacing;
+		double Deadline = 0.0;
+		double QueueTime = 0.0;
+		FInworldLLMScheduledRequest Request;
+	};
+
+	void StartNext();
+	bool CanStart(EInworldLLMRequestPriority Priority) const;
+	void RemoveInFlight(int32 Index, FEntry& OutEntry);
+	void UpdateQueueMetrics();
+	TArray<FEntry>& GetQueue(EInworldLLMRequestPriority Priority);
+
+	FClock Clock;
+
+	TArray<FEntry> PlayerFacingQueue;
+	TArray<FEntry> BackgroundQueue;
+	TArray<FEntry> InFlight;
+	int32 NumBackgroundInFlight = 0;
+	int32 NumDeadlines = 0;
+
+	int32 MaxInFlight = 4;
+	int32 MaxBackgroundInFlight = 2;
+
+	uint64 NextId = 1;
+	bool bStarting = false;
+	double TotalQueueTime = 0.0;
+
+	FInworldLLMSchedulerMetrics Metrics;
+};
+
+/**
+ * Owns the scheduler shared by all LLM completion actions, limits come from UInworldAILLMSettings.
+ */
+UCLASS()
+class INWORLDAILLM_API UInworldLLMSchedulerSubsystem : public UEngineSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	static UInworldLLMSchedulerSubsystem* Get();
+
+	FInworldLLMRequestScheduler& GetScheduler() { return Scheduler; }
+
+	/**
+	 * Get the request queue metrics.
+	 */
+	UFUNCTION(BlueprintPure, Category = "LLMService")
+	FInworldLLMSchedulerMetrics GetMetrics() const { return Scheduler.GetMetrics(); }
+
+	/** Subsystem interface */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/** Tickable interface */
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return Scheduler.HasDeadlines(); }
+	virtual bool IsTickableInEditor() const override { return true; }
+	virtual ETickableTickType GetTickableTickType() const override { return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Conditional; }
+	virtual TStatId GetStatId() const override;
+
+private:
+	FInworldLLMRequestScheduler Scheduler;
+};
@@ -27,6 +27,8 @@ public class InworldAITest : ModuleRules
 				"CoreUObject",
 				"Engine",
 				"Projects",
+				"InworldAIIntegration",
+				"InworldAILLM",
             }
 			);
 
@@ -0,0 +1,127 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#include "Tests/Interaction/MultiConversation/InworldTestCoalesceConversationUpdates.h"
+#include "Commands/InworldTestCommandsGarbageCollection.h"
+#include "Commands/InworldTestCommandsCustom.h"
+#include "Commands/InworldTestCommandsInteraction.h"
+#include "Commands/InworldTestCommandsSession.h"
+#include "Commands/InworldTestCommandsWait.h"
+#include "InworldTestChecks.h"
+
+UInworldTestObjectCoalesceConversationUpdates::UInworldTestObjectCoalesceConversationUpdates()
+	: UInworldTestObjectSession()
+{
+	// every conversation update sent to the client broadcasts a conversation change
+	Player->OnConversationChanged().AddLambda([this]() { NumConversationUpdates++; });
+}
+
+bool Inworld::Test::FCoalesceConversationUpdates::RunTest(const FString& Parameters)
+{
+	TScopedGCObject<UInworldTestObjectCoalesceConversationUpdates> TestObject;
+	{
+		FScopedSessionScene SessionScenePinned(TestObject->Session, TestObject->Scene, TestObject->Workspace, TestObject->RuntimeAuth);
+
+		UInworldTestObjectCoalesceConversationUpdates* Object = &TestObject.Get();
+		auto CheckNumConversationUpdates = [Object](int32 Expected)
+			{
+				TestCustom([Object, Expected]()
+					{
+						CheckTrue(*FString::Printf(TEXT("Conversation updates %d == %d"), Object->NumConversationUpdates, Expected), Object->NumConversationUpdates == Expected);
+						return true;
+					});
+			};
+
+		// all targets added within a frame are sent as one update
+		TestCustom([Object]()
+			{
+				for (UInworldCharacter* const Character : Object->Characters)
+				{
+					Object->Player->AddTargetCharacter(Character);
+				}
+				return true;
+			});
+		Wait(0.1f);
+		CheckNumConversationUpdates(1);
+
+		// changes cancelling each other out are not sent
+		TestCustom([Object]()
+			{
+				UInworldCharacter* const Character = Object->Characters[0];
+				Object->Player->RemoveTargetCharacter(Character);
+				Object->Player->AddTargetCharacter(Character);
+				return true;
+			});
+		Wait(0.1f);
+		CheckNumConversationUpdates(1);
+
+		// explicit commit sends the update right away
+		TestCustom([Object]()
+			{
+				Object->Player->ClearAllTargetCharacters();
+				Object->Player->CommitConversationUpdate();
+				CheckTrue(TEXT("Conversation update sent on commit"), Object->NumConversationUpdates == 2);
+				return true;
+			});
+		Wait(0.1f);
+		CheckNumConversationUpdates(2);
+	}
+
+	return true;
+}
+
+bool Inworld::Test::FSendInSameFrameAsTargetChange::RunTest(const FString& Parameters)
+{
+	TScopedGCObject<UInworldTestObjectSession> TestObject;
+	{
+		FScopedSessionScene SessionScenePinned(TestObject->Session, TestObject->Scene, TestObject->Workspace, TestObject->RuntimeAuth);
+
+		UInworldTestObjectSession* Object = &TestObject.Get();
+		auto CheckRepliesFrom = [Object](int32 CharacterIdx)
+			{
+				TestCustom([Object, CharacterIdx]()
+					{
+						const FString& AgentId = Object->Characters[CharacterIdx]->GetAgentInfo().AgentId;
+						const FString& OtherAgentId = Object->Characters[1 - CharacterIdx]->GetAgentInfo().AgentId;
+						int32 NumFromTarget = 0;
+						int32 NumFromOther = 0;
+						for (const FInworldTextEvent& TextEvent : Object->TextEvents)
+						{
+							NumFromTarget += TextEvent.Routing.Source.Name == AgentId;
+							NumFromOther += TextEvent.Routing.Source.Name == OtherAgentId;
+						}
+						CheckTrue(TEXT("Reply from the target"), NumFromTarget > 0);
+						CheckTrue(TEXT("No reply from the previous target"), NumFromOther == 0);
+						Object->TextEvents.Empty();
+						return true;
+					});
+			};
+
+		// no conversation yet, the message must not be dropped
+		TestCustom([Object]()
+			{
+				Object->Player->AddTargetCharacter(Object->Characters[0]);
+				Object->Player->SendTextMessageToConversation(TEXT("Hello!"));
+				return true;
+			});
+		WaitUntilInteractionEndWithTimeout(Object->ControlEvents, 1);
+		CheckRepliesFrom(0);
+
+		// existing conversation, the message must go to the new participants
+		TestCustom([Object]()
+			{
+				Object->Player->RemoveTargetCharacter(Object->Characters[0]);
+				Object->Player->AddTargetCharacter(Object->Characters[1]);
+				Object->Player->SendTextMessageToConversation(TEXT("Hello!"));
+				return true;
+			});
+		WaitUntilInteractionEndWithTimeout(Object->ControlEvents, 2);
+		CheckRepliesFrom(1);
+	}
+
+	return true;
+}
@@ -0,0 +1,132 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#include "Tests/LLM/InworldTestLLMCompletionCache.h"
+#include "Completion/InworldLLMCompletionCache.h"
+
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+namespace Inworld
+{
+	namespace Test
+	{
+		static const FString CacheUrl = TEXT("https://api.inworld.ai/llm/v1alpha/completions:completeChat");
+		static const FString CacheBody = TEXT("{\"messages\":[{\"role\":1,\"content\":\"Say hi\"}],\"text_generation_config\":{\"temperature\":0}}");
+		static const TArray<FString> CacheLines = {
+			TEXT("{\"result\":{\"choices\":[{\"message\":{\"content\":\"Hi\"}}]}}"),
+			TEXT("{\"result\":{\"choices\":[{\"message\":{\"content\":\" there\"}}]}}"),
+		};
+
+		static FString GetCacheTestDirectory()
+		{
+			return FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("InworldLLMCache"));
+		}
+	}
+}
+
+bool Inworld::Test::FLLMCompletionCacheLookup::RunTest(const FString& Parameters)
+{
+	const FString Directory = GetCacheTestDirectory();
+	IFileManager::Get().DeleteDirectory(*Directory, false, true);
+
+	const FString Key = FInworldLLMCompletionCache::MakeKey(CacheUrl, CacheBody);
+	TestEqual(TEXT("Stable key"), Key, FInworldLLMCompletionCache::MakeKey(CacheUrl, CacheBody));
+	TestNotEqual(TEXT("Key depends on the body"), Key, FInworldLLMCompletionCache::MakeKey(CacheUrl, CacheBody.Replace(TEXT("hi"), TEXT("bye"))));
+	TestNotEqual(TEXT("Key depends on the url"), Key, FInworldLLMCompletionCache::MakeKey(CacheUrl.Replace(TEXT("Chat"), TEXT("Text")), CacheBody));
+
+	FDateTime Now = FDateTime(2024, 1, 1);
+	TArray<FString> Lines;
+	{
+		FInworldLLMCompletionCache Cache(Directory, [&Now]() { return Now; });
+		Cache.SetLimits(60.0, 1024 * 1024, 1024 * 1024);
+
+		TestFalse(TEXT("Miss before store"), Cache.Find(Key, Lines));
+		Cache.Store(Key, CacheLines);
+		TestTrue(TEXT("Memory hit"), Cache.Find(Key, Lines) && Lines == CacheLines);
+		TestEqual(TEXT("Memory hits"), Cache.GetStats().NumMemoryHits, 1);
+		TestEqual(TEXT("Misses"), Cache.GetStats().NumMisses, 1);
+	}
+
+	// a new cache, e.g. after a restart, reads the response back from disk
+	{
+		FInworldLLMCompletionCache Cache(Directory, [&Now]() { return Now; });
+		Cache.SetLimits(60.0, 1024 * 1024, 1024 * 1024);
+
+		Now += FTimespan::FromSeconds(30.0);
+		TestTrue(TEXT("Disk hit"), Cache.Find(Key, Lines) && Lines == CacheLines);
+		TestTrue(TEXT("Memory hit after disk hit"), Cache.Find(Key, Lines) && Lines == CacheLines);
+		TestEqual(TEXT("Disk hits"), Cache.GetStats().NumDiskHits, 1);
+
+		Now += FTimespan::FromSeconds(31.0);
+		TestFalse(TEXT("Expired"), Cache.Find(Key, Lines));
+	}
+
+	{
+		FInworldLLMCompletionCache Cache(Directory, [&Now]() { return Now; });
+		TestFalse(TEXT("Expired response deleted from disk"), Cache.Find(Key, Lines));
+	}
+
+	IFileManager::Get().DeleteDirectory(*Directory, false, true);
+	return true;
+}
+
+bool Inworld::Test::FLLMCompletionCacheLimits::RunTest(const FString& Parameters)
+{
+	const FString Directory = GetCacheTestDirectory();
+	IFileManager::Get().DeleteDirectory(*Directory, false, true);
+
+	TArray<FString> Lines;
+	TArray<FString> Keys;
+	for (int32 i = 0; i < 3; ++i)
+	{
+		Keys.Add(FInworldLLMCompletionCache::MakeKey(CacheUrl, CacheBody + FString::FromInt(i)));
+	}
+
+	// memory only, room for two responses
+	FInworldLLMCompletionCache Cache;
+	const int64 ResponseSize = (Keys[0].Len() + CacheLines[0].Len() + CacheLines[1].Len()) * sizeof(TCHAR);
+	Cache.SetLimits(0.0, ResponseSize * 2, 0);
+
+	Cache.Store(Keys[0], CacheLines);
+	Cache.Store(Keys[1], CacheLines);
+	TestTrue(TEXT("First response used"), Cache.Find(Keys[0], Lines));
+	Cache.Store(Keys[2], CacheLines);
+
+	TestTrue(TEXT("Recently used response kept"), Cache.Find(Keys[0], Lines));
+	TestFalse(TEXT("Least recently used response evicted"), Cache.Find(Keys[1], Lines));
+	TestTrue(TEXT("Latest response kept"), Cache.Find(Keys[2], Lines));
+	TestEqual(TEXT("Evicted"), Cache.GetStats().NumEvicted, 1);
+	TestEqual(TEXT("Memory size"), Cache.GetStats().MemoryBytes, ResponseSize * 2);
+
+	// the disk limit keeps only the latest file
+	FInworldLLMCompletionCache DiskCache(Directory);
+	DiskCache.SetLimits(0.0, 0, 1);
+	DiskCache.Store(Keys[0], CacheLines);
+	DiskCache.Store(Keys[1], CacheLines);
+
+	TArray<FString> Files;
+	IFileManager::Get().FindFiles(Files, *Directory, TEXT("json"));
+	TestEqual(TEXT("Files over the disk limit deleted"), Files.Num(), 1);
+	const int64 FileSize = Files.Num() == 1 ? IFileManager::Get().FileSize(*FPaths::Combine(Directory, Files[0])) : 0;
+	TestEqual(TEXT("Disk size tracked"), DiskCache.GetStats().DiskBytes, FileSize);
+
+	// files of a previous run are tracked from the start
+	{
+		FInworldLLMCompletionCache RestartedCache(Directory);
+		RestartedCache.SetLimits(0.0, 0, 1);
+		TestEqual(TEXT("Disk size after restart"), RestartedCache.GetStats().DiskBytes, FileSize);
+		RestartedCache.Store(Keys[2], CacheLines);
+		TestFalse(TEXT("Previous run's file evicted"), RestartedCache.Find(Keys[1], Lines));
+	}
+
+	DiskCache.Clear();
+	TestFalse(TEXT("Cleared"), DiskCache.Find(Keys[1], Lines));
+
+	IFileManager::Get().DeleteDirectory(*Directory, false, true);
+	return true;
+}
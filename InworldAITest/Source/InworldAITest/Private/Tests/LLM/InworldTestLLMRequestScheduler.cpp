@@ -0,0 +1,189 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#include "Tests/LLM/InworldTestLLMRequestScheduler.h"
+#include "InworldLLMRequestScheduler.h"
+
+namespace Inworld
+{
+	namespace Test
+	{
+		/**
+		 * Stands in for the completion server: accepts the requests the scheduler starts
+		 * and answers them when the test decides to.
+		 */
+		struct FLLMSchedulerStandIn
+		{
+			FLLMSchedulerStandIn()
+				: Scheduler([this]() { return Time; })
+			{
+				Scheduler.SetLimits(2, 1);
+			}
+
+			uint64 Send(const FString& Name, EInworldLLMRequestPriority Priority, float Timeout = 0.f)
+			{
+				FInworldLLMScheduledRequest Request;
+				Request.Start = [this, Name](uint64) { Received.Add(Name); InFlight.Add(Name); };
+				Request.Abort = [this, Name]() { Aborted.Add(Name); InFlight.Remove(Name); };
+				Request.Drop = [this, Name]() { Dropped.Add(Name); };
+				const uint64 Id = Scheduler.Schedule(Priority, Timeout, MoveTemp(Request));
+				Ids.Add(Name, Id);
+				return Id;
+			}
+
+			void Respond(const FString& Name)
+			{
+				InFlight.Remove(Name);
+				Scheduler.Finish(Ids[Name]);
+			}
+
+			FInworldLLMRequestScheduler Scheduler;
+			double Time = 0.0;
+
+			TMap<FString, uint64> Ids;
+			TArray<FString> Received;
+			TArray<FString> InFlight;
+			TArray<FString> Aborted;
+			TArray<FString> Dropped;
+		};
+	}
+}
+
+bool Inworld::Test::FLLMRequestSchedulerPriority::RunTest(const FString& Parameters)
+{
+	FLLMSchedulerStandIn StandIn;
+
+	// background requests only take one of the two slots
+	StandIn.Send(TEXT("Bark1"), EInworldLLMRequestPriority::Background);
+	StandIn.Send(TEXT("Bark2"), EInworldLLMRequestPriority::Background);
+	StandIn.Send(TEXT("Bark3"), EInworldLLMRequestPriority::Background);
+	TestEqual(TEXT("One background in flight"), StandIn.InFlight.Num(), 1);
+
+	// a player request gets the free slot right away
+	StandIn.Send(TEXT("Player1"), EInworldLLMRequestPriority::PlayerFacing);
+	TestTrue(TEXT("Player request started"), StandIn.InFlight.Contains(TEXT("Player1")));
+
+	// queued player requests go before queued background ones
+	StandIn.Send(TEXT("Player2"), EInworldLLMRequestPriority::PlayerFacing);
+	TestEqual(TEXT("Max in flight"), StandIn.InFlight.Num(), 2);
+	StandIn.Respond(TEXT("Bark1"));
+	TestTrue(TEXT("Player request before background"), StandIn.InFlight.Contains(TEXT("Player2")));
+	TestFalse(TEXT("Background still queued"), StandIn.InFlight.Contains(TEXT("Bark2")));
+
+	StandIn.Respond(TEXT("Player1"));
+	StandIn.Respond(TEXT("Player2"));
+	StandIn.Respond(TEXT("Bark2"));
+	StandIn.Respond(TEXT("Bark3"));
+
+	const TArray<FString> ExpectedOrder = { TEXT("Bark1"), TEXT("Player1"), TEXT("Player2"), TEXT("Bark2"), TEXT("Bark3") };
+	TestTrue(TEXT("Start order"), StandIn.Received == ExpectedOrder);
+
+	const FInworldLLMSchedulerMetrics& Metrics = StandIn.Scheduler.GetMetrics();
+	TestEqual(TEXT("Started"), Metrics.NumStarted, 5);
+	TestEqual(TEXT("Finished"), Metrics.NumFinished, 5);
+	TestEqual(TEXT("Nothing in flight"), Metrics.NumInFlight, 0);
+	TestEqual(TEXT("Nothing queued"), Metrics.NumQueuedPlayerFacing + Metrics.NumQueuedBackground, 0);
+
+	// a request answered synchronously doesn't stall the queue
+	FInworldLLMScheduledRequest Immediate;
+	Immediate.Start = [&StandIn](uint64 Id) { StandIn.Received.Add(TEXT("Immediate")); StandIn.Scheduler.Finish(Id); };
+	StandIn.Send(TEXT("Blocker1"), EInworldLLMRequestPriority::PlayerFacing);
+	StandIn.Send(TEXT("Blocker2"), EInworldLLMRequestPriority::PlayerFacing);
+	StandIn.Scheduler.Schedule(EInworldLLMRequestPriority::PlayerFacing, 0.f, MoveTemp(Immediate));
+	StandIn.Send(TEXT("After"), EInworldLLMRequestPriority::PlayerFacing);
+	StandIn.Respond(TEXT("Blocker1"));
+	TestTrue(TEXT("Queue continues after synchronous finish"), StandIn.InFlight.Contains(TEXT("After")));
+
+	return true;
+}
+
+bool Inworld::Test::FLLMRequestSchedulerCancel::RunTest(const FString& Parameters)
+{
+	FLLMSchedulerStandIn StandIn;
+
+	StandIn.Send(TEXT("Player1"), EInworldLLMRequestPriority::PlayerFacing);
+	StandIn.Send(TEXT("Player2"), EInworldLLMRequestPriority::PlayerFacing);
+	StandIn.Send(TEXT("Player3"), EInworldLLMRequestPriority::PlayerFacing);
+	StandIn.Send(TEXT("Bark1"), EInworldLLMRequestPriority::Background);
+
+	// queued requests are dropped without being sent
+	TestTrue(TEXT("Cancel queued"), StandIn.Scheduler.Cancel(StandIn.Ids[TEXT("Player3")]));
+	TestTrue(TEXT("Queued dropped"), StandIn.Dropped.Contains(TEXT("Player3")));
+	TestFalse(TEXT("Queued never sent"), StandIn.Received.Contains(TEXT("Player3")));
+
+	// in flight requests are aborted and free their slot
+	TestTrue(TEXT("Cancel in flight"), StandIn.Scheduler.Cancel(StandIn.Ids[TEXT("Player1")]));
+	TestTrue(TEXT("In flight aborted"), StandIn.Aborted.Contains(TEXT("Player1")));
+	TestTrue(TEXT("Slot reused"), StandIn.InFlight.Contains(TEXT("Bark1")));
+
+	// late answers and repeated cancels are ignored
+	StandIn.Scheduler.Finish(StandIn.Ids[TEXT("Player1")]);
+	TestFalse(TEXT("Cancel twice"), StandIn.Scheduler.Cancel(StandIn.Ids[TEXT("Player1")]));
+	TestEqual(TEXT("Canceled"), StandIn.Scheduler.GetMetrics().NumCanceled, 2);
+	TestEqual(TEXT("In flight after cancel"), StandIn.Scheduler.GetMetrics().NumInFlight, 2);
+
+	return true;
+}
+
+bool Inworld::Test::FLLMRequestSchedulerDeadline::RunTest(const FString& Parameters)
+{
+	FLLMSchedulerStandIn StandIn;
+
+	StandIn.Send(TEXT("Player1"), EInworldLLMRequestPriority::PlayerFacing, 5.f);
+	StandIn.Send(TEXT("Player2"), EInworldLLMRequestPriority::PlayerFacing);
+	StandIn.Send(TEXT("Player3"), EInworldLLMRequestPriority::PlayerFacing, 2.f);
+	StandIn.Send(TEXT("Player4"), EInworldLLMRequestPriority::PlayerFacing);
+	TestTrue(TEXT("Deadlines tracked"), StandIn.Scheduler.HasDeadlines());
+
+	StandIn.Time = 1.0;
+	StandIn.Scheduler.Update();
+	TestEqual(TEXT("Nothing expired yet"), StandIn.Scheduler.GetMetrics().NumExpired, 0);
+
+	// the queued request expires before being sent
+	StandIn.Time = 3.0;
+	StandIn.Scheduler.Update();
+	TestTrue(TEXT("Queued request dropped"), StandIn.Dropped.Contains(TEXT("Player3")));
+	TestFalse(TEXT("Expired request never sent"), StandIn.Received.Contains(TEXT("Player3")));
+
+	// the in flight request is aborted, the next one takes its slot
+	StandIn.Time = 6.0;
+	StandIn.Scheduler.Update();
+	TestTrue(TEXT("In flight request aborted"), StandIn.Aborted.Contains(TEXT("Player1")));
+	TestTrue(TEXT("Next request started"), StandIn.InFlight.Contains(TEXT("Player4")));
+	TestEqual(TEXT("Expired"), StandIn.Scheduler.GetMetrics().NumExpired, 2);
+	TestFalse(TEXT("No deadlines left"), StandIn.Scheduler.HasDeadlines());
+
+	// Player4 waited from 0 to 6
+	TestEqual(TEXT("Max queue time"), StandIn.Scheduler.GetMetrics().MaxQueueTime, 6.f);
+
+	return true;
+}
+
+bool Inworld::Test::FLLMRequestSchedulerSynchronousFinish::RunTest(const FString& Parameters)
+{
+	FLLMSchedulerStandIn StandIn;
+
+	// requests failing before they are sent finish inside Schedule, before their id is returned
+	int32 NumFailed = 0;
+	for (int32 i = 0; i < 5; ++i)
+	{
+		FInworldLLMScheduledRequest Failing;
+		Failing.Start = [&StandIn, &NumFailed](uint64 Id) { NumFailed++; StandIn.Scheduler.Finish(Id); };
+		StandIn.Scheduler.Schedule(EInworldLLMRequestPriority::PlayerFacing, 0.f, MoveTemp(Failing));
+	}
+	TestEqual(TEXT("Failed right away"), NumFailed, 5);
+	TestEqual(TEXT("Slots released"), StandIn.Scheduler.GetMetrics().NumInFlight, 0);
+	TestEqual(TEXT("Finished"), StandIn.Scheduler.GetMetrics().NumFinished, 5);
+
+	// more failures than slots never stall later requests
+	StandIn.Send(TEXT("Player1"), EInworldLLMRequestPriority::PlayerFacing);
+	StandIn.Send(TEXT("Bark1"), EInworldLLMRequestPriority::Background);
+	TestTrue(TEXT("Player request started"), StandIn.InFlight.Contains(TEXT("Player1")));
+	TestTrue(TEXT("Background request started"), StandIn.InFlight.Contains(TEXT("Bark1")));
+
+	return true;
+}
@@ -0,0 +1,171 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#include "Tests/LLM/InworldTestLLMStreamParser.h"
+#include "Completion/InworldLLMStreamParser.h"
+#include "InworldAITestModule.h"
+
+#include "Math/RandomStream.h"
+
+namespace Inworld
+{
+	namespace Test
+	{
+		/**
+		 * Stands in for the completion server: serves a canned response body,
+		 * growing the received content by one chunk per progress callback like the HTTP response does.
+		 */
+		struct FLLMStreamStandIn
+		{
+			FLLMStreamStandIn(const FString& Body)
+			{
+				const FTCHARToUTF8 Converted(*Body);
+				Bytes.Append(reinterpret_cast<const uint8*>(Converted.Get()), Converted.Length());
+			}
+
+			/** Deliver the body split at the given byte offsets, returning the lines handed out by the parser. */
+			TArray<FString> Serve(const TArray<int32>& Boundaries)
+			{
+				TArray<FString> Lines;
+				FInworldLLMStreamParser Parser;
+				TArray<uint8> Content;
+				int32 Offset = 0;
+				for (int32 Boundary : Boundaries)
+				{
+					Boundary = FMath::Clamp(Boundary, Offset, Bytes.Num());
+					Content.Append(Bytes.GetData() + Offset, Boundary - Offset);
+					Offset = Boundary;
+					Parser.FeedContent(Content, [&Lines](const FString& Line) { Lines.Add(Line); });
+				}
+				Content.Append(Bytes.GetData() + Offset, Bytes.Num() - Offset);
+				Parser.FeedContent(Content, [&Lines](const FString& Line) { Lines.Add(Line); });
+				Parser.Finish([&Lines](const FString& Line) { Lines.Add(Line); });
+
+				bDone = Parser.IsDone();
+				NumConsumedBytes = Parser.GetNumConsumedBytes();
+				return Lines;
+			}
+
+			/** Every single byte boundary, so every UTF-8 sequence and line ending gets split. */
+			TArray<int32> EveryByte() const
+			{
+				TArray<int32> Boundaries;
+				for (int32 i = 1; i < Bytes.Num(); ++i)
+				{
+					Boundaries.Add(i);
+				}
+				return Boundaries;
+			}
+
+			TArray<uint8> Bytes;
+			uint64 NumConsumedBytes = 0;
+			bool bDone = false;
+		};
+
+		static bool AreLinesIdentical(const TArray<FString>& A, const TArray<FString>& B)
+		{
+			if (A.Num() != B.Num())
+			{
+				return false;
+			}
+			for (int32 i = 0; i < A.Num(); ++i)
+			{
+				if (!A[i].Equals(B[i], ESearchCase::CaseSensitive))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		static const TArray<FString> ExpectedLines = {
+			TEXT("{\"result\":{\"choices\":[{\"message\":{\"content\":\"Hello\"}}]}}"),
+			TEXT("{\"result\":{\"choices\":[{\"message\":{\"content\":\" \u041f\u0440\u0438\u0432\u0435\u0442, \u4e16\u754c\"}}]}}"),
+			TEXT("{\"result\":{\"choices\":[{\"message\":{\"content\":\" \U0001F44B\"}}]}}"),
+		};
+	}
+}
+
+bool Inworld::Test::FLLMStreamParserNDJSON::RunTest(const FString& Parameters)
+{
+	const FString Body = FString::Join(ExpectedLines, TEXT("\n")) + TEXT("\n");
+	FLLMStreamStandIn StandIn(Body);
+
+	TestTrue(TEXT("Single chunk"), AreLinesIdentical(StandIn.Serve({}), ExpectedLines));
+	TestEqual(TEXT("All bytes consumed"), StandIn.NumConsumedBytes, static_cast<uint64>(StandIn.Bytes.Num()));
+	TestTrue(TEXT("Split at every byte"), AreLinesIdentical(StandIn.Serve(StandIn.EveryByte()), ExpectedLines));
+
+	// split in the middle of the 4 byte emoji sequence
+	const int32 EmojiOffset = StandIn.Bytes.Find(static_cast<uint8>(0xF0));
+	TestTrue(TEXT("Split mid UTF-8"), EmojiOffset != INDEX_NONE && AreLinesIdentical(StandIn.Serve({ EmojiOffset + 1, EmojiOffset + 3 }), ExpectedLines));
+
+	// the last line may come without a newline
+	FLLMStreamStandIn Unterminated(FString::Join(ExpectedLines, TEXT("\n")));
+	TestTrue(TEXT("Unterminated last line"), AreLinesIdentical(Unterminated.Serve(Unterminated.EveryByte()), ExpectedLines));
+
+	// empty lines are skipped
+	FLLMStreamStandIn EmptyLines(TEXT("\n\n") + FString::Join(ExpectedLines, TEXT("\n\n")) + TEXT("\n\n"));
+	TestTrue(TEXT("Empty lines skipped"), AreLinesIdentical(EmptyLines.Serve(EmptyLines.EveryByte()), ExpectedLines));
+
+	return true;
+}
+
+bool Inworld::Test::FLLMStreamParserSSE::RunTest(const FString& Parameters)
+{
+	FString Body = TEXT(": keep-alive\r\n\r\n");
+	for (const FString& Line : ExpectedLines)
+	{
+		Body += TEXT("event: completion\r\nid: 1\r\ndata: ") + Line + TEXT("\r\n\r\n");
+	}
+	Body += TEXT("retry: 1000\r\ndata: [DONE]\r\n\r\n");
+	FLLMStreamStandIn StandIn(Body);
+
+	TestTrue(TEXT("SSE single chunk"), AreLinesIdentical(StandIn.Serve({}), ExpectedLines));
+	TestTrue(TEXT("SSE done"), StandIn.bDone);
+	TestTrue(TEXT("SSE split at every byte"), AreLinesIdentical(StandIn.Serve(StandIn.EveryByte()), ExpectedLines));
+	TestTrue(TEXT("SSE done when split"), StandIn.bDone);
+
+	// data without the optional space
+	FLLMStreamStandIn Compact(TEXT("data:") + ExpectedLines[0] + TEXT("\n"));
+	TestTrue(TEXT("SSE data without space"), AreLinesIdentical(Compact.Serve(Compact.EveryByte()), { ExpectedLines[0] }));
+	TestFalse(TEXT("SSE not done"), Compact.bDone);
+
+	return true;
+}
+
+bool Inworld::Test::FLLMStreamParserRandomChunks::RunTest(const FString& Parameters)
+{
+	FRandomStream Random(0x11D);
+
+	TArray<FString> Lines;
+	for (int32 i = 0; i < 200; ++i)
+	{
+		Lines.Add(ExpectedLines[Random.RandRange(0, ExpectedLines.Num() - 1)]);
+	}
+	FLLMStreamStandIn StandIn(FString::Join(Lines, TEXT("\r\n")) + TEXT("\r\n"));
+
+	for (int32 Iteration = 0; Iteration < 50; ++Iteration)
+	{
+		TArray<int32> Boundaries;
+		for (int32 Offset = Random.RandRange(0, 64); Offset < StandIn.Bytes.Num(); Offset += Random.RandRange(0, 64))
+		{
+			Boundaries.Add(Offset);
+		}
+		if (!TestTrue(TEXT("Random chunks"), AreLinesIdentical(StandIn.Serve(Boundaries), Lines)))
+		{
+			return false;
+		}
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	StandIn.Serve(StandIn.EveryByte());
+	const FString Result = FString::Printf(TEXT("Parsed %d bytes fed one byte at a time in %.3f ms"), StandIn.Bytes.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	UE_LOG(LogInworldAITest, Log, TEXT("%s"), *Result);
+	AddInfo(Result);
+
+	return true;
+}
@@ -0,0 +1,329 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#include "Tests/LLM/InworldTestLLMTokenStream.h"
+#include "Completion/InworldLLMTokenStream.h"
+#include "InworldLLMRequestScheduler.h"
+
+#include "Async/Async.h"
+#include "HAL/Event.h"
+
+namespace Inworld
+{
+	namespace Test
+	{
+		/**
+		 * Stands in for the completion server: sends a chunked completeChat response from a worker thread,
+		 * growing the received content by one chunk at a time like the HTTP response does.
+		 */
+		struct FLLMTokenStreamStandIn
+		{
+			FLLMTokenStreamStandIn(int32 NumTokens)
+			{
+				FString Body;
+				for (int32 i = 0; i < NumTokens; ++i)
+				{
+					const FString Token = FString::Printf(TEXT(" token%d"), i);
+					Body += FString::Printf(TEXT("{\"result\":{\"choices\":[{\"message\":{\"content\":\"%s\"}}]}}\n"), *Token);
+					ExpectedText += Token;
+				}
+				const FTCHARToUTF8 Converted(*Body);
+				Bytes.Append(reinterpret_cast<const uint8*>(Converted.Get()), Converted.Length());
+			}
+
+			/**
+			 * Serve the response in chunks on a worker thread.
+			 * @param AfterChunk Called on the worker thread after each chunk.
+			 */
+			TFuture<void> Serve(TSharedRef<FInworldLLMTokenStream, ESPMode::ThreadSafe> Stream, int32 ChunkSize, TFunction<void(int32)> AfterChunk = nullptr)
+			{
+				return Async(EAsyncExecution::Thread, [this, Stream, ChunkSize, AfterChunk]()
+				{
+					TArray<uint8> Content;
+					for (int32 Offset = 0, Chunk = 0; Offset < Bytes.Num(); Offset += ChunkSize, ++Chunk)
+					{
+						Content.Append(Bytes.GetData() + Offset, FMath::Min(ChunkSize, Bytes.Num() - Offset));
+						Stream->ReceiveContent(Content);
+						if (AfterChunk)
+						{
+							AfterChunk(Chunk);
+						}
+					}
+					Stream->ReceiveComplete(true);
+				});
+			}
+
+			TArray<uint8> Bytes;
+			FString ExpectedText;
+		};
+
+		/** Records what a stream hands out, guarded as callbacks come from the worker thread. */
+		struct FLLMTokenStreamRecord
+		{
+			void Bind(FInworldLLMTokenStream& Stream)
+			{
+				Stream.OnTokens.BindLambda([this](const FString& Delta)
+				{
+					FScopeLock ScopeLock(&Lock);
+					Text += Delta;
+					NumDeltas++;
+					bAllOffGameThread &= !IsInGameThread();
+				});
+				Stream.OnComplete.BindLambda([this](bool bSuccess)
+				{
+					FScopeLock ScopeLock(&Lock);
+					NumCompletes++;
+					bSucceeded = bSuccess;
+				});
+				Stream.OnFinished.BindLambda([this]()
+				{
+					FScopeLock ScopeLock(&Lock);
+					NumFinished++;
+				});
+			}
+
+			FCriticalSection Lock;
+			FString Text;
+			int32 NumDeltas = 0;
+			int32 NumCompletes = 0;
+			int32 NumFinished = 0;
+			bool bSucceeded = false;
+			bool bAllOffGameThread = true;
+		};
+	}
+}
+
+bool Inworld::Test::FLLMTokenStreamWorker::RunTest(const FString& Parameters)
+{
+	FLLMTokenStreamStandIn StandIn(100);
+	FLLMTokenStreamRecord Record;
+	TSharedRef<FInworldLLMTokenStream, ESPMode::ThreadSafe> Stream = MakeShared<FInworldLLMTokenStream, ESPMode::ThreadSafe>();
+	Record.Bind(*Stream);
+
+	StandIn.Serve(Stream, 7).Wait();
+
+	TestTrue(TEXT("Tokens delivered on the worker thread"), Record.bAllOffGameThread);
+	TestEqual(TEXT("One delta per token"), Record.NumDeltas, 100);
+	TestTrue(TEXT("Streamed text"), Record.Text.Equals(StandIn.ExpectedText, ESearchCase::CaseSensitive));
+	TestEqual(TEXT("Completed once"), Record.NumCompletes, 1);
+	TestTrue(TEXT("Succeeded"), Record.bSucceeded);
+	TestEqual(TEXT("Finished once"), Record.NumFinished, 1);
+
+	// a completion after the end is ignored
+	Stream->ReceiveComplete(false);
+	TestEqual(TEXT("Completed once after end"), Record.NumCompletes, 1);
+
+	return true;
+}
+
+bool Inworld::Test::FLLMTokenStreamCoalesce::RunTest(const FString& Parameters)
+{
+	FLLMTokenStreamStandIn StandIn(50);
+
+	TArray<FString> Broadcasts;
+	TOptional<bool> Completed;
+	TSharedRef<FInworldLLMTokenMarshal, ESPMode::ThreadSafe> Marshal = MakeShared<FInworldLLMTokenMarshal, ESPMode::ThreadSafe>(
+		FInworldLLMTokenStream::FOnTokens::CreateLambda([this, &Broadcasts](const FString& Delta) { TestTrue(TEXT("Broadcast on the game thread"), IsInGameThread()); Broadcasts.Add(Delta); }),
+		FInworldLLMTokenStream::FOnComplete::CreateLambda([&Completed](bool bSuccess) { Completed = bSuccess; }));
+
+	TSharedRef<FInworldLLMTokenStream, ESPMode::ThreadSafe> Stream = MakeShared<FInworldLLMTokenStream, ESPMode::ThreadSafe>();
+	Marshal->Bind(*Stream);
+
+	// half of the response arrives within the first frame, the rest within the second
+	FEvent* HalfServed = FPlatformProcess::GetSynchEventFromPool();
+	FEvent* ContinueServing = FPlatformProcess::GetSynchEventFromPool();
+	const int32 ChunkSize = 16;
+	const int32 HalfChunk = StandIn.Bytes.Num() / ChunkSize / 2;
+	TFuture<void> Served = StandIn.Serve(Stream, ChunkSize, [HalfChunk, HalfServed, ContinueServing](int32 Chunk)
+	{
+		if (Chunk == HalfChunk)
+		{
+			HalfServed->Trigger();
+			ContinueServing->Wait();
+		}
+	});
+
+	HalfServed->Wait();
+	TestTrue(TEXT("Still running after first frame"), Marshal->Flush());
+	TestEqual(TEXT("One broadcast in the first frame"), Broadcasts.Num(), 1);
+	TestTrue(TEXT("Nothing to broadcast"), Marshal->Flush());
+	TestEqual(TEXT("No broadcast without tokens"), Broadcasts.Num(), 1);
+
+	ContinueServing->Trigger();
+	Served.Wait();
+	TestFalse(TEXT("Done after second frame"), Marshal->Flush());
+	TestEqual(TEXT("One broadcast in the second frame"), Broadcasts.Num(), 2);
+	TestTrue(TEXT("Completed"), Completed.IsSet() && Completed.GetValue());
+	TestTrue(TEXT("Coalesced text"), FString::Join(Broadcasts, TEXT("")).Equals(StandIn.ExpectedText, ESearchCase::CaseSensitive));
+	TestFalse(TEXT("Flush after completion"), Marshal->Flush());
+	TestEqual(TEXT("Broadcasts"), Marshal->GetNumBroadcasts(), 2);
+
+	FPlatformProcess::ReturnSynchEventToPool(HalfServed);
+	FPlatformProcess::ReturnSynchEventToPool(ContinueServing);
+	return true;
+}
+
+bool Inworld::Test::FLLMTokenStreamCancel::RunTest(const FString& Parameters)
+{
+	FLLMTokenStreamStandIn StandIn(100);
+	FLLMTokenStreamRecord Record;
+	TSharedRef<FInworldLLMTokenStream, ESPMode::ThreadSafe> Stream = MakeShared<FInworldLLMTokenStream, ESPMode::ThreadSafe>();
+	Record.Bind(*Stream);
+
+	// cancel from the game thread while the worker is mid stream
+	FEvent* Paused = FPlatformProcess::GetSynchEventFromPool();
+	FEvent* Resume = FPlatformProcess::GetSynchEventFromPool();
+	TFuture<void> Served = StandIn.Serve(Stream, 16, [Paused, Resume](int32 Chunk)
+	{
+		if (Chunk == 10)
+		{
+			Paused->Trigger();
+			Resume->Wait();
+		}
+	});
+
+	Paused->Wait();
+	Stream->Cancel();
+	const int32 NumDeltasAtCancel = Record.NumDeltas;
+	Resume->Trigger();
+	Served.Wait();
+
+	TestTrue(TEXT("Tokens before cancel"), NumDeltasAtCancel > 0);
+	TestEqual(TEXT("No tokens after cancel"), Record.NumDeltas, NumDeltasAtCancel);
+	TestEqual(TEXT("No completion after cancel"), Record.NumCompletes, 0);
+	TestEqual(TEXT("Finished once"), Record.NumFinished, 1);
+	TestTrue(TEXT("Canceled"), Stream->IsCanceled());
+
+	// cancel from a callback stops the rest of the chunk
+	FLLMTokenStreamRecord SelfCancelRecord;
+	TSharedRef<FInworldLLMTokenStream, ESPMode::ThreadSafe> SelfCanceled = MakeShared<FInworldLLMTokenStream, ESPMode::ThreadSafe>();
+	SelfCancelRecord.Bind(*SelfCanceled);
+	TWeakPtr<FInworldLLMTokenStream, ESPMode::ThreadSafe> WeakSelfCanceled = SelfCanceled;
+	SelfCanceled->OnTokens.BindLambda([&SelfCancelRecord, WeakSelfCanceled](const FString& Delta)
+	{
+		SelfCancelRecord.NumDeltas++;
+		WeakSelfCanceled.Pin()->Cancel();
+	});
+	StandIn.Serve(SelfCanceled, StandIn.Bytes.Num()).Wait();
+	TestEqual(TEXT("One token before self cancel"), SelfCancelRecord.NumDeltas, 1);
+	TestEqual(TEXT("Self cancel finished once"), SelfCancelRecord.NumFinished, 1);
+
+	FPlatformProcess::ReturnSynchEventToPool(Paused);
+	FPlatformProcess::ReturnSynchEventToPool(Resume);
+	return true;
+}
+
+bool Inworld::Test::FLLMTokenMarshalCancel::RunTest(const FString& Parameters)
+{
+	FLLMTokenStreamStandIn StandIn(50);
+
+	int32 NumBroadcasts = 0;
+	int32 NumCompletes = 0;
+	TSharedRef<FInworldLLMTokenMarshal, ESPMode::ThreadSafe> Marshal = FInworldLLMTokenMarshal::Create(
+		FInworldLLMTokenStream::FOnTokens::CreateLambda([&NumBroadcasts](const FString& Delta) { NumBroadcasts++; }),
+		FInworldLLMTokenStream::FOnComplete::CreateLambda([&NumCompletes](bool bSuccess) { NumCompletes++; }));
+
+	TSharedRef<FInworldLLMTokenStream, ESPMode::ThreadSafe> Stream = MakeShared<FInworldLLMTokenStream, ESPMode::ThreadSafe>();
+	Marshal->Bind(*Stream);
+	TestTrue(TEXT("Ticking"), Marshal->IsTicking());
+
+	// tokens are queued for the next frame when the stream is canceled
+	FEvent* HalfServed = FPlatformProcess::GetSynchEventFromPool();
+	FEvent* ContinueServing = FPlatformProcess::GetSynchEventFromPool();
+	const int32 ChunkSize = 16;
+	const int32 HalfChunk = StandIn.Bytes.Num() / ChunkSize / 2;
+	TFuture<void> Served = StandIn.Serve(Stream, ChunkSize, [HalfChunk, HalfServed, ContinueServing](int32 Chunk)
+	{
+		if (Chunk == HalfChunk)
+		{
+			HalfServed->Trigger();
+			ContinueServing->Wait();
+		}
+	});
+
+	HalfServed->Wait();
+	Stream->Cancel();
+	TestTrue(TEXT("Marshal canceled with the stream"), Marshal->IsCanceled());
+	TestFalse(TEXT("Ticker removed"), Marshal->IsTicking());
+
+	ContinueServing->Trigger();
+	Served.Wait();
+	TestFalse(TEXT("Done after cancel"), Marshal->Flush());
+	TestEqual(TEXT("Queued tokens dropped"), NumBroadcasts, 0);
+	TestEqual(TEXT("No completion after cancel"), NumCompletes, 0);
+
+	// a cancel from the token callback stops the completion of the same frame
+	TSharedPtr<FInworldLLMTokenMarshal, ESPMode::ThreadSafe> SelfCanceled;
+	int32 NumSelfCancelBroadcasts = 0;
+	bool bSelfCancelCompleted = false;
+	SelfCanceled = MakeShared<FInworldLLMTokenMarshal, ESPMode::ThreadSafe>(
+		FInworldLLMTokenStream::FOnTokens::CreateLambda([&NumSelfCancelBroadcasts, &SelfCanceled](const FString& Delta) { NumSelfCancelBroadcasts++; SelfCanceled->Cancel(); }),
+		FInworldLLMTokenStream::FOnComplete::CreateLambda([&bSelfCancelCompleted](bool bSuccess) { bSelfCancelCompleted = true; }));
+	SelfCanceled->PushTokens(TEXT("token"));
+	SelfCanceled->PushComplete(true);
+	TestFalse(TEXT("Self cancel done"), SelfCanceled->Flush());
+	TestEqual(TEXT("Tokens before self cancel"), NumSelfCancelBroadcasts, 1);
+	TestFalse(TEXT("No completion after self cancel"), bSelfCancelCompleted);
+	SelfCanceled.Reset();
+
+	FPlatformProcess::ReturnSynchEventToPool(HalfServed);
+	FPlatformProcess::ReturnSynchEventToPool(ContinueServing);
+	return true;
+}
+
+bool Inworld::Test::FLLMTokenStreamSchedulerDeadline::RunTest(const FString& Parameters)
+{
+	FLLMTokenStreamStandIn StandIn(20);
+	const TArray<uint8> HalfResponse(StandIn.Bytes.GetData(), StandIn.Bytes.Num() / 2);
+
+	double Time = 0.0;
+	FInworldLLMRequestScheduler Scheduler([&Time]() { return Time; });
+	Scheduler.SetLimits(1, 1);
+
+	// sent, half the response arrives before the deadline
+	FLLMTokenStreamRecord SentRecord;
+	TSharedRef<FInworldLLMTokenStream, ESPMode::ThreadSafe> Sent = MakeShared<FInworldLLMTokenStream, ESPMode::ThreadSafe>();
+	SentRecord.Bind(*Sent);
+	Scheduler.Schedule(EInworldLLMRequestPriority::PlayerFacing, 5.f, Sent->MakeScheduledRequest([Sent, &HalfResponse](uint64) { Sent->ReceiveContent(HalfResponse); }));
+	const int32 NumDeltasBeforeDeadline = SentRecord.NumDeltas;
+	TestTrue(TEXT("Tokens before deadline"), NumDeltasBeforeDeadline > 0);
+
+	// queued behind it, received on the game thread
+	int32 NumQueuedCompletes = 0;
+	bool bQueuedSucceeded = true;
+	TSharedRef<FInworldLLMTokenMarshal, ESPMode::ThreadSafe> Marshal = FInworldLLMTokenMarshal::Create(
+		FInworldLLMTokenStream::FOnTokens(),
+		FInworldLLMTokenStream::FOnComplete::CreateLambda([&NumQueuedCompletes, &bQueuedSucceeded](bool bSuccess) { NumQueuedCompletes++; bQueuedSucceeded = bSuccess; }));
+	TSharedRef<FInworldLLMTokenStream, ESPMode::ThreadSafe> Queued = MakeShared<FInworldLLMTokenStream, ESPMode::ThreadSafe>();
+	Marshal->Bind(*Queued);
+	bool bQueuedStarted = false;
+	Scheduler.Schedule(EInworldLLMRequestPriority::PlayerFacing, 2.f, Queued->MakeScheduledRequest([&bQueuedStarted](uint64) { bQueuedStarted = true; }));
+
+	// the queued stream expires before being sent and completes with failure
+	Time = 3.0;
+	Scheduler.Update();
+	TestFalse(TEXT("Expired stream never sent"), bQueuedStarted);
+	TestFalse(TEXT("Marshal done"), Marshal->Flush());
+	TestEqual(TEXT("Queued completed once"), NumQueuedCompletes, 1);
+	TestFalse(TEXT("Queued failed"), bQueuedSucceeded);
+
+	// the sent stream is aborted and completes with failure
+	Time = 6.0;
+	Scheduler.Update();
+	TestEqual(TEXT("Expired"), Scheduler.GetMetrics().NumExpired, 2);
+	TestEqual(TEXT("Aborted stream completed once"), SentRecord.NumCompletes, 1);
+	TestFalse(TEXT("Aborted stream failed"), SentRecord.bSucceeded);
+	TestEqual(TEXT("Aborted stream finished once"), SentRecord.NumFinished, 1);
+
+	// the rest of the response is ignored
+	Sent->ReceiveContent(StandIn.Bytes);
+	Sent->ReceiveComplete(true);
+	TestEqual(TEXT("No tokens after abort"), SentRecord.NumDeltas, NumDeltasBeforeDeadline);
+	TestEqual(TEXT("Completed once after abort"), SentRecord.NumCompletes, 1);
+
+	return true;
+}
@@ -0,0 +1,329 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#include "Tests/Packets/InworldTestPacketSerialization.h"
+#include "InworldPackets.h"
+
+#include "Math/RandomStream.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+
+namespace Inworld
+{
+	namespace Test
+	{
+		static constexpr int32 NumPacketsPerType = 64;
+
+		static FString RandomString(FRandomStream& Random, int32 MaxLen = 24)
+		{
+			static const TCHAR Chars[] = TEXT("abcXYZ019 -_/.éß中文Ж");
+			const int32 NumChars = UE_ARRAY_COUNT(Chars) - 1;
+
+			FString Str;
+			const int32 Len = Random.RandRange(0, MaxLen);
+			for (int32 i = 0; i < Len; ++i)
+			{
+				Str.AppendChar(Chars[Random.RandRange(0, NumChars - 1)]);
+			}
+			return Str;
+		}
+
+		// ids are drawn from a small pool so interning has repeats to reference
+		static FString RandomId(FRandomStream& Random)
+		{
+			return FString::Printf(TEXT("id-%d"), Random.RandRange(0, 7));
+		}
+
+		static TArray<uint8> RandomBytes(FRandomStream& Random, int32 MaxNum = 64)
+		{
+			TArray<uint8> Bytes;
+			Bytes.SetNumUninitialized(Random.RandRange(0, MaxNum));
+			for (uint8& Byte : Bytes)
+			{
+				Byte = static_cast<uint8>(Random.RandRange(0, 255));
+			}
+			return Bytes;
+		}
+
+		static int32 RandomInt(FRandomStream& Random)
+		{
+			return Random.RandRange(MIN_int32 / 2, MAX_int32 / 2) * 2 + Random.RandRange(0, 1);
+		}
+
+		template<typename TEnum>
+		static TEnum RandomEnum(FRandomStream& Random, TEnum Max)
+		{
+			return static_cast<TEnum>(Random.RandRange(0, static_cast<int32>(Max)));
+		}
+
+		static TSharedPtr<FInworldPacket> MakeRandomPacket(FRandomStream& Random, EInworldPacketType Type)
+		{
+			TSharedPtr<FInworldPacket> Packet = MakePacket(Type);
+
+			Packet->PacketId = FInworldPacketId(RandomString(Random), RandomId(Random), RandomId(Random));
+			Packet->Routing = FInworldRouting(
+				FInworldActor(RandomEnum(Random, EInworldActorType::WORLD), RandomId(Random)),
+				FInworldActor(RandomEnum(Random, EInworldActorType::WORLD), RandomId(Random)),
+				RandomId(Random));
+
+			switch (Type)
+			{
+			case EInworldPacketType::Text:
+			{
+				FInworldTextEvent& Event = static_cast<FInworldTextEvent&>(*Packet);
+				Event.Text = RandomString(Random, 256);
+				Event.Final = Random.RandRange(0, 1) != 0;
+				break;
+			}
+			case EInworldPacketType::VAD:
+				static_cast<FInworldVADEvent&>(*Packet).VoiceDetected = Random.RandRange(0, 1) != 0;
+				break;
+			case EInworldPacketType::Data:
+				static_cast<FInworldDataEvent&>(*Packet).Chunk = RandomBytes(Random);
+				break;
+			case EInworldPacketType::AudioData:
+			{
+				FInworldAudioDataEvent& Event = static_cast<FInworldAudioDataEvent&>(*Packet);
+				Event.Chunk = RandomBytes(Random, 2048);
+				Event.VisemeInfos.SetNum(Random.RandRange(0, 8));
+				for (FInworldVisemeInfo& VisemeInfo : Event.VisemeInfos)
+				{
+					VisemeInfo.Code = RandomId(Random);
+					VisemeInfo.Timestamp = Random.FRandRange(0.f, 10.f);
+				}
+				Event.bFinal = Random.RandRange(0, 1) != 0;
+				break;
+			}
+			case EInworldPacketType::A2FHeader:
+			{
+				FInworldA2FHeaderEvent& Event = static_cast<FInworldA2FHeaderEvent&>(*Packet);
+				Event.ChannelCount = RandomInt(Random);
+				Event.SamplesPerSecond = RandomInt(Random);
+				Event.BitsPerSample = RandomInt(Random);
+				Event.BlendShapes.SetNum(Random.RandRange(0, 8));
+				for (FName& BlendShape : Event.BlendShapes)
+				{
+					BlendShape = FName(*FString::Printf(TEXT("BlendShape%d"), Random.RandRange(0, 4)));
+				}
+				break;
+			}
+			case EInworldPacketType::A2FContent:
+			{
+				FInworldA2FContentEvent& Event = static_cast<FInworldA2FContentEvent&>(*Packet);
+				Event.AudioInfo.TimeCode = Random.FRand() * 1000.0;
+				Event.AudioInfo.Audio = RandomBytes(Random, 512);
+				Event.BlendShapeWeights.TimeCode = Random.FRand() * 1000.0;
+				Event.BlendShapeWeights.Values.SetNum(Random.RandRange(0, 52));
+				for (float& Value : Event.BlendShapeWeights.Values)
+				{
+					Value = Random.FRand();
+				}
+				break;
+			}
+			case EInworldPacketType::Silence:
+				static_cast<FInworldSilenceEvent&>(*Packet).Duration = Random.FRandRange(0.f, 5.f);
+				break;
+			case EInworldPacketType::Control:
+			case EInworldPacketType::ConversationUpdate:
+			case EInworldPacketType::CurrentSceneStatus:
+			{
+				FInworldControlEvent& Control = static_cast<FInworldControlEvent&>(*Packet);
+				Control.Action = RandomEnum(Random, EInworldControlEventAction::WARNING);
+				Control.Description = RandomString(Random);
+				if (Type == EInworldPacketType::ConversationUpdate)
+				{
+					FInworldConversationUpdateEvent& Event = static_cast<FInworldConversationUpdateEvent&>(*Packet);
+					Event.Agents.SetNum(Random.RandRange(0, 4));
+					for (FString& Agent : Event.Agents)
+					{
+						Agent = RandomId(Random);
+					}
+					Event.EventType = RandomEnum(Random, EInworldConversationUpdateType::EVICTED);
+					Event.bIncludePlayer = Random.RandRange(0, 1) != 0;
+				}
+				else if (Type == EInworldPacketType::CurrentSceneStatus)
+				{
+					FInworldCurrentSceneStatusEvent& Event = static_cast<FInworldCurrentSceneStatusEvent&>(*Packet);
+					Event.SceneName = RandomString(Random);
+					Event.SceneDescription = RandomString(Random, 128);
+					Event.SceneDisplayName = RandomString(Random);
+					Event.AgentInfos.SetNum(Random.RandRange(0, 4));
+					for (FInworldAgentInfo& AgentInfo : Event.AgentInfos)
+					{
+						AgentInfo.BrainName = RandomId(Random);
+						AgentInfo.AgentId = RandomId(Random);
+						AgentInfo.GivenName = RandomString(Random);
+					}
+				}
+				break;
+			}
+			case EInworldPacketType::Emotion:
+			{
+				FInworldEmotionEvent& Event = static_cast<FInworldEmotionEvent&>(*Packet);
+				Event.Behavior = RandomEnum(Random, EInworldCharacterEmotionalBehavior::SURPRISE);
+				Event.Strength = RandomEnum(Random, EInworldCharacterEmotionStrength::STRONG);
+				break;
+			}
+			case EInworldPacketType::Custom:
+			{
+				FInworldCustomEvent& Event = static_cast<FInworldCustomEvent&>(*Packet);
+				Event.Name = RandomString(Random);
+				const int32 NumParams = Random.RandRange(0, 6);
+				for (int32 i = 0; i < NumParams; ++i)
+				{
+					Event.Params.RepMap.Add(RandomId(Random), RandomString(Random));
+				}
+				break;
+			}
+			case EInworldPacketType::Relation:
+			{
+				FInworldRelationEvent& Event = static_cast<FInworldRelationEvent&>(*Packet);
+				Event.Attraction = RandomInt(Random);
+				Event.Familiar = RandomInt(Random);
+				Event.Flirtatious = RandomInt(Random);
+				Event.Respect = RandomInt(Random);
+				Event.Trust = RandomInt(Random);
+				break;
+			}
+			default:
+				break;
+			}
+			return Packet;
+		}
+
+		static TArray<TSharedPtr<FInworldPacket>> MakeRandomPackets(FRandomStream& Random)
+		{
+			TArray<TSharedPtr<FInworldPacket>> Packets;
+			for (int32 i = 0; i < NumPacketsPerType; ++i)
+			{
+				for (int32 Type = 0; Type < static_cast<int32>(EInworldPacketType::Count); ++Type)
+				{
+					Packets.Add(MakeRandomPacket(Random, static_cast<EInworldPacketType>(Type)));
+				}
+			}
+			return Packets;
+		}
+
+		static TArray<uint8> WritePackets(const TArray<TSharedPtr<FInworldPacket>>& Packets, bool bInternNames)
+		{
+			TArray<uint8> Data;
+			FMemoryWriter Ar(Data);
+			FInworldPacketNameTable NameTable;
+			for (const TSharedPtr<FInworldPacket>& Packet : Packets)
+			{
+				WritePacket(Ar, *Packet, bInternNames ? &NameTable : nullptr);
+			}
+			return Data;
+		}
+	}
+}
+
+bool Inworld::Test::FPacketSerializationRoundTrip::RunTest(const FString& Parameters)
+{
+	FRandomStream Random(0x1A2B3C);
+	const TArray<TSharedPtr<FInworldPacket>> Packets = MakeRandomPackets(Random);
+
+	for (const bool bInternNames : { false, true })
+	{
+		const TArray<uint8> Data = WritePackets(Packets, bInternNames);
+
+		TArray<TSharedPtr<FInworldPacket>> ReadPackets;
+		FMemoryReader Ar(Data);
+		FInworldPacketNameTable NameTable;
+		while (Ar.Tell() < Ar.TotalSize())
+		{
+			TSharedPtr<FInworldPacket> Packet = ReadPacket(Ar, &NameTable);
+			if (!TestTrue(TEXT("Packet read"), Packet.IsValid()))
+			{
+				return false;
+			}
+			ReadPackets.Add(Packet);
+		}
+
+		if (!TestEqual(TEXT("Packet count"), ReadPackets.Num(), Packets.Num()))
+		{
+			return false;
+		}
+		for (int32 i = 0; i < Packets.Num(); ++i)
+		{
+			TestEqual(TEXT("Packet type"), ReadPackets[i]->GetPacketType(), Packets[i]->GetPacketType());
+			TestEqual(TEXT("Conversation id"), ReadPackets[i]->Routing.ConversationId, Packets[i]->Routing.ConversationId);
+			TestEqual(TEXT("Debug string"), ReadPackets[i]->ToDebugString(), Packets[i]->ToDebugString());
+		}
+
+		// every field is in the compact format, so equal encodings mean equal packets
+		TestTrue(TEXT("Re-encoded packets match"), WritePackets(ReadPackets, bInternNames) == Data);
+	}
+
+	return true;
+}
+
+bool Inworld::Test::FPacketSerializationMalformed::RunTest(const FString& Parameters)
+{
+	FRandomStream Random(0x4D5E6F);
+
+	for (int32 Iteration = 0; Iteration < NumPacketsPerType; ++Iteration)
+	{
+		for (int32 Type = 0; Type < static_cast<int32>(EInworldPacketType::Count); ++Type)
+		{
+			TSharedPtr<FInworldPacket> Packet = MakeRandomPacket(Random, static_cast<EInworldPacketType>(Type));
+			const TArray<uint8> Data = WritePackets({ Packet }, Random.RandRange(0, 1) != 0);
+
+			// truncated data is rejected
+			{
+				TArray<uint8> Truncated(Data.GetData(), Random.RandRange(0, Data.Num() - 1));
+				FMemoryReader Ar(Truncated);
+				FInworldPacketNameTable NameTable;
+				TestFalse(TEXT("Truncated packet rejected"), ReadPacket(Ar, &NameTable).IsValid());
+			}
+
+			// corrupted data must not read out of bounds, whatever is decoded
+			{
+				TArray<uint8> Corrupted = Data;
+				const int32 NumFlips = Random.RandRange(1, 4);
+				for (int32 i = 0; i < NumFlips; ++i)
+				{
+					Corrupted[Random.RandRange(0, Corrupted.Num() - 1)] ^= static_cast<uint8>(1 << Random.RandRange(0, 7));
+				}
+				FMemoryReader Ar(Corrupted);
+				FInworldPacketNameTable NameTable;
+				ReadPacket(Ar, &NameTable);
+				TestTrue(TEXT("Corrupted packet read in bounds"), Ar.Tell() <= Ar.TotalSize());
+			}
+		}
+	}
+
+	return true;
+}
+
+bool Inworld::Test::FPacketSerializationLegacy::RunTest(const FString& Parameters)
+{
+	FRandomStream Random(0x7A8B9C);
+
+	for (const EInworldPacketType Type : { EInworldPacketType::Data, EInworldPacketType::AudioData, EInworldPacketType::A2FHeader, EInworldPacketType::A2FContent })
+	{
+		for (int32 i = 0; i < NumPacketsPerType; ++i)
+		{
+			TSharedPtr<FInworldPacket> Packet = MakeRandomPacket(Random, Type);
+
+			TArray<uint8> Data;
+			FMemoryWriter Writer(Data);
+			Packet->Serialize(Writer);
+
+			FMemoryReader Reader(Data);
+			TSharedPtr<FInworldPacket> ReadPacketLegacy = ReadPacket(Reader, nullptr, Type);
+			if (!TestTrue(TEXT("Legacy packet read"), ReadPacketLegacy.IsValid()))
+			{
+				return false;
+			}
+			TestEqual(TEXT("Legacy packet fully read"), Reader.Tell(), Reader.TotalSize());
+			TestEqual(TEXT("Legacy debug string"), ReadPacketLegacy->ToDebugString(), Packet->ToDebugString());
+		}
+	}
+
+	return true;
+}
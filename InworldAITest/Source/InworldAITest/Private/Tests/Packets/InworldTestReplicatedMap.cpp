@@ -0,0 +1,346 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#include "Tests/Packets/InworldTestReplicatedMap.h"
+#include "InworldPackets.h"
+#include "InworldReplicatedKeys.h"
+#include "InworldAITestModule.h"
+
+#include "Math/RandomStream.h"
+#include "Serialization/BitWriter.h"
+#include "Serialization/BitReader.h"
+
+namespace Inworld
+{
+	namespace Test
+	{
+		struct FReplicatedMapBits
+		{
+			TArray<uint8> Data;
+			int64 NumBits = 0;
+		};
+
+		static FReplicatedMapBits WriteMap(const TMap<FString, FString>& Map, FInworldReplicatedKeyDictionary* Keys)
+		{
+			FInworldReplicatedMapStruct RepMap;
+			RepMap.RepMap = Map;
+
+			FBitWriter Writer(0, true);
+			RepMap.NetSerializeWithKeys(Writer, Keys);
+			return { *Writer.GetBuffer(), Writer.GetNumBits() };
+		}
+
+		static bool ReadMap(const FReplicatedMapBits& Bits, FInworldReplicatedKeyDictionary* Keys, TMap<FString, FString>& OutMap)
+		{
+			FInworldReplicatedMapStruct RepMap;
+			FBitReader Reader(const_cast<uint8*>(Bits.Data.GetData()), Bits.NumBits);
+			const bool bSuccess = RepMap.NetSerializeWithKeys(Reader, Keys);
+			OutMap = MoveTemp(RepMap.RepMap);
+			return bSuccess && !Reader.IsError();
+		}
+
+		static int64 GetLegacyNumBits(const TMap<FString, FString>& Map)
+		{
+			TArray<FString> ParamKeys;
+			TArray<FString> ParamValues;
+			Map.GenerateKeyArray(ParamKeys);
+			Map.GenerateValueArray(ParamValues);
+
+			FBitWriter Writer(0, true);
+			Writer << ParamKeys;
+			Writer << ParamValues;
+			return Writer.GetNumBits();
+		}
+
+		// FString comparison ignores case, values such as "True" must come back unchanged
+		static bool AreMapsIdentical(const TMap<FString, FString>& A, const TMap<FString, FString>& B)
+		{
+			if (A.Num() != B.Num())
+			{
+				return false;
+			}
+			auto ItA = A.CreateConstIterator();
+			auto ItB = B.CreateConstIterator();
+			for (; ItA && ItB; ++ItA, ++ItB)
+			{
+				if (!ItA->Key.Equals(ItB->Key, ESearchCase::CaseSensitive) || !ItA->Value.Equals(ItB->Value, ESearchCase::CaseSensitive))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		static FString RandomValue(FRandomStream& Random)
+		{
+			static const TCHAR* Strings[] = {
+				TEXT(""), TEXT("true"), TEXT("false"), TEXT("True"), TEXT("007"), TEXT("+3"), TEXT("-0"), TEXT("1e5"),
+				TEXT("9999999999"), TEXT("-2147483648"), TEXT("2147483647"), TEXT("0.1"), TEXT("1."), TEXT(".5"),
+				TEXT("happy"), TEXT("中文"), TEXT("Ärger über Öl"),
+			};
+
+			switch (Random.RandRange(0, 3))
+			{
+			case 0:
+				return FString::FromInt(Random.RandRange(-100000, 100000));
+			case 1:
+				return FString::SanitizeFloat(Random.FRandRange(-1000.f, 1000.f));
+			default:
+				return Strings[Random.RandRange(0, UE_ARRAY_COUNT(Strings) - 1)];
+			}
+		}
+
+		static TMap<FString, FString> RandomMap(FRandomStream& Random)
+		{
+			static const TCHAR* Keys[] = {
+				TEXT("character_name"), TEXT("mood"), TEXT("intensity"), TEXT("ratio"), TEXT("visible"), TEXT("ключ"), TEXT("a"),
+			};
+
+			TMap<FString, FString> Map;
+			const int32 Num = Random.RandRange(0, UE_ARRAY_COUNT(Keys));
+			for (int32 i = 0; i < Num; ++i)
+			{
+				Map.Add(Keys[Random.RandRange(0, UE_ARRAY_COUNT(Keys) - 1)], RandomValue(Random));
+			}
+			// one-off keys keep growing the dictionary
+			if (Random.RandRange(0, 9) == 0)
+			{
+				Map.Add(FString::Printf(TEXT("unique_%d"), Random.RandRange(0, MAX_int32 - 1)), RandomValue(Random));
+			}
+			return Map;
+		}
+
+		static const TMap<FString, FString> TriggerParams = {
+			{ TEXT("character_name"), TEXT("Innequin") },
+			{ TEXT("mood"), TEXT("happy") },
+			{ TEXT("intensity"), TEXT("3") },
+			{ TEXT("ratio"), TEXT("0.75") },
+			{ TEXT("visible"), TEXT("true") },
+		};
+	}
+}
+
+bool Inworld::Test::FReplicatedMapRoundTrip::RunTest(const FString& Parameters)
+{
+	FRandomStream Random(0x5EED);
+	FInworldReplicatedKeyDictionary SenderKeys;
+	FInworldReplicatedKeyDictionary ReceiverKeys;
+
+	for (int32 Iteration = 0; Iteration < 500; ++Iteration)
+	{
+		// two maps written back to back may be received in either order, as if sent from different channels
+		const TMap<FString, FString> MapA = RandomMap(Random);
+		const TMap<FString, FString> MapB = RandomMap(Random);
+		const FReplicatedMapBits BitsA = WriteMap(MapA, &SenderKeys);
+		const FReplicatedMapBits BitsB = WriteMap(MapB, &SenderKeys);
+
+		const bool bSwap = Random.RandRange(0, 1) != 0;
+		TMap<FString, FString> ReadA, ReadB;
+		const bool bReadFirst = bSwap ? ReadMap(BitsB, &ReceiverKeys, ReadB) : ReadMap(BitsA, &ReceiverKeys, ReadA);
+		const bool bReadSecond = bSwap ? ReadMap(BitsA, &ReceiverKeys, ReadA) : ReadMap(BitsB, &ReceiverKeys, ReadB);
+		if (!TestTrue(TEXT("Maps read"), bReadFirst && bReadSecond))
+		{
+			return false;
+		}
+		TestTrue(TEXT("First map identical"), AreMapsIdentical(MapA, ReadA));
+		TestTrue(TEXT("Second map identical"), AreMapsIdentical(MapB, ReadB));
+
+		TArray<int32> Indices;
+		if (Random.RandRange(0, 1) != 0 && ReceiverKeys.ConsumeAcknowledgement(Indices))
+		{
+			SenderKeys.Acknowledge(Indices);
+		}
+	}
+	TestTrue(TEXT("Keys acknowledged"), SenderKeys.GetNumAcknowledged() > 0);
+
+	// without a dictionary keys are sent inline
+	for (int32 Iteration = 0; Iteration < 100; ++Iteration)
+	{
+		const TMap<FString, FString> Map = RandomMap(Random);
+		TMap<FString, FString> ReadResult;
+		TestTrue(TEXT("Map read without dictionary"), ReadMap(WriteMap(Map, nullptr), nullptr, ReadResult));
+		TestTrue(TEXT("Map identical without dictionary"), AreMapsIdentical(Map, ReadResult));
+	}
+
+	return true;
+}
+
+bool Inworld::Test::FReplicatedMapSize::RunTest(const FString& Parameters)
+{
+	FInworldReplicatedKeyDictionary SenderKeys;
+	FInworldReplicatedKeyDictionary ReceiverKeys;
+
+	const int64 LegacyBits = GetLegacyNumBits(TriggerParams);
+
+	const FReplicatedMapBits DefineBits = WriteMap(TriggerParams, &SenderKeys);
+	TMap<FString, FString> ReadResult;
+	TestTrue(TEXT("Map read"), ReadMap(DefineBits, &ReceiverKeys, ReadResult));
+
+	// unacknowledged keys are defined again
+	const FReplicatedMapBits UnacknowledgedBits = WriteMap(TriggerParams, &SenderKeys);
+	TestEqual(TEXT("Unacknowledged size"), UnacknowledgedBits.NumBits, DefineBits.NumBits);
+
+	TArray<int32> Indices;
+	TestTrue(TEXT("Acknowledgement pending"), ReceiverKeys.ConsumeAcknowledgement(Indices));
+	TestEqual(TEXT("Keys acknowledged"), Indices.Num(), TriggerParams.Num());
+	TestTrue(TEXT("Definition again"), ReadMap(UnacknowledgedBits, &ReceiverKeys, ReadResult));
+	TestFalse(TEXT("Acknowledgement consumed"), ReceiverKeys.ConsumeAcknowledgement(Indices));
+	SenderKeys.Acknowledge(Indices);
+
+	const FReplicatedMapBits ReferenceBits = WriteMap(TriggerParams, &SenderKeys);
+	TestTrue(TEXT("Acknowledged map read"), ReadMap(ReferenceBits, &ReceiverKeys, ReadResult));
+	TestTrue(TEXT("Acknowledged map identical"), AreMapsIdentical(TriggerParams, ReadResult));
+
+	TestTrue(TEXT("Defined keys smaller than legacy"), DefineBits.NumBits < LegacyBits);
+	TestTrue(TEXT("Referenced keys smaller than defined"), ReferenceBits.NumBits < DefineBits.NumBits);
+
+	const FString Result = FString::Printf(TEXT("%d params: legacy %lld bytes, defined keys %lld bytes, referenced keys %lld bytes"),
+		TriggerParams.Num(), (LegacyBits + 7) / 8, (DefineBits.NumBits + 7) / 8, (ReferenceBits.NumBits + 7) / 8);
+	UE_LOG(LogInworldAITest, Log, TEXT("%s"), *Result);
+	AddInfo(Result);
+
+	return true;
+}
+
+bool Inworld::Test::FReplicatedMapMalformed::RunTest(const FString& Parameters)
+{
+	// references need the receiver to know the key
+	{
+		FInworldReplicatedKeyDictionary SenderKeys;
+		WriteMap(TriggerParams, &SenderKeys);
+		SenderKeys.Acknowledge({ 0, 1, 2, 3, 4 });
+
+		const FReplicatedMapBits Bits = WriteMap(TriggerParams, &SenderKeys);
+		FInworldReplicatedKeyDictionary ReceiverKeys;
+		TMap<FString, FString> ReadResult;
+		TestFalse(TEXT("Unknown key rejected"), ReadMap(Bits, &ReceiverKeys, ReadResult));
+		TestEqual(TEXT("Rejected map is empty"), ReadResult.Num(), 0);
+		TestFalse(TEXT("Key without dictionary rejected"), ReadMap(Bits, nullptr, ReadResult));
+	}
+
+	// acknowledgements only cover the keys sent
+	{
+		FInworldReplicatedKeyDictionary SenderKeys;
+		SenderKeys.Acknowledge({ 0, 100 });
+		TestEqual(TEXT("Acknowledged before sending"), SenderKeys.GetNumAcknowledged(), 0);
+		WriteMap(TriggerParams, &SenderKeys);
+		SenderKeys.Acknowledge({ -1, 0, 0, 100 });
+		TestEqual(TEXT("Acknowledged past sent"), SenderKeys.GetNumAcknowledged(), 1);
+	}
+
+	// a discarded write leaves a key undelivered, keys defined after it are still acknowledged
+	{
+		FInworldReplicatedKeyDictionary SenderKeys;
+		FInworldReplicatedKeyDictionary ReceiverKeys;
+		const TMap<FString, FString> Discarded = { { TEXT("discarded"), TEXT("1") } };
+		WriteMap(Discarded, &SenderKeys);
+
+		TMap<FString, FString> ReadResult;
+		TestTrue(TEXT("Map after discarded read"), ReadMap(WriteMap(TriggerParams, &SenderKeys), &ReceiverKeys, ReadResult));
+		TArray<int32> Indices;
+		TestTrue(TEXT("Acknowledgement after gap"), ReceiverKeys.ConsumeAcknowledgement(Indices));
+		SenderKeys.Acknowledge(Indices);
+		TestEqual(TEXT("Keys after gap acknowledged"), SenderKeys.GetNumAcknowledged(), TriggerParams.Num());
+
+		const FReplicatedMapBits ReferenceBits = WriteMap(TriggerParams, &SenderKeys);
+		TestTrue(TEXT("Referenced after gap"), ReadMap(ReferenceBits, &ReceiverKeys, ReadResult) && AreMapsIdentical(TriggerParams, ReadResult));
+		TestTrue(TEXT("Discarded key defined again"), ReadMap(WriteMap(Discarded, &SenderKeys), &ReceiverKeys, ReadResult) && AreMapsIdentical(Discarded, ReadResult));
+	}
+
+	// the sender truncates what the reader would reject
+	{
+		TMap<FString, FString> Oversized;
+		for (int32 i = 0; i <= FInworldReplicatedMapStruct::MaxNum; ++i)
+		{
+			Oversized.Add(FString::FromInt(i), FString::FromInt(i));
+		}
+		TMap<FString, FString> ReadResult;
+		TestTrue(TEXT("Oversized map read"), ReadMap(WriteMap(Oversized, nullptr), nullptr, ReadResult));
+		TestEqual(TEXT("Params past the limit dropped"), ReadResult.Num(), FInworldReplicatedMapStruct::MaxNum);
+
+		// a two byte character straddles the key limit
+		const FString LongKey = TEXT("k") + FString::ChrN(FInworldReplicatedKeyDictionary::MaxKeyBytes / 2, TEXT('\u00E4'));
+		const FString LongValue = FString::ChrN(FInworldReplicatedMapStruct::MaxValueBytes + 1, TEXT('v'));
+		FInworldReplicatedKeyDictionary SenderKeys;
+		FInworldReplicatedKeyDictionary ReceiverKeys;
+		TestTrue(TEXT("Long strings read"), ReadMap(WriteMap({ { LongKey, LongValue } }, &SenderKeys), &ReceiverKeys, ReadResult) && ReadResult.Num() == 1);
+		for (const TPair<FString, FString>& Param : ReadResult)
+		{
+			TestTrue(TEXT("Key cut at a character"), Param.Key.Equals(LongKey.LeftChop(1), ESearchCase::CaseSensitive));
+			TestEqual(TEXT("Value truncated"), Param.Value.Len(), FInworldReplicatedMapStruct::MaxValueBytes);
+		}
+	}
+
+	// keys differing only in case are distinct keys of the dictionary
+	{
+		FInworldReplicatedKeyDictionary SenderKeys;
+		FInworldReplicatedKeyDictionary ReceiverKeys;
+		const TMap<FString, FString> Upper = { { TEXT("Mood"), TEXT("happy") } };
+		const TMap<FString, FString> Lower = { { TEXT("mood"), TEXT("sad") } };
+		TMap<FString, FString> ReadUpper, ReadLower;
+		TestTrue(TEXT("Upper case key read"), ReadMap(WriteMap(Upper, &SenderKeys), &ReceiverKeys, ReadUpper));
+		TestTrue(TEXT("Lower case key read"), ReadMap(WriteMap(Lower, &SenderKeys), &ReceiverKeys, ReadLower));
+		TestEqual(TEXT("Both spellings sent"), SenderKeys.GetNumSent(), 2);
+		TestTrue(TEXT("Upper case key identical"), AreMapsIdentical(Upper, ReadUpper));
+		TestTrue(TEXT("Lower case key identical"), AreMapsIdentical(Lower, ReadLower));
+
+		TArray<int32> Indices;
+		ReceiverKeys.ConsumeAcknowledgement(Indices);
+		SenderKeys.Acknowledge(Indices);
+		TestTrue(TEXT("Lower case key referenced"), ReadMap(WriteMap(Lower, &SenderKeys), &ReceiverKeys, ReadLower) && AreMapsIdentical(Lower, ReadLower));
+	}
+
+	// counts, indices, lengths and value kinds past their limits
+	auto ReadHeader = [this](TFunctionRef<void(FBitWriter&)> Write, const TCHAR* What)
+	{
+		FBitWriter Writer(0, true);
+		Write(Writer);
+		FInworldReplicatedKeyDictionary ReceiverKeys;
+		TMap<FString, FString> ReadResult;
+		TestFalse(What, ReadMap({ *Writer.GetBuffer(), Writer.GetNumBits() }, &ReceiverKeys, ReadResult));
+	};
+
+	ReadHeader([](FBitWriter& Writer)
+		{
+			uint32 Num = FInworldReplicatedMapStruct::MaxNum + 1;
+			Writer.SerializeIntPacked(Num);
+		}, TEXT("Count rejected"));
+
+	ReadHeader([](FBitWriter& Writer)
+		{
+			uint32 Num = 1, Tag = (FInworldReplicatedKeyDictionary::MaxKeys << 2) | 1;
+			Writer.SerializeIntPacked(Num);
+			Writer.SerializeIntPacked(Tag);
+		}, TEXT("Key index rejected"));
+
+	ReadHeader([](FBitWriter& Writer)
+		{
+			uint32 Num = 1, Tag = 2, Length = FInworldReplicatedKeyDictionary::MaxKeyBytes + 1;
+			Writer.SerializeIntPacked(Num);
+			Writer.SerializeIntPacked(Tag);
+			Writer.SerializeIntPacked(Length);
+		}, TEXT("Key length rejected"));
+
+	ReadHeader([](FBitWriter& Writer)
+		{
+			uint32 Num = 1, Tag = 3;
+			Writer.SerializeIntPacked(Num);
+			Writer.SerializeIntPacked(Tag);
+		}, TEXT("Key kind rejected"));
+
+	ReadHeader([](FBitWriter& Writer)
+		{
+			uint32 Num = 1, Tag = 2, Length = 0;
+			uint8 Kind = 0xFF;
+			Writer.SerializeIntPacked(Num);
+			Writer.SerializeIntPacked(Tag);
+			Writer.SerializeIntPacked(Length);
+			Writer << Kind;
+		}, TEXT("Value kind rejected"));
+
+	return true;
+}
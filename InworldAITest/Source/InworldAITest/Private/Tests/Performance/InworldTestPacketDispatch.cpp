@@ -0,0 +1,100 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#include "Tests/Performance/InworldTestPacketDispatch.h"
+#include "InworldPacketEventBus.h"
+#include "InworldSession.h"
+#include "InworldAITestModule.h"
+
+namespace Inworld
+{
+	namespace Test
+	{
+		static constexpr int32 NumDispatches = 100000;
+
+		// mirrors the session -> character visitor -> multicast delegate path
+		class FDelegatePacketVisitor : public InworldPacketVisitor
+		{
+		public:
+			virtual void Visit(const FInworldTextEvent& Event) override
+			{
+				OnTextEventDelegateNative.Broadcast(Event);
+			}
+
+			FOnInworldTextEventNative OnTextEventDelegateNative;
+		};
+
+		static TSharedPtr<FInworldPacket> MakeTextPacket(const FString& AgentId)
+		{
+			TSharedPtr<FInworldTextEvent> TextEvent = MakeShared<FInworldTextEvent>();
+			TextEvent->Routing.Source = FInworldActor(EInworldActorType::AGENT, AgentId);
+			TextEvent->Routing.Target = FInworldActor(EInworldActorType::PLAYER, TEXT("Player"));
+			TextEvent->Text = TEXT("Hello");
+			return TextEvent;
+		}
+
+		static double MeasureDelegates(int32 NumListeners, int32& OutNumCalls)
+		{
+			FDelegatePacketVisitor Visitor;
+			for (int32 Index = 0; Index < NumListeners; ++Index)
+			{
+				Visitor.OnTextEventDelegateNative.AddLambda([&OutNumCalls](const FInworldTextEvent& Event) { ++OutNumCalls; });
+			}
+
+			TSharedPtr<FInworldPacket> Packet = MakeTextPacket(TEXT("Agent0"));
+			const double StartTime = FPlatformTime::Seconds();
+			for (int32 Index = 0; Index < NumDispatches; ++Index)
+			{
+				Packet->Accept(Visitor);
+			}
+			return FPlatformTime::Seconds() - StartTime;
+		}
+
+		static double MeasureEventBus(int32 NumListeners, bool bFilterByAgent, int32& OutNumCalls)
+		{
+			FInworldPacketEventBus EventBus;
+			for (int32 Index = 0; Index < NumListeners; ++Index)
+			{
+				const FInworldPacketFilter Filter = bFilterByAgent ? FInworldPacketFilter::ForAgent(FString::Printf(TEXT("Agent%d"), Index)) : FInworldPacketFilter();
+				EventBus.Subscribe<FInworldTextEvent>([&OutNumCalls](const FInworldTextEvent& Event) { ++OutNumCalls; }, Filter);
+			}
+
+			TSharedPtr<FInworldPacket> Packet = MakeTextPacket(TEXT("Agent0"));
+			const double StartTime = FPlatformTime::Seconds();
+			for (int32 Index = 0; Index < NumDispatches; ++Index)
+			{
+				EventBus.Dispatch(*Packet);
+			}
+			return FPlatformTime::Seconds() - StartTime;
+		}
+	}
+}
+
+bool Inworld::Test::FPacketDispatch::RunTest(const FString& Parameters)
+{
+	for (const int32 NumListeners : { 1, 10, 100 })
+	{
+		int32 NumDelegateCalls = 0;
+		const double DelegateTime = MeasureDelegates(NumListeners, NumDelegateCalls);
+		TestEqual(TEXT("Delegate calls"), NumDelegateCalls, NumListeners * NumDispatches);
+
+		int32 NumBusCalls = 0;
+		const double BusTime = MeasureEventBus(NumListeners, false, NumBusCalls);
+		TestEqual(TEXT("Event bus calls"), NumBusCalls, NumListeners * NumDispatches);
+
+		// one listener per agent, only the packet's agent is reached
+		int32 NumFilteredBusCalls = 0;
+		const double FilteredBusTime = MeasureEventBus(NumListeners, true, NumFilteredBusCalls);
+		TestEqual(TEXT("Filtered event bus calls"), NumFilteredBusCalls, NumDispatches);
+
+		const FString Result = FString::Printf(TEXT("%d listeners, %d packets: delegates %.2f ms, event bus %.2f ms, event bus by agent %.2f ms"),
+			NumListeners, NumDispatches, DelegateTime * 1000.0, BusTime * 1000.0, FilteredBusTime * 1000.0);
+		UE_LOG(LogInworldAITest, Log, TEXT("%s"), *Result);
+		AddInfo(Result);
+	}
+	return true;
+}
@@ -0,0 +1,112 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#include "Tests/Playback/InworldTestPlaybackHistory.h"
+#include "InworldCharacterPlaybackHistory.h"
+
+namespace Inworld
+{
+	namespace Test
+	{
+		static const FString InteractionId = TEXT("Interaction");
+
+		/** Rebuilds the history from the change events only, as a chat widget would. */
+		struct FPlaybackHistoryListener
+		{
+			FPlaybackHistoryListener(FInworldCharacterInteractionHistory& InHistory)
+				: History(InHistory)
+			{
+				History.OnAppended().AddLambda([this](int32 Index)
+					{
+						Texts.Insert(History.GetInteraction(Index).Text, Index);
+					});
+				History.OnUpdated().AddLambda([this](int32 Index)
+					{
+						Texts[Index] = History.GetInteraction(Index).Text;
+					});
+				History.OnEvicted().AddLambda([this]()
+					{
+						Texts.RemoveAt(0);
+					});
+				History.OnRemoved().AddLambda([this](int32 Index)
+					{
+						Texts.RemoveAt(Index);
+					});
+				History.OnCleared().AddLambda([this]()
+					{
+						Texts.Reset();
+					});
+			}
+
+			/** Whether the rebuilt history, the full array and the expected texts all agree. */
+			bool Matches(const TArray<FString>& Expected) const
+			{
+				TArray<FString> Interactions;
+				for (const FInworldCharacterInteraction& Interaction : History.GetInteractions())
+				{
+					Interactions.Add(Interaction.Text);
+				}
+				return Texts == Expected && Interactions == Expected && History.Num() == Expected.Num();
+			}
+
+			FInworldCharacterInteractionHistory& History;
+			TArray<FString> Texts;
+		};
+
+		static void AddUtterance(FInworldCharacterInteractionHistory& History, int32 Id, const FString& Text)
+		{
+			History.Add(InteractionId, FString::Printf(TEXT("Utterance%d"), Id), Text, false);
+		}
+	}
+}
+
+bool Inworld::Test::FPlaybackHistoryRing::RunTest(const FString& Parameters)
+{
+	FInworldCharacterInteractionHistory History;
+	History.SetMaxEntries(3);
+	FPlaybackHistoryListener Listener(History);
+
+	// wraps around the ring twice
+	for (int32 Id = 0; Id < 7; ++Id)
+	{
+		AddUtterance(History, Id, FString::FromInt(Id));
+	}
+	TestTrue(TEXT("Wrapped around"), Listener.Matches({ TEXT("4"), TEXT("5"), TEXT("6") }));
+
+	// updates find the interaction by utterance id after evictions moved the head
+	AddUtterance(History, 5, TEXT("5b"));
+	TestTrue(TEXT("Updated after eviction"), Listener.Matches({ TEXT("4"), TEXT("5b"), TEXT("6") }));
+
+	// an evicted utterance is added again instead of updating a stale slot
+	AddUtterance(History, 1, TEXT("1b"));
+	TestTrue(TEXT("Evicted utterance added again"), Listener.Matches({ TEXT("5b"), TEXT("6"), TEXT("1b") }));
+
+	// removal shifts the later interactions and their sequence numbers
+	History.CancelUtterance(InteractionId, TEXT("Utterance6"));
+	TestTrue(TEXT("Removed"), Listener.Matches({ TEXT("5b"), TEXT("1b") }));
+	History.ClearCanceledInteraction(InteractionId);
+	AddUtterance(History, 1, TEXT("1c"));
+	TestTrue(TEXT("Updated after removal"), Listener.Matches({ TEXT("5b"), TEXT("1c") }));
+	AddUtterance(History, 7, TEXT("7"));
+	AddUtterance(History, 8, TEXT("8"));
+	TestTrue(TEXT("Evicted after removal"), Listener.Matches({ TEXT("1c"), TEXT("7"), TEXT("8") }));
+
+	// shrinking evicts the oldest
+	History.SetMaxEntries(2);
+	TestTrue(TEXT("Shrunk"), Listener.Matches({ TEXT("7"), TEXT("8") }));
+	AddUtterance(History, 8, TEXT("8b"));
+	TestTrue(TEXT("Updated after shrinking"), Listener.Matches({ TEXT("7"), TEXT("8b") }));
+
+	// clearing notifies listeners and forgets every utterance id
+	History.Clear();
+	TestTrue(TEXT("Cleared"), Listener.Matches({}));
+	AddUtterance(History, 8, TEXT("8c"));
+	AddUtterance(History, 7, TEXT("7b"));
+	TestTrue(TEXT("Added after clear"), Listener.Matches({ TEXT("8c"), TEXT("7b") }));
+
+	return true;
+}
@@ -0,0 +1,183 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#include "Tests/Playback/InworldTestPlaybackText.h"
+#include "InworldCharacterPlaybackText.h"
+#include "InworldCharacterMessage.h"
+
+#include "UObject/StrongObjectPtr.h"
+
+namespace Inworld
+{
+	namespace Test
+	{
+		static const FString InteractionId = TEXT("Interaction");
+
+		/** Rebuilds each utterance from the deltas only, as a subtitle widget would. */
+		struct FPlaybackTextListener
+		{
+			FPlaybackTextListener()
+				: Playback(NewObject<UInworldCharacterPlaybackText>())
+			{
+				Playback->OnCharacterTextDeltaNative.AddLambda([this](const FString& Id, bool bIsPlayer, int32 Start, const FString& Delta)
+					{
+						FString& Text = Texts.FindOrAdd(Id);
+						Text.LeftInline(Start, false);
+						Text += Delta;
+						++NumDeltas;
+						NumRevealed += Delta.Len();
+					});
+			}
+
+			void Utterance(const FString& UtteranceId, const FString& Text, bool bTextFinal)
+			{
+				FCharacterMessageUtterance Message;
+				Message.InteractionId = InteractionId;
+				Message.UtteranceId = UtteranceId;
+				Message.Text = Text;
+				Message.bTextFinal = bTextFinal;
+				Playback->OnCharacterUtterance(Message);
+			}
+
+			void PlayerTalk(const FString& UtteranceId, const FString& Text, bool bTextFinal)
+			{
+				FCharacterMessagePlayerTalk Message;
+				Message.InteractionId = InteractionId;
+				Message.UtteranceId = UtteranceId;
+				Message.Text = Text;
+				Message.bTextFinal = bTextFinal;
+				Playback->OnCharacterPlayerTalk(Message);
+			}
+
+			void Interrupt(const FString& UtteranceId)
+			{
+				FCharacterMessageUtterance Message;
+				Message.InteractionId = InteractionId;
+				Message.UtteranceId = UtteranceId;
+				Playback->OnCharacterUtteranceInterrupt(Message);
+			}
+
+			void InteractionEnd()
+			{
+				FCharacterMessageInteractionEnd Message;
+				Message.InteractionId = InteractionId;
+				Playback->OnCharacterInteractionEnd(Message);
+			}
+
+			FString GetText(const FString& UtteranceId) const
+			{
+				FString Text;
+				Playback->GetText(UtteranceId, Text);
+				return Text;
+			}
+
+			FString GetDeltaText(const FString& UtteranceId) const
+			{
+				const FString* Text = Texts.Find(UtteranceId);
+				return Text ? *Text : FString();
+			}
+
+			TStrongObjectPtr<UInworldCharacterPlaybackText> Playback;
+			TMap<FString, FString> Texts;
+			int32 NumDeltas = 0;
+			int32 NumRevealed = 0;
+		};
+	}
+}
+
+bool Inworld::Test::FPlaybackTextDelta::RunTest(const FString& Parameters)
+{
+	FPlaybackTextListener Listener;
+
+	Listener.Utterance(TEXT("A"), TEXT("Hello"), false);
+	Listener.Utterance(TEXT("A"), TEXT("Hello there"), false);
+	Listener.Utterance(TEXT("A"), TEXT("Hello there, traveler."), true);
+	TestEqual(TEXT("Appended text"), Listener.GetText(TEXT("A")), FString(TEXT("Hello there, traveler.")));
+	TestEqual(TEXT("Appended deltas"), Listener.GetDeltaText(TEXT("A")), Listener.GetText(TEXT("A")));
+	TestEqual(TEXT("Append delta count"), Listener.NumDeltas, 3);
+	TestEqual(TEXT("Only new characters revealed"), Listener.NumRevealed, Listener.GetText(TEXT("A")).Len());
+
+	// a revision replaces the tail after the common prefix
+	Listener.PlayerTalk(TEXT("B"), TEXT("What is the whether"), false);
+	Listener.PlayerTalk(TEXT("B"), TEXT("What is the weather like"), true);
+	TestEqual(TEXT("Revised text"), Listener.GetText(TEXT("B")), FString(TEXT("What is the weather like")));
+	TestEqual(TEXT("Revised deltas"), Listener.GetDeltaText(TEXT("B")), Listener.GetText(TEXT("B")));
+
+	// repeated text does not emit a delta
+	const int32 NumDeltas = Listener.NumDeltas;
+	Listener.Utterance(TEXT("C"), TEXT("Same"), false);
+	Listener.Utterance(TEXT("C"), TEXT("Same"), false);
+	TestEqual(TEXT("Unchanged text has no delta"), Listener.NumDeltas, NumDeltas + 1);
+
+	Listener.InteractionEnd();
+	FString Text;
+	TestFalse(TEXT("Text released on interaction end"), Listener.Playback->GetText(TEXT("A"), Text));
+
+	return true;
+}
+
+bool Inworld::Test::FPlaybackTextOutOfOrder::RunTest(const FString& Parameters)
+{
+	FPlaybackTextListener Listener;
+
+	// an older partial arriving after a newer one is ignored
+	Listener.Utterance(TEXT("A"), TEXT("One two three"), false);
+	Listener.Utterance(TEXT("A"), TEXT("One two"), false);
+	TestEqual(TEXT("Stale partial ignored"), Listener.GetText(TEXT("A")), FString(TEXT("One two three")));
+
+	// a partial arriving after the final is ignored
+	Listener.Utterance(TEXT("A"), TEXT("One two three four."), true);
+	Listener.Utterance(TEXT("A"), TEXT("One two three four"), false);
+	TestEqual(TEXT("Partial after final ignored"), Listener.GetText(TEXT("A")), FString(TEXT("One two three four.")));
+	TestEqual(TEXT("Deltas match after final"), Listener.GetDeltaText(TEXT("A")), Listener.GetText(TEXT("A")));
+
+	// a shorter final still replaces the text
+	Listener.PlayerTalk(TEXT("B"), TEXT("Hello hello"), false);
+	Listener.PlayerTalk(TEXT("B"), TEXT("Hello"), true);
+	TestEqual(TEXT("Shorter final applied"), Listener.GetText(TEXT("B")), FString(TEXT("Hello")));
+	TestEqual(TEXT("Deltas match shorter final"), Listener.GetDeltaText(TEXT("B")), Listener.GetText(TEXT("B")));
+
+	// utterances are tracked independently
+	Listener.Utterance(TEXT("C"), TEXT("First"), false);
+	Listener.Utterance(TEXT("D"), TEXT("Second"), false);
+	Listener.Utterance(TEXT("C"), TEXT("First line"), true);
+	Listener.Utterance(TEXT("D"), TEXT("Second line"), true);
+	TestEqual(TEXT("Interleaved first"), Listener.GetDeltaText(TEXT("C")), FString(TEXT("First line")));
+	TestEqual(TEXT("Interleaved second"), Listener.GetDeltaText(TEXT("D")), FString(TEXT("Second line")));
+
+	return true;
+}
+
+bool Inworld::Test::FPlaybackTextInterrupt::RunTest(const FString& Parameters)
+{
+	FPlaybackTextListener Listener;
+
+	// chunks after an interrupt are dropped
+	Listener.Utterance(TEXT("A"), TEXT("I was about to"), false);
+	Listener.Interrupt(TEXT("A"));
+	Listener.Utterance(TEXT("A"), TEXT("I was about to say something"), true);
+	TestEqual(TEXT("Text kept at interrupt"), Listener.GetText(TEXT("A")), FString(TEXT("I was about to")));
+	TestEqual(TEXT("Deltas kept at interrupt"), Listener.GetDeltaText(TEXT("A")), Listener.GetText(TEXT("A")));
+
+	// an interrupt received before the first chunk suppresses the utterance
+	const int32 NumDeltas = Listener.NumDeltas;
+	Listener.Interrupt(TEXT("B"));
+	Listener.Utterance(TEXT("B"), TEXT("Never shown"), false);
+	Listener.Utterance(TEXT("B"), TEXT("Never shown."), true);
+	TestEqual(TEXT("Interrupted before start has no deltas"), Listener.NumDeltas, NumDeltas);
+	TestTrue(TEXT("Interrupted before start has no text"), Listener.GetText(TEXT("B")).IsEmpty());
+
+	// other utterances are unaffected
+	Listener.Utterance(TEXT("C"), TEXT("Still here"), true);
+	TestEqual(TEXT("Other utterance"), Listener.GetDeltaText(TEXT("C")), FString(TEXT("Still here")));
+
+	Listener.InteractionEnd();
+	FString Text;
+	TestFalse(TEXT("Interrupted text released on interaction end"), Listener.Playback->GetText(TEXT("B"), Text));
+
+	return true;
+}
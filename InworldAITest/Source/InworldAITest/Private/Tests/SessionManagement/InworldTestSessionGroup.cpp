@@ -0,0 +1,104 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#include "Tests/SessionManagement/InworldTestSessionGroup.h"
+#include "Commands/InworldTestCommandsGarbageCollection.h"
+#include "Commands/InworldTestCommandsCharacter.h"
+#include "Commands/InworldTestCommandsCustom.h"
+#include "Commands/InworldTestCommandsSession.h"
+#include "InworldTestChecks.h"
+#include "InworldAITestSettings.h"
+#include "InworldSession.h"
+
+UInworldTestObjectSessionGroup::UInworldTestObjectSessionGroup()
+	: UInworldTestObject()
+	, SessionGroup(NewObject<UInworldSessionGroup>())
+{
+	const UInworldAITestSettings* InworldAITestSettings = GetDefault<UInworldAITestSettings>();
+	Workspace = InworldAITestSettings->Workspace;
+	Scene = InworldAITestSettings->Scene;
+
+	SessionGroup->RebalanceInterval = 0.f;
+	SessionGroup->Init(2);
+
+	TArray<FString> CharacterNames = InworldAITestSettings->InitialCharacterNames;
+	for (const FString& CharacterName : InworldAITestSettings->CharacterNamesToLoad)
+	{
+		CharacterNames.AddUnique(CharacterName);
+	}
+	for (const FString& CharacterName : CharacterNames)
+	{
+		UInworldCharacter* const Character = Characters.Emplace_GetRef(NewObject<UInworldCharacter>());
+		Character->SetBrainName(CharacterName);
+		SessionGroup->RegisterCharacter(Character);
+	}
+}
+
+bool Inworld::Test::FSessionGroupShardLoads::RunTest(const FString& Parameters)
+{
+	TScopedGCObject<UInworldTestObjectSessionGroup> TestObject;
+	UInworldTestObjectSessionGroup* Object = &TestObject.Get();
+
+	TestCustom([Object]()
+		{
+			Object->SessionGroup->StartSessionsFromScene(Object->Scene, {}, {}, {}, Object->Workspace, Object->RuntimeAuth);
+			return true;
+		});
+	for (UInworldSession* const Shard : Object->SessionGroup->GetShards())
+	{
+		WaitUntilSessionLoadedWithTimeout(Shard, 30.f);
+	}
+	for (UInworldCharacter* const Character : Object->Characters)
+	{
+		WaitUntilCharacterPossessedWithTimeout(Character);
+	}
+
+	// every shard loads its own characters only, no character is loaded twice
+	TestCustom([Object]()
+		{
+			auto ToShortBrainName = [](const FString& BrainName)
+				{
+					FString ShortBrainName;
+					return BrainName.Split(TEXT("/"), nullptr, &ShortBrainName, ESearchCase::CaseSensitive, ESearchDir::FromEnd) ? ShortBrainName : BrainName;
+				};
+
+			TSet<FString> LoadedBrainNames;
+			for (UInworldSession* const Shard : Object->SessionGroup->GetShards())
+			{
+				TSet<FString> RegisteredBrainNames;
+				for (UInworldCharacter* const Character : Shard->GetRegisteredCharacters())
+				{
+					RegisteredBrainNames.Add(ToShortBrainName(Character->GetAgentInfo().BrainName));
+				}
+
+				for (const TPair<FString, FInworldAgentInfo>& LoadedAgent : Shard->GetLoadedAgents())
+				{
+					if (LoadedAgent.Key == TEXT("__DUMMY__"))
+					{
+						continue;
+					}
+					CheckTrue(*FString::Printf(TEXT("%s loaded by its shard only"), *LoadedAgent.Key), RegisteredBrainNames.Contains(LoadedAgent.Key));
+					CheckTrue(*FString::Printf(TEXT("%s loaded once"), *LoadedAgent.Key), !LoadedBrainNames.Contains(LoadedAgent.Key));
+					LoadedBrainNames.Add(LoadedAgent.Key);
+				}
+			}
+			CheckTrue(TEXT("All characters loaded"), LoadedBrainNames.Num() == Object->Characters.Num());
+			return true;
+		});
+
+	TestCustom([Object]()
+		{
+			Object->SessionGroup->StopSessions();
+			return true;
+		});
+	for (UInworldSession* const Shard : Object->SessionGroup->GetShards())
+	{
+		WaitUntilSessionDisconnectingCompleteWithTimeout(Shard);
+		TestEqualConnectionState(Shard, EInworldConnectionState::Idle);
+	}
+	return true;
+}
@@ -0,0 +1,297 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#include "Tests/Studio/InworldTestStudioClient.h"
+#include "InworldStudioClient.h"
+
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+namespace Inworld
+{
+	namespace Test
+	{
+		/**
+		 * Stands in for the Studio server: serves paged resources with ETags,
+		 * holding the requests until the test answers them.
+		 */
+		struct FStudioStandIn
+		{
+			struct FPage
+			{
+				FString Body;
+				FString ETag;
+			};
+
+			FStudioStandIn()
+			{
+				SetPage(TEXT("https://studio.test/studio/v1/workspaces"), TEXT(""), TEXT("{\"workspaces\":[{\"name\":\"ws1\"}],\"nextPageToken\":\"w2\"}"), TEXT("\"w-1\""));
+				for (const FString Workspace : { TEXT("ws1"), TEXT("ws2") })
+				{
+					const FString Path = TEXT("https://studio.test/studio/v1/workspaces/") + Workspace;
+					SetPage(Path + TEXT("/characters"), TEXT(""), TEXT("{\"characters\":[{\"name\":\"c1\"},{\"name\":\"c2\"}],\"nextPageToken\":\"p2\"}"), TEXT("\"c-1\""));
+					SetPage(Path + TEXT("/characters"), TEXT("p2"), TEXT("{\"characters\":[{\"name\":\"c3\"}],\"nextPageToken\":\"\"}"), TEXT("\"c-2\""));
+					SetPage(Path + TEXT("/scenes"), TEXT(""), TEXT("{\"scenes\":[{\"name\":\"s1\",\"displayName\":\"Scene\"}]}"), TEXT("\"s-1\""));
+				}
+			}
+
+			void SetPage(const FString& Path, const FString& PageToken, const FString& Body, const FString& ETag)
+			{
+				Pages.Add(Path + TEXT("|") + PageToken, { Body, ETag });
+			}
+
+			FInworldStudioClient::FTransport MakeTransport()
+			{
+				return [this](const FInworldStudioHttpRequest& Request, FInworldStudioClient::FOnResponse OnResponse)
+				{
+					Received.Add(Request);
+					Pending.Emplace(Request, MoveTemp(OnResponse));
+				};
+			}
+
+			/** Answer the oldest pending request. */
+			bool RespondNext()
+			{
+				if (Pending.Num() == 0)
+				{
+					return false;
+				}
+				TPair<FInworldStudioHttpRequest, FInworldStudioClient::FOnResponse> Next = MoveTemp(Pending[0]);
+				Pending.RemoveAt(0);
+
+				FString Path = Next.Key.Url;
+				FString Query;
+				Next.Key.Url.Split(TEXT("?"), &Path, &Query);
+				FString PageToken;
+				if (Query.Split(TEXT("pageToken="), nullptr, &PageToken))
+				{
+					PageToken.Split(TEXT("&"), &PageToken, nullptr);
+				}
+
+				FInworldStudioHttpResponse Response;
+				Response.bSuccess = true;
+				const FPage* Page = Pages.Find(Path + TEXT("|") + PageToken);
+				const FString* IfNoneMatch = Next.Key.Headers.Find(TEXT("If-None-Match"));
+				if (Page == nullptr)
+				{
+					Response.Code = 404;
+				}
+				else if (IfNoneMatch && *IfNoneMatch == Page->ETag)
+				{
+					Response.Code = 304;
+				}
+				else
+				{
+					Response.Code = 200;
+					Response.Content = Page->Body;
+					Response.ETag = Page->ETag;
+				}
+				Next.Value(Response);
+				return true;
+			}
+
+			int32 RespondAll()
+			{
+				int32 MaxPending = Pending.Num();
+				while (RespondNext())
+				{
+					MaxPending = FMath::Max(MaxPending, Pending.Num());
+				}
+				return MaxPending;
+			}
+
+			TMap<FString, FPage> Pages;
+			TArray<FInworldStudioHttpRequest> Received;
+			TArray<TPair<FInworldStudioHttpRequest, FInworldStudioClient::FOnResponse>> Pending;
+		};
+
+		struct FStudioContents
+		{
+			FInworldStudioClient::FOnWorkspaceContents MakeCallback()
+			{
+				return [this](const FInworldStudioCharacters& InCharacters, const FInworldStudioScenes& InScenes, bool bInSuccess, const FString& InError)
+				{
+					Characters = InCharacters;
+					Scenes = InScenes;
+					bSuccess = bInSuccess;
+					Error = InError;
+					NumCallbacks++;
+				};
+			}
+
+			FString GetCharacterNames() const
+			{
+				FString Names;
+				for (const FInworldStudioCharacter& Character : Characters.characters)
+				{
+					Names += Character.name;
+				}
+				return Names;
+			}
+
+			FInworldStudioCharacters Characters;
+			FInworldStudioScenes Scenes;
+			bool bSuccess = false;
+			FString Error;
+			int32 NumCallbacks = 0;
+		};
+	}
+}
+
+bool Inworld::Test::FStudioClientPagination::RunTest(const FString& Parameters)
+{
+	FStudioStandIn StandIn;
+	TSharedRef<FInworldStudioClient> Client = MakeShared<FInworldStudioClient>(FString(), StandIn.MakeTransport());
+	Client->SetPageSize(2);
+
+	FStudioContents Contents;
+	Client->GetWorkspaceContents(TEXT("studio.test"), TEXT("ws1"), TEXT("key"), Contents.MakeCallback());
+	StandIn.RespondAll();
+
+	TestEqual(TEXT("Called once"), Contents.NumCallbacks, 1);
+	TestTrue(TEXT("Succeeded"), Contents.bSuccess);
+	TestEqual(TEXT("Pages merged"), Contents.GetCharacterNames(), FString(TEXT("c1c2c3")));
+	TestTrue(TEXT("Scenes"), Contents.Scenes.scenes.Num() == 1 && Contents.Scenes.scenes[0].displayName == TEXT("Scene"));
+
+	TestEqual(TEXT("Requests"), StandIn.Received.Num(), 3);
+	TestTrue(TEXT("Page size sent"), StandIn.Received[0].Url.Contains(TEXT("pageSize=2")));
+	TestTrue(TEXT("Page token followed"), StandIn.Received.ContainsByPredicate([](const FInworldStudioHttpRequest& Request) { return Request.Url.Contains(TEXT("pageToken=p2")); }));
+	TestEqual(TEXT("Authorization"), StandIn.Received[0].Headers.FindRef(TEXT("Authorization")), FString(TEXT("Basic key")));
+
+	// a missing resource fails the whole workspace once
+	FStudioContents Missing;
+	Client->GetWorkspaceContents(TEXT("studio.test"), TEXT("unknown"), TEXT("key"), Missing.MakeCallback());
+	StandIn.RespondAll();
+	TestEqual(TEXT("Failure called once"), Missing.NumCallbacks, 1);
+	TestFalse(TEXT("Missing workspace fails"), Missing.bSuccess);
+	TestTrue(TEXT("Failure reports the code"), Missing.Error.Contains(TEXT("code=404")));
+
+	// endpoints without paging get the url as is and a single request
+	StandIn.Received.Reset();
+	bool bWorkspacesSucceeded = false;
+	Client->GetResource(TEXT("https://studio.test/studio/v1/workspaces"), TEXT("key"), true, false, [&bWorkspacesSucceeded](bool bSuccess, const FString& Json, const FString& Error) { bWorkspacesSucceeded = bSuccess; });
+	StandIn.RespondAll();
+	TestTrue(TEXT("Not paginated"), bWorkspacesSucceeded);
+	TestEqual(TEXT("Single request"), StandIn.Received.Num(), 1);
+	TestEqual(TEXT("No paging parameters"), StandIn.Received[0].Url, FString(TEXT("https://studio.test/studio/v1/workspaces")));
+
+	return true;
+}
+
+bool Inworld::Test::FStudioClientParallel::RunTest(const FString& Parameters)
+{
+	FStudioStandIn StandIn;
+	TSharedRef<FInworldStudioClient> Client = MakeShared<FInworldStudioClient>(FString(), StandIn.MakeTransport());
+	Client->SetMaxInFlight(2);
+
+	FStudioContents Contents1;
+	FStudioContents Contents2;
+	Client->GetWorkspaceContents(TEXT("studio.test"), TEXT("ws1"), TEXT("key"), Contents1.MakeCallback());
+	Client->GetWorkspaceContents(TEXT("studio.test"), TEXT("ws2"), TEXT("key"), Contents2.MakeCallback());
+
+	// characters and scenes of the first workspace are in flight together
+	TestEqual(TEXT("Limited in flight"), StandIn.Pending.Num(), 2);
+	TestTrue(TEXT("Characters in flight"), StandIn.Pending[0].Key.Url.Contains(TEXT("ws1/characters")));
+	TestTrue(TEXT("Scenes in flight"), StandIn.Pending[1].Key.Url.Contains(TEXT("ws1/scenes")));
+
+	TestEqual(TEXT("Never over the limit"), StandIn.RespondAll(), 2);
+	TestEqual(TEXT("Max in flight"), Client->GetStats().MaxInFlight, 2);
+	TestTrue(TEXT("First workspace"), Contents1.bSuccess && Contents1.GetCharacterNames() == TEXT("c1c2c3"));
+	TestTrue(TEXT("Second workspace"), Contents2.bSuccess && Contents2.GetCharacterNames() == TEXT("c1c2c3"));
+
+	return true;
+}
+
+bool Inworld::Test::FStudioClientETag::RunTest(const FString& Parameters)
+{
+	const FString Directory = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("InworldStudioCache"));
+	IFileManager::Get().DeleteDirectory(*Directory, false, true);
+
+	FStudioStandIn StandIn;
+	{
+		TSharedRef<FInworldStudioClient> Client = MakeShared<FInworldStudioClient>(Directory, StandIn.MakeTransport());
+		FStudioContents Contents;
+		Client->GetWorkspaceContents(TEXT("studio.test"), TEXT("ws1"), TEXT("key"), Contents.MakeCallback());
+		StandIn.RespondAll();
+		TestTrue(TEXT("First fetch"), Contents.bSuccess);
+		TestFalse(TEXT("Nothing to revalidate"), StandIn.Received[0].Headers.Contains(TEXT("If-None-Match")));
+	}
+
+	// a new client, e.g. the editor panel opened again after a restart, revalidates from disk
+	StandIn.Received.Reset();
+	TSharedRef<FInworldStudioClient> Client = MakeShared<FInworldStudioClient>(Directory, StandIn.MakeTransport());
+	FStudioContents Revalidated;
+	Client->GetWorkspaceContents(TEXT("studio.test"), TEXT("ws1"), TEXT("key"), Revalidated.MakeCallback());
+	StandIn.RespondAll();
+
+	TestTrue(TEXT("Revalidated"), Revalidated.bSuccess && Revalidated.GetCharacterNames() == TEXT("c1c2c3"));
+	TestEqual(TEXT("If-None-Match sent"), StandIn.Received[0].Headers.FindRef(TEXT("If-None-Match")), FString(TEXT("\"c-1\"")));
+	TestEqual(TEXT("All pages not modified"), Client->GetStats().NumNotModified, 3);
+
+	// a changed page is downloaded again
+	StandIn.SetPage(TEXT("https://studio.test/studio/v1/workspaces/ws1/characters"), TEXT("p2"), TEXT("{\"characters\":[{\"name\":\"c4\"}]}"), TEXT("\"c-3\""));
+	FStudioContents Changed;
+	Client->GetWorkspaceContents(TEXT("studio.test"), TEXT("ws1"), TEXT("key"), Changed.MakeCallback());
+	StandIn.RespondAll();
+	TestTrue(TEXT("Changed page"), Changed.bSuccess && Changed.GetCharacterNames() == TEXT("c1c2c4"));
+	TestEqual(TEXT("Unchanged pages not modified"), Client->GetStats().NumNotModified, 5);
+
+	// a different key doesn't share the cache
+	StandIn.Received.Reset();
+	FStudioContents OtherKey;
+	Client->GetWorkspaceContents(TEXT("studio.test"), TEXT("ws1"), TEXT("other"), OtherKey.MakeCallback());
+	StandIn.RespondAll();
+	TestFalse(TEXT("Other key not revalidated"), StandIn.Received[0].Headers.Contains(TEXT("If-None-Match")));
+
+	Client->ClearCache();
+	IFileManager::Get().DeleteDirectory(*Directory, false, true);
+	return true;
+}
+
+bool Inworld::Test::FStudioClientDiskLimit::RunTest(const FString& Parameters)
+{
+	const FString Directory = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("InworldStudioCacheLimit"));
+	IFileManager::Get().DeleteDirectory(*Directory, false, true);
+	auto NumFiles = [&Directory]()
+	{
+		TArray<FString> Files;
+		IFileManager::Get().FindFiles(Files, *FPaths::Combine(Directory, TEXT("*.json")), true, false);
+		return Files.Num();
+	};
+
+	FStudioStandIn StandIn;
+	int64 WorkspaceBytes = 0;
+	{
+		TSharedRef<FInworldStudioClient> Client = MakeShared<FInworldStudioClient>(Directory, StandIn.MakeTransport());
+		FStudioContents Contents;
+		Client->GetWorkspaceContents(TEXT("studio.test"), TEXT("ws1"), TEXT("key"), Contents.MakeCallback());
+		StandIn.RespondAll();
+		WorkspaceBytes = Client->GetStats().DiskBytes;
+		TestTrue(TEXT("Tracked on disk"), WorkspaceBytes > 0);
+		TestEqual(TEXT("One file per page"), NumFiles(), 3);
+
+		// the second workspace has the same sizes, it replaces the first
+		Client->SetMaxDiskBytes(WorkspaceBytes);
+		FStudioContents Second;
+		Client->GetWorkspaceContents(TEXT("studio.test"), TEXT("ws2"), TEXT("key"), Second.MakeCallback());
+		StandIn.RespondAll();
+		TestTrue(TEXT("Second workspace"), Second.bSuccess);
+		TestEqual(TEXT("Within the limit"), Client->GetStats().DiskBytes, WorkspaceBytes);
+		TestEqual(TEXT("Oldest evicted"), Client->GetStats().NumEvicted, 3);
+		TestEqual(TEXT("Files deleted"), NumFiles(), 3);
+	}
+
+	// a new client picks up the files of the previous one
+	TSharedRef<FInworldStudioClient> Client = MakeShared<FInworldStudioClient>(Directory, StandIn.MakeTransport());
+	Client->SetMaxDiskBytes(0);
+	TestEqual(TEXT("Restarted cache evicted"), Client->GetStats().NumEvicted, 3);
+	TestEqual(TEXT("Nothing on disk"), Client->GetStats().DiskBytes, static_cast<int64>(0));
+	TestEqual(TEXT("Restarted files deleted"), NumFiles(), 0);
+
+	Client->ClearCache();
+	return true;
+}
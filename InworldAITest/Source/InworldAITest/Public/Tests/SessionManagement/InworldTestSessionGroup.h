@@ -0,0 +1,44 @@
+/**
+ * Copyright 2022-2024 Theai, Inc. dba Inworld AI
+ *
+ * Use of this source code is governed by the Inworld.ai Software Development Kit License Agreement
+ * that can be found in the LICENSE.md file or at https://www.inworld.ai/sdk-license
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "InworldTestFlags.h"
+#include "InworldCharacter.h"
+#include "InworldSessionGroup.h"
+#include "TestObjects/InworldTestObject.h"
+#include "InworldTestSessionGroup.generated.h"
+
+UCLASS()
+class UInworldTestObjectSessionGroup : public UInworldTestObject
+{
+	GENERATED_BODY()
+public:
+	UInworldTestObjectSessionGroup();
+
+	UPROPERTY()
+	FString Workspace;
+
+	UPROPERTY()
+	FInworldScene Scene;
+
+	UPROPERTY()
+	TObjectPtr<UInworldSessionGroup> SessionGroup;
+
+	UPROPERTY()
+	TArray<TObjectPtr<UInworldCharacter>> Characters;
+};
+
+namespace Inworld
+{
+	namespace Test
+	{
+		IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSessionGroupShardLoads, "Inworld.SessionManagement.SessionGroupShardLoads", Flags)
+	}
+}